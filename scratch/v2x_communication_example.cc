@@ -37,6 +37,7 @@
 #include <ns3/spectrum-analyzer-helper.h>
 #include <ns3/multi-model-spectrum-channel.h>
 #include "ns3/ns2-mobility-helper.h"
+#include "ns3/v2x-broadcast-stats-calculator.h"
 #include <cfloat>
 #include <sstream>
 
@@ -60,6 +61,8 @@ Ptr<OutputStreamWrapper> log_tx_data;
 // Global variables
 uint32_t ctr_totRx = 0; 	// Counter for total received packets
 uint32_t ctr_totTx = 0; 	// Counter for total transmitted packets
+std::map<uint32_t, uint32_t> seq_tx;    // Sequence number of the next CAM of each node
+Ptr<V2xBroadcastStatsCalculator> prrStats;  // PRR, inter-reception time and latency statistics
 uint16_t lenCam;  
 double baseline= 150.0;     // Baseline distance in meter (150m for urban, 320m for freeway)
 
@@ -84,12 +87,16 @@ void SidelinkV2xAnnouncementMacTrace (Ptr<OutputStreamWrapper> stream)
 void 
 PrintStatus (uint32_t s_period, Ptr<OutputStreamWrapper> log_simtime)
 {
-    if (ctr_totRx > ctr_totTx)
+    // receptions and expected receptions within the baseline distance
+    uint64_t totRx = 0;
+    uint64_t totExpected = 0;
+    for (uint32_t i = 0; i < prrStats->GetNDistanceBins (); i++)
     {
-        ctr_totRx = ctr_totTx; 
+        totRx += prrStats->GetNReceived (i);
+        totExpected += prrStats->GetNExpected (i);
     }
-	*log_simtime->GetStream() << Simulator::Now ().GetSeconds () << ";" << ctr_totRx << ";" << ctr_totTx << ";" << (double) ctr_totRx / ctr_totTx << std::endl; 
-    std::cout << "t=" <<  Simulator::Now().GetSeconds() << "\t Rx/Tx="<< ctr_totRx << "/" << ctr_totTx << "\t PRR=" << (double) ctr_totRx / ctr_totTx << std::endl;
+	*log_simtime->GetStream() << Simulator::Now ().GetSeconds () << ";" << totRx << ";" << totExpected << ";" << (double) totRx / totExpected << std::endl; 
+    std::cout << "t=" <<  Simulator::Now().GetSeconds() << "\t Rx/Tx="<< totRx << "/" << totExpected << "\t PRR=" << (double) totRx / totExpected << std::endl;
     Simulator::Schedule(Seconds(s_period), &PrintStatus, s_period,log_simtime);
 }
 
@@ -102,23 +109,16 @@ SidelinkV2xAnnouncementMacTrace(Ptr<Socket> socket)
     Ptr<MobilityModel> posMobility = node->GetObject<MobilityModel>();
     Vector posTx = posMobility->GetPosition();
 
-    // check for each UE distance to transmitter
-    for (uint8_t i=0; i<ueVeh.GetN();i++)
-    {
-        Ptr<MobilityModel> mob = ueVeh.Get(i)->GetObject<MobilityModel>(); 
-        Vector posRx = mob->GetPosition();
-        
-        double distance = sqrt(pow((posTx.x - posRx.x),2.0)+pow((posTx.y - posRx.y),2.0));
-        if  (distance > 0 && distance <= baseline)
-        {
-            ctr_totTx++;
-        }
-    }
-    // Generate CAM 
-    std::ostringstream msgCam;
-    msgCam << id-1 << ";" << simTime << ";" << (int) posTx.x << ";" << (int) posTx.y << '\0'; 
-    Ptr<Packet> packet = Create<Packet>((uint8_t*)msgCam.str().c_str(),lenCam);
+    // Generate CAM: the metadata is carried by a tag, the payload is not used
+    V2xMessageTag tag;
+    tag.SetStationId (id);
+    tag.SetSequenceNumber (seq_tx[id]++);
+    tag.SetGenerationTime (Simulator::Now ());
+    tag.SetPosition (posTx);
+    Ptr<Packet> packet = Create<Packet>(lenCam);
+    packet->AddByteTag (tag);
     socket->Send(packet);
+    ctr_totTx++;
     *log_tx_data->GetStream() << ctr_totTx << ";" << simTime << ";"  << id-1 << ";" << (int) posTx.x << ";" << (int) posTx.y << std::endl;
 }
 
@@ -129,37 +129,21 @@ ReceivePacket(Ptr<Socket> socket)
     Ptr<MobilityModel> posMobility = node->GetObject<MobilityModel>();
     Vector posRx = posMobility->GetPosition();
     Ptr<Packet> packet = socket->Recv (); 
-    uint8_t *buffer = new uint8_t[packet->GetSize()];
-    packet->CopyData(buffer,packet->GetSize());
-    std::string s = std::string((char*)buffer);  
-
-    size_t pos = 0; 
-    std::string copy = s; 
-    std::string token;
-    int posTx_x;
-    int posTx_y;  
-    for (int i = 0; i < 3; i++)
+    V2xMessageTag tag;
+    if (!packet->FindFirstMatchingByteTag (tag))
     {
-        if (copy.find(";") != std::string::npos)
-        {
-            pos = copy.find(";");
-            token = copy.substr(0,pos);
-            if(i == 2)
-            {
-                posTx_x = atoi(token.c_str());
-            }
-            copy.erase (0,pos+1);
-        }  
-    }  
-    posTx_y = atoi(copy.c_str()); 
-
-    double distance = sqrt(pow((posTx_x - posRx.x),2.0)+pow((posTx_y - posRx.y),2.0));
+        return;
+    }
+    Vector posTx = tag.GetPosition ();
+
+    double distance = sqrt(pow((posTx.x - posRx.x),2.0)+pow((posTx.y - posRx.y),2.0));
     if (distance <= baseline)
     {         
         int id = node->GetId();
         int simTime = Simulator::Now().GetMilliSeconds();
         ctr_totRx++; 
-        *log_rx_data->GetStream() << ctr_totRx << ";" << simTime << ";"  << id-1 << ";" << s << std::endl; 
+        *log_rx_data->GetStream() << ctr_totRx << ";" << simTime << ";"  << id-1 << ";" << (int) tag.GetStationId () - 1 << ";"
+                                  << tag.GetGenerationTime ().GetMilliSeconds () << ";" << (int) posTx.x << ";" << (int) posTx.y << std::endl;
     }
 }
 
@@ -179,7 +163,7 @@ main (int argc, char *argv[])
     uint32_t mcs = 20;                      // Modulation and Coding Scheme
     bool harqEnabled = false;               // Retransmission enabled 
     bool adjacencyPscchPssch = true;        // Subchannelization scheme
-    bool partialSensing = false;            // Partial sensing enabled (actual only partialSensing is false supported)
+    bool partialSensing = false;            // Partial sensing enabled
     uint16_t sizeSubchannel = 10;           // Number of RBs per subchannel
     uint16_t numSubchannel = 3;             // Number of subchannels per subframe
     uint16_t startRbSubchannel = 0;         // Index of first RB corresponding to subchannelization
@@ -200,7 +184,7 @@ main (int argc, char *argv[])
     cmd.AddValue ("T1", "T1 Value of Selection Window", t1);
     cmd.AddValue ("T2", "T2 Value of Selection Window", t2);
     //cmd.AddValue ("harqEnabled", "HARQ Retransmission Enabled", harqEnabled);
-    //cmd.AddValue ("partialSensingEnabled", "Partial Sensing Enabled", partialSensing);
+    cmd.AddValue ("partialSensingEnabled", "Partial Sensing Enabled", partialSensing);
     cmd.AddValue ("lenCam", "Packetsize in Bytes", lenCam);
     cmd.AddValue ("mcs", "Modulation and Coding Scheme", mcs);
     cmd.AddValue ("pRsvp", "Resource Reservation Interval", pRsvp); 
@@ -375,111 +359,33 @@ main (int argc, char *argv[])
     //Attach each UE to the best available eNB
     lteHelper->Attach(ueDevs); 
 
-    NS_LOG_INFO ("Creating sidelink groups...");
-    std::vector<NetDeviceContainer> txGroups;
-    txGroups = lteV2xHelper->AssociateForV2xBroadcast(ueRespondersDevs, numVeh); 
-
-    lteV2xHelper->PrintGroups(txGroups); 
-    // compute average number of receivers associated per transmitter and vice versa
-    double totalRxs = 0;
-    std::map<uint32_t, uint32_t> txPerUeMap;
-    std::map<uint32_t, uint32_t> groupsPerUe;
-
-    std::vector<NetDeviceContainer>::iterator gIt;
-    for(gIt=txGroups.begin(); gIt != txGroups.end(); gIt++)
-        {
-            uint32_t numDevs = gIt->GetN();
-
-            totalRxs += numDevs-1;
-            uint32_t nId;
-
-            for(uint32_t i=1; i< numDevs; i++)
-                {
-                    nId = gIt->Get(i)->GetNode()->GetId();
-                    txPerUeMap[nId]++;
-                }
-        }
-
-    double totalTxPerUe = 0; 
-    std::map<uint32_t, uint32_t>::iterator mIt;
-    for(mIt=txPerUeMap.begin(); mIt != txPerUeMap.end(); mIt++)
-        {
-            totalTxPerUe += mIt->second;
-            groupsPerUe [mIt->second]++;
-        }
-
-    // lteV2xHelper->PrintGroups (txGroups, log_connections);
+    NS_LOG_INFO ("Creating sidelink group...");
+    // All vehicles broadcast to and receive from a single group
+    Ipv4AddressGenerator::Init(Ipv4Address ("225.0.0.0"), Ipv4Mask("255.0.0.0"));
+    Ipv4Address clientRespondersAddress = Ipv4AddressGenerator::NextAddress (Ipv4Mask ("255.0.0.0"));
+    uint32_t groupL2Address = 0x00; 
+    NetDeviceContainer activeTxUes = lteV2xHelper->AssociateForV2xSharedBroadcast (Seconds(0.0), ueRespondersDevs, numVeh, clientRespondersAddress, groupL2Address); 
 
     NS_LOG_INFO ("Installing applications...");
     
     // Application Setup for Responders
-    std::vector<uint32_t> groupL2Addresses; 
-    uint32_t groupL2Address = 0x00; 
-    Ipv4AddressGenerator::Init(Ipv4Address ("225.0.0.0"), Ipv4Mask("255.0.0.0"));
-    Ipv4Address clientRespondersAddress = Ipv4AddressGenerator::NextAddress (Ipv4Mask ("255.0.0.0"));
-
     uint16_t application_port = 8000; // Application port to TX/RX
-    NetDeviceContainer activeTxUes;
 
-    // Set Sidelink V2X Traces
-    /*AsciiTraceHelper ascii;
-    Ptr<OutputStreamWrapper> stream = ascii.CreateFileStream ("sidelinkV2x_out_monitoring.tr");
-    *stream->GetStream () << "Time" << std::endl;
-    
-    AsciiTraceHelper ascii1;
-    Ptr<OutputStreamWrapper> stream1 = ascii1.CreateFileStream ("sidelinkV2x_out_announcement_phy.tr");
-    *stream1->GetStream () << "Time" << std::endl;
-    
-    AsciiTraceHelper ascii2;
-    Ptr<OutputStreamWrapper> stream2 = ascii1.CreateFileStream ("sidelinkV2x_out_announcement_mac.tr");
-    *stream2->GetStream () << "Time" << std::endl;
-
-    std::ostringstream oss;
-    oss.str("");*/
-
-    for(gIt=txGroups.begin(); gIt != txGroups.end(); gIt++)
+    for(uint32_t i = 0; i < activeTxUes.GetN(); i++)
         {
-            // Create Sidelink bearers
-            // Use Tx for the group transmitter and Rx for all the receivers
-            // Split Tx/Rx
-
-            NetDeviceContainer txUe ((*gIt).Get(0));
-            activeTxUes.Add(txUe);
-            NetDeviceContainer rxUes = lteV2xHelper->RemoveNetDevice ((*gIt), txUe.Get (0));
-            Ptr<LteSlTft> tft = Create<LteSlTft> (LteSlTft::TRANSMIT, clientRespondersAddress, groupL2Address);
-            lteV2xHelper->ActivateSidelinkBearer (Seconds(0.0), txUe, tft);
-            tft = Create<LteSlTft> (LteSlTft::RECEIVE, clientRespondersAddress, groupL2Address);
-            lteV2xHelper->ActivateSidelinkBearer (Seconds(0.0), rxUes, tft);
-
-            //std::cout << "Created group L2Address=" << groupL2Address << " IPAddress=";
-            //clientRespondersAddress.Print(std::cout);
-            //std::cout << std::endl;
-
             //Individual Socket Traffic Broadcast everyone
-            Ptr<Socket> host = Socket::CreateSocket(txUe.Get(0)->GetNode(),TypeId::LookupByName ("ns3::UdpSocketFactory"));
+            Ptr<Socket> host = Socket::CreateSocket(activeTxUes.Get(i)->GetNode(),TypeId::LookupByName ("ns3::UdpSocketFactory"));
             host->Bind();
             host->Connect(InetSocketAddress(clientRespondersAddress,application_port));
             host->SetAllowBroadcast(true);
             host->ShutdownRecv();
 
-            //Ptr<LteUeRrc> ueRrc = DynamicCast<LteUeRrc>( txUe.Get (0)->GetObject<LteUeNetDevice> ()->GetRrc () );    
-            //ueRrc->TraceConnectWithoutContext ("SidelinkV2xMonitoring", MakeBoundCallback (&SidelinkV2xMonitoringTrace, stream));
-            //oss << txUe.Get(0) ->GetObject<LteUeNetDevice>()->GetImsi(); 
-            //Ptr<LteUePhy> uePhy = DynamicCast<LteUePhy>( txUe.Get (0)->GetObject<LteUeNetDevice> ()->GetPhy () );
-            //uePhy->TraceConnect ("SidelinkV2xAnnouncement", oss.str() ,MakeBoundCallback (&SidelinkV2xAnnouncementPhyTrace, stream1));
-            //uePhy->TraceConnectWithoutContext ("SidelinkV2xAnnouncement", MakeBoundCallback (&SidelinkV2xAnnouncementPhyTrace, host));
-            Ptr<LteUeMac> ueMac = DynamicCast<LteUeMac>( txUe.Get (0)->GetObject<LteUeNetDevice> ()->GetMac () );
+            Ptr<LteUeMac> ueMac = DynamicCast<LteUeMac>( activeTxUes.Get (i)->GetObject<LteUeNetDevice> ()->GetMac () );
             ueMac->TraceConnectWithoutContext ("SidelinkV2xAnnouncement", MakeBoundCallback (&SidelinkV2xAnnouncementMacTrace, host));
-            //ueMac->TraceConnect ("SidelinkV2xAnnouncement", oss.str() ,MakeBoundCallback (&SidelinkV2xAnnouncementMacTrace, stream2));
 
-            Ptr<Socket> sink = Socket::CreateSocket(txUe.Get(0)->GetNode(),TypeId::LookupByName ("ns3::UdpSocketFactory"));
+            Ptr<Socket> sink = Socket::CreateSocket(activeTxUes.Get(i)->GetNode(),TypeId::LookupByName ("ns3::UdpSocketFactory"));
             sink->Bind(InetSocketAddress (Ipv4Address::GetAny (), application_port));
             sink->SetRecvCallback (MakeCallback (&ReceivePacket));
-
-            //store and increment addresses
-            groupL2Addresses.push_back (groupL2Address);
-            groupL2Address++;
-            clientRespondersAddress = Ipv4AddressGenerator::NextAddress (Ipv4Mask ("255.0.0.0"));
         }
 
         NS_LOG_INFO ("Creating Sidelink Configuration...");
@@ -519,6 +425,10 @@ main (int argc, char *argv[])
         NS_LOG_INFO ("Enabling LTE traces...");
         lteHelper->EnableTraces();
 
+        // PRR within the baseline distance
+        prrStats = CreateObjectWithAttributes<V2xBroadcastStatsCalculator> ("MaxDistance", DoubleValue (baseline));
+        prrStats->Install (ueRespondersDevs);
+
         NS_LOG_INFO ("Enabling Pcap ...");
         lteV2xHelper->EnablePcapAll("v2x_communication_example");
     
@@ -529,6 +439,9 @@ main (int argc, char *argv[])
         NS_LOG_INFO ("Starting Simulation...");
         Simulator::Stop(MilliSeconds(simTime*1000+40));
         Simulator::Run();
+
+        std::ofstream prrFile ("log_prr_v2x.txt");
+        prrStats->Print (prrFile);
         Simulator::Destroy();
 
         NS_LOG_INFO("Simulation done.");
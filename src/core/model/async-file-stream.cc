@@ -0,0 +1,342 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "async-file-stream.h"
+#include "global-value.h"
+#include "boolean.h"
+#include "assert.h"
+#include "log.h"
+
+/**
+ * \file
+ * \ingroup thread
+ * ns3::AsyncFileStreamBuf and ns3::AsyncFileStream implementations.
+ */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("AsyncFileStream");
+
+/**
+ * \ingroup thread
+ * Whether the trace and statistics files are written by background
+ * threads.
+ */
+static GlobalValue g_asyncFileStreamsEnabled = GlobalValue
+  ("AsyncFileStreamsEnabled",
+   "Write the trace and statistics files in background threads, "
+   "instead of the simulation thread",
+   BooleanValue (false),
+   MakeBooleanChecker ());
+
+/// The size in bytes of a chunk of the streams created by AsyncFileStream
+static const uint32_t g_asyncFileStreamChunkSize = 1 << 16;
+/// The number of chunks of the streams created by AsyncFileStream
+static const uint32_t g_asyncFileStreamNChunks = 16;
+
+AsyncFileStreamBuf::AsyncFileStreamBuf ()
+#ifdef HAVE_PTHREAD_H
+  : m_head (0),
+    m_tail (0),
+    m_writerWaiting (false),
+    m_producerWaiting (false),
+    m_error (false),
+    m_stop (false)
+#else
+  : m_error (false)
+#endif /* HAVE_PTHREAD_H */
+{
+  NS_LOG_FUNCTION (this);
+}
+
+AsyncFileStreamBuf::~AsyncFileStreamBuf ()
+{
+  NS_LOG_FUNCTION (this);
+  Close ();
+}
+
+AsyncFileStreamBuf *
+AsyncFileStreamBuf::Open (std::string filename, std::ios::openmode mode,
+                          uint32_t chunkSize, uint32_t nChunks)
+{
+  NS_LOG_FUNCTION (this << filename << mode << chunkSize << nChunks);
+  NS_ASSERT (chunkSize > 0 && nChunks > 0);
+  if (IsOpen () || !m_file.open (filename.c_str (), mode | std::ios::out))
+    {
+      return 0;
+    }
+  Chunk chunk;
+  chunk.data.resize (chunkSize);
+  chunk.length = 0;
+  chunk.sync = false;
+  m_chunks.assign (nChunks, chunk);
+  m_error = false;
+#ifdef HAVE_PTHREAD_H
+  m_head = 0;
+  m_tail = 0;
+  m_stop = false;
+  m_thread = std::thread (&AsyncFileStreamBuf::DoWrite, this);
+#endif /* HAVE_PTHREAD_H */
+  SetPutArea ();
+  return this;
+}
+
+bool
+AsyncFileStreamBuf::IsOpen (void) const
+{
+  return m_file.is_open ();
+}
+
+bool
+AsyncFileStreamBuf::Flush (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (!IsOpen ())
+    {
+      return false;
+    }
+  bool ok = Publish (true);
+#ifdef HAVE_PTHREAD_H
+  WaitHead (m_tail);
+  ok = !m_error;
+#endif /* HAVE_PTHREAD_H */
+  return ok;
+}
+
+AsyncFileStreamBuf *
+AsyncFileStreamBuf::Close (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (!IsOpen ())
+    {
+      return 0;
+    }
+  Publish (false);
+#ifdef HAVE_PTHREAD_H
+  {
+    std::unique_lock<std::mutex> lock (m_mutex);
+    m_stop = true;
+  }
+  m_notEmpty.notify_one ();
+  m_thread.join ();
+#endif /* HAVE_PTHREAD_H */
+  bool ok = !m_error;
+  if (!m_file.close ())
+    {
+      ok = false;
+    }
+  setp (0, 0);
+  m_chunks.clear ();
+  return ok ? this : 0;
+}
+
+AsyncFileStreamBuf::int_type
+AsyncFileStreamBuf::overflow (int_type c)
+{
+  if (!IsOpen () || !Publish (false))
+    {
+      return traits_type::eof ();
+    }
+  if (!traits_type::eq_int_type (c, traits_type::eof ()))
+    {
+      *pptr () = traits_type::to_char_type (c);
+      pbump (1);
+    }
+  return traits_type::not_eof (c);
+}
+
+int
+AsyncFileStreamBuf::sync (void)
+{
+  // the records are written by the writer thread: see Flush
+  return m_error ? -1 : 0;
+}
+
+void
+AsyncFileStreamBuf::SetPutArea (void)
+{
+#ifdef HAVE_PTHREAD_H
+  Chunk &chunk = m_chunks[m_tail % m_chunks.size ()];
+#else
+  Chunk &chunk = m_chunks[0];
+#endif /* HAVE_PTHREAD_H */
+  setp (&chunk.data[0], &chunk.data[0] + chunk.data.size ());
+}
+
+bool
+AsyncFileStreamBuf::Publish (bool sync)
+{
+  std::size_t length = pptr () - pbase ();
+  if (length == 0 && !sync)
+    {
+      return !m_error;
+    }
+#ifdef HAVE_PTHREAD_H
+  uint64_t tail = m_tail;
+  Chunk &chunk = m_chunks[tail % m_chunks.size ()];
+  chunk.length = length;
+  chunk.sync = sync;
+  m_tail = tail + 1;
+  if (m_writerWaiting)
+    {
+      std::unique_lock<std::mutex> lock (m_mutex);
+      m_notEmpty.notify_one ();
+    }
+  // back-pressure: wait for the next chunk to be written to the file
+  if (tail + 2 > m_chunks.size ())
+    {
+      WaitHead (tail + 2 - m_chunks.size ());
+    }
+#else
+  if (m_file.sputn (pbase (), length) != static_cast<std::streamsize> (length)
+      || (sync && m_file.pubsync () == -1))
+    {
+      m_error = true;
+    }
+#endif /* HAVE_PTHREAD_H */
+  SetPutArea ();
+  return !m_error;
+}
+
+#ifdef HAVE_PTHREAD_H
+void
+AsyncFileStreamBuf::WaitHead (uint64_t head)
+{
+  if (m_head >= head)
+    {
+      return;
+    }
+  std::unique_lock<std::mutex> lock (m_mutex);
+  m_producerWaiting = true;
+  while (m_head < head)
+    {
+      m_written.wait (lock);
+    }
+  m_producerWaiting = false;
+}
+
+void
+AsyncFileStreamBuf::DoWrite (void)
+{
+  for (;;)
+    {
+      uint64_t head = m_head;
+      if (m_tail == head)
+        {
+          std::unique_lock<std::mutex> lock (m_mutex);
+          m_writerWaiting = true;
+          while (m_tail == head && !m_stop)
+            {
+              m_notEmpty.wait (lock);
+            }
+          m_writerWaiting = false;
+          if (m_tail == head)
+            {
+              // stopped, and all the chunks are written
+              return;
+            }
+          continue;
+        }
+      const Chunk &chunk = m_chunks[head % m_chunks.size ()];
+      if (!m_error
+          && (m_file.sputn (&chunk.data[0], chunk.length) != static_cast<std::streamsize> (chunk.length)
+              || (chunk.sync && m_file.pubsync () == -1)))
+        {
+          m_error = true;
+        }
+      m_head = head + 1;
+      if (m_producerWaiting)
+        {
+          std::unique_lock<std::mutex> lock (m_mutex);
+          m_written.notify_one ();
+        }
+    }
+}
+#endif /* HAVE_PTHREAD_H */
+
+
+AsyncFileStream::AsyncFileStream ()
+  : std::ostream (0)
+{
+  init (&m_buf);
+}
+
+AsyncFileStream::AsyncFileStream (std::string filename, std::ios::openmode mode)
+  : std::ostream (0)
+{
+  init (&m_buf);
+  open (filename, mode);
+}
+
+void
+AsyncFileStream::open (std::string filename, std::ios::openmode mode)
+{
+  if (m_buf.Open (filename, mode, g_asyncFileStreamChunkSize, g_asyncFileStreamNChunks) == 0)
+    {
+      setstate (std::ios::failbit);
+    }
+  else
+    {
+      clear ();
+    }
+}
+
+bool
+AsyncFileStream::is_open (void) const
+{
+  return m_buf.IsOpen ();
+}
+
+void
+AsyncFileStream::close (void)
+{
+  if (m_buf.Close () == 0)
+    {
+      setstate (std::ios::failbit);
+    }
+}
+
+void
+AsyncFileStream::Flush (void)
+{
+  if (!m_buf.Flush ())
+    {
+      setstate (std::ios::badbit);
+    }
+}
+
+bool
+AsyncFileStream::IsEnabled (void)
+{
+  BooleanValue enabled;
+  g_asyncFileStreamsEnabled.GetValue (enabled);
+  return enabled.Get ();
+}
+
+std::ostream *
+AsyncFileStream::Create (std::string filename, std::ios::openmode mode)
+{
+  NS_LOG_FUNCTION (filename << mode);
+  if (IsEnabled ())
+    {
+      return new AsyncFileStream (filename, mode);
+    }
+  std::ofstream *os = new std::ofstream ();
+  os->open (filename.c_str (), mode);
+  return os;
+}
+
+} // namespace ns3
@@ -0,0 +1,196 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef ASYNC_FILE_STREAM_H
+#define ASYNC_FILE_STREAM_H
+
+#include "ns3/core-config.h"
+#include <stdint.h>
+#include <fstream>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <vector>
+#ifdef HAVE_PTHREAD_H
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#endif /* HAVE_PTHREAD_H */
+
+/**
+ * \file
+ * \ingroup thread
+ * ns3::AsyncFileStreamBuf and ns3::AsyncFileStream declarations.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup thread
+ *
+ * \brief A file stream buffer written by a background thread.
+ *
+ * The stream is written into a ring of fixed-size chunks.  A full
+ * chunk is queued and a background thread writes it to the file, so
+ * the thread formatting the records never waits for the disk unless
+ * all the chunks are queued.  The ring has a single producer and a
+ * single consumer, and its indices are atomic: a thread only takes a
+ * lock to sleep, when the ring is full or empty.
+ *
+ * Flushing the stream, e.g. by std::endl, does nothing: the records
+ * are written when a chunk is full, on Flush and on Close.  The streams
+ * registered with FatalImpl::RegisterStream are written by Flush on a
+ * fatal error.
+ *
+ * Without POSIX threads, the chunks are written by the thread writing
+ * the stream.
+ */
+class AsyncFileStreamBuf : public std::streambuf
+{
+public:
+  AsyncFileStreamBuf ();
+  /** Close the file. */
+  virtual ~AsyncFileStreamBuf ();
+
+  /**
+   * Open a file and start its writer thread.
+   * \param filename the name of the file
+   * \param mode the std::ios::openmode flags
+   * \param chunkSize the size in bytes of a chunk
+   * \param nChunks the number of chunks, which bounds the memory of
+   *        the records not written yet
+   * \return this, or 0 if the file can't be opened
+   */
+  AsyncFileStreamBuf * Open (std::string filename, std::ios::openmode mode,
+                             uint32_t chunkSize, uint32_t nChunks);
+  /** \return true if the file is open */
+  bool IsOpen (void) const;
+  /**
+   * Write the records to the file and wait for the writer thread.
+   * \return false if a write failed
+   */
+  bool Flush (void);
+  /**
+   * Write the records, stop the writer thread and close the file.
+   * \return this, or 0 if the file was not open or a write failed
+   */
+  AsyncFileStreamBuf * Close (void);
+
+protected:
+  virtual int_type overflow (int_type c);
+  virtual int sync (void);
+
+private:
+  /** A chunk of the ring. */
+  struct Chunk
+  {
+    std::vector<char> data; //!< the records
+    std::size_t length;     //!< the number of bytes of the records
+    bool sync;              //!< whether to flush the file after the records
+  };
+
+  /**
+   * Queue the chunk being written and take the next one.
+   * \param sync whether to flush the file after the chunk
+   * \return false if a write failed
+   */
+  bool Publish (bool sync);
+  /** Set the put area to the chunk being written. */
+  void SetPutArea (void);
+
+  std::filebuf m_file;                    //!< the file
+  std::vector<Chunk> m_chunks;            //!< the ring of chunks
+#ifdef HAVE_PTHREAD_H
+  /** Loop of the writer thread. */
+  void DoWrite (void);
+  /**
+   * Wait until the writer thread has written the chunks up to an index.
+   * \param head the index of the first chunk not to wait for
+   */
+  void WaitHead (uint64_t head);
+
+  std::atomic<uint64_t> m_head;           //!< the index of the next chunk to write to the file
+  std::atomic<uint64_t> m_tail;           //!< the index of the chunk being written by the stream
+  std::atomic<bool> m_writerWaiting;      //!< whether the writer thread sleeps
+  std::atomic<bool> m_producerWaiting;    //!< whether the stream waits for the writer thread
+  std::atomic<bool> m_error;              //!< whether a write failed
+  std::thread m_thread;                   //!< the writer thread
+  std::mutex m_mutex;                     //!< protects the sleeps
+  std::condition_variable m_notEmpty;     //!< signals a queued chunk or the end of the thread
+  std::condition_variable m_written;      //!< signals a chunk written to the file
+  bool m_stop;                            //!< whether the writer thread must stop
+#else
+  bool m_error;                           //!< whether a write failed
+#endif /* HAVE_PTHREAD_H */
+};
+
+/**
+ * \ingroup thread
+ *
+ * \brief An output file stream written by a background thread.
+ *
+ * The counterpart of std::ofstream for AsyncFileStreamBuf.  Flush
+ * waits for the records to be written; std::ostream::flush does not.
+ * The file streams of OutputStreamWrapper and of the statistics files
+ * are of this type when the global value AsyncFileStreamsEnabled is
+ * true.
+ */
+class AsyncFileStream : public std::ostream
+{
+public:
+  AsyncFileStream ();
+  /**
+   * Open a file.
+   * \param filename the name of the file
+   * \param mode the std::ios::openmode flags
+   */
+  AsyncFileStream (std::string filename, std::ios::openmode mode = std::ios::out);
+
+  /**
+   * Open a file; the stream fails if it can't be opened.
+   * \param filename the name of the file
+   * \param mode the std::ios::openmode flags
+   */
+  void open (std::string filename, std::ios::openmode mode = std::ios::out);
+  /** \return true if the file is open */
+  bool is_open (void) const;
+  /** Write the records and close the file. */
+  void close (void);
+  /** Write the records to the file and wait for them to be written. */
+  void Flush (void);
+
+  /**
+   * \return the value of the global value AsyncFileStreamsEnabled
+   */
+  static bool IsEnabled (void);
+
+  /**
+   * Create an output file stream, of this type if the global value
+   * AsyncFileStreamsEnabled is true and a std::ofstream otherwise.
+   * \param filename the name of the file
+   * \param mode the std::ios::openmode flags
+   * \return the stream, which fails if the file can't be opened
+   */
+  static std::ostream * Create (std::string filename, std::ios::openmode mode);
+
+private:
+  AsyncFileStreamBuf m_buf; //!< the stream buffer
+};
+
+} // namespace ns3
+
+#endif /* ASYNC_FILE_STREAM_H */
@@ -0,0 +1,168 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "bucket-scheduler.h"
+#include "event-impl.h"
+#include "assert.h"
+#include "log.h"
+#include <algorithm>
+
+/**
+ * \file
+ * \ingroup scheduler
+ * ns3::BucketScheduler implementation.
+ */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("BucketScheduler");
+
+NS_OBJECT_ENSURE_REGISTERED (BucketScheduler);
+
+namespace {
+
+/**
+ * \ingroup scheduler
+ * Compare the uids of two events of the same timestamp.
+ *
+ * \param [in] a The first event.
+ * \param [in] b The second event.
+ * \returns \c true if the uid of \p a is smaller.
+ */
+bool
+UidLess (const Scheduler::Event &a, const Scheduler::Event &b)
+{
+  return a.key.m_uid < b.key.m_uid;
+}
+
+/** The maximum number of arrays kept for the future buckets. */
+const std::size_t MAX_FREE_ARRAYS = 64;
+
+} // unnamed namespace
+
+TypeId
+BucketScheduler::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::BucketScheduler")
+    .SetParent<Scheduler> ()
+    .SetGroupName ("Core")
+    .AddConstructor<BucketScheduler> ()
+  ;
+  return tid;
+}
+
+BucketScheduler::BucketScheduler ()
+{
+  NS_LOG_FUNCTION (this);
+  m_freeArrays.reserve (MAX_FREE_ARRAYS);
+}
+BucketScheduler::~BucketScheduler ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+BucketScheduler::Insert (const Event &ev)
+{
+  NS_LOG_FUNCTION (this << ev.impl << ev.key.m_ts << ev.key.m_uid);
+  BucketMapI i = m_buckets.lower_bound (ev.key.m_ts);
+  if (i == m_buckets.end () || i->first != ev.key.m_ts)
+    {
+      i = m_buckets.insert (i, std::make_pair (ev.key.m_ts, Bucket ()));
+      i->second.m_head = 0;
+      if (!m_freeArrays.empty ())
+        {
+          i->second.m_events.swap (m_freeArrays.back ());
+          m_freeArrays.pop_back ();
+        }
+    }
+  std::vector<Event> &events = i->second.m_events;
+  if (events.size () == i->second.m_head || events.back ().key.m_uid < ev.key.m_uid)
+    {
+      // the uids are increasing, so this is the common case
+      events.push_back (ev);
+    }
+  else
+    {
+      std::vector<Event>::iterator pos = std::upper_bound (events.begin () + i->second.m_head, events.end (), ev, UidLess);
+      events.insert (pos, ev);
+    }
+}
+
+bool
+BucketScheduler::IsEmpty (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_buckets.empty ();
+}
+
+Scheduler::Event
+BucketScheduler::PeekNext (void) const
+{
+  NS_LOG_FUNCTION (this);
+  BucketMapCI i = m_buckets.begin ();
+  NS_ASSERT (i != m_buckets.end ());
+  const Event &ev = i->second.m_events[i->second.m_head];
+  NS_LOG_DEBUG (this << ev.impl << ev.key.m_ts << ev.key.m_uid);
+  return ev;
+}
+
+Scheduler::Event
+BucketScheduler::RemoveNext (void)
+{
+  NS_LOG_FUNCTION (this);
+  BucketMapI i = m_buckets.begin ();
+  NS_ASSERT (i != m_buckets.end ());
+  Event ev = i->second.m_events[i->second.m_head];
+  i->second.m_head++;
+  if (i->second.m_head == i->second.m_events.size ())
+    {
+      RemoveBucket (i);
+    }
+  NS_LOG_DEBUG (this << ev.impl << ev.key.m_ts << ev.key.m_uid);
+  return ev;
+}
+
+void
+BucketScheduler::Remove (const Event &ev)
+{
+  NS_LOG_FUNCTION (this << ev.impl << ev.key.m_ts << ev.key.m_uid);
+  BucketMapI i = m_buckets.find (ev.key.m_ts);
+  NS_ASSERT (i != m_buckets.end ());
+  std::vector<Event> &events = i->second.m_events;
+  std::vector<Event>::iterator pos = std::lower_bound (events.begin () + i->second.m_head, events.end (), ev, UidLess);
+  NS_ASSERT (pos != events.end () && pos->impl == ev.impl);
+  events.erase (pos);
+  if (i->second.m_head == events.size ())
+    {
+      RemoveBucket (i);
+    }
+}
+
+void
+BucketScheduler::RemoveBucket (BucketMapI i)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_freeArrays.size () < MAX_FREE_ARRAYS)
+    {
+      i->second.m_events.clear ();
+      m_freeArrays.push_back (std::vector<Event> ());
+      m_freeArrays.back ().swap (i->second.m_events);
+    }
+  m_buckets.erase (i);
+}
+
+} // namespace ns3
@@ -0,0 +1,105 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef BUCKET_SCHEDULER_H
+#define BUCKET_SCHEDULER_H
+
+#include "scheduler.h"
+#include <stdint.h>
+#include <map>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup scheduler
+ * ns3::BucketScheduler declaration.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup scheduler
+ * \brief an event scheduler bucketing the events by timestamp
+ *
+ * The events with the same timestamp are stored in a contiguous array,
+ * in increasing uid order, and a std::map orders the distinct
+ * timestamps. Inserting an event at an existing timestamp appends it to
+ * the array, and removing the next event advances the head of the
+ * array of the first timestamp, so that the cost of the map is paid once
+ * per distinct timestamp instead of once per event.
+ *
+ * This suits the workloads where many events are scheduled at exactly
+ * the same times, e.g. the subframe boundaries of LTE, every 1 ms. For
+ * workloads where almost all timestamps are distinct, it costs slightly
+ * more than the MapScheduler.
+ *
+ * The arrays of the empty buckets are recycled to avoid reallocating
+ * them at each timestamp.
+ */
+class BucketScheduler : public Scheduler
+{
+public:
+  /**
+   *  Register this type.
+   *  \return The object TypeId.
+   */
+  static TypeId GetTypeId (void);
+
+  /** Constructor. */
+  BucketScheduler ();
+  /** Destructor. */
+  virtual ~BucketScheduler ();
+
+  // Inherited
+  virtual void Insert (const Scheduler::Event &ev);
+  virtual bool IsEmpty (void) const;
+  virtual Scheduler::Event PeekNext (void) const;
+  virtual Scheduler::Event RemoveNext (void);
+  virtual void Remove (const Scheduler::Event &ev);
+
+private:
+  /** The events of a timestamp. */
+  struct Bucket
+  {
+    /** The events, in increasing uid order from m_head. */
+    std::vector<Scheduler::Event> m_events;
+    /** The index of the next event, the previous ones were removed. */
+    std::size_t m_head;
+  };
+
+  /** Bucket list type: a Map from timestamp to Bucket. */
+  typedef std::map<uint64_t, Bucket> BucketMap;
+  /** BucketMap iterator. */
+  typedef std::map<uint64_t, Bucket>::iterator BucketMapI;
+  /** BucketMap const iterator. */
+  typedef std::map<uint64_t, Bucket>::const_iterator BucketMapCI;
+
+  /**
+   * Remove an empty bucket, and keep its array for a future bucket.
+   *
+   * \param [in] i The bucket to remove.
+   */
+  void RemoveBucket (BucketMapI i);
+
+  /** The buckets, by increasing timestamp. */
+  BucketMap m_buckets;
+  /** The arrays of the removed buckets. */
+  std::vector<std::vector<Scheduler::Event> > m_freeArrays;
+};
+
+} // namespace ns3
+
+#endif /* BUCKET_SCHEDULER_H */
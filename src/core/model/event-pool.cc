@@ -0,0 +1,195 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "event-pool.h"
+#include "ns3/core-config.h"
+#include <new>
+
+/**
+ * \file
+ * \ingroup events
+ * ns3::EventPool implementation.
+ *
+ * No logging here: the functions are called for every event.
+ */
+
+namespace ns3 {
+
+const std::size_t EventPool::GRANULARITY;
+const std::size_t EventPool::MAX_SIZE;
+const std::size_t EventPool::MAX_CACHED_BYTES;
+
+namespace {
+
+/** The number of size classes. */
+const std::size_t N_CLASSES = EventPool::MAX_SIZE / EventPool::GRANULARITY;
+
+/** A free block, linked to the next free block of its size class. */
+struct FreeBlock
+{
+  FreeBlock *m_next; //!< the next free block
+};
+
+/**
+ * The pool of a thread.
+ *
+ * It is trivially constructible and destructible, so that it is usable
+ * during the destruction of the other objects of the thread; the blocks
+ * are freed by a PoolReaper.
+ */
+struct PoolState
+{
+  FreeBlock *m_heads[N_CLASSES];  //!< the free list of each size class
+  EventPool::Stats m_stats;       //!< the statistics
+  bool m_reaperRegistered;        //!< whether the PoolReaper of the thread exists
+  bool m_exited;                  //!< whether the thread is exiting
+};
+
+/**
+ * The pool of the calling thread.
+ *
+ * With --enable-static-tls, the initial-exec model avoids calling
+ * __tls_get_addr at each access from the shared library, but takes a
+ * part of the static TLS block, which dlopen may not have left.
+ */
+#if defined (NS3_STATIC_TLS) && defined (__GNUC__) && !defined (__APPLE__)
+__attribute__ ((tls_model ("initial-exec")))
+#endif
+thread_local PoolState g_pool;
+
+/** Free the blocks of the pool of a thread when the thread exits. */
+struct PoolReaper
+{
+  ~PoolReaper ()
+  {
+    EventPool::Release ();
+    g_pool.m_exited = true;
+  }
+};
+
+/**
+ * Create the PoolReaper of the calling thread, before its first block is
+ * kept in a free list.
+ */
+void
+RegisterReaper (void)
+{
+  static thread_local PoolReaper reaper;
+  (void) reaper;
+  g_pool.m_reaperRegistered = true;
+}
+
+/**
+ * \param [in] size The size of a block.
+ * \returns The size class of the block.
+ */
+inline std::size_t
+GetSizeClass (std::size_t size)
+{
+  return (size + EventPool::GRANULARITY - 1) / EventPool::GRANULARITY - 1;
+}
+
+} // unnamed namespace
+
+void *
+EventPool::Allocate (std::size_t size)
+{
+  PoolState &pool = g_pool;
+  pool.m_stats.m_allocations++;
+  if (size > MAX_SIZE || size == 0)
+    {
+      pool.m_stats.m_unpooled++;
+      return ::operator new (size);
+    }
+  std::size_t c = GetSizeClass (size);
+  FreeBlock *block = pool.m_heads[c];
+  if (block != 0)
+    {
+      pool.m_heads[c] = block->m_next;
+      pool.m_stats.m_cached--;
+      pool.m_stats.m_cachedBytes -= (c + 1) * GRANULARITY;
+      pool.m_stats.m_reuses++;
+      return block;
+    }
+  return ::operator new ((c + 1) * GRANULARITY);
+}
+
+void
+EventPool::Deallocate (void *p, std::size_t size)
+{
+  if (p == 0)
+    {
+      return;
+    }
+  PoolState &pool = g_pool;
+  pool.m_stats.m_deallocations++;
+  if (size > MAX_SIZE || size == 0 || pool.m_exited)
+    {
+      ::operator delete (p);
+      return;
+    }
+  std::size_t c = GetSizeClass (size);
+  if (pool.m_stats.m_cachedBytes + (c + 1) * GRANULARITY > MAX_CACHED_BYTES)
+    {
+      ::operator delete (p);
+      return;
+    }
+  if (!pool.m_reaperRegistered)
+    {
+      RegisterReaper ();
+    }
+  FreeBlock *block = static_cast<FreeBlock *> (p);
+  block->m_next = pool.m_heads[c];
+  pool.m_heads[c] = block;
+  pool.m_stats.m_cached++;
+  pool.m_stats.m_cachedBytes += (c + 1) * GRANULARITY;
+}
+
+EventPool::Stats
+EventPool::GetStats (void)
+{
+  return g_pool.m_stats;
+}
+
+void
+EventPool::ResetStats (void)
+{
+  PoolState &pool = g_pool;
+  uint64_t cached = pool.m_stats.m_cached;
+  uint64_t cachedBytes = pool.m_stats.m_cachedBytes;
+  pool.m_stats = Stats ();
+  pool.m_stats.m_cached = cached;
+  pool.m_stats.m_cachedBytes = cachedBytes;
+}
+
+void
+EventPool::Release (void)
+{
+  PoolState &pool = g_pool;
+  for (std::size_t c = 0; c < N_CLASSES; c++)
+    {
+      while (pool.m_heads[c] != 0)
+        {
+          FreeBlock *block = pool.m_heads[c];
+          pool.m_heads[c] = block->m_next;
+          ::operator delete (block);
+        }
+    }
+  pool.m_stats.m_cached = 0;
+  pool.m_stats.m_cachedBytes = 0;
+}
+
+} // namespace ns3
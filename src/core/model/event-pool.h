@@ -0,0 +1,96 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef EVENT_POOL_H
+#define EVENT_POOL_H
+
+#include <stdint.h>
+#include <cstddef>
+
+/**
+ * \file
+ * \ingroup events
+ * ns3::EventPool declaration.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup events
+ * \brief Size-classed free lists for the memory of the EventImpl objects.
+ *
+ * Each EventImpl, e.g. the ones created by MakeEvent for every
+ * Simulator::Schedule, is allocated by Allocate and freed by Deallocate
+ * once invoked or cancelled.  The sizes are rounded up to a multiple of
+ * #GRANULARITY and the freed blocks of each size class are kept in a
+ * free list, so that, once the number of pending events has reached its
+ * peak, scheduling an event reuses the block of a past one instead of
+ * calling malloc and free.  The blocks bigger than #MAX_SIZE are not
+ * pooled, and a thread keeps at most #MAX_CACHED_BYTES in its free
+ * lists.
+ *
+ * The free lists and the statistics belong to the calling thread, so no
+ * lock is taken: an event scheduled by a thread and freed by another one
+ * is pooled by the latter.  The blocks kept by a thread are freed when
+ * the thread exits.
+ */
+class EventPool
+{
+public:
+  /** The statistics of the pool of a thread. */
+  struct Stats
+  {
+    uint64_t m_allocations;   //!< the number of blocks allocated
+    uint64_t m_reuses;        //!< the number of allocations served by a free list
+    uint64_t m_deallocations; //!< the number of blocks freed
+    uint64_t m_unpooled;      //!< the number of allocations bigger than #MAX_SIZE
+    uint64_t m_cached;        //!< the number of blocks currently in the free lists
+    uint64_t m_cachedBytes;   //!< the size of the blocks currently in the free lists
+  };
+
+  /** The size classes are the multiples of GRANULARITY. */
+  static const std::size_t GRANULARITY = 16;
+  /** The size of the biggest pooled blocks. */
+  static const std::size_t MAX_SIZE = 256;
+  /** The maximum size of the blocks kept in the free lists of a thread. */
+  static const std::size_t MAX_CACHED_BYTES = 4 << 20;
+
+  /**
+   * Allocate a block.
+   * \param [in] size The size of the block.
+   * \returns The block.
+   */
+  static void * Allocate (std::size_t size);
+  /**
+   * Free a block returned by Allocate.
+   * \param [in] p The block.
+   * \param [in] size The size given to Allocate.
+   */
+  static void Deallocate (void *p, std::size_t size);
+
+  /**
+   * \returns The statistics of the pool of the calling thread.
+   */
+  static Stats GetStats (void);
+  /** Reset the counters of the pool of the calling thread. */
+  static void ResetStats (void);
+  /** Free the blocks kept in the free lists of the calling thread. */
+  static void Release (void);
+};
+
+} // namespace ns3
+
+#endif /* EVENT_POOL_H */
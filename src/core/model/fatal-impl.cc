@@ -18,6 +18,7 @@
  * Author: Quincy Tse <quincy.tse@nicta.com.au>
  */
 #include "fatal-impl.h"
+#include "async-file-stream.h"
 #include "log.h"
 
 #include <iostream>
@@ -171,7 +172,16 @@ FlushStreams (void)
     {
       std::ostream* s (l->front ());
       l->pop_front ();
-      s->flush ();
+      /* Flushing an AsyncFileStream does not write its records */
+      AsyncFileStream *async = dynamic_cast<AsyncFileStream *> (s);
+      if (async != 0)
+        {
+          async->Flush ();
+        }
+      else
+        {
+          s->flush ();
+        }
     }
 
   /* Restore default SIGSEGV handler (Not that it matters anyway) */
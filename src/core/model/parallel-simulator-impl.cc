@@ -0,0 +1,647 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "simulator.h"
+#include "parallel-simulator-impl.h"
+#include "scheduler.h"
+#include "event-impl.h"
+#include "worker-pool.h"
+
+#include "uinteger.h"
+#include "abort.h"
+#include "assert.h"
+#include "log.h"
+
+#include <algorithm>
+#include <limits>
+
+/**
+ * \file
+ * \ingroup simulator
+ * ns3::ParallelSimulatorImpl implementation.
+ */
+
+namespace ns3 {
+
+// Note:  Logging in this file is largely avoided due to the
+// number of calls that are made to these functions and the possibility
+// of causing recursions leading to stack overflow
+NS_LOG_COMPONENT_DEFINE ("ParallelSimulatorImpl");
+
+NS_OBJECT_ENSURE_REGISTERED (ParallelSimulatorImpl);
+
+namespace {
+
+/**
+ * The partition run by the calling thread, set during the windows.
+ * There is only one simulator implementation at a time.
+ */
+thread_local void *g_currentPartition = 0;
+
+/** Whether the partition of the calling thread shares its windows with others. */
+thread_local bool g_concurrentPartitions = false;
+
+/** The partition of the contexts not set by SetPartition. */
+const uint32_t NO_PARTITION = std::numeric_limits<uint32_t>::max ();
+
+/** A time after all the events. */
+const uint64_t NEVER = std::numeric_limits<uint64_t>::max ();
+
+} // unnamed namespace
+
+TypeId
+ParallelSimulatorImpl::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::ParallelSimulatorImpl")
+    .SetParent<SimulatorImpl> ()
+    .SetGroupName ("Core")
+    .AddConstructor<ParallelSimulatorImpl> ()
+    .AddAttribute ("Partitions",
+                   "The number of partitions of the events; the simulation "
+                   "depends on it, not on the number of threads",
+                   UintegerValue (8),
+                   MakeUintegerAccessor (&ParallelSimulatorImpl::m_nPartitions),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("Threads",
+                   "The number of threads running the partitions, including "
+                   "the simulation thread (0 for one per partition)",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&ParallelSimulatorImpl::m_nThreads),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("Lookahead",
+                   "The duration of a window: the minimum delay of the events "
+                   "scheduled in another partition",
+                   TimeValue (MilliSeconds (1)),
+                   MakeTimeAccessor (&ParallelSimulatorImpl::m_lookahead),
+                   MakeTimeChecker (TimeStep (1)))
+  ;
+  return tid;
+}
+
+ParallelSimulatorImpl::ParallelSimulatorImpl ()
+  : m_pool (0),
+    m_nPartitions (1),
+    m_nThreads (0),
+    m_windowEnd (0),
+    m_stopTs (NEVER),
+    m_stop (false),
+    m_running (false),
+    m_currentTs (0),
+    m_windowCount (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+ParallelSimulatorImpl::~ParallelSimulatorImpl ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+ParallelSimulatorImpl::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  DeliverOutboxes ();
+  for (std::vector<Partition>::iterator p = m_partitions.begin (); p != m_partitions.end (); p++)
+    {
+      while (!p->m_events->IsEmpty ())
+        {
+          Scheduler::Event next = p->m_events->RemoveNext ();
+          next.impl->Unref ();
+        }
+      p->m_events = 0;
+    }
+  m_partitions.clear ();
+  delete m_pool;
+  m_pool = 0;
+  SimulatorImpl::DoDispose ();
+}
+
+void
+ParallelSimulatorImpl::Destroy ()
+{
+  NS_LOG_FUNCTION (this);
+  while (!m_destroyEvents.empty ())
+    {
+      Ptr<EventImpl> ev = m_destroyEvents.front ().PeekEventImpl ();
+      m_destroyEvents.pop_front ();
+      NS_LOG_LOGIC ("handle destroy " << ev);
+      if (!ev->IsCancelled ())
+        {
+          ev->Invoke ();
+        }
+    }
+}
+
+void
+ParallelSimulatorImpl::CreatePartitions (void)
+{
+  NS_LOG_FUNCTION (this << m_nPartitions << m_nThreads);
+  m_partitions.resize (m_nPartitions);
+  for (uint32_t i = 0; i < m_nPartitions; i++)
+    {
+      Partition &p = m_partitions[i];
+      p.m_events = m_schedulerFactory.Create<Scheduler> ();
+      p.m_id = i;
+      // uids are allocated from 4, as in the DefaultSimulatorImpl
+      p.m_uid = 4;
+      p.m_currentUid = 0;
+      p.m_currentTs = 0;
+      p.m_currentContext = Simulator::NO_CONTEXT;
+      p.m_eventCount = 0;
+      p.m_unscheduledEvents = 0;
+      p.m_outboxSeq = 0;
+      p.m_stopTs = NEVER;
+      p.m_stop = false;
+    }
+  m_pool = new WorkerPool (m_nThreads == 0 ? m_nPartitions : m_nThreads);
+}
+
+void
+ParallelSimulatorImpl::SetScheduler (ObjectFactory schedulerFactory)
+{
+  NS_LOG_FUNCTION (this << schedulerFactory);
+  NS_ASSERT_MSG (!m_running, "ParallelSimulatorImpl::SetScheduler(): called during a window");
+  m_schedulerFactory = schedulerFactory;
+  if (m_partitions.empty ())
+    {
+      CreatePartitions ();
+      return;
+    }
+  for (std::vector<Partition>::iterator p = m_partitions.begin (); p != m_partitions.end (); p++)
+    {
+      Ptr<Scheduler> scheduler = schedulerFactory.Create<Scheduler> ();
+      while (!p->m_events->IsEmpty ())
+        {
+          scheduler->Insert (p->m_events->RemoveNext ());
+        }
+      p->m_events = scheduler;
+    }
+}
+
+void
+ParallelSimulatorImpl::SetPartition (uint32_t context, uint32_t partition)
+{
+  NS_LOG_FUNCTION (this << context << partition);
+  NS_ASSERT_MSG (!m_running, "ParallelSimulatorImpl::SetPartition(): called during a window");
+  NS_ABORT_MSG_IF (partition >= m_nPartitions, "ParallelSimulatorImpl::SetPartition(): no partition " << partition);
+  NS_ABORT_MSG_IF (context == Simulator::NO_CONTEXT, "ParallelSimulatorImpl::SetPartition(): the events without context run in the partition 0");
+  if (context >= m_contextPartitions.size ())
+    {
+      m_contextPartitions.resize (context + 1, NO_PARTITION);
+    }
+  m_contextPartitions[context] = partition;
+}
+
+uint32_t
+ParallelSimulatorImpl::GetPartition (uint32_t context) const
+{
+  if (context == Simulator::NO_CONTEXT)
+    {
+      return 0;
+    }
+  if (context < m_contextPartitions.size () && m_contextPartitions[context] != NO_PARTITION)
+    {
+      return m_contextPartitions[context];
+    }
+  return context % m_nPartitions;
+}
+
+uint64_t
+ParallelSimulatorImpl::GetWindowCount (void) const
+{
+  return m_windowCount;
+}
+
+bool
+ParallelSimulatorImpl::IsRunningConcurrently (void)
+{
+  return g_concurrentPartitions;
+}
+
+// System ID for non-distributed simulation is always zero
+uint32_t
+ParallelSimulatorImpl::GetSystemId (void) const
+{
+  return 0;
+}
+
+ParallelSimulatorImpl::Partition *
+ParallelSimulatorImpl::GetCurrentPartition (void) const
+{
+  return static_cast<Partition *> (g_currentPartition);
+}
+
+Scheduler::Event
+ParallelSimulatorImpl::Insert (Partition *p, uint64_t ts, uint32_t context, EventImpl *event)
+{
+  Scheduler::Event ev;
+  ev.impl = event;
+  ev.key.m_ts = ts;
+  ev.key.m_context = context;
+  ev.key.m_uid = p->m_uid;
+  p->m_uid++;
+  p->m_unscheduledEvents++;
+  p->m_events->Insert (ev);
+  return ev;
+}
+
+bool
+ParallelSimulatorImpl::RemoteEventLess (const RemoteEvent &a, const RemoteEvent &b)
+{
+  if (a.m_ts != b.m_ts)
+    {
+      return a.m_ts < b.m_ts;
+    }
+  if (a.m_source != b.m_source)
+    {
+      return a.m_source < b.m_source;
+    }
+  return a.m_seq < b.m_seq;
+}
+
+void
+ParallelSimulatorImpl::DeliverOutboxes (void)
+{
+  std::vector<RemoteEvent> events;
+  for (std::vector<Partition>::iterator p = m_partitions.begin (); p != m_partitions.end (); p++)
+    {
+      events.insert (events.end (), p->m_outbox.begin (), p->m_outbox.end ());
+      p->m_outbox.clear ();
+    }
+  if (events.empty ())
+    {
+      return;
+    }
+  // the delivery order, hence the uids of the events, does not depend
+  // on the order in which the partitions were run
+  std::sort (events.begin (), events.end (), &ParallelSimulatorImpl::RemoteEventLess);
+  for (std::vector<RemoteEvent>::const_iterator i = events.begin (); i != events.end (); i++)
+    {
+      Insert (&m_partitions[GetPartition (i->m_context)], i->m_ts, i->m_context, i->m_event);
+    }
+}
+
+void
+ParallelSimulatorImpl::RunPartition (uint32_t i)
+{
+  Partition &p = m_partitions[i];
+  g_currentPartition = &p;
+  g_concurrentPartitions = m_nPartitions > 1;
+  while (!p.m_events->IsEmpty () && !p.m_stop)
+    {
+      // with a single partition, an event may stop it within the window
+      uint64_t ts = p.m_events->PeekNext ().key.m_ts;
+      if (ts >= m_windowEnd || ts >= p.m_stopTs)
+        {
+          break;
+        }
+      Scheduler::Event next = p.m_events->RemoveNext ();
+      NS_ASSERT (next.key.m_ts >= p.m_currentTs);
+      p.m_unscheduledEvents--;
+      p.m_currentTs = next.key.m_ts;
+      p.m_currentContext = next.key.m_context;
+      p.m_currentUid = next.key.m_uid;
+      p.m_eventCount++;
+      next.impl->Invoke ();
+      next.impl->Unref ();
+    }
+  g_currentPartition = 0;
+  g_concurrentPartitions = false;
+}
+
+bool
+ParallelSimulatorImpl::IsFinished (void) const
+{
+  if (m_stop)
+    {
+      return true;
+    }
+  for (std::vector<Partition>::const_iterator p = m_partitions.begin (); p != m_partitions.end (); p++)
+    {
+      if (!p->m_events->IsEmpty () || !p->m_outbox.empty ())
+        {
+          return false;
+        }
+    }
+  return true;
+}
+
+void
+ParallelSimulatorImpl::Run (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_stop = false;
+  Callback<void, uint32_t> runPartition = MakeCallback (&ParallelSimulatorImpl::RunPartition, this);
+  while (true)
+    {
+      DeliverOutboxes ();
+      for (std::vector<Partition>::iterator p = m_partitions.begin (); p != m_partitions.end (); p++)
+        {
+          m_stop = m_stop || p->m_stop;
+          m_stopTs = std::min (m_stopTs, p->m_stopTs);
+          p->m_stop = false;
+          p->m_stopTs = NEVER;
+        }
+      if (m_stop)
+        {
+          break;
+        }
+
+      uint64_t next = NEVER;
+      for (std::vector<Partition>::const_iterator p = m_partitions.begin (); p != m_partitions.end (); p++)
+        {
+          if (!p->m_events->IsEmpty ())
+            {
+              next = std::min (next, p->m_events->PeekNext ().key.m_ts);
+            }
+        }
+      if (next == NEVER)
+        {
+          break;
+        }
+      if (next >= m_stopTs)
+        {
+          m_currentTs = m_stopTs;
+          m_stopTs = NEVER;
+          m_stop = true;
+          break;
+        }
+
+      uint64_t lookahead = m_lookahead.GetTimeStep ();
+      m_windowEnd = next < NEVER - lookahead ? next + lookahead : NEVER;
+      m_windowEnd = std::min (m_windowEnd, m_stopTs);
+      m_running = true;
+      m_pool->Run (m_nPartitions, runPartition);
+      m_running = false;
+      m_windowCount++;
+
+      for (std::vector<Partition>::const_iterator p = m_partitions.begin (); p != m_partitions.end (); p++)
+        {
+          m_currentTs = std::max (m_currentTs, p->m_currentTs);
+        }
+    }
+
+  // If the simulator stopped naturally by lack of events, make a
+  // consistency test to check that we didn't lose any events along the way.
+  for (std::vector<Partition>::const_iterator p = m_partitions.begin (); p != m_partitions.end (); p++)
+    {
+      NS_ASSERT (m_stop || !p->m_events->IsEmpty () || p->m_unscheduledEvents == 0);
+    }
+}
+
+void
+ParallelSimulatorImpl::Stop (void)
+{
+  NS_LOG_FUNCTION (this);
+  Partition *p = GetCurrentPartition ();
+  if (p != 0)
+    {
+      if (m_nPartitions > 1)
+        {
+          NS_FATAL_ERROR ("ParallelSimulatorImpl::Stop(): the other partitions may have run events after " <<
+                          TimeStep (p->m_currentTs) << ": stop the simulation with a delay of at least the lookahead " <<
+                          m_lookahead);
+        }
+      p->m_stop = true;
+    }
+  else
+    {
+      m_stop = true;
+    }
+}
+
+void
+ParallelSimulatorImpl::Stop (Time const &delay)
+{
+  NS_LOG_FUNCTION (this << delay.GetTimeStep ());
+  NS_ASSERT_MSG (delay.IsPositive (), "ParallelSimulatorImpl::Stop(): Negative delay");
+  Partition *p = GetCurrentPartition ();
+  if (p != 0)
+    {
+      uint64_t ts = p->m_currentTs + delay.GetTimeStep ();
+      if (m_nPartitions > 1 && ts < m_windowEnd)
+        {
+          NS_FATAL_ERROR ("ParallelSimulatorImpl::Stop(): the other partitions may have run events after " <<
+                          TimeStep (ts) << ": the delay " << delay << " is shorter than the lookahead " <<
+                          m_lookahead);
+        }
+      p->m_stopTs = std::min (p->m_stopTs, ts);
+    }
+  else
+    {
+      m_stopTs = std::min (m_stopTs, m_currentTs + delay.GetTimeStep ());
+    }
+}
+
+//
+// Schedule an event for a _relative_ time in the future.
+//
+EventId
+ParallelSimulatorImpl::Schedule (Time const &delay, EventImpl *event)
+{
+  NS_ASSERT_MSG (delay.IsPositive (), "ParallelSimulatorImpl::Schedule(): Negative delay");
+  Partition *p = GetCurrentPartition ();
+  Scheduler::Event ev;
+  if (p != 0)
+    {
+      ev = Insert (p, p->m_currentTs + delay.GetTimeStep (), p->m_currentContext, event);
+    }
+  else
+    {
+      NS_ASSERT_MSG (!m_running, "Simulator::Schedule Thread-unsafe invocation!");
+      ev = Insert (&m_partitions[0], m_currentTs + delay.GetTimeStep (), Simulator::NO_CONTEXT, event);
+    }
+  return EventId (event, ev.key.m_ts, ev.key.m_context, ev.key.m_uid);
+}
+
+void
+ParallelSimulatorImpl::ScheduleWithContext (uint32_t context, Time const &delay, EventImpl *event)
+{
+  NS_ASSERT_MSG (delay.IsPositive (), "ParallelSimulatorImpl::ScheduleWithContext(): Negative delay");
+  uint32_t partition = GetPartition (context);
+  Partition *p = GetCurrentPartition ();
+  if (p == 0)
+    {
+      NS_ASSERT_MSG (!m_running, "Simulator::ScheduleWithContext Thread-unsafe invocation!");
+      Insert (&m_partitions[partition], m_currentTs + delay.GetTimeStep (), context, event);
+      return;
+    }
+  uint64_t ts = p->m_currentTs + delay.GetTimeStep ();
+  if (partition == p->m_id)
+    {
+      Insert (p, ts, context, event);
+      return;
+    }
+  if (ts < m_windowEnd)
+    {
+      NS_FATAL_ERROR ("ParallelSimulatorImpl::ScheduleWithContext(): the delay " << delay <<
+                      " from the context " << p->m_currentContext << " to the context " << context <<
+                      " in another partition is shorter than the lookahead " << m_lookahead);
+    }
+  RemoteEvent ev;
+  ev.m_ts = ts;
+  ev.m_context = context;
+  ev.m_source = p->m_id;
+  ev.m_seq = p->m_outboxSeq;
+  ev.m_event = event;
+  p->m_outboxSeq++;
+  p->m_outbox.push_back (ev);
+}
+
+EventId
+ParallelSimulatorImpl::ScheduleNow (EventImpl *event)
+{
+  return Schedule (TimeStep (0), event);
+}
+
+EventId
+ParallelSimulatorImpl::ScheduleDestroy (EventImpl *event)
+{
+  EventId id (Ptr<EventImpl> (event, false), Now ().GetTimeStep (), 0xffffffff, 2);
+  CriticalSection cs (m_destroyEventsMutex);
+  m_destroyEvents.push_back (id);
+  return id;
+}
+
+Time
+ParallelSimulatorImpl::Now (void) const
+{
+  // Do not add function logging here, to avoid stack overflow
+  Partition *p = GetCurrentPartition ();
+  return TimeStep (p != 0 ? p->m_currentTs : m_currentTs);
+}
+
+Time
+ParallelSimulatorImpl::GetDelayLeft (const EventId &id) const
+{
+  if (IsExpired (id))
+    {
+      return TimeStep (0);
+    }
+  else
+    {
+      return TimeStep (id.GetTs () - Now ().GetTimeStep ());
+    }
+}
+
+void
+ParallelSimulatorImpl::Remove (const EventId &id)
+{
+  if (id.GetUid () == 2)
+    {
+      // destroy events.
+      CriticalSection cs (m_destroyEventsMutex);
+      for (DestroyEvents::iterator i = m_destroyEvents.begin (); i != m_destroyEvents.end (); i++)
+        {
+          if (*i == id)
+            {
+              m_destroyEvents.erase (i);
+              break;
+            }
+        }
+      return;
+    }
+  if (IsExpired (id))
+    {
+      return;
+    }
+  Partition &p = m_partitions[GetPartition (id.GetContext ())];
+  Scheduler::Event event;
+  event.impl = id.PeekEventImpl ();
+  event.key.m_ts = id.GetTs ();
+  event.key.m_context = id.GetContext ();
+  event.key.m_uid = id.GetUid ();
+  p.m_events->Remove (event);
+  event.impl->Cancel ();
+  // whenever we remove an event from the event list, we have to unref it.
+  event.impl->Unref ();
+
+  p.m_unscheduledEvents--;
+}
+
+void
+ParallelSimulatorImpl::Cancel (const EventId &id)
+{
+  if (!IsExpired (id))
+    {
+      id.PeekEventImpl ()->Cancel ();
+    }
+}
+
+bool
+ParallelSimulatorImpl::IsExpired (const EventId &id) const
+{
+  if (id.GetUid () == 2)
+    {
+      if (id.PeekEventImpl () == 0 ||
+          id.PeekEventImpl ()->IsCancelled ())
+        {
+          return true;
+        }
+      // destroy events.
+      CriticalSection cs (m_destroyEventsMutex);
+      for (DestroyEvents::const_iterator i = m_destroyEvents.begin (); i != m_destroyEvents.end (); i++)
+        {
+          if (*i == id)
+            {
+              return false;
+            }
+        }
+      return true;
+    }
+  const Partition &p = m_partitions[GetPartition (id.GetContext ())];
+  NS_ASSERT_MSG (!m_running || GetCurrentPartition () == &p,
+                 "ParallelSimulatorImpl: access to an event of another partition");
+  if (id.PeekEventImpl () == 0 ||
+      id.GetTs () < p.m_currentTs ||
+      (id.GetTs () == p.m_currentTs &&
+       id.GetUid () <= p.m_currentUid) ||
+      id.PeekEventImpl ()->IsCancelled ())
+    {
+      return true;
+    }
+  else
+    {
+      return false;
+    }
+}
+
+Time
+ParallelSimulatorImpl::GetMaximumSimulationTime (void) const
+{
+  return TimeStep (0x7fffffffffffffffLL);
+}
+
+uint32_t
+ParallelSimulatorImpl::GetContext (void) const
+{
+  Partition *p = GetCurrentPartition ();
+  return p != 0 ? p->m_currentContext : Simulator::NO_CONTEXT;
+}
+
+uint64_t
+ParallelSimulatorImpl::GetEventCount (void) const
+{
+  uint64_t count = 0;
+  for (std::vector<Partition>::const_iterator p = m_partitions.begin (); p != m_partitions.end (); p++)
+    {
+      count += p->m_eventCount;
+    }
+  return count;
+}
+
+} // namespace ns3
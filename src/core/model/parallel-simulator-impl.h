@@ -0,0 +1,233 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef PARALLEL_SIMULATOR_IMPL_H
+#define PARALLEL_SIMULATOR_IMPL_H
+
+#include "simulator-impl.h"
+#include "scheduler.h"
+#include "event-impl.h"
+#include "object-factory.h"
+#include "nstime.h"
+#include "ptr.h"
+#include "system-mutex.h"
+
+#include <stdint.h>
+#include <list>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup simulator
+ * ns3::ParallelSimulatorImpl declaration.
+ */
+
+namespace ns3 {
+
+class WorkerPool;
+
+/**
+ * \ingroup simulator
+ *
+ * \brief A conservative shared-memory parallel simulator implementation.
+ *
+ * The events are partitioned by their context, i.e. by node: each
+ * partition has its own event queue and clock.  The simulation advances
+ * by windows: a window starts at the timestamp of the earliest pending
+ * event of all the partitions and lasts the Lookahead, and the
+ * partitions run the events of the window concurrently on a WorkerPool.
+ *
+ * An event may schedule an event in another partition, with
+ * Simulator::ScheduleWithContext, only after the end of the window:
+ * the delay must be at least the Lookahead, e.g. the 1 ms TTI of LTE
+ * between the transmission of a subframe and its reception.  Such an
+ * event is kept in the outbox of its source partition, and the outboxes
+ * are delivered to the partitions between two windows, sorted by
+ * timestamp, source partition and order of scheduling.  Hence, the
+ * simulation does not depend on the number of threads, only on the
+ * number and the composition of the partitions.  A shorter delay is a
+ * fatal error.
+ *
+ * The contexts are assigned to the partitions round robin, or as set by
+ * SetPartition; the events without context run in the partition 0.
+ * Simulator::Stop (delay) stops the simulation before the events at or
+ * after the given time.  Since the other partitions may already have run
+ * the events of the window after the caller, an event of a window shared
+ * by several partitions must stop the simulation at the end of the
+ * window or later, i.e. with a delay of at least the Lookahead:
+ * Simulator::Stop, or a shorter delay, is a fatal error.
+ *
+ * The models run by the partitions must only share state that is safe
+ * to access concurrently, e.g. a node must not call the methods of
+ * another node; the interactions go through the events between
+ * partitions.  Hence, the spectrum channels, which deliver the signals
+ * of a node to the others with the propagation delay, and the LTE
+ * models, whose UEs share batches of work, only run in a single
+ * partition: the V2X UEs abort when IsRunningConcurrently.
+ */
+class ParallelSimulatorImpl : public SimulatorImpl
+{
+public:
+  /**
+   *  Register this type.
+   *  \return The object TypeId.
+   */
+  static TypeId GetTypeId (void);
+
+  /** Constructor. */
+  ParallelSimulatorImpl ();
+  /** Destructor. */
+  ~ParallelSimulatorImpl ();
+
+  /**
+   * Set the partition of the events of a context.  It must be called
+   * before scheduling any event of the context.
+   *
+   * \param [in] context The context, e.g. a node id.
+   * \param [in] partition The partition, smaller than the Partitions
+   *             attribute.
+   */
+  void SetPartition (uint32_t context, uint32_t partition);
+  /**
+   * \param [in] context The context, e.g. a node id.
+   * \returns The partition running the events of the context.
+   */
+  uint32_t GetPartition (uint32_t context) const;
+  /**
+   * \returns The number of windows run.
+   */
+  uint64_t GetWindowCount (void) const;
+  /**
+   * \returns \c true if the calling thread runs an event of a window
+   *          shared by several partitions, i.e. concurrently with the
+   *          events of the other partitions.
+   */
+  static bool IsRunningConcurrently (void);
+
+  // Inherited
+  virtual void Destroy ();
+  virtual bool IsFinished (void) const;
+  virtual void Stop (void);
+  virtual void Stop (const Time &delay);
+  virtual EventId Schedule (const Time &delay, EventImpl *event);
+  virtual void ScheduleWithContext (uint32_t context, const Time &delay, EventImpl *event);
+  virtual EventId ScheduleNow (EventImpl *event);
+  virtual EventId ScheduleDestroy (EventImpl *event);
+  virtual void Remove (const EventId &id);
+  virtual void Cancel (const EventId &id);
+  virtual bool IsExpired (const EventId &id) const;
+  virtual void Run (void);
+  virtual Time Now (void) const;
+  virtual Time GetDelayLeft (const EventId &id) const;
+  virtual Time GetMaximumSimulationTime (void) const;
+  virtual void SetScheduler (ObjectFactory schedulerFactory);
+  virtual uint32_t GetSystemId (void) const;
+  virtual uint32_t GetContext (void) const;
+  virtual uint64_t GetEventCount (void) const;
+
+private:
+  virtual void DoDispose (void);
+
+  /** An event scheduled in another partition, delivered between two windows. */
+  struct RemoteEvent
+  {
+    uint64_t m_ts;        //!< the timestamp of the event
+    uint32_t m_context;   //!< the context of the event
+    uint32_t m_source;    //!< the partition which scheduled the event
+    uint64_t m_seq;       //!< the order of scheduling in the source partition
+    EventImpl *m_event;   //!< the event
+  };
+
+  /** The state of a partition. */
+  struct Partition
+  {
+    Ptr<Scheduler> m_events;          //!< the event queue
+    uint32_t m_id;                    //!< the index of the partition
+    uint32_t m_uid;                   //!< the next event uid
+    uint32_t m_currentUid;            //!< the uid of the current event
+    uint64_t m_currentTs;             //!< the timestamp of the current event
+    uint32_t m_currentContext;        //!< the context of the current event
+    uint64_t m_eventCount;            //!< the number of events run
+    int m_unscheduledEvents;          //!< the number of events in the queue
+    std::vector<RemoteEvent> m_outbox; //!< the events scheduled in other partitions
+    uint64_t m_outboxSeq;             //!< the next sequence number of the outbox
+    uint64_t m_stopTs;                //!< the stop time set by the events of the window
+    bool m_stop;                      //!< whether an event of the window called Stop
+  };
+
+  /**
+   * Compare two remote events by timestamp, source partition and order
+   * of scheduling.
+   * \param [in] a The first event.
+   * \param [in] b The second event.
+   * \returns \c true if \p a is delivered before \p b.
+   */
+  static bool RemoteEventLess (const RemoteEvent &a, const RemoteEvent &b);
+
+  /** Create the partitions, at the first use. */
+  void CreatePartitions (void);
+  /**
+   * \returns The partition running on the calling thread, or 0 outside
+   *          of a window.
+   */
+  Partition * GetCurrentPartition (void) const;
+  /**
+   * Insert an event in the queue of a partition.
+   * \param [in] p The partition.
+   * \param [in] ts The timestamp of the event.
+   * \param [in] context The context of the event.
+   * \param [in] event The event.
+   * \returns The scheduled event.
+   */
+  Scheduler::Event Insert (Partition *p, uint64_t ts, uint32_t context, EventImpl *event);
+  /** Deliver the outboxes of the partitions, between two windows. */
+  void DeliverOutboxes (void);
+  /**
+   * Run the events of a partition until the end of the window.
+   * \param [in] i The index of the partition.
+   */
+  void RunPartition (uint32_t i);
+
+  /** The partitions. */
+  std::vector<Partition> m_partitions;
+  /** The partitions set by SetPartition, by context. */
+  std::vector<uint32_t> m_contextPartitions;
+  /** The scheduler factory of the partitions. */
+  ObjectFactory m_schedulerFactory;
+  /** The threads running the partitions. */
+  WorkerPool *m_pool;
+
+  /** Container type for the events to run at Simulator::Destroy() */
+  typedef std::list<EventId> DestroyEvents;
+  /** The container of events to run at Destroy. */
+  DestroyEvents m_destroyEvents;
+  /** Mutex to control access to the list of events to run at Destroy. */
+  mutable SystemMutex m_destroyEventsMutex;
+
+  uint32_t m_nPartitions;   //!< the number of partitions
+  uint32_t m_nThreads;      //!< the number of threads
+  Time m_lookahead;         //!< the duration of a window
+  uint64_t m_windowEnd;     //!< the end of the current window
+  uint64_t m_stopTs;        //!< the time at which the simulation stops
+  bool m_stop;              //!< flag calling for the end of the simulation
+  bool m_running;           //!< whether the partitions are running a window
+  uint64_t m_currentTs;     //!< the time between two windows
+  uint64_t m_windowCount;   //!< the number of windows run
+};
+
+} // namespace ns3
+
+#endif /* PARALLEL_SIMULATOR_IMPL_H */
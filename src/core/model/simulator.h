@@ -184,6 +184,15 @@ public:
    */
   static uint32_t GetContext (void);
 
+  /**
+   * Get the number of events processed so far.
+   *
+   * @return The number of events removed from the event list and
+   *         processed since the simulator implementation was created,
+   *         including the canceled events.
+   */
+  static uint64_t GetEventCount (void);
+
   /**
    * Context enum values.
    *
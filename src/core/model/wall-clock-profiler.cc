@@ -0,0 +1,270 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "wall-clock-profiler.h"
+#include "assert.h"
+#include "log.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <mutex>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup system
+ * ns3::WallClockProfiler implementation.
+ */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("WallClockProfiler");
+
+namespace {
+
+/** The counters of a section in a thread. */
+struct Counters
+{
+  Counters ()
+    : depth (0),
+      calls (0),
+      time (std::chrono::steady_clock::duration::zero ())
+  {
+  }
+  uint32_t depth; //!< the number of active calls of the section
+  uint64_t calls; //!< the number of outermost calls of the section
+  std::chrono::steady_clock::duration time; //!< the time spent in the section
+};
+
+/**
+ * The counters of the sections in a thread, indexed by identifier. They
+ * are registered in the Registry while the thread runs, and merged into
+ * its counters of the ended threads when the thread ends.
+ */
+struct ThreadCounters
+{
+  ThreadCounters ();
+  ~ThreadCounters ();
+  std::vector<Counters> sections; //!< the counters of the sections
+};
+
+/** The sections and the counters of the threads. */
+struct Registry
+{
+  std::mutex mutex; //!< protects the registry
+  std::vector<std::string> names; //!< the names of the sections, indexed by identifier
+  std::vector<ThreadCounters *> threads; //!< the counters of the running threads
+  std::vector<Counters> ended; //!< the merged counters of the ended threads
+};
+
+/**
+ * \return the registry
+ */
+Registry &
+GetRegistry (void)
+{
+  static Registry registry;
+  return registry;
+}
+
+/**
+ * \return the counters of the calling thread
+ */
+ThreadCounters &
+GetThreadCounters (void)
+{
+  static thread_local ThreadCounters counters;
+  return counters;
+}
+
+ThreadCounters::ThreadCounters ()
+{
+  Registry &registry = GetRegistry ();
+  std::lock_guard<std::mutex> lock (registry.mutex);
+  registry.threads.push_back (this);
+}
+
+ThreadCounters::~ThreadCounters ()
+{
+  Registry &registry = GetRegistry ();
+  std::lock_guard<std::mutex> lock (registry.mutex);
+  registry.threads.erase (std::find (registry.threads.begin (), registry.threads.end (), this));
+  if (registry.ended.size () < sections.size ())
+    {
+      registry.ended.resize (sections.size ());
+    }
+  for (uint32_t id = 0; id < sections.size (); id++)
+    {
+      registry.ended[id].calls += sections[id].calls;
+      registry.ended[id].time += sections[id].time;
+    }
+}
+
+/**
+ * \param registry the locked registry
+ * \param id the identifier of a section
+ * \return the counters of the section merged over all the threads
+ */
+Counters
+MergeCounters (const Registry &registry, uint32_t id)
+{
+  Counters merged;
+  if (id < registry.ended.size ())
+    {
+      merged = registry.ended[id];
+    }
+  for (std::vector<ThreadCounters *>::const_iterator it = registry.threads.begin (); it != registry.threads.end (); it++)
+    {
+      if (id < (*it)->sections.size ())
+        {
+          merged.calls += (*it)->sections[id].calls;
+          merged.time += (*it)->sections[id].time;
+        }
+    }
+  return merged;
+}
+
+} // unnamed namespace
+
+bool WallClockProfiler::m_enabled = false;
+
+void
+WallClockProfiler::Enable (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  m_enabled = true;
+}
+
+void
+WallClockProfiler::Disable (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  m_enabled = false;
+}
+
+uint32_t
+WallClockProfiler::GetSectionId (const std::string &name)
+{
+  NS_LOG_FUNCTION (name);
+  Registry &registry = GetRegistry ();
+  std::lock_guard<std::mutex> lock (registry.mutex);
+  for (uint32_t id = 0; id < registry.names.size (); id++)
+    {
+      if (registry.names[id] == name)
+        {
+          return id;
+        }
+    }
+  registry.names.push_back (name);
+  return registry.names.size () - 1;
+}
+
+uint32_t
+WallClockProfiler::GetNSections (void)
+{
+  Registry &registry = GetRegistry ();
+  std::lock_guard<std::mutex> lock (registry.mutex);
+  return registry.names.size ();
+}
+
+std::string
+WallClockProfiler::GetSectionName (uint32_t id)
+{
+  Registry &registry = GetRegistry ();
+  std::lock_guard<std::mutex> lock (registry.mutex);
+  NS_ASSERT (id < registry.names.size ());
+  return registry.names[id];
+}
+
+double
+WallClockProfiler::GetSeconds (uint32_t id)
+{
+  Registry &registry = GetRegistry ();
+  std::lock_guard<std::mutex> lock (registry.mutex);
+  NS_ASSERT (id < registry.names.size ());
+  return std::chrono::duration<double> (MergeCounters (registry, id).time).count ();
+}
+
+uint64_t
+WallClockProfiler::GetCalls (uint32_t id)
+{
+  Registry &registry = GetRegistry ();
+  std::lock_guard<std::mutex> lock (registry.mutex);
+  NS_ASSERT (id < registry.names.size ());
+  return MergeCounters (registry, id).calls;
+}
+
+void
+WallClockProfiler::Reset (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  Registry &registry = GetRegistry ();
+  std::lock_guard<std::mutex> lock (registry.mutex);
+  registry.ended.clear ();
+  for (std::vector<ThreadCounters *>::iterator thread = registry.threads.begin (); thread != registry.threads.end (); thread++)
+    {
+      std::vector<Counters> &sections = (*thread)->sections;
+      for (std::vector<Counters>::iterator it = sections.begin (); it != sections.end (); it++)
+        {
+          it->calls = 0;
+          it->time = std::chrono::steady_clock::duration::zero ();
+        }
+    }
+}
+
+void
+WallClockProfiler::Print (std::ostream &os, double totalSeconds)
+{
+  for (uint32_t id = 0; id < GetNSections (); id++)
+    {
+      double seconds = GetSeconds (id);
+      os << std::left << std::setw (40) << GetSectionName (id) << std::right
+         << " calls " << std::setw (12) << GetCalls (id)
+         << " time " << std::setw (10) << seconds << " s";
+      if (totalSeconds > 0)
+        {
+          os << " share " << std::setw (8) << 100 * seconds / totalSeconds << " %";
+        }
+      os << std::endl;
+    }
+}
+
+bool
+WallClockProfiler::Enter (uint32_t id)
+{
+  std::vector<Counters> &sections = GetThreadCounters ().sections;
+  if (id >= sections.size ())
+    {
+      sections.resize (id + 1);
+    }
+  return sections[id].depth++ == 0;
+}
+
+void
+WallClockProfiler::Leave (uint32_t id, std::chrono::steady_clock::time_point start)
+{
+  std::vector<Counters> &sections = GetThreadCounters ().sections;
+  NS_ASSERT (id < sections.size ());
+  Counters &section = sections[id];
+  NS_ASSERT (section.depth > 0);
+  if (--section.depth == 0)
+    {
+      section.time += std::chrono::steady_clock::now () - start;
+      section.calls++;
+    }
+}
+
+} // namespace ns3
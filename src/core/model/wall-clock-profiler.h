@@ -0,0 +1,171 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef WALL_CLOCK_PROFILER_H
+#define WALL_CLOCK_PROFILER_H
+
+/**
+ * \file
+ * \ingroup system
+ * ns3::WallClockProfiler declaration.
+ */
+
+#include <stdint.h>
+#include <chrono>
+#include <ostream>
+#include <string>
+
+namespace ns3 {
+
+/**
+ * \ingroup system
+ *
+ * \brief Accumulate the wall clock time spent in named code sections.
+ *
+ * A section is a scope marked with NS_PROFILE_SCOPE.  When the profiler
+ * is enabled, the time spent in the outermost activation of each
+ * section and its number of calls are accumulated, so that recursive
+ * or chained calls of a section are counted once.  The sections are
+ * inclusive: the time of a section includes the time of the sections
+ * it calls.  When the profiler is disabled (the default), a section
+ * costs a test of a flag.
+ *
+ * Each thread accumulates the time of the sections it runs in its own
+ * counters, e.g., the threads of the WorkerPool or of a parallel
+ * simulator; the counters of all the threads are merged when they are
+ * read.  The counters must be read or reset while no other thread runs
+ * a section, e.g., before or after Simulator::Run.
+ */
+class WallClockProfiler
+{
+public:
+  /** Start accumulating the time spent in the sections. */
+  static void Enable (void);
+  /** Stop accumulating the time spent in the sections. */
+  static void Disable (void);
+  /**
+   * \return true if the profiler is enabled
+   */
+  static bool IsEnabled (void)
+  {
+    return m_enabled;
+  }
+  /**
+   * Get the identifier of a section, creating the section if needed.
+   * \param name the name of the section
+   * \return the identifier of the section
+   */
+  static uint32_t GetSectionId (const std::string &name);
+  /**
+   * \return the number of sections
+   */
+  static uint32_t GetNSections (void);
+  /**
+   * \param id the identifier of a section
+   * \return the name of the section
+   */
+  static std::string GetSectionName (uint32_t id);
+  /**
+   * \param id the identifier of a section
+   * \return the wall clock time spent in the section, in seconds
+   */
+  static double GetSeconds (uint32_t id);
+  /**
+   * \param id the identifier of a section
+   * \return the number of calls of the section
+   */
+  static uint64_t GetCalls (uint32_t id);
+  /** Reset the time and calls accumulated by all the sections. */
+  static void Reset (void);
+  /**
+   * Print the calls, the time and the share of time of each section.
+   * \param os the output stream
+   * \param totalSeconds the wall clock time the shares are relative to
+   */
+  static void Print (std::ostream &os, double totalSeconds);
+
+  /**
+   * Enter a section.
+   * \param id the identifier of the section
+   * \return true if this is the outermost activation of the section
+   */
+  static bool Enter (uint32_t id);
+  /**
+   * Leave a section entered by Enter.
+   * \param id the identifier of the section
+   * \param start the time the outermost activation of the section
+   *        was entered
+   */
+  static void Leave (uint32_t id, std::chrono::steady_clock::time_point start);
+
+private:
+  static bool m_enabled; //!< whether the profiler is enabled
+};
+
+/**
+ * \ingroup system
+ *
+ * \brief Account the lifetime of this object to a section of the
+ * WallClockProfiler.
+ */
+class WallClockProfilerScope
+{
+public:
+  /**
+   * Enter a section.
+   * \param id the identifier of the section
+   */
+  WallClockProfilerScope (uint32_t id)
+    : m_id (id),
+      m_entered (false)
+  {
+    if (WallClockProfiler::IsEnabled ())
+      {
+        m_entered = true;
+        if (WallClockProfiler::Enter (id))
+          {
+            m_start = std::chrono::steady_clock::now ();
+          }
+      }
+  }
+  /** Leave the section. */
+  ~WallClockProfilerScope ()
+  {
+    if (m_entered)
+      {
+        WallClockProfiler::Leave (m_id, m_start);
+      }
+  }
+
+private:
+  uint32_t m_id; //!< the identifier of the section
+  bool m_entered; //!< whether the section was entered
+  std::chrono::steady_clock::time_point m_start; //!< the time the section was entered
+};
+
+} // namespace ns3
+
+/**
+ * \ingroup system
+ * Account the rest of the enclosing scope to the WallClockProfiler
+ * section named \p name.
+ * \param name the name of the section
+ */
+#define NS_PROFILE_SCOPE(name)                                          \
+  static const uint32_t NS_PROFILE_SCOPE_ID_ = ns3::WallClockProfiler::GetSectionId (name); \
+  ns3::WallClockProfilerScope NS_PROFILE_SCOPE_ (NS_PROFILE_SCOPE_ID_)
+
+#endif /* WALL_CLOCK_PROFILER_H */
@@ -0,0 +1,188 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "worker-pool.h"
+#include "global-value.h"
+#include "uinteger.h"
+#include "log.h"
+
+/**
+ * \file
+ * \ingroup thread
+ * ns3::WorkerPool implementation.
+ */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("WorkerPool");
+
+/**
+ * \ingroup thread
+ * The number of threads of the pool shared by the models.
+ */
+static GlobalValue g_workerPoolSize = GlobalValue
+  ("WorkerPoolSize",
+   "The number of threads running the parallel stages of the models, "
+   "including the simulation thread (0 or 1 runs them sequentially)",
+   UintegerValue (0),
+   MakeUintegerChecker<uint32_t> ());
+
+WorkerPool::WorkerPool (uint32_t nThreads)
+  : m_nThreads (nThreads > 1 ? nThreads : 1)
+{
+  NS_LOG_FUNCTION (this << nThreads);
+#ifdef HAVE_PTHREAD_H
+  m_nJobs = 0;
+  m_next = 0;
+  m_pending = 0;
+  m_batch = 0;
+  m_busy = false;
+  m_stop = false;
+  for (uint32_t i = 1; i < m_nThreads; i++)
+    {
+      m_threads.push_back (std::thread (&WorkerPool::DoWork, this));
+    }
+#else
+  m_nThreads = 1;
+#endif /* HAVE_PTHREAD_H */
+}
+
+WorkerPool::~WorkerPool ()
+{
+  NS_LOG_FUNCTION (this);
+#ifdef HAVE_PTHREAD_H
+  {
+    std::unique_lock<std::mutex> lock (m_mutex);
+    m_stop = true;
+  }
+  m_start.notify_all ();
+  for (std::vector<std::thread>::iterator it = m_threads.begin (); it != m_threads.end (); it++)
+    {
+      it->join ();
+    }
+#endif /* HAVE_PTHREAD_H */
+}
+
+/**
+ * \ingroup thread
+ * \return the size of the pool shared by the models
+ */
+static uint32_t
+GetWorkerPoolSize (void)
+{
+  UintegerValue size;
+  g_workerPoolSize.GetValue (size);
+  return size.Get ();
+}
+
+WorkerPool *
+WorkerPool::Get (void)
+{
+  static WorkerPool shared (GetWorkerPoolSize ());
+  return &shared;
+}
+
+uint32_t
+WorkerPool::GetNThreads (void) const
+{
+  return m_nThreads;
+}
+
+void
+WorkerPool::Run (uint32_t nJobs, Callback<void, uint32_t> job)
+{
+  NS_LOG_FUNCTION (this << nJobs);
+#ifdef HAVE_PTHREAD_H
+  if (!m_threads.empty () && nJobs > 1)
+    {
+      std::unique_lock<std::mutex> lock (m_mutex);
+      if (!m_busy)
+        {
+          m_busy = true;
+          m_job = job;
+          m_nJobs = nJobs;
+          m_next = 0;
+          m_pending = nJobs;
+          m_batch++;
+          lock.unlock ();
+          m_start.notify_all ();
+          DoJobs ();
+          lock.lock ();
+          while (m_pending > 0)
+            {
+              m_done.wait (lock);
+            }
+          m_job = Callback<void, uint32_t> ();
+          m_busy = false;
+          return;
+        }
+      // another batch is running, possibly the one of the calling job
+    }
+#endif /* HAVE_PTHREAD_H */
+  for (uint32_t i = 0; i < nJobs; i++)
+    {
+      job (i);
+    }
+}
+
+#ifdef HAVE_PTHREAD_H
+void
+WorkerPool::DoWork (void)
+{
+  uint64_t batch = 0;
+  while (true)
+    {
+      {
+        std::unique_lock<std::mutex> lock (m_mutex);
+        while (!m_stop && m_batch == batch)
+          {
+            m_start.wait (lock);
+          }
+        if (m_stop)
+          {
+            return;
+          }
+        batch = m_batch;
+      }
+      DoJobs ();
+    }
+}
+
+void
+WorkerPool::DoJobs (void)
+{
+  while (true)
+    {
+      uint32_t i;
+      {
+        std::unique_lock<std::mutex> lock (m_mutex);
+        if (m_next >= m_nJobs)
+          {
+            return;
+          }
+        i = m_next++;
+      }
+      m_job (i);
+      std::unique_lock<std::mutex> lock (m_mutex);
+      if (--m_pending == 0)
+        {
+          m_done.notify_all ();
+        }
+    }
+}
+#endif /* HAVE_PTHREAD_H */
+
+} // namespace ns3
@@ -0,0 +1,113 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef WORKER_POOL_H
+#define WORKER_POOL_H
+
+#include "ns3/core-config.h"
+#include "callback.h"
+#include <stdint.h>
+#include <vector>
+#ifdef HAVE_PTHREAD_H
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#endif /* HAVE_PTHREAD_H */
+
+/**
+ * \file
+ * \ingroup thread
+ * ns3::WorkerPool declaration.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup thread
+ *
+ * \brief A pool of threads running batches of independent jobs.
+ *
+ * Run executes a batch of jobs, identified by their index, and returns
+ * when all of them are done; the calling thread takes jobs as well.
+ * The jobs of a batch must not depend on each other nor call the
+ * simulator: a model uses the pool to evaluate, in parallel, work that
+ * only reads shared state and writes its own results, and then consumes
+ * the results in the order of the sequential simulation.
+ *
+ * The pool shared by the models is returned by Get and its size is set
+ * by the global value WorkerPoolSize.  Without POSIX threads, or with a
+ * size of 0 or 1, the jobs are run in sequence by the calling thread.
+ * So are the jobs of a batch started by a job, or by another thread
+ * while a batch is running, e.g. by the partitions of a
+ * ParallelSimulatorImpl sharing the pool of the models.
+ */
+class WorkerPool
+{
+public:
+  /**
+   * Create a pool.
+   * \param nThreads the number of threads running the jobs, including
+   *        the thread calling Run
+   */
+  WorkerPool (uint32_t nThreads);
+  /** Stop and join the threads of the pool. */
+  ~WorkerPool ();
+
+  /**
+   * Get the pool shared by the models, created at the first call with
+   * the size given by the global value WorkerPoolSize.
+   * \return the shared pool
+   */
+  static WorkerPool * Get (void);
+
+  /**
+   * \return the number of threads running the jobs, including the
+   *         thread calling Run
+   */
+  uint32_t GetNThreads (void) const;
+
+  /**
+   * Run a batch of jobs and wait for their completion.
+   * \param nJobs the number of jobs
+   * \param job the job, called once with each index in [0, nJobs)
+   */
+  void Run (uint32_t nJobs, Callback<void, uint32_t> job);
+
+private:
+#ifdef HAVE_PTHREAD_H
+  /** Loop of a thread of the pool. */
+  void DoWork (void);
+  /** Take and run jobs of the current batch until none is left. */
+  void DoJobs (void);
+
+  std::vector<std::thread> m_threads;  //!< the threads of the pool
+  std::mutex m_mutex;                  //!< protects the state of the batch
+  std::condition_variable m_start;     //!< signals a new batch or the end of the pool
+  std::condition_variable m_done;      //!< signals the completion of a batch
+  Callback<void, uint32_t> m_job;      //!< the job of the current batch
+  uint32_t m_nJobs;                    //!< the number of jobs of the current batch
+  uint32_t m_next;                     //!< the index of the next job to take
+  uint32_t m_pending;                  //!< the number of jobs not completed
+  uint64_t m_batch;                    //!< the number of batches started
+  bool m_busy;                         //!< whether a batch is running
+  bool m_stop;                         //!< whether the pool is being destroyed
+#endif /* HAVE_PTHREAD_H */
+  uint32_t m_nThreads;                 //!< the number of threads running the jobs
+};
+
+} // namespace ns3
+
+#endif /* WORKER_POOL_H */
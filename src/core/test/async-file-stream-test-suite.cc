@@ -0,0 +1,216 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/async-file-stream.h"
+#include "ns3/config.h"
+#include "ns3/boolean.h"
+#include "ns3/fatal-impl.h"
+
+#include <fstream>
+#include <sstream>
+
+using namespace ns3;
+
+/**
+ * \ingroup core-tests
+ *
+ * Check that the records written to an AsyncFileStreamBuf reach the
+ * file in order, when its ring of chunks is full and on Flush.
+ */
+class AsyncFileStreamBufTestCase : public TestCase
+{
+public:
+  /**
+   * Constructor
+   * \param chunkSize the size in bytes of a chunk
+   * \param nChunks the number of chunks
+   */
+  AsyncFileStreamBufTestCase (uint32_t chunkSize, uint32_t nChunks);
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Build the name of the test case
+   * \param chunkSize the size in bytes of a chunk
+   * \param nChunks the number of chunks
+   * \return the name of the test case
+   */
+  static std::string BuildNameString (uint32_t chunkSize, uint32_t nChunks);
+  /**
+   * \param filename the name of a file
+   * \return the content of the file
+   */
+  static std::string ReadFile (std::string filename);
+
+  uint32_t m_chunkSize; //!< the size in bytes of a chunk
+  uint32_t m_nChunks; //!< the number of chunks
+};
+
+AsyncFileStreamBufTestCase::AsyncFileStreamBufTestCase (uint32_t chunkSize, uint32_t nChunks)
+  : TestCase (BuildNameString (chunkSize, nChunks)),
+    m_chunkSize (chunkSize),
+    m_nChunks (nChunks)
+{
+}
+
+std::string
+AsyncFileStreamBufTestCase::BuildNameString (uint32_t chunkSize, uint32_t nChunks)
+{
+  std::ostringstream oss;
+  oss << "Async file stream with " << nChunks << " chunks of " << chunkSize << " bytes";
+  return oss.str ();
+}
+
+std::string
+AsyncFileStreamBufTestCase::ReadFile (std::string filename)
+{
+  std::ifstream in (filename.c_str ());
+  std::ostringstream content;
+  content << in.rdbuf ();
+  return content.str ();
+}
+
+void
+AsyncFileStreamBufTestCase::DoRun (void)
+{
+  std::string filename = CreateTempDirFilename ("async.txt");
+  AsyncFileStreamBuf buf;
+  NS_TEST_ASSERT_MSG_NE (buf.Open (filename, std::ios::out, m_chunkSize, m_nChunks), 0, "can't open " << filename);
+  std::ostream os (&buf);
+  std::ostringstream expected;
+  for (uint32_t i = 0; i < 5000; i++)
+    {
+      os << i << ";" << 0.5 * i << std::endl;
+      expected << i << ";" << 0.5 * i << std::endl;
+    }
+  NS_TEST_ASSERT_MSG_EQ (buf.Flush (), true, "flush failed");
+  NS_TEST_ASSERT_MSG_EQ (ReadFile (filename), expected.str (), "records missing after a flush");
+
+  os << "last record" << std::endl;
+  expected << "last record" << std::endl;
+  NS_TEST_ASSERT_MSG_NE (buf.Close (), 0, "close failed");
+  NS_TEST_ASSERT_MSG_EQ (buf.IsOpen (), false, "file still open");
+  NS_TEST_ASSERT_MSG_EQ (ReadFile (filename), expected.str (), "records missing after closing the file");
+}
+
+/**
+ * \ingroup core-tests
+ *
+ * Check the streams created by AsyncFileStream::Create with the global
+ * value AsyncFileStreamsEnabled, and the failure to open a file.
+ */
+class AsyncFileStreamCreateTestCase : public TestCase
+{
+public:
+  AsyncFileStreamCreateTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+AsyncFileStreamCreateTestCase::AsyncFileStreamCreateTestCase ()
+  : TestCase ("Create async file streams")
+{
+}
+
+void
+AsyncFileStreamCreateTestCase::DoRun (void)
+{
+  std::string filename = CreateTempDirFilename ("create.txt");
+  std::ostream *os = AsyncFileStream::Create (filename, std::ios::out);
+  NS_TEST_ASSERT_MSG_EQ ((dynamic_cast<std::ofstream *> (os) != 0), true, "not a std::ofstream by default");
+  delete os;
+
+  Config::SetGlobal ("AsyncFileStreamsEnabled", BooleanValue (true));
+  os = AsyncFileStream::Create (filename, std::ios::out);
+  AsyncFileStream *async = dynamic_cast<AsyncFileStream *> (os);
+  NS_TEST_ASSERT_MSG_NE (async, 0, "not an AsyncFileStream when enabled");
+  NS_TEST_ASSERT_MSG_EQ (async->is_open (), true, "file not open");
+  *os << "record" << std::endl;
+  delete os;
+  std::ifstream in (filename.c_str ());
+  std::string line;
+  std::getline (in, line);
+  NS_TEST_ASSERT_MSG_EQ (line, "record", "record not written when the stream is deleted");
+
+  os = AsyncFileStream::Create (CreateTempDirFilename ("missing/create.txt"), std::ios::out);
+  NS_TEST_ASSERT_MSG_EQ (os->fail (), true, "file in a missing directory opened");
+  delete os;
+  Config::SetGlobal ("AsyncFileStreamsEnabled", BooleanValue (false));
+}
+
+/**
+ * \ingroup core-tests
+ *
+ * Check that FatalImpl::FlushStreams writes the records of a
+ * registered AsyncFileStream, as on a fatal error.
+ */
+class AsyncFileStreamFatalTestCase : public TestCase
+{
+public:
+  AsyncFileStreamFatalTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+AsyncFileStreamFatalTestCase::AsyncFileStreamFatalTestCase ()
+  : TestCase ("Flush async file streams on a fatal error")
+{
+}
+
+void
+AsyncFileStreamFatalTestCase::DoRun (void)
+{
+  std::string filename = CreateTempDirFilename ("fatal.txt");
+  AsyncFileStream os (filename, std::ios::out);
+  NS_TEST_ASSERT_MSG_EQ (os.is_open (), true, "can't open " << filename);
+  FatalImpl::RegisterStream (&os);
+  os << "record" << std::endl;
+  FatalImpl::FlushStreams ();
+  FatalImpl::UnregisterStream (&os);
+
+  std::ifstream in (filename.c_str ());
+  std::string line;
+  std::getline (in, line);
+  NS_TEST_ASSERT_MSG_EQ (line, "record", "record not written by FatalImpl::FlushStreams");
+  os.close ();
+}
+
+/**
+ * \ingroup core-tests
+ *
+ * AsyncFileStream test suite
+ */
+class AsyncFileStreamTestSuite : public TestSuite
+{
+public:
+  AsyncFileStreamTestSuite ();
+};
+
+AsyncFileStreamTestSuite::AsyncFileStreamTestSuite ()
+  : TestSuite ("async-file-stream", UNIT)
+{
+  AddTestCase (new AsyncFileStreamBufTestCase (1 << 16, 16), TestCase::QUICK);
+  AddTestCase (new AsyncFileStreamBufTestCase (64, 2), TestCase::QUICK);
+  AddTestCase (new AsyncFileStreamBufTestCase (7, 1), TestCase::QUICK);
+  AddTestCase (new AsyncFileStreamCreateTestCase, TestCase::QUICK);
+  AddTestCase (new AsyncFileStreamFatalTestCase, TestCase::QUICK);
+}
+
+static AsyncFileStreamTestSuite g_asyncFileStreamTestSuite;
@@ -0,0 +1,324 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/default-simulator-impl.h"
+#include "ns3/parallel-simulator-impl.h"
+#include "ns3/object-factory.h"
+#include "ns3/uinteger.h"
+
+#include <algorithm>
+#include <sstream>
+#include <utility>
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * \ingroup core-tests
+ *
+ * Check that the nodes exchanging events through a ParallelSimulatorImpl
+ * receive the same events as with the DefaultSimulatorImpl, in the same
+ * order whatever the number of threads.
+ *
+ * Every millisecond, each node sends a message to another node, one
+ * TTI later, and schedules a local event within the TTI.
+ */
+class ParallelSimulatorTestCase : public TestCase
+{
+public:
+  /**
+   * Constructor
+   * \param nThreads the number of threads of the simulator
+   */
+  ParallelSimulatorTestCase (uint32_t nThreads);
+
+private:
+  virtual void DoRun (void);
+
+  /** A received message: the reception time and the value. */
+  typedef std::pair<uint64_t, uint32_t> Message;
+  /** The messages received by each node. */
+  typedef std::vector<std::vector<Message> > Log;
+
+  /**
+   * Run the scenario.
+   * \param impl the simulator implementation
+   * \param [out] log the messages received by each node
+   */
+  void RunScenario (Ptr<SimulatorImpl> impl, Log &log);
+  /**
+   * Send the messages of a node for the current TTI.
+   * \param node the node
+   * \param round the index of the TTI
+   */
+  void Tick (uint32_t node, uint32_t round);
+  /**
+   * A local event of a node.
+   * \param node the node
+   * \param value the value of the event
+   */
+  void Local (uint32_t node, uint32_t value);
+  /**
+   * Receive a message.
+   * \param node the receiving node
+   * \param value the value of the message
+   */
+  void Receive (uint32_t node, uint32_t value);
+
+  uint32_t m_nThreads; //!< the number of threads of the simulator
+  Log *m_log; //!< the messages received by each node in the current run
+  std::vector<uint32_t> m_local; //!< the local state of each node
+};
+
+/** The number of nodes. */
+static const uint32_t N_NODES = 16;
+/** The number of TTIs during which the nodes send messages. */
+static const uint32_t N_ROUNDS = 20;
+
+ParallelSimulatorTestCase::ParallelSimulatorTestCase (uint32_t nThreads)
+  : TestCase ("Parallel simulator with " + std::to_string (nThreads) + " threads"),
+    m_nThreads (nThreads),
+    m_log (0)
+{
+}
+
+void
+ParallelSimulatorTestCase::Tick (uint32_t node, uint32_t round)
+{
+  NS_ASSERT (Simulator::GetContext () == node);
+  uint32_t dest = (node * 7 + round) % N_NODES;
+  uint32_t value = node * 1000 + round + m_local[node];
+  Simulator::ScheduleWithContext (dest, MilliSeconds (1), &ParallelSimulatorTestCase::Receive, this, dest, value);
+  Simulator::Schedule (MicroSeconds ((node * 31 + round * 17) % 1000), &ParallelSimulatorTestCase::Local, this, node, round);
+  if (round + 1 < N_ROUNDS)
+    {
+      Simulator::Schedule (MilliSeconds (1), &ParallelSimulatorTestCase::Tick, this, node, round + 1);
+    }
+}
+
+void
+ParallelSimulatorTestCase::Local (uint32_t node, uint32_t value)
+{
+  m_local[node] = m_local[node] * 3 + value;
+}
+
+void
+ParallelSimulatorTestCase::Receive (uint32_t node, uint32_t value)
+{
+  NS_ASSERT (Simulator::GetContext () == node);
+  (*m_log)[node].push_back (std::make_pair (Simulator::Now ().GetTimeStep (), value));
+}
+
+void
+ParallelSimulatorTestCase::RunScenario (Ptr<SimulatorImpl> impl, Log &log)
+{
+  Simulator::SetImplementation (impl);
+  log.assign (N_NODES, std::vector<Message> ());
+  m_log = &log;
+  m_local.assign (N_NODES, 0);
+  for (uint32_t node = 0; node < N_NODES; node++)
+    {
+      Simulator::ScheduleWithContext (node, MilliSeconds (0), &ParallelSimulatorTestCase::Tick, this, node, 0);
+    }
+  Simulator::Run ();
+  Simulator::Destroy ();
+}
+
+void
+ParallelSimulatorTestCase::DoRun (void)
+{
+  Log sequential;
+  RunScenario (CreateObject<DefaultSimulatorImpl> (), sequential);
+
+  ObjectFactory factory ("ns3::ParallelSimulatorImpl");
+  factory.Set ("Partitions", UintegerValue (4));
+  factory.Set ("Threads", UintegerValue (m_nThreads));
+
+  Log parallel;
+  RunScenario (factory.Create<SimulatorImpl> (), parallel);
+  Log again;
+  RunScenario (factory.Create<SimulatorImpl> (), again);
+
+  for (uint32_t node = 0; node < N_NODES; node++)
+    {
+      NS_TEST_ASSERT_MSG_EQ ((parallel[node] == again[node]), true, "the messages of node " << node << " differ between two runs");
+      // the messages received at the same time may be ordered differently
+      std::sort (sequential[node].begin (), sequential[node].end ());
+      std::sort (parallel[node].begin (), parallel[node].end ());
+      NS_TEST_ASSERT_MSG_EQ ((parallel[node] == sequential[node]), true, "the messages of node " << node << " differ from the sequential run");
+    }
+}
+
+/**
+ * \ingroup core-tests
+ *
+ * Check that Simulator::Stop (delay) stops a ParallelSimulatorImpl
+ * before the events at the stop time.
+ */
+class ParallelSimulatorStopTestCase : public TestCase
+{
+public:
+  ParallelSimulatorStopTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Count an event and schedule the next one in another partition.
+   * \param node the node of the event
+   */
+  void Ping (uint32_t node);
+
+  uint32_t m_count; //!< the number of events run
+};
+
+ParallelSimulatorStopTestCase::ParallelSimulatorStopTestCase ()
+  : TestCase ("Stop a parallel simulator")
+{
+}
+
+void
+ParallelSimulatorStopTestCase::Ping (uint32_t node)
+{
+  m_count++;
+  Simulator::ScheduleWithContext (node + 1, MilliSeconds (1), &ParallelSimulatorStopTestCase::Ping, this, node + 1);
+}
+
+void
+ParallelSimulatorStopTestCase::DoRun (void)
+{
+  ObjectFactory factory ("ns3::ParallelSimulatorImpl");
+  factory.Set ("Partitions", UintegerValue (2));
+  factory.Set ("Threads", UintegerValue (2));
+  Ptr<ParallelSimulatorImpl> impl = factory.Create<ParallelSimulatorImpl> ();
+  Simulator::SetImplementation (impl);
+
+  m_count = 0;
+  Simulator::ScheduleWithContext (0, MilliSeconds (0), &ParallelSimulatorStopTestCase::Ping, this, 0);
+  Simulator::Stop (MilliSeconds (10));
+  Simulator::Run ();
+  NS_TEST_ASSERT_MSG_EQ (m_count, 10, "wrong number of events before the stop time");
+  NS_TEST_ASSERT_MSG_EQ (Simulator::Now (), MilliSeconds (10), "wrong time after the stop");
+  NS_TEST_ASSERT_MSG_EQ (impl->GetWindowCount (), 10, "wrong number of windows");
+  NS_TEST_ASSERT_MSG_EQ (Simulator::IsFinished (), true, "the simulator is not stopped");
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup core-tests
+ *
+ * Check that the events of a single partition stop the simulation
+ * within a window, as with the DefaultSimulatorImpl.
+ */
+class ParallelSimulatorStopInWindowTestCase : public TestCase
+{
+public:
+  ParallelSimulatorStopInWindowTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Count an event, stop the simulation at the stop event, and schedule
+   * the next event.
+   * \param delay the delay of the stop, negative for Simulator::Stop ()
+   */
+  void Tick (Time delay);
+  /**
+   * Run a simulation stopped by the event at 3 ms.
+   * \param impl the simulator implementation
+   * \param delay the delay of the stop, negative for Simulator::Stop ()
+   */
+  void RunTicks (Ptr<SimulatorImpl> impl, Time delay);
+
+  uint32_t m_count; //!< the number of events run
+  Time m_end; //!< the time after the stop
+};
+
+ParallelSimulatorStopInWindowTestCase::ParallelSimulatorStopInWindowTestCase ()
+  : TestCase ("Stop a single partition within a window")
+{
+}
+
+void
+ParallelSimulatorStopInWindowTestCase::Tick (Time delay)
+{
+  m_count++;
+  if (Simulator::Now () == MilliSeconds (3))
+    {
+      if (delay.IsNegative ())
+        {
+          Simulator::Stop ();
+        }
+      else
+        {
+          Simulator::Stop (delay);
+        }
+    }
+  Simulator::Schedule (MilliSeconds (1), &ParallelSimulatorStopInWindowTestCase::Tick, this, delay);
+}
+
+void
+ParallelSimulatorStopInWindowTestCase::RunTicks (Ptr<SimulatorImpl> impl, Time delay)
+{
+  Simulator::SetImplementation (impl);
+  m_count = 0;
+  Simulator::ScheduleWithContext (0, MilliSeconds (0), &ParallelSimulatorStopInWindowTestCase::Tick, this, delay);
+  Simulator::Run ();
+  m_end = Simulator::Now ();
+  Simulator::Destroy ();
+}
+
+void
+ParallelSimulatorStopInWindowTestCase::DoRun (void)
+{
+  Time delays[] = {MilliSeconds (-1), MilliSeconds (0), MilliSeconds (2)};
+  for (uint32_t i = 0; i < sizeof (delays) / sizeof (delays[0]); i++)
+    {
+      RunTicks (CreateObject<DefaultSimulatorImpl> (), delays[i]);
+      uint32_t count = m_count;
+      Time end = m_end;
+
+      ObjectFactory factory ("ns3::ParallelSimulatorImpl");
+      factory.Set ("Partitions", UintegerValue (1));
+      factory.Set ("Lookahead", TimeValue (MilliSeconds (10)));
+      RunTicks (factory.Create<ParallelSimulatorImpl> (), delays[i]);
+      NS_TEST_ASSERT_MSG_EQ (m_count, count, "wrong number of events before the stop with the delay " << delays[i]);
+      NS_TEST_ASSERT_MSG_EQ (m_end, end, "wrong time after the stop with the delay " << delays[i]);
+    }
+}
+
+/**
+ * \ingroup core-tests
+ *
+ * ParallelSimulatorImpl test suite
+ */
+class ParallelSimulatorTestSuite : public TestSuite
+{
+public:
+  ParallelSimulatorTestSuite ();
+};
+
+ParallelSimulatorTestSuite::ParallelSimulatorTestSuite ()
+  : TestSuite ("parallel-simulator", UNIT)
+{
+  AddTestCase (new ParallelSimulatorTestCase (1), TestCase::QUICK);
+  AddTestCase (new ParallelSimulatorTestCase (4), TestCase::QUICK);
+  AddTestCase (new ParallelSimulatorStopTestCase (), TestCase::QUICK);
+  AddTestCase (new ParallelSimulatorStopInWindowTestCase (), TestCase::QUICK);
+}
+
+static ParallelSimulatorTestSuite g_parallelSimulatorTestSuite;
@@ -23,6 +23,9 @@
 #include "ns3/heap-scheduler.h"
 #include "ns3/map-scheduler.h"
 #include "ns3/calendar-scheduler.h"
+#include "ns3/bucket-scheduler.h"
+#include "ns3/event-pool.h"
+#include <vector>
 
 using namespace ns3;
 
@@ -138,6 +141,7 @@ SimulatorEventsTestCase::DoRun (void)
   NS_TEST_EXPECT_MSG_EQ (m_b, true, "Event B did not run ?");
   NS_TEST_EXPECT_MSG_EQ (m_c, true, "Event C did not run ?");
   NS_TEST_EXPECT_MSG_EQ (m_d, true, "Event D did not run ?");
+  NS_TEST_EXPECT_MSG_EQ (Simulator::GetEventCount (), 3, "Events A (canceled), B and D should have been processed");
 
   EventId anId = Simulator::ScheduleNow (&SimulatorEventsTestCase::Eventfoo0, this);
   EventId anotherId = anId;
@@ -461,6 +465,100 @@ SimulatorTemplateTestCase::DoRun (void)
   Simulator::Destroy ();
 }
 
+class SimulatorEventPoolTestCase : public TestCase
+{
+public:
+  SimulatorEventPoolTestCase ();
+private:
+  virtual void DoRun (void);
+  void Count (uint32_t value);
+  uint32_t m_sum;
+};
+
+SimulatorEventPoolTestCase::SimulatorEventPoolTestCase ()
+  : TestCase ("Check that the events reuse the memory of the past events")
+{
+}
+
+void
+SimulatorEventPoolTestCase::Count (uint32_t value)
+{
+  m_sum += value;
+}
+
+void
+SimulatorEventPoolTestCase::DoRun (void)
+{
+  const uint32_t n = 100;
+  m_sum = 0;
+  for (uint32_t i = 0; i < n; i++)
+    {
+      Simulator::Schedule (MicroSeconds (i), &SimulatorEventPoolTestCase::Count, this, 1);
+    }
+  Simulator::Run ();
+  NS_TEST_EXPECT_MSG_EQ (m_sum, n, "Not all the events ran");
+
+  EventPool::ResetStats ();
+  EventPool::Stats before = EventPool::GetStats ();
+  NS_TEST_EXPECT_MSG_GT_OR_EQ (before.m_cached, n, "The events were not kept in the pool");
+  for (uint32_t i = 0; i < n; i++)
+    {
+      EventId id = Simulator::Schedule (MicroSeconds (i), &SimulatorEventPoolTestCase::Count, this, 2);
+      if (i % 2 == 0)
+        {
+          Simulator::Cancel (id);
+        }
+    }
+  EventPool::Stats scheduled = EventPool::GetStats ();
+  NS_TEST_EXPECT_MSG_EQ (scheduled.m_allocations, n, "Unexpected number of allocations");
+  NS_TEST_EXPECT_MSG_EQ (scheduled.m_reuses, n, "The events did not reuse the pooled memory");
+  NS_TEST_EXPECT_MSG_EQ (scheduled.m_unpooled, 0, "The events are not pooled");
+  NS_TEST_EXPECT_MSG_EQ (scheduled.m_cached, before.m_cached - n, "Unexpected number of pooled blocks");
+  Simulator::Run ();
+  NS_TEST_EXPECT_MSG_EQ (m_sum, 2 * n, "The cancelled events ran");
+  EventPool::Stats run = EventPool::GetStats ();
+  NS_TEST_EXPECT_MSG_EQ (run.m_deallocations, n, "Not all the events were freed");
+  NS_TEST_EXPECT_MSG_EQ (run.m_cached, before.m_cached, "The events were not returned to the pool");
+  Simulator::Destroy ();
+}
+
+class SimulatorEventPoolCapTestCase : public TestCase
+{
+public:
+  SimulatorEventPoolCapTestCase ();
+private:
+  virtual void DoRun (void);
+};
+
+SimulatorEventPoolCapTestCase::SimulatorEventPoolCapTestCase ()
+  : TestCase ("Check that the event pool keeps at most MAX_CACHED_BYTES")
+{
+}
+
+void
+SimulatorEventPoolCapTestCase::DoRun (void)
+{
+  const std::size_t size = 4 * EventPool::GRANULARITY;
+  const std::size_t n = 2 * EventPool::MAX_CACHED_BYTES / size;
+  EventPool::Release ();
+  std::vector<void *> blocks;
+  for (std::size_t i = 0; i < n; i++)
+    {
+      blocks.push_back (EventPool::Allocate (size));
+    }
+  for (std::size_t i = 0; i < n; i++)
+    {
+      EventPool::Deallocate (blocks[i], size);
+    }
+  EventPool::Stats stats = EventPool::GetStats ();
+  NS_TEST_EXPECT_MSG_LT_OR_EQ (stats.m_cachedBytes, EventPool::MAX_CACHED_BYTES, "The pool kept too many blocks");
+  NS_TEST_EXPECT_MSG_EQ (stats.m_cachedBytes, stats.m_cached * size, "Unexpected size of the pooled blocks");
+  NS_TEST_EXPECT_MSG_GT (stats.m_cached, 0, "The pool kept no block");
+  EventPool::Release ();
+  stats = EventPool::GetStats ();
+  NS_TEST_EXPECT_MSG_EQ (stats.m_cachedBytes, 0, "The pool was not released");
+}
+
 class SimulatorTestSuite : public TestSuite
 {
 public:
@@ -477,5 +575,9 @@ public:
     AddTestCase (new SimulatorEventsTestCase (factory), TestCase::QUICK);
     factory.SetTypeId (CalendarScheduler::GetTypeId ());
     AddTestCase (new SimulatorEventsTestCase (factory), TestCase::QUICK);
+    factory.SetTypeId (BucketScheduler::GetTypeId ());
+    AddTestCase (new SimulatorEventsTestCase (factory), TestCase::QUICK);
+    AddTestCase (new SimulatorEventPoolTestCase (), TestCase::QUICK);
+    AddTestCase (new SimulatorEventPoolCapTestCase (), TestCase::QUICK);
   }
 } g_simulatorTestSuite;
@@ -242,7 +242,8 @@ public:
       "ns3::ListScheduler",
       "ns3::HeapScheduler",
       "ns3::MapScheduler",
-      "ns3::CalendarScheduler"
+      "ns3::CalendarScheduler",
+      "ns3::BucketScheduler"
     };
     unsigned int threadcounts[] = {
       0,
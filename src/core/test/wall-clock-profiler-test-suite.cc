@@ -0,0 +1,115 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/wall-clock-profiler.h"
+#include "ns3/worker-pool.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup core-tests
+ *
+ * Check that the calls of the sections run by the threads of a
+ * WorkerPool are all counted, and that the nested calls of a section
+ * are counted once.
+ */
+class WallClockProfilerTestCase : public TestCase
+{
+public:
+  WallClockProfilerTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * A job of a batch, which calls the section twice, once nested
+   * \param i the index of the job
+   */
+  void Job (uint32_t i);
+  /** The profiled section */
+  void Section (void);
+  /** The profiled section, calling itself once */
+  void NestedSection (void);
+};
+
+WallClockProfilerTestCase::WallClockProfilerTestCase ()
+  : TestCase ("Merge the sections of the threads")
+{
+}
+
+void
+WallClockProfilerTestCase::Section (void)
+{
+  NS_PROFILE_SCOPE ("WallClockProfilerTestCase::Section");
+}
+
+void
+WallClockProfilerTestCase::NestedSection (void)
+{
+  NS_PROFILE_SCOPE ("WallClockProfilerTestCase::Section");
+  Section ();
+}
+
+void
+WallClockProfilerTestCase::Job (uint32_t i)
+{
+  Section ();
+  NestedSection ();
+}
+
+void
+WallClockProfilerTestCase::DoRun (void)
+{
+  uint32_t id = WallClockProfiler::GetSectionId ("WallClockProfilerTestCase::Section");
+  bool enabled = WallClockProfiler::IsEnabled ();
+  WallClockProfiler::Enable ();
+  WallClockProfiler::Reset ();
+  {
+    WorkerPool pool (4);
+    for (uint32_t b = 0; b < 10; b++)
+      {
+        pool.Run (100, MakeCallback (&WallClockProfilerTestCase::Job, this));
+      }
+    NS_TEST_ASSERT_MSG_EQ (WallClockProfiler::GetCalls (id), 2000, "calls of the running threads not counted");
+  }
+  // the threads of the pool ended
+  NS_TEST_ASSERT_MSG_EQ (WallClockProfiler::GetCalls (id), 2000, "calls of the ended threads not counted");
+  WallClockProfiler::Reset ();
+  NS_TEST_ASSERT_MSG_EQ (WallClockProfiler::GetCalls (id), 0, "calls not reset");
+  if (!enabled)
+    {
+      WallClockProfiler::Disable ();
+    }
+}
+
+/**
+ * \ingroup core-tests
+ *
+ * WallClockProfiler test suite
+ */
+class WallClockProfilerTestSuite : public TestSuite
+{
+public:
+  WallClockProfilerTestSuite ();
+};
+
+WallClockProfilerTestSuite::WallClockProfilerTestSuite ()
+  : TestSuite ("wall-clock-profiler", UNIT)
+{
+  AddTestCase (new WallClockProfilerTestCase, TestCase::QUICK);
+}
+
+static WallClockProfilerTestSuite g_wallClockProfilerTestSuite;
@@ -0,0 +1,236 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/worker-pool.h"
+
+#include <sstream>
+
+using namespace ns3;
+
+/**
+ * \ingroup core-tests
+ *
+ * Check that every job of successive batches is run exactly once by
+ * a WorkerPool.
+ */
+class WorkerPoolTestCase : public TestCase
+{
+public:
+  /**
+   * Constructor
+   * \param nThreads the number of threads of the pool
+   */
+  WorkerPoolTestCase (uint32_t nThreads);
+
+private:
+  virtual void DoRun (void);
+  /**
+   * A job of a batch
+   * \param i the index of the job
+   */
+  void Job (uint32_t i);
+
+  /**
+   * Build the name of the test case
+   * \param nThreads the number of threads of the pool
+   * \return the name of the test case
+   */
+  static std::string BuildNameString (uint32_t nThreads);
+
+  uint32_t m_nThreads; //!< the number of threads of the pool
+  std::vector<uint32_t> m_runs; //!< the number of runs of each job
+  std::vector<uint64_t> m_results; //!< the result of each job
+};
+
+WorkerPoolTestCase::WorkerPoolTestCase (uint32_t nThreads)
+  : TestCase (BuildNameString (nThreads)),
+    m_nThreads (nThreads)
+{
+}
+
+std::string
+WorkerPoolTestCase::BuildNameString (uint32_t nThreads)
+{
+  std::ostringstream oss;
+  oss << "Worker pool with " << nThreads << " threads";
+  return oss.str ();
+}
+
+void
+WorkerPoolTestCase::Job (uint32_t i)
+{
+  uint64_t result = i;
+  for (uint32_t k = 0; k < 1000; k++)
+    {
+      result = result * 6364136223846793005ULL + 1442695040888963407ULL;
+    }
+  m_results[i] = result;
+  m_runs[i]++;
+}
+
+void
+WorkerPoolTestCase::DoRun (void)
+{
+  WorkerPool pool (m_nThreads);
+  NS_TEST_ASSERT_MSG_GT (pool.GetNThreads (), 0, "the pool has no thread");
+
+  uint32_t nJobs[] = {0, 1, 2, 7, 1000, 3};
+  for (uint32_t b = 0; b < sizeof (nJobs) / sizeof (nJobs[0]); b++)
+    {
+      m_runs.assign (nJobs[b], 0);
+      m_results.assign (nJobs[b], 0);
+      pool.Run (nJobs[b], MakeCallback (&WorkerPoolTestCase::Job, this));
+      for (uint32_t i = 0; i < nJobs[b]; i++)
+        {
+          NS_TEST_ASSERT_MSG_EQ (m_runs[i], 1, "job " << i << " of batch " << b << " not run once");
+          uint64_t expected = i;
+          for (uint32_t k = 0; k < 1000; k++)
+            {
+              expected = expected * 6364136223846793005ULL + 1442695040888963407ULL;
+            }
+          NS_TEST_ASSERT_MSG_EQ (m_results[i], expected, "wrong result of job " << i << " of batch " << b);
+        }
+    }
+}
+
+/**
+ * \ingroup core-tests
+ *
+ * Check that the batches started by the jobs of a batch, or by another
+ * thread while a batch is running, are run completely.
+ */
+class WorkerPoolNestedTestCase : public TestCase
+{
+public:
+  WorkerPoolNestedTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * A job of the outer batch, running an inner batch
+   * \param i the index of the job
+   */
+  void OuterJob (uint32_t i);
+  /**
+   * A job of an inner batch
+   * \param k the index of the job
+   */
+  void InnerJob (uint32_t k);
+  /**
+   * A job of the batch run by the other thread
+   * \param i the index of the job
+   */
+  void OtherJob (uint32_t i);
+  /** Run a batch of OtherJob */
+  void RunOtherBatch (void);
+
+  WorkerPool *m_pool; //!< the pool
+  std::vector<uint32_t> m_runs; //!< the number of runs of each job
+  std::vector<uint32_t> m_otherRuns; //!< the number of runs of each job of the other thread
+};
+
+/** The number of jobs of a batch */
+static const uint32_t N_NESTED_JOBS = 16;
+
+/** The outer job running the inner batch of the calling thread */
+static thread_local uint32_t g_outerJob = 0;
+
+WorkerPoolNestedTestCase::WorkerPoolNestedTestCase ()
+  : TestCase ("Worker pool with nested and concurrent batches")
+{
+}
+
+void
+WorkerPoolNestedTestCase::OuterJob (uint32_t i)
+{
+  g_outerJob = i;
+  m_pool->Run (N_NESTED_JOBS, MakeCallback (&WorkerPoolNestedTestCase::InnerJob, this));
+}
+
+void
+WorkerPoolNestedTestCase::InnerJob (uint32_t k)
+{
+  // the inner batch is run by the thread of its outer job
+  m_runs[g_outerJob * N_NESTED_JOBS + k]++;
+}
+
+void
+WorkerPoolNestedTestCase::OtherJob (uint32_t i)
+{
+  m_otherRuns[i]++;
+}
+
+void
+WorkerPoolNestedTestCase::RunOtherBatch (void)
+{
+  m_pool->Run (N_NESTED_JOBS, MakeCallback (&WorkerPoolNestedTestCase::OtherJob, this));
+}
+
+void
+WorkerPoolNestedTestCase::DoRun (void)
+{
+  WorkerPool pool (4);
+  m_pool = &pool;
+
+  m_runs.assign (N_NESTED_JOBS * N_NESTED_JOBS, 0);
+  pool.Run (N_NESTED_JOBS, MakeCallback (&WorkerPoolNestedTestCase::OuterJob, this));
+  for (uint32_t i = 0; i < m_runs.size (); i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (m_runs[i], 1, "inner job " << i % N_NESTED_JOBS << " of outer job " << i / N_NESTED_JOBS << " not run once");
+    }
+
+#ifdef HAVE_PTHREAD_H
+  for (uint32_t b = 0; b < 100; b++)
+    {
+      m_runs.assign (N_NESTED_JOBS * N_NESTED_JOBS, 0);
+      m_otherRuns.assign (N_NESTED_JOBS, 0);
+      std::thread other (&WorkerPoolNestedTestCase::RunOtherBatch, this);
+      pool.Run (N_NESTED_JOBS, MakeCallback (&WorkerPoolNestedTestCase::OuterJob, this));
+      other.join ();
+      for (uint32_t i = 0; i < m_runs.size (); i++)
+        {
+          NS_TEST_ASSERT_MSG_EQ (m_runs[i], 1, "inner job " << i % N_NESTED_JOBS << " of outer job " << i / N_NESTED_JOBS << " not run once");
+        }
+      for (uint32_t i = 0; i < m_otherRuns.size (); i++)
+        {
+          NS_TEST_ASSERT_MSG_EQ (m_otherRuns[i], 1, "job " << i << " of the other thread not run once");
+        }
+    }
+#endif /* HAVE_PTHREAD_H */
+}
+
+/**
+ * \ingroup core-tests
+ *
+ * WorkerPool test suite
+ */
+class WorkerPoolTestSuite : public TestSuite
+{
+public:
+  WorkerPoolTestSuite ();
+};
+
+WorkerPoolTestSuite::WorkerPoolTestSuite ()
+  : TestSuite ("worker-pool", UNIT)
+{
+  AddTestCase (new WorkerPoolTestCase (1), TestCase::QUICK);
+  AddTestCase (new WorkerPoolTestCase (2), TestCase::QUICK);
+  AddTestCase (new WorkerPoolTestCase (8), TestCase::QUICK);
+  AddTestCase (new WorkerPoolNestedTestCase (), TestCase::QUICK);
+}
+
+static WorkerPoolTestSuite g_workerPoolTestSuite;
@@ -0,0 +1,270 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// Reference scenario of the distributed sidelink V2X Mode 4 simulation.
+//
+// The vehicles are spread over a two lane road along the x axis, and
+// all of them broadcast a 'lenCam' bytes packet every 'pRsvp' ms. The
+// program writes each packet received, as "<time in ns> <receiver node>
+// <transmitter address>", to 'outputFile', and prints the number of
+// packets sent and received.
+//
+// With 'distributed', the road is split in as many segments as MPI
+// processes, each simulating the vehicles starting in its segment with a
+// DistributedSpectrumChannel, and each process writes the packets received
+// by its vehicles to 'outputFile' followed by its system id. Since the
+// scenario does not depend on the number of processes, the receptions of
+// all the processes must be those of the sequential simulation, which is
+// checked by src/lte/test/lte-v2x-test-distributed.pl. Only the SINRs may
+// differ, by rounding: the positions of the remote transmitters are
+// extrapolated, and the signals starting at the same time are added to
+// the interference in another order.
+//
+// Sample usage:
+//   ./waf --run 'lena-v2x-distributed --outputFile=ref.txt'
+//   mpirun -np 2 ./waf --run 'lena-v2x-distributed --distributed=1 --outputFile=dist.txt'
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/lte-module.h"
+#include "ns3/point-to-point-helper.h"
+#include "ns3/lte-v2x-helper.h"
+#include "ns3/mpi-interface.h"
+#include "ns3/config-store.h"
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("LenaV2xDistributed");
+
+static uint16_t g_lenCam = 190; ///< size of the broadcast packets
+static uint64_t g_txPackets = 0; ///< number of packets sent
+static uint64_t g_rxPackets = 0; ///< number of packets received
+static std::ofstream g_output; ///< the packets received
+
+static void
+SendPacket (Ptr<Socket> socket)
+{
+  socket->Send (Create<Packet> (g_lenCam));
+  g_txPackets++;
+}
+
+static void
+ReceivePacket (Ptr<Socket> socket)
+{
+  Address from;
+  while (socket->RecvFrom (from))
+    {
+      g_rxPackets++;
+      g_output << Simulator::Now ().GetNanoSeconds () << " " << socket->GetNode ()->GetId ()
+               << " " << InetSocketAddress::ConvertFrom (from).GetIpv4 () << std::endl;
+    }
+}
+
+int
+main (int argc, char *argv[])
+{
+  uint32_t numVeh = 40;
+  double simTime = 4.0;
+  uint16_t sizeSubchannel = 10;
+  uint16_t numSubchannel = 3;
+  uint16_t pRsvp = 100;
+  uint32_t mcs = 20;
+  double ueTxPower = 23.0;
+  double roadLength = 1000.0;
+  double speed = 20.0;
+  bool distributed = false;
+  std::string outputFile = "lena-v2x-distributed.txt";
+
+  CommandLine cmd;
+  cmd.AddValue ("numVeh", "Number of vehicles", numVeh);
+  cmd.AddValue ("simTime", "Total duration of the simulation (in seconds)", simTime);
+  cmd.AddValue ("lenCam", "Size of the broadcast packets in bytes", g_lenCam);
+  cmd.AddValue ("pRsvp", "Resource reservation interval (in ms)", pRsvp);
+  cmd.AddValue ("roadLength", "Length of the road (in meters)", roadLength);
+  cmd.AddValue ("speed", "Speed of the vehicles (in m/s)", speed);
+  cmd.AddValue ("distributed", "Split the road among the MPI processes", distributed);
+  cmd.AddValue ("outputFile", "File of the packets received", outputFile);
+  cmd.Parse (argc, argv);
+
+  if (distributed)
+    {
+      GlobalValue::Bind ("SimulatorImplementationType", StringValue ("ns3::DistributedSimulatorImpl"));
+      MpiInterface::Enable (&argc, &argv);
+    }
+  uint32_t systemId = MpiInterface::GetSystemId ();
+  uint32_t systemCount = MpiInterface::GetSize ();
+
+  Config::SetDefault ("ns3::LteUePhy::TxPower", DoubleValue (ueTxPower));
+  Config::SetDefault ("ns3::LteUePhy::RsrpUeMeasThreshold", DoubleValue (-10.0));
+  Config::SetDefault ("ns3::LteUePhy::EnableV2x", BooleanValue (true));
+  Config::SetDefault ("ns3::LteUePowerControl::Pcmax", DoubleValue (ueTxPower));
+  Config::SetDefault ("ns3::LteUePowerControl::PsschTxPower", DoubleValue (ueTxPower));
+  Config::SetDefault ("ns3::LteUePowerControl::PscchTxPower", DoubleValue (ueTxPower));
+
+  uint16_t slBandwidth = sizeSubchannel * numSubchannel;
+  Config::SetDefault ("ns3::LteUeMac::UlBandwidth", UintegerValue (slBandwidth));
+  Config::SetDefault ("ns3::LteUeMac::EnableV2xHarq", BooleanValue (false));
+  Config::SetDefault ("ns3::LteUeMac::EnableAdjacencyPscchPssch", BooleanValue (true));
+  Config::SetDefault ("ns3::LteUeMac::SlGrantMcs", UintegerValue (mcs));
+  Config::SetDefault ("ns3::LteUeMac::SlSubchannelSize", UintegerValue (sizeSubchannel));
+  Config::SetDefault ("ns3::LteUeMac::SlSubchannelNum", UintegerValue (numSubchannel));
+  Config::SetDefault ("ns3::LteUeMac::SlPrsvp", UintegerValue (pRsvp));
+  Config::SetDefault ("ns3::LteUeMac::SelectionWindowT1", UintegerValue (4));
+  Config::SetDefault ("ns3::LteUeMac::SelectionWindowT2", UintegerValue (std::min<uint16_t> (pRsvp, 100)));
+
+  ConfigStore inputConfig;
+  inputConfig.ConfigureDefaults ();
+
+  // parse again so you can override default values from the command line
+  cmd.Parse (argc, argv);
+
+  // the vehicles, and their nodes, are the same whatever the number of
+  // systems: only the system simulating them depends on it. They are not
+  // evenly spaced, to avoid exact ties between the sensed resources,
+  // which the rounding of the SINRs would break differently.
+  double spacing = roadLength / numVeh;
+  double segmentLength = roadLength / systemCount;
+  std::vector<double> x;
+  NodeContainer vehicles;
+  for (uint32_t i = 0; i < numVeh; i++)
+    {
+      x.push_back ((i + 0.5 + 0.4 * std::sin (1.7 * i)) * spacing);
+      vehicles.Create (1, std::min<uint32_t> (x[i] / segmentLength, systemCount - 1));
+    }
+  MobilityHelper mobility;
+  mobility.SetMobilityModel ("ns3::ConstantVelocityMobilityModel");
+  mobility.Install (vehicles);
+  for (uint32_t i = 0; i < numVeh; i++)
+    {
+      Ptr<ConstantVelocityMobilityModel> mob = vehicles.Get (i)->GetObject<ConstantVelocityMobilityModel> ();
+      mob->SetPosition (Vector (x[i], 4.0 * (i % 2), 1.5));
+      mob->SetVelocity (Vector ((i % 2 == 0 ? 1 : -1) * speed, 0, 0));
+    }
+
+  Ptr<PointToPointEpcHelper> epcHelper = CreateObject<PointToPointEpcHelper> ();
+  Ptr<LteHelper> lteHelper = CreateObject<LteHelper> ();
+  lteHelper->SetEpcHelper (epcHelper);
+  lteHelper->DisableNewEnbPhy ();
+  Ptr<LteV2xHelper> lteV2xHelper = CreateObject<LteV2xHelper> ();
+  lteV2xHelper->SetLteHelper (lteHelper);
+  Config::SetDefault ("ns3::LteEnbNetDevice::UlEarfcn", StringValue ("54990"));
+  // a deterministic propagation loss, without shadowing
+  lteHelper->SetAttribute ("PathlossModel", StringValue ("ns3::LogDistancePropagationLossModel"));
+  lteHelper->SetPathlossModelAttribute ("Exponent", DoubleValue (3.0));
+  if (distributed)
+    {
+      lteHelper->SetSpectrumChannelType ("ns3::DistributedSpectrumChannel");
+    }
+
+  NodeContainer enbNodes;
+  enbNodes.Create (1);
+  MobilityHelper enbMobility;
+  enbMobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  enbMobility.Install (enbNodes);
+  lteHelper->InstallEnbDevice (enbNodes);
+
+  lteHelper->SetAttribute ("UseSidelink", BooleanValue (true));
+  NetDeviceContainer ueDevs = lteHelper->InstallUeDevice (vehicles);
+
+  InternetStackHelper internet;
+  internet.Install (vehicles);
+  epcHelper->AssignUeIpv4Address (ueDevs);
+  Ipv4StaticRoutingHelper ipv4RoutingHelper;
+  for (uint32_t u = 0; u < vehicles.GetN (); ++u)
+    {
+      Ptr<Ipv4StaticRouting> ueStaticRouting = ipv4RoutingHelper.GetStaticRouting (vehicles.Get (u)->GetObject<Ipv4> ());
+      ueStaticRouting->SetDefaultRoute (epcHelper->GetUeDefaultGatewayAddress (), 1);
+    }
+  lteHelper->Attach (ueDevs);
+
+  uint32_t groupL2Address = 0x00;
+  Ipv4AddressGenerator::Init (Ipv4Address ("225.0.0.0"), Ipv4Mask ("255.0.0.0"));
+  Ipv4Address groupAddress = Ipv4AddressGenerator::NextAddress (Ipv4Mask ("255.0.0.0"));
+  uint16_t port = 8000;
+  NetDeviceContainer txUes = lteV2xHelper->AssociateForV2xSharedBroadcast (Seconds (0.0), ueDevs, numVeh, groupAddress, groupL2Address);
+  for (uint32_t i = 0; i < txUes.GetN (); ++i)
+    {
+      if (txUes.Get (i)->GetNode ()->GetSystemId () != systemId)
+        {
+          continue;
+        }
+      Ptr<Socket> host = Socket::CreateSocket (txUes.Get (i)->GetNode (), UdpSocketFactory::GetTypeId ());
+      host->Bind ();
+      host->Connect (InetSocketAddress (groupAddress, port));
+      host->SetAllowBroadcast (true);
+      host->ShutdownRecv ();
+      Ptr<LteUeMac> ueMac = DynamicCast<LteUeMac> (txUes.Get (i)->GetObject<LteUeNetDevice> ()->GetMac ());
+      ueMac->TraceConnectWithoutContext ("SidelinkV2xAnnouncement", MakeBoundCallback (&SendPacket, host));
+    }
+  for (uint32_t u = 0; u < vehicles.GetN (); ++u)
+    {
+      Ptr<Socket> sink = Socket::CreateSocket (vehicles.Get (u), UdpSocketFactory::GetTypeId ());
+      sink->Bind (InetSocketAddress (Ipv4Address::GetAny (), port));
+      sink->SetRecvCallback (MakeCallback (&ReceivePacket));
+    }
+
+  Ptr<LteUeRrcSl> ueSidelinkConfiguration = CreateObject<LteUeRrcSl> ();
+  ueSidelinkConfiguration->SetSlEnabled (true);
+  ueSidelinkConfiguration->SetV2xEnabled (true);
+  LteRrcSap::SlV2xPreconfiguration preconfiguration;
+  preconfiguration.v2xPreconfigFreqList.freq[0].v2xCommPreconfigGeneral.carrierFreq = 54890;
+  preconfiguration.v2xPreconfigFreqList.freq[0].v2xCommPreconfigGeneral.slBandwidth = slBandwidth;
+  preconfiguration.v2xPreconfigFreqList.freq[0].v2xCommTxPoolList.nbPools = 1;
+  preconfiguration.v2xPreconfigFreqList.freq[0].v2xCommRxPoolList.nbPools = 1;
+  SlV2xPreconfigPoolFactory pFactory;
+  pFactory.SetHaveUeSelectedResourceConfig (true);
+  pFactory.SetSlSubframe (std::bitset<20> (0xFFFFF));
+  pFactory.SetAdjacencyPscchPssch (true);
+  pFactory.SetSizeSubchannel (sizeSubchannel);
+  pFactory.SetNumSubchannel (numSubchannel);
+  pFactory.SetStartRbSubchannel (0);
+  pFactory.SetStartRbPscchPool (0);
+  pFactory.SetDataTxP0 (-4);
+  pFactory.SetDataTxAlpha (0.9);
+  preconfiguration.v2xPreconfigFreqList.freq[0].v2xCommTxPoolList.pools[0] = pFactory.CreatePool ();
+  preconfiguration.v2xPreconfigFreqList.freq[0].v2xCommRxPoolList.pools[0] = pFactory.CreatePool ();
+  ueSidelinkConfiguration->SetSlV2xPreconfiguration (preconfiguration);
+  lteHelper->InstallSidelinkV2xConfiguration (ueDevs, ueSidelinkConfiguration);
+
+  if (distributed)
+    {
+      std::ostringstream name;
+      name << outputFile << "-" << systemId;
+      outputFile = name.str ();
+    }
+  g_output.open (outputFile.c_str ());
+  NS_ABORT_MSG_UNLESS (g_output.is_open (), "Cannot open " << outputFile);
+
+  Simulator::Stop (Seconds (simTime));
+  Simulator::Run ();
+  Simulator::Destroy ();
+  g_output.close ();
+  if (distributed)
+    {
+      MpiInterface::Disable ();
+      std::cout << "system " << systemId << " of " << systemCount << ": ";
+    }
+  std::cout << "packets sent " << g_txPackets << ", received " << g_rxPackets << std::endl;
+
+  return 0;
+}
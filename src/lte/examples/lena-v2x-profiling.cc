@@ -0,0 +1,459 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// Scalability benchmark of the sidelink V2X Mode 4 model.
+//
+// The vehicles move at constant speed on a freeway (parallel lanes in both
+// directions) or on an urban grid (streets in both axes), and the first
+// 'txRatio' of them broadcast a 'lenCam' bytes packet every 'pRsvp' ms
+// to all the other vehicles, starting about 2 s into the simulation once
+// the sidelink is configured.  At the end of the simulation, the program
+// prints the wall clock time per simulated second, the number of events
+// executed per second, the peak resident set size and the share of the
+// wall clock time spent in the main sections of the model (see
+// WallClockProfiler), followed by a single line of key=value results
+// which is parsed by src/lte/test/lte-v2x-test-run-time.pl.
+//
+// With 'distributed', the freeway is split in as many segments as MPI
+// processes, each simulating the vehicles starting in its segment (see
+// DistributedSpectrumChannel), and each process prints its own results.
+//
+// Sample usage:
+//   ./waf --run 'lena-v2x-profiling --numVeh=100 --scenario=urban --simTime=5'
+//   mpirun -np 4 ./waf --run 'lena-v2x-profiling --numVeh=1000 --distributed=1'
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/lte-module.h"
+#include "ns3/point-to-point-helper.h"
+#include "ns3/lte-v2x-helper.h"
+#include "ns3/mpi-interface.h"
+#ifdef NS3_MPI
+#include "ns3/distributed-spectrum-channel.h"
+#endif
+#include "ns3/config-store.h"
+#include <ns3/buildings-helper.h>
+#include <ns3/wall-clock-profiler.h>
+#include <sys/resource.h>
+#include <iomanip>
+#include <string>
+#include <vector>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("LenaV2xProfiling");
+
+static uint16_t g_lenCam = 190; ///< size of the broadcast packets
+static uint64_t g_txPackets = 0; ///< number of packets sent
+static uint64_t g_rxPackets = 0; ///< number of packets received
+
+static void
+SendPacket (Ptr<Socket> socket)
+{
+  socket->Send (Create<Packet> (g_lenCam));
+  g_txPackets++;
+}
+
+static void
+ReceivePacket (Ptr<Socket> socket)
+{
+  while (socket->Recv ())
+    {
+      g_rxPackets++;
+    }
+}
+
+/**
+ * Send a packet to the group address at each sidelink announcement of
+ * the transmitter
+ * \param txUe the transmitter
+ * \param groupAddress the address of the group
+ * \param port the port of the receivers
+ */
+static void
+InstallSender (Ptr<NetDevice> txUe, Ipv4Address groupAddress, uint16_t port)
+{
+  Ptr<Socket> host = Socket::CreateSocket (txUe->GetNode (), UdpSocketFactory::GetTypeId ());
+  host->Bind ();
+  host->Connect (InetSocketAddress (groupAddress, port));
+  host->SetAllowBroadcast (true);
+  host->ShutdownRecv ();
+  Ptr<LteUeMac> ueMac = DynamicCast<LteUeMac> (txUe->GetObject<LteUeNetDevice> ()->GetMac ());
+  ueMac->TraceConnectWithoutContext ("SidelinkV2xAnnouncement", MakeBoundCallback (&SendPacket, host));
+}
+
+/**
+ * \return the peak resident set size of the process, in kB
+ */
+static long
+GetPeakRssKb (void)
+{
+  struct rusage usage;
+  if (getrusage (RUSAGE_SELF, &usage) != 0)
+    {
+      return 0;
+    }
+#ifdef __APPLE__
+  return usage.ru_maxrss / 1024;
+#else
+  return usage.ru_maxrss;
+#endif
+}
+
+/**
+ * Install the vehicles on a freeway: 'numLanes' lanes in each direction
+ * along the x axis, 4 m apart, over 'roadLength' m.  The road is split in
+ * 'numSegments' segments, and each vehicle starts in the segment of its
+ * system id.
+ */
+static void
+InstallFreewayMobility (NodeContainer vehicles, double roadLength, uint32_t numLanes, double speed, uint32_t numSegments)
+{
+  double segmentLength = roadLength / numSegments;
+  Ptr<UniformRandomVariable> x = CreateObject<UniformRandomVariable> ();
+  MobilityHelper mobility;
+  mobility.SetMobilityModel ("ns3::ConstantVelocityMobilityModel");
+  mobility.Install (vehicles);
+  for (uint32_t i = 0; i < vehicles.GetN (); i++)
+    {
+      uint32_t lane = i % (2 * numLanes);
+      double direction = (lane < numLanes) ? 1 : -1;
+      Ptr<ConstantVelocityMobilityModel> mob = vehicles.Get (i)->GetObject<ConstantVelocityMobilityModel> ();
+      double segmentStart = segmentLength * vehicles.Get (i)->GetSystemId ();
+      mob->SetPosition (Vector (x->GetValue (segmentStart, segmentStart + segmentLength), 4.0 * lane, 1.5));
+      mob->SetVelocity (Vector (direction * speed, 0, 0));
+    }
+}
+
+/**
+ * Install the vehicles on an urban grid of 'gridSize' x 'gridSize'
+ * streets, 'blockSize' m apart, half of them driving along the x axis
+ * and half of them along the y axis.
+ */
+static void
+InstallUrbanGridMobility (NodeContainer vehicles, uint32_t gridSize, double blockSize, double speed)
+{
+  Ptr<UniformRandomVariable> position = CreateObject<UniformRandomVariable> ();
+  Ptr<UniformRandomVariable> street = CreateObject<UniformRandomVariable> ();
+  double gridLength = (gridSize - 1) * blockSize;
+  MobilityHelper mobility;
+  mobility.SetMobilityModel ("ns3::ConstantVelocityMobilityModel");
+  mobility.Install (vehicles);
+  for (uint32_t i = 0; i < vehicles.GetN (); i++)
+    {
+      double streetPos = blockSize * street->GetInteger (0, gridSize - 1);
+      double alongPos = position->GetValue (0, gridLength);
+      double direction = (i % 4 < 2) ? 1 : -1;
+      Ptr<ConstantVelocityMobilityModel> mob = vehicles.Get (i)->GetObject<ConstantVelocityMobilityModel> ();
+      if (i % 2 == 0)
+        {
+          mob->SetPosition (Vector (alongPos, streetPos, 1.5));
+          mob->SetVelocity (Vector (direction * speed, 0, 0));
+        }
+      else
+        {
+          mob->SetPosition (Vector (streetPos, alongPos, 1.5));
+          mob->SetVelocity (Vector (0, direction * speed, 0));
+        }
+    }
+}
+
+int
+main (int argc, char *argv[])
+{
+  uint32_t numVeh = 50;
+  std::string scenario = "freeway";
+  double simTime = 4.0;
+  double txRatio = 1.0;
+  uint16_t sizeSubchannel = 10;
+  uint16_t numSubchannel = 3;
+  bool adjacencyPscchPssch = true;
+  uint16_t pRsvp = 100;
+  uint32_t mcs = 20;
+  double ueTxPower = 23.0;
+  double roadLength = 2000.0;
+  uint32_t numLanes = 3;
+  uint32_t gridSize = 5;
+  double blockSize = 250.0;
+  double speed = 20.0;
+  bool profile = true;
+  bool sharedGroup = true;
+  bool distributed = false;
+
+  CommandLine cmd;
+  cmd.AddValue ("numVeh", "Number of vehicles", numVeh);
+  cmd.AddValue ("scenario", "Scenario: freeway or urban", scenario);
+  cmd.AddValue ("simTime", "Total duration of the simulation (in seconds)", simTime);
+  cmd.AddValue ("txRatio", "Fraction of the vehicles which broadcast packets", txRatio);
+  cmd.AddValue ("lenCam", "Size of the broadcast packets in bytes", g_lenCam);
+  cmd.AddValue ("sizeSubchannel", "Number of RBs per subchannel", sizeSubchannel);
+  cmd.AddValue ("numSubchannel", "Number of subchannels", numSubchannel);
+  cmd.AddValue ("adjacencyPscchPssch", "Scheme for subchannelization", adjacencyPscchPssch);
+  cmd.AddValue ("pRsvp", "Resource reservation interval (in ms)", pRsvp);
+  cmd.AddValue ("mcs", "Modulation and coding scheme", mcs);
+  cmd.AddValue ("roadLength", "Length of the freeway (in meters)", roadLength);
+  cmd.AddValue ("numLanes", "Number of freeway lanes in each direction", numLanes);
+  cmd.AddValue ("gridSize", "Number of urban streets in each axis", gridSize);
+  cmd.AddValue ("blockSize", "Distance between urban streets (in meters)", blockSize);
+  cmd.AddValue ("speed", "Speed of the vehicles (in m/s)", speed);
+  cmd.AddValue ("profile", "Profile the main sections of the model", profile);
+  cmd.AddValue ("sharedGroup", "Use a single broadcast group instead of one group per transmitter", sharedGroup);
+  cmd.AddValue ("distributed", "Split the freeway among the MPI processes", distributed);
+  cmd.Parse (argc, argv);
+
+  if (scenario != "freeway" && scenario != "urban")
+    {
+      NS_FATAL_ERROR ("Unknown scenario " << scenario);
+    }
+  if (distributed)
+    {
+#ifndef NS3_MPI
+      NS_FATAL_ERROR ("Configure ns-3 with --enable-mpi to distribute the simulation");
+#endif
+      NS_ABORT_MSG_IF (scenario != "freeway", "Only the freeway scenario can be distributed");
+      GlobalValue::Bind ("SimulatorImplementationType", StringValue ("ns3::DistributedSimulatorImpl"));
+      MpiInterface::Enable (&argc, &argv);
+    }
+  uint32_t systemId = MpiInterface::GetSystemId ();
+  uint32_t systemCount = MpiInterface::GetSize ();
+  uint32_t numTx = std::max<uint32_t> (1, std::min<uint32_t> (numVeh, txRatio * numVeh + 0.5));
+
+  SystemWallClockMs setupClock;
+  setupClock.Start ();
+
+  Config::SetDefault ("ns3::LteUePhy::TxPower", DoubleValue (ueTxPower));
+  Config::SetDefault ("ns3::LteUePhy::RsrpUeMeasThreshold", DoubleValue (-10.0));
+  Config::SetDefault ("ns3::LteUePhy::EnableV2x", BooleanValue (true));
+  Config::SetDefault ("ns3::LteUePowerControl::Pcmax", DoubleValue (ueTxPower));
+  Config::SetDefault ("ns3::LteUePowerControl::PsschTxPower", DoubleValue (ueTxPower));
+  Config::SetDefault ("ns3::LteUePowerControl::PscchTxPower", DoubleValue (ueTxPower));
+
+  uint16_t slBandwidth = adjacencyPscchPssch ? sizeSubchannel * numSubchannel : (sizeSubchannel + 2) * numSubchannel;
+  Config::SetDefault ("ns3::LteUeMac::UlBandwidth", UintegerValue (slBandwidth));
+  Config::SetDefault ("ns3::LteUeMac::EnableV2xHarq", BooleanValue (false));
+  Config::SetDefault ("ns3::LteUeMac::EnableAdjacencyPscchPssch", BooleanValue (adjacencyPscchPssch));
+  Config::SetDefault ("ns3::LteUeMac::SlGrantMcs", UintegerValue (mcs));
+  Config::SetDefault ("ns3::LteUeMac::SlSubchannelSize", UintegerValue (sizeSubchannel));
+  Config::SetDefault ("ns3::LteUeMac::SlSubchannelNum", UintegerValue (numSubchannel));
+  Config::SetDefault ("ns3::LteUeMac::SlPrsvp", UintegerValue (pRsvp));
+  Config::SetDefault ("ns3::LteUeMac::SelectionWindowT1", UintegerValue (4));
+  Config::SetDefault ("ns3::LteUeMac::SelectionWindowT2", UintegerValue (std::min<uint16_t> (pRsvp, 100)));
+
+  ConfigStore inputConfig;
+  inputConfig.ConfigureDefaults ();
+
+  // parse again so you can override default values from the command line
+  cmd.Parse (argc, argv);
+
+  NodeContainer vehicles;
+  for (uint32_t i = 0; i < numVeh; i++)
+    {
+      // the same number of vehicles, and of transmitters, in each segment
+      vehicles.Create (1, i % systemCount);
+    }
+  if (scenario == "freeway")
+    {
+      InstallFreewayMobility (vehicles, roadLength, numLanes, speed, systemCount);
+    }
+  else
+    {
+      InstallUrbanGridMobility (vehicles, gridSize, blockSize, speed);
+    }
+
+  Ptr<PointToPointEpcHelper> epcHelper = CreateObject<PointToPointEpcHelper> ();
+  Ptr<LteHelper> lteHelper = CreateObject<LteHelper> ();
+  lteHelper->SetEpcHelper (epcHelper);
+  lteHelper->DisableNewEnbPhy ();
+  Ptr<LteV2xHelper> lteV2xHelper = CreateObject<LteV2xHelper> ();
+  lteV2xHelper->SetLteHelper (lteHelper);
+  lteHelper->SetEnbAntennaModelType ("ns3::NistParabolic3dAntennaModel");
+  lteHelper->SetAttribute ("UseSameUlDlPropagationCondition", BooleanValue (true));
+  Config::SetDefault ("ns3::LteEnbNetDevice::UlEarfcn", StringValue ("54990"));
+  lteHelper->SetAttribute ("PathlossModel", StringValue ("ns3::CniUrbanmicrocellPropagationLossModel"));
+  if (distributed)
+    {
+      lteHelper->SetSpectrumChannelType ("ns3::DistributedSpectrumChannel");
+    }
+
+  NodeContainer enbNodes;
+  enbNodes.Create (1);
+  MobilityHelper enbMobility;
+  enbMobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  enbMobility.Install (enbNodes);
+  lteHelper->InstallEnbDevice (enbNodes);
+  BuildingsHelper::Install (enbNodes);
+  BuildingsHelper::Install (vehicles);
+  BuildingsHelper::MakeMobilityModelConsistent ();
+
+  lteHelper->SetAttribute ("UseSidelink", BooleanValue (true));
+  NetDeviceContainer ueDevs = lteHelper->InstallUeDevice (vehicles);
+#ifdef NS3_MPI
+  if (distributed)
+    {
+      // the sidelink is on the uplink channel
+      Ptr<DistributedSpectrumChannel> channel = DynamicCast<DistributedSpectrumChannel> (lteHelper->GetUplinkSpectrumChannel ());
+      double segmentLength = roadLength / systemCount;
+      for (uint32_t s = 0; s < systemCount; s++)
+        {
+          channel->SetRegion (s, Box (s * segmentLength, (s + 1) * segmentLength, 0, 4.0 * (2 * numLanes - 1), 1.5, 1.5));
+        }
+    }
+#endif
+
+  InternetStackHelper internet;
+  internet.Install (vehicles);
+  epcHelper->AssignUeIpv4Address (ueDevs);
+  Ipv4StaticRoutingHelper ipv4RoutingHelper;
+  for (uint32_t u = 0; u < vehicles.GetN (); ++u)
+    {
+      Ptr<Ipv4StaticRouting> ueStaticRouting = ipv4RoutingHelper.GetStaticRouting (vehicles.Get (u)->GetObject<Ipv4> ());
+      ueStaticRouting->SetDefaultRoute (epcHelper->GetUeDefaultGatewayAddress (), 1);
+    }
+  lteHelper->Attach (ueDevs);
+
+  uint32_t groupL2Address = 0x00;
+  Ipv4AddressGenerator::Init (Ipv4Address ("225.0.0.0"), Ipv4Mask ("255.0.0.0"));
+  Ipv4Address groupAddress = Ipv4AddressGenerator::NextAddress (Ipv4Mask ("255.0.0.0"));
+  uint16_t port = 8000;
+  if (sharedGroup)
+    {
+      // a single broadcast group for all the transmitters
+      NetDeviceContainer txUes = lteV2xHelper->AssociateForV2xSharedBroadcast (Seconds (0.0), ueDevs, numTx, groupAddress, groupL2Address);
+      for (uint32_t i = 0; i < txUes.GetN (); ++i)
+        {
+          if (txUes.Get (i)->GetNode ()->GetSystemId () == systemId)
+            {
+              InstallSender (txUes.Get (i), groupAddress, port);
+            }
+        }
+    }
+  else
+    {
+      // one broadcast group per transmitter
+      std::vector<NetDeviceContainer> txGroups = lteV2xHelper->AssociateForV2xBroadcast (ueDevs, numTx);
+      for (std::vector<NetDeviceContainer>::iterator gIt = txGroups.begin (); gIt != txGroups.end (); gIt++)
+        {
+          NetDeviceContainer txUe ((*gIt).Get (0));
+          NetDeviceContainer rxUes = lteV2xHelper->RemoveNetDevice ((*gIt), txUe.Get (0));
+          Ptr<LteSlTft> tft = Create<LteSlTft> (LteSlTft::TRANSMIT, groupAddress, groupL2Address);
+          lteV2xHelper->ActivateSidelinkBearer (Seconds (0.0), txUe, tft);
+          tft = Create<LteSlTft> (LteSlTft::RECEIVE, groupAddress, groupL2Address);
+          lteV2xHelper->ActivateSidelinkBearer (Seconds (0.0), rxUes, tft);
+          if (txUe.Get (0)->GetNode ()->GetSystemId () == systemId)
+            {
+              InstallSender (txUe.Get (0), groupAddress, port);
+            }
+
+          groupL2Address++;
+          groupAddress = Ipv4AddressGenerator::NextAddress (Ipv4Mask ("255.0.0.0"));
+        }
+    }
+  for (uint32_t u = 0; u < vehicles.GetN (); ++u)
+    {
+      Ptr<Socket> sink = Socket::CreateSocket (vehicles.Get (u), UdpSocketFactory::GetTypeId ());
+      sink->Bind (InetSocketAddress (Ipv4Address::GetAny (), port));
+      sink->SetRecvCallback (MakeCallback (&ReceivePacket));
+    }
+
+  Ptr<LteUeRrcSl> ueSidelinkConfiguration = CreateObject<LteUeRrcSl> ();
+  ueSidelinkConfiguration->SetSlEnabled (true);
+  ueSidelinkConfiguration->SetV2xEnabled (true);
+  LteRrcSap::SlV2xPreconfiguration preconfiguration;
+  preconfiguration.v2xPreconfigFreqList.freq[0].v2xCommPreconfigGeneral.carrierFreq = 54890;
+  preconfiguration.v2xPreconfigFreqList.freq[0].v2xCommPreconfigGeneral.slBandwidth = slBandwidth;
+  preconfiguration.v2xPreconfigFreqList.freq[0].v2xCommTxPoolList.nbPools = 1;
+  preconfiguration.v2xPreconfigFreqList.freq[0].v2xCommRxPoolList.nbPools = 1;
+  SlV2xPreconfigPoolFactory pFactory;
+  pFactory.SetHaveUeSelectedResourceConfig (true);
+  pFactory.SetSlSubframe (std::bitset<20> (0xFFFFF));
+  pFactory.SetAdjacencyPscchPssch (adjacencyPscchPssch);
+  pFactory.SetSizeSubchannel (sizeSubchannel);
+  pFactory.SetNumSubchannel (numSubchannel);
+  pFactory.SetStartRbSubchannel (0);
+  pFactory.SetStartRbPscchPool (0);
+  pFactory.SetDataTxP0 (-4);
+  pFactory.SetDataTxAlpha (0.9);
+  preconfiguration.v2xPreconfigFreqList.freq[0].v2xCommTxPoolList.pools[0] = pFactory.CreatePool ();
+  preconfiguration.v2xPreconfigFreqList.freq[0].v2xCommRxPoolList.pools[0] = pFactory.CreatePool ();
+  ueSidelinkConfiguration->SetSlV2xPreconfiguration (preconfiguration);
+  lteHelper->InstallSidelinkV2xConfiguration (ueDevs, ueSidelinkConfiguration);
+
+  double setupSeconds = setupClock.End () / 1000.0;
+
+  if (profile)
+    {
+      WallClockProfiler::Enable ();
+    }
+  Simulator::Stop (Seconds (simTime));
+  SystemWallClockMs runClock;
+  runClock.Start ();
+  Simulator::Run ();
+  double runSeconds = runClock.End () / 1000.0;
+  uint64_t events = Simulator::GetEventCount ();
+  Simulator::Destroy ();
+  if (distributed)
+    {
+      MpiInterface::Disable ();
+      std::cout << "system " << systemId << " of " << systemCount << ": ";
+    }
+
+  double eventsPerSecond = (runSeconds > 0) ? events / runSeconds : 0;
+  std::cout << "scenario " << scenario << " numVeh " << numVeh << " numTx " << numTx
+            << " sizeSubchannel " << sizeSubchannel << " numSubchannel " << numSubchannel
+            << " pRsvp " << pRsvp << " lenCam " << g_lenCam << " simTime " << simTime << std::endl;
+  std::cout << "setup time " << setupSeconds << " s, run time " << runSeconds << " s, "
+            << runSeconds / simTime << " s per simulated second" << std::endl;
+  std::cout << "events " << events << ", " << eventsPerSecond << " events/s, peak RSS "
+            << GetPeakRssKb () << " kB" << std::endl;
+  std::cout << "packets sent " << g_txPackets << ", received " << g_rxPackets << std::endl;
+  LteMiErrorModelCache::Stats miCacheStats = LteMiErrorModelCache::GetGlobalStats ();
+  if (miCacheStats.lookups > 0)
+    {
+      std::cout << "MI error model cache: lookups " << miCacheStats.lookups << ", hits " << miCacheStats.hits;
+      if (miCacheStats.validated > 0)
+        {
+          std::cout << ", validated " << miCacheStats.validated << ", mean TBLER error "
+                    << miCacheStats.sumError / miCacheStats.validated << ", max TBLER error " << miCacheStats.maxError;
+        }
+      std::cout << std::endl;
+    }
+  if (profile)
+    {
+      WallClockProfiler::Print (std::cout, runSeconds);
+    }
+
+  // single line of results for the scripts
+  std::cout << "RESULT scenario=" << scenario << " numVeh=" << numVeh << " numTx=" << numTx
+            << " sizeSubchannel=" << sizeSubchannel << " numSubchannel=" << numSubchannel
+            << " pRsvp=" << pRsvp << " lenCam=" << g_lenCam << " simTime=" << simTime
+            << " setupTime=" << setupSeconds << " runTime=" << runSeconds
+            << " timePerSimSecond=" << runSeconds / simTime
+            << " events=" << events << " eventsPerSecond=" << eventsPerSecond
+            << " peakRssKb=" << GetPeakRssKb ()
+            << " sharedGroup=" << sharedGroup
+            << " systemId=" << systemId << " systemCount=" << systemCount
+            << " txPackets=" << g_txPackets << " rxPackets=" << g_rxPackets;
+  for (uint32_t id = 0; profile && id < WallClockProfiler::GetNSections (); id++)
+    {
+      double share = (runSeconds > 0) ? WallClockProfiler::GetSeconds (id) / runSeconds : 0;
+      std::cout << " share:" << WallClockProfiler::GetSectionName (id) << "=" << share;
+    }
+  std::cout << std::endl;
+
+  return 0;
+}
@@ -43,6 +43,10 @@
 #include <ns3/lte-chunk-processor.h>
 #include <ns3/lte-sl-chunk-processor.h>
 #include <ns3/multi-model-spectrum-channel.h>
+#ifdef NS3_MPI
+#include <ns3/distributed-spectrum-channel.h>
+#include <ns3/lte-sl-signal-codec.h>
+#endif
 #include <ns3/friis-spectrum-propagation-loss.h>
 #include <ns3/trace-fading-loss-model.h>
 #include <ns3/isotropic-antenna-model.h>
@@ -283,6 +287,15 @@ LteHelper::ChannelModelInitialization (void)
   m_downlinkChannel = m_channelFactory.Create<SpectrumChannel> ();
   m_uplinkChannel = m_channelFactory.Create<SpectrumChannel> ();
 
+#ifdef NS3_MPI
+  // the sidelink frames are sent on the uplink channel
+  Ptr<DistributedSpectrumChannel> distributedUlChannel = DynamicCast<DistributedSpectrumChannel> (m_uplinkChannel);
+  if (distributedUlChannel != 0)
+    {
+      distributedUlChannel->AddCodec (CreateObject<LteSlSignalCodec> ());
+    }
+#endif
+
   m_downlinkPathlossModel = m_pathlossModelFactory.Create ();
   Ptr<SpectrumPropagationLossModel> dlSplm = m_downlinkPathlossModel->GetObject<SpectrumPropagationLossModel> ();
   if (dlSplm != 0)
@@ -976,6 +989,15 @@ LteHelper::InstallSingleUeDevice (Ptr<Node> n)
       {
         slPhy->SetChannel (m_uplinkChannel); //want the UE to receive sidelink messages on the uplink
       }
+#ifdef NS3_MPI
+      Ptr<DistributedSpectrumChannel> distributedUlChannel = DynamicCast<DistributedSpectrumChannel> (m_uplinkChannel);
+      if (distributedUlChannel != 0)
+        {
+          // the sidelink frames known in advance are announced to the other systems
+          ulPhy->SetLtePhyAnnounceTxCallback (distributedUlChannel->GetLookahead (),
+                                              MakeCallback (&DistributedSpectrumChannel::AnnounceTx, distributedUlChannel));
+        }
+#endif
 
       Ptr<MobilityModel> mm = n->GetObject<MobilityModel> ();
       NS_ASSERT_MSG (mm, "MobilityModel needs to be set on node before calling LteHelper::InstallUeDevice ()");
@@ -1679,6 +1701,24 @@ LteHelper::EnableTraces (void)
   EnablePdcpTraces ();
 }
 
+void
+LteHelper::FlushTraces (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_phyTxStats != 0)
+    {
+      m_phyTxStats->FlushOutputFiles ();
+    }
+  if (m_phyRxStats != 0)
+    {
+      m_phyRxStats->FlushOutputFiles ();
+    }
+  if (m_macStats != 0)
+    {
+      m_macStats->FlushOutputFiles ();
+    }
+}
+
 void
 LteHelper::EnableRlcTraces (void)
 {
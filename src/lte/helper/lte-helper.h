@@ -670,6 +670,13 @@ public:
    */
   void EnableTraces (void);
 
+  /**
+   * Writes the buffered records of the PHY and MAC trace files, which are
+   * otherwise complete once the simulation is destroyed. Call it after
+   * Simulator::Run to read the files before Simulator::Destroy.
+   */
+  void FlushTraces (void);
+
   /**
    * Enable trace sinks for PHY layer.
    */
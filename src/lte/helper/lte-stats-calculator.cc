@@ -23,6 +23,7 @@
 
 #include <ns3/log.h>
 #include <ns3/config.h>
+#include <ns3/boolean.h>
 #include <ns3/lte-enb-rrc.h>
 #include <ns3/lte-ue-rrc.h>
 #include <ns3/lte-enb-net-device.h>
@@ -35,7 +36,8 @@ NS_LOG_COMPONENT_DEFINE ("LteStatsCalculator");
 NS_OBJECT_ENSURE_REGISTERED (LteStatsCalculator);
 
 LteStatsCalculator::LteStatsCalculator ()
-  : m_dlOutputFilename (""),
+  : m_binaryOutputEnabled (false),
+    m_dlOutputFilename (""),
     m_ulOutputFilename ("")
 {
   // Nothing to do here
@@ -55,6 +57,12 @@ LteStatsCalculator::GetTypeId (void)
     .SetParent<Object> ()
     .SetGroupName("Lte")
     .AddConstructor<LteStatsCalculator> ()
+    .AddAttribute ("BinaryOutputEnabled",
+                   "If true, the output files are written in a compact binary format, "
+                   "which can be converted to text with the lte-stats-to-csv program",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&LteStatsCalculator::m_binaryOutputEnabled),
+                   MakeBooleanChecker ())
   ;
   return tid;
 }
@@ -357,4 +365,27 @@ LteStatsCalculator::FindImsiForUe (std::string path, uint16_t rnti)
 }
 
 
+bool
+LteStatsCalculator::OpenOutputFile (Ptr<LteStatsFile> file, std::string filename)
+{
+  NS_LOG_FUNCTION (this << filename);
+  if (!file->Open (filename, m_binaryOutputEnabled))
+    {
+      NS_LOG_ERROR ("Can't open file " << filename);
+      return false;
+    }
+  m_outputFiles.push_back (file);
+  return true;
+}
+
+void
+LteStatsCalculator::FlushOutputFiles (void)
+{
+  NS_LOG_FUNCTION (this);
+  for (std::vector<Ptr<LteStatsFile> >::iterator it = m_outputFiles.begin (); it != m_outputFiles.end (); ++it)
+    {
+      (*it)->Flush ();
+    }
+}
+
 } // namespace ns3
@@ -24,7 +24,9 @@
 
 #include "ns3/object.h"
 #include "ns3/string.h"
+#include "ns3/lte-stats-file.h"
 #include <map>
+#include <vector>
 
 namespace ns3 {
 
@@ -175,6 +177,13 @@ public:
    */
   uint16_t GetCellIdPath (std::string path);
 
+  /**
+   * Writes the buffered records of the output files opened by the
+   * calculator, which are otherwise complete once the simulation is
+   * destroyed
+   */
+  void FlushOutputFiles (void);
+
 protected:
 
   /**
@@ -237,7 +246,26 @@ protected:
    */
   static uint64_t FindImsiForUe (std::string path, uint16_t rnti);
 
+  /**
+   * Opens an output file of the calculator, in the format selected by the
+   * BinaryOutputEnabled attribute
+   * @param file the file, with its columns
+   * @param filename the name of the file
+   * @return true if the file was opened
+   */
+  bool OpenOutputFile (Ptr<LteStatsFile> file, std::string filename);
+
 private:
+  /**
+   * Whether the output files are written in the binary format
+   */
+  bool m_binaryOutputEnabled;
+
+  /**
+   * Output files opened by the calculator
+   */
+  std::vector<Ptr<LteStatsFile> > m_outputFiles;
+
   /**
    * List of IMSI by path in the attribute system
    */
@@ -0,0 +1,377 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "lte-stats-file.h"
+#include <ns3/simulator.h>
+#include <ns3/log.h>
+#include <ns3/async-file-stream.h>
+#include <fstream>
+#include <cstring>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("LteStatsFile");
+
+/// Identifier at the start of the binary files
+static const char g_lteStatsFileMagic[8] = { 'L', 'T', 'E', 'S', 'T', 'A', 'T', 'S' };
+/// Written in the byte order of the host, to detect files of other hosts
+static const uint32_t g_lteStatsFileByteOrder = 0x01020304;
+/// Version of the binary format
+static const uint32_t g_lteStatsFileVersion = 1;
+/// Size of the buffer of the files
+static const uint32_t g_lteStatsFileBufferSize = 1 << 16;
+
+/**
+ * \param type the type of a column
+ * \return the width in bytes of the column in the binary format
+ */
+static uint32_t
+GetColumnWidth (LteStatsFile::ColumnType type)
+{
+  switch (type)
+    {
+    case LteStatsFile::UINT8:
+      return 1;
+    case LteStatsFile::UINT16:
+      return 2;
+    case LteStatsFile::UINT32:
+      return 4;
+    default:
+      return 8;
+    }
+}
+
+/**
+ * Print a value in the text format
+ * \param os the output stream
+ * \param type the type of the column
+ * \param data the value, in the binary format
+ */
+static void
+PrintValue (std::ostream& os, LteStatsFile::ColumnType type, const char* data)
+{
+  switch (type)
+    {
+    case LteStatsFile::UINT8:
+      {
+        uint8_t v;
+        std::memcpy (&v, data, sizeof (v));
+        os << (uint32_t) v;
+        break;
+      }
+    case LteStatsFile::UINT16:
+      {
+        uint16_t v;
+        std::memcpy (&v, data, sizeof (v));
+        os << v;
+        break;
+      }
+    case LteStatsFile::UINT32:
+      {
+        uint32_t v;
+        std::memcpy (&v, data, sizeof (v));
+        os << v;
+        break;
+      }
+    case LteStatsFile::UINT64:
+      {
+        uint64_t v;
+        std::memcpy (&v, data, sizeof (v));
+        os << v;
+        break;
+      }
+    case LteStatsFile::INT64:
+      {
+        int64_t v;
+        std::memcpy (&v, data, sizeof (v));
+        os << v;
+        break;
+      }
+    case LteStatsFile::DOUBLE:
+      {
+        double v;
+        std::memcpy (&v, data, sizeof (v));
+        os << v;
+        break;
+      }
+    }
+}
+
+LteStatsFile::LteStatsFile ()
+  : m_file (0),
+    m_binary (false),
+    m_column (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+LteStatsFile::~LteStatsFile ()
+{
+  NS_LOG_FUNCTION (this);
+  if (m_file != 0)
+    {
+      NS_ASSERT_MSG (m_column == 0, "Incomplete record");
+      delete m_file;
+      m_file = 0;
+    }
+}
+
+void
+LteStatsFile::AddColumn (std::string name, ColumnType type)
+{
+  NS_LOG_FUNCTION (this << name << type);
+  NS_ASSERT_MSG (m_file == 0, "The columns must be added before opening the file");
+  Column column;
+  column.name = name;
+  column.type = type;
+  m_columns.push_back (column);
+}
+
+bool
+LteStatsFile::Open (std::string filename, bool binary)
+{
+  NS_LOG_FUNCTION (this << filename << binary);
+  NS_ASSERT_MSG (m_file == 0, "File already open");
+  NS_ASSERT_MSG (m_columns.size () > 0, "No columns");
+
+  std::ios_base::openmode mode = std::ios_base::out | std::ios_base::trunc;
+  if (binary)
+    {
+      mode |= std::ios_base::binary;
+    }
+  if (AsyncFileStream::IsEnabled ())
+    {
+      m_file = new AsyncFileStream (filename, mode);
+    }
+  else
+    {
+      // the buffer must be set before opening the file
+      std::ofstream *file = new std::ofstream ();
+      m_buffer.resize (g_lteStatsFileBufferSize);
+      file->rdbuf ()->pubsetbuf (&m_buffer[0], m_buffer.size ());
+      file->open (filename.c_str (), mode);
+      m_file = file;
+    }
+  if (m_file->fail ())
+    {
+      delete m_file;
+      m_file = 0;
+      return false;
+    }
+  m_binary = binary;
+
+  if (m_binary)
+    {
+      m_file->write (g_lteStatsFileMagic, sizeof (g_lteStatsFileMagic));
+      m_file->write ((const char*) &g_lteStatsFileByteOrder, sizeof (g_lteStatsFileByteOrder));
+      m_file->write ((const char*) &g_lteStatsFileVersion, sizeof (g_lteStatsFileVersion));
+      uint32_t numColumns = m_columns.size ();
+      m_file->write ((const char*) &numColumns, sizeof (numColumns));
+      for (std::vector<Column>::const_iterator it = m_columns.begin (); it != m_columns.end (); ++it)
+        {
+          uint8_t type = it->type;
+          uint32_t length = it->name.size ();
+          m_file->write ((const char*) &type, sizeof (type));
+          m_file->write ((const char*) &length, sizeof (length));
+          m_file->write (it->name.data (), length);
+        }
+    }
+  else
+    {
+      *m_file << "% ";
+      for (uint32_t i = 0; i < m_columns.size (); i++)
+        {
+          *m_file << (i > 0 ? "\t" : "") << m_columns[i].name;
+        }
+      *m_file << "\n";
+    }
+  // the file may outlive the simulation: make sure that it is complete
+  // when the simulation is destroyed
+  Simulator::ScheduleDestroy (&LteStatsFile::Flush, Ptr<LteStatsFile> (this));
+  return true;
+}
+
+void
+LteStatsFile::Flush ()
+{
+  NS_LOG_FUNCTION (this);
+  AsyncFileStream *async = dynamic_cast<AsyncFileStream *> (m_file);
+  if (async != 0)
+    {
+      async->Flush ();
+    }
+  else if (m_file != 0)
+    {
+      m_file->flush ();
+    }
+}
+
+template <typename T>
+void
+LteStatsFile::DoWriteValue (T value)
+{
+  NS_ASSERT_MSG (m_file != 0, "File not open");
+  NS_ASSERT_MSG (m_column < m_columns.size (), "Too many values in the record");
+  ColumnType type = m_columns[m_column].type;
+  char data[8];
+  switch (type)
+    {
+    case UINT8:
+      {
+        uint8_t v = static_cast<uint8_t> (value);
+        std::memcpy (data, &v, sizeof (v));
+        break;
+      }
+    case UINT16:
+      {
+        uint16_t v = static_cast<uint16_t> (value);
+        std::memcpy (data, &v, sizeof (v));
+        break;
+      }
+    case UINT32:
+      {
+        uint32_t v = static_cast<uint32_t> (value);
+        std::memcpy (data, &v, sizeof (v));
+        break;
+      }
+    case UINT64:
+      {
+        uint64_t v = static_cast<uint64_t> (value);
+        std::memcpy (data, &v, sizeof (v));
+        break;
+      }
+    case INT64:
+      {
+        int64_t v = static_cast<int64_t> (value);
+        std::memcpy (data, &v, sizeof (v));
+        break;
+      }
+    case DOUBLE:
+      {
+        double v = static_cast<double> (value);
+        std::memcpy (data, &v, sizeof (v));
+        break;
+      }
+    }
+
+  bool last = (m_column + 1 == m_columns.size ());
+  if (m_binary)
+    {
+      m_file->write (data, GetColumnWidth (type));
+    }
+  else
+    {
+      PrintValue (*m_file, type, data);
+      *m_file << (last ? '\n' : '\t');
+    }
+  m_column = last ? 0 : m_column + 1;
+}
+
+void
+LteStatsFile::WriteValue (uint64_t value)
+{
+  DoWriteValue (value);
+}
+
+void
+LteStatsFile::WriteValue (int64_t value)
+{
+  DoWriteValue (value);
+}
+
+void
+LteStatsFile::WriteValue (double value)
+{
+  DoWriteValue (value);
+}
+
+bool
+LteStatsFile::ConvertToText (std::istream& in, std::ostream& out, char separator, bool comment)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  char magic[sizeof (g_lteStatsFileMagic)];
+  uint32_t byteOrder = 0;
+  uint32_t version = 0;
+  uint32_t numColumns = 0;
+  in.read (magic, sizeof (magic));
+  in.read ((char*) &byteOrder, sizeof (byteOrder));
+  in.read ((char*) &version, sizeof (version));
+  in.read ((char*) &numColumns, sizeof (numColumns));
+  if (!in || std::memcmp (magic, g_lteStatsFileMagic, sizeof (magic)) != 0)
+    {
+      NS_LOG_ERROR ("Not a binary statistics file");
+      return false;
+    }
+  if (byteOrder != g_lteStatsFileByteOrder || version != g_lteStatsFileVersion)
+    {
+      NS_LOG_ERROR ("Unsupported byte order or version " << version);
+      return false;
+    }
+
+  std::vector<ColumnType> types;
+  uint32_t recordWidth = 0;
+  if (comment)
+    {
+      out << "% ";
+    }
+  for (uint32_t i = 0; i < numColumns; i++)
+    {
+      uint8_t type = 0;
+      uint32_t length = 0;
+      in.read ((char*) &type, sizeof (type));
+      in.read ((char*) &length, sizeof (length));
+      if (!in || type > DOUBLE)
+        {
+          NS_LOG_ERROR ("Invalid column " << i);
+          return false;
+        }
+      std::string name (length, ' ');
+      in.read (&name[0], length);
+      types.push_back (static_cast<ColumnType> (type));
+      recordWidth += GetColumnWidth (types.back ());
+      out << (i > 0 ? std::string (1, separator) : "") << name;
+    }
+  out << "\n";
+  if (!in)
+    {
+      NS_LOG_ERROR ("Truncated header");
+      return false;
+    }
+
+  std::vector<char> record (recordWidth);
+  while (in.read (&record[0], recordWidth))
+    {
+      const char* data = &record[0];
+      for (uint32_t i = 0; i < types.size (); i++)
+        {
+          if (i > 0)
+            {
+              out << separator;
+            }
+          PrintValue (out, types[i], data);
+          data += GetColumnWidth (types[i]);
+        }
+      out << "\n";
+    }
+  if (in.gcount () != 0)
+    {
+      NS_LOG_ERROR ("Truncated record");
+      return false;
+    }
+  return true;
+}
+
+} // namespace ns3
@@ -0,0 +1,160 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef LTE_STATS_FILE_H_
+#define LTE_STATS_FILE_H_
+
+#include <ns3/simple-ref-count.h>
+#include <stdint.h>
+#include <ostream>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \ingroup lte
+ *
+ * Output file of the statistics calculators. The file is opened once and
+ * written through a buffer, which is flushed when the simulation is
+ * destroyed and when the file is deleted. If the global value
+ * AsyncFileStreamsEnabled is true, the buffer is written to the file by a
+ * background thread (see AsyncFileStream).
+ *
+ * The records have a fixed list of columns. In the text format, the file
+ * starts with a "% " line of the column names, followed by one line of tab
+ * separated values per record. In the binary format, the file starts with
+ * a header describing the columns, followed by fixed-width records in the
+ * byte order of the host; ConvertToText turns it back into text.
+ */
+class LteStatsFile : public SimpleRefCount<LteStatsFile>
+{
+public:
+  /// Type of a column, which sets its width in the binary format
+  enum ColumnType
+  {
+    UINT8 = 0,
+    UINT16,
+    UINT32,
+    UINT64,
+    INT64,
+    DOUBLE
+  };
+
+  LteStatsFile ();
+  ~LteStatsFile ();
+
+  /**
+   * Add a column to the records; all the columns must be added before
+   * opening the file.
+   *
+   * \param name the name of the column
+   * \param type the type of the column
+   */
+  void AddColumn (std::string name, ColumnType type);
+
+  /**
+   * Create the file and write its header.
+   *
+   * \param filename the name of the file
+   * \param binary true for the binary format, false for the text format
+   * \return true if the file was opened
+   */
+  bool Open (std::string filename, bool binary);
+
+  /// Write the buffered records to the file
+  void Flush ();
+
+  /**
+   * Write the value of the next column of the current record; the record
+   * ends with the value of its last column. The value is converted to the
+   * type of the column.
+   *
+   * \param value the value
+   */
+  template <typename T>
+  void Write (T value);
+
+  /**
+   * Convert a file written in the binary format to the text format.
+   *
+   * \param in the binary file
+   * \param out the output stream
+   * \param separator the separator of the values
+   * \param comment if true, the line of the column names starts with "% "
+   * \return false if the input is not a valid binary file
+   */
+  static bool ConvertToText (std::istream& in, std::ostream& out, char separator, bool comment);
+
+private:
+  /**
+   * Write a value in the current column
+   * \param value the value
+   */
+  void WriteValue (uint64_t value);
+  /**
+   * Write a value in the current column
+   * \param value the value
+   */
+  void WriteValue (int64_t value);
+  /**
+   * Write a value in the current column
+   * \param value the value
+   */
+  void WriteValue (double value);
+  /**
+   * Write a value in the current column, converted to its type
+   * \param value the value
+   */
+  template <typename T>
+  void DoWriteValue (T value);
+
+  /// A column of the records
+  struct Column
+  {
+    std::string name; ///< name
+    ColumnType type; ///< type
+  };
+
+  std::vector<Column> m_columns; ///< columns of the records
+  std::vector<char> m_buffer; ///< buffer of the file
+  std::ostream *m_file; ///< the file, or 0 if it is not open
+  bool m_binary; ///< whether the file is in the binary format
+  uint32_t m_column; ///< next column of the current record
+};
+
+template <typename T>
+void
+LteStatsFile::Write (T value)
+{
+  if (!std::numeric_limits<T>::is_integer)
+    {
+      WriteValue (static_cast<double> (value));
+    }
+  else if (std::numeric_limits<T>::is_signed)
+    {
+      WriteValue (static_cast<int64_t> (value));
+    }
+  else
+    {
+      WriteValue (static_cast<uint64_t> (value));
+    }
+}
+
+} // namespace ns3
+
+#endif /* LTE_STATS_FILE_H_ */
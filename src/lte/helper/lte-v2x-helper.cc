@@ -166,6 +166,42 @@ LteV2xHelper::AssociateForV2xBroadcast (NetDeviceContainer ues, uint32_t ntransm
   return groups;
 }
 
+NetDeviceContainer
+LteV2xHelper::AssociateForV2xSharedBroadcast (Time activationTime, NetDeviceContainer ues, uint32_t ntransmitters, Ipv4Address groupAddress, uint32_t groupL2Address)
+{
+  NS_LOG_FUNCTION (this << ntransmitters << groupAddress << groupL2Address);
+  NS_ASSERT_MSG (m_lteHelper, "Sidelink activation requires LteHelper to be registered with the LteV2xHelper");
+  NS_ASSERT_MSG (ntransmitters <= ues.GetN (), "More transmitters than UEs");
+
+  // A broadcast transmitter is received by all the other UEs of the group,
+  // and a UE with a transmit bearer selects resources even without data,
+  // so only the transmitters get the bidirectional TFT
+  NetDeviceContainer txUes;
+  NetDeviceContainer rxUes;
+  for (uint32_t i = 0 ; i < ues.GetN (); i++)
+    {
+      if (i < ntransmitters)
+        {
+          txUes.Add (ues.Get (i));
+        }
+      else
+        {
+          rxUes.Add (ues.Get (i));
+        }
+    }
+  if (txUes.GetN () > 0)
+    {
+      Ptr<LteSlTft> tft = Create<LteSlTft> (LteSlTft::BIDIRECTIONAL, groupAddress, groupL2Address);
+      Simulator::Schedule (activationTime, &LteV2xHelper::DoActivateSharedSidelinkBearer, this, txUes, tft);
+    }
+  if (rxUes.GetN () > 0)
+    {
+      Ptr<LteSlTft> tft = Create<LteSlTft> (LteSlTft::RECEIVE, groupAddress, groupL2Address);
+      Simulator::Schedule (activationTime, &LteV2xHelper::DoActivateSharedSidelinkBearer, this, rxUes, tft);
+    }
+  return txUes;
+}
+
 void 
 LteV2xHelper::PrintGroups (std::vector<NetDeviceContainer> groups)
 {
@@ -219,8 +255,20 @@ LteV2xHelper::DoActivateSidelinkBearer (NetDeviceContainer ues, Ptr<LteSlTft> tf
   m_lteHelper->ActivateSidelinkBearer (ues, tft);
 }
 
+void 
+LteV2xHelper::DoActivateSharedSidelinkBearer (NetDeviceContainer ues, Ptr<LteSlTft> tft)
+{
+  NS_LOG_FUNCTION (this);
+  // the NAS of the UEs do not modify the TFT, so it does not need to be
+  // copied per UE as in LteHelper::ActivateSidelinkBearer (NetDeviceContainer, ...)
+  for (NetDeviceContainer::Iterator i = ues.Begin (); i != ues.End (); ++i)
+    {
+      m_lteHelper->ActivateSidelinkBearer (*i, tft);
+    }
+}
+
 void
-LteV2xHelper::EnablePcapInternal (std::string prefix, Ptr<SimpleNetDevice> nd, bool promiscuous, bool explicitFilename)
+LteV2xHelper::EnablePcapInternal (std::string prefix, Ptr<NetDevice> nd, bool promiscuous, bool explicitFilename)
 {
   //
   // All of the Pcap enable functions vector through here including the ones
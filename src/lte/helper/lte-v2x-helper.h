@@ -133,6 +133,20 @@ public:
    */
   std::vector < NetDeviceContainer > AssociateForV2xBroadcast (NetDeviceContainer ues, uint32_t ntransmitters);
 
+  /**
+   * Associate UEs to a single broadcast group shared by all transmitters,
+   * instead of one group per transmitter. The transmitters share one
+   * bidirectional TFT and the other UEs share one receive TFT, so the
+   * setup cost and memory are linear in the number of UEs.
+   * \param activationTime The time to setup the sidelink bearers
+   * \param ues The list of UEs deployed
+   * \param ntransmitters Number of transmitters, the first UEs of the list
+   * \param groupAddress The IP address of the group
+   * \param groupL2Address The layer 2 address of the group
+   * \return The transmitters
+   */
+  NetDeviceContainer AssociateForV2xSharedBroadcast (Time activationTime, NetDeviceContainer ues, uint32_t ntransmitters, Ipv4Address groupAddress, uint32_t groupL2Address);
+
 
   /**
    * Prints the groups starting by the transmitter
@@ -162,6 +176,14 @@ public:
    */
   void DoActivateSidelinkBearer (NetDeviceContainer ues, Ptr<LteSlTft> tft);;
 
+  /**
+   * Activation of a sidelink bearer with the same TFT on all UEs, instead
+   * of a copy per UE
+   * \param ues The list of UEs where the bearer must be activated
+   * \param tft Traffic flow template shared by the UEs
+   */
+  void DoActivateSharedSidelinkBearer (NetDeviceContainer ues, Ptr<LteSlTft> tft);
+
   /**
    * \brief Enable pcap output the indicated net device.
    *
@@ -173,7 +195,7 @@ public:
    * \param promiscuous If true capture all possible packets available at the device.
    * \param explicitFilename Treat the prefix as an explicit filename if true
    */
-  virtual void EnablePcapInternal (std::string prefix, Ptr<SimpleNetDevice> nd, bool promiscuous, bool explicitFilename);
+  virtual void EnablePcapInternal (std::string prefix, Ptr<NetDevice> nd, bool promiscuous, bool explicitFilename);
 
 
 
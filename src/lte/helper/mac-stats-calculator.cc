@@ -33,10 +33,6 @@ NS_LOG_COMPONENT_DEFINE ("MacStatsCalculator");
 NS_OBJECT_ENSURE_REGISTERED (MacStatsCalculator);
 
 MacStatsCalculator::MacStatsCalculator ()
-  : m_dlFirstWrite (true),
-    m_ulFirstWrite (true),
-    m_slUeFirstWrite (true),
-    m_slSchUeFirstWrite (true)
 {
   NS_LOG_FUNCTION (this);
 
@@ -133,41 +129,38 @@ MacStatsCalculator::DlScheduling (uint16_t cellId, uint64_t imsi, DlSchedulingCa
 		  dlSchedulingCallbackInfo.rnti << (uint32_t) dlSchedulingCallbackInfo.mcsTb1 << dlSchedulingCallbackInfo.sizeTb1 << (uint32_t) dlSchedulingCallbackInfo.mcsTb2 << dlSchedulingCallbackInfo.sizeTb2);
   NS_LOG_INFO ("Write DL Mac Stats in " << GetDlOutputFilename ().c_str ());
 
-  std::ofstream outFile;
-  if ( m_dlFirstWrite == true )
+  if (m_dlFile == 0)
     {
-      outFile.open (GetDlOutputFilename ().c_str ());
-      if (!outFile.is_open ())
+      Ptr<LteStatsFile> file = Create<LteStatsFile> ();
+      file->AddColumn ("time", LteStatsFile::DOUBLE);
+      file->AddColumn ("cellId", LteStatsFile::UINT16);
+      file->AddColumn ("IMSI", LteStatsFile::UINT64);
+      file->AddColumn ("frame", LteStatsFile::UINT32);
+      file->AddColumn ("sframe", LteStatsFile::UINT32);
+      file->AddColumn ("RNTI", LteStatsFile::UINT16);
+      file->AddColumn ("mcsTb1", LteStatsFile::UINT8);
+      file->AddColumn ("sizeTb1", LteStatsFile::UINT16);
+      file->AddColumn ("mcsTb2", LteStatsFile::UINT8);
+      file->AddColumn ("sizeTb2", LteStatsFile::UINT16);
+      file->AddColumn ("ccId", LteStatsFile::UINT8);
+      if (!OpenOutputFile (file, GetDlOutputFilename ()))
         {
-          NS_LOG_ERROR ("Can't open file " << GetDlOutputFilename ().c_str ());
-          return;
-        }
-      m_dlFirstWrite = false;
-      outFile << "% time\tcellId\tIMSI\tframe\tsframe\tRNTI\tmcsTb1\tsizeTb1\tmcsTb2\tsizeTb2\tccId";
-      outFile << std::endl;
-    }
-  else
-    {
-      outFile.open (GetDlOutputFilename ().c_str (),  std::ios_base::app);
-      if (!outFile.is_open ())
-        {
-          NS_LOG_ERROR ("Can't open file " << GetDlOutputFilename ().c_str ());
           return;
         }
+      m_dlFile = file;
     }
 
-  outFile << Simulator::Now ().GetNanoSeconds () / (double) 1e9 << "\t";
-  outFile << (uint32_t) cellId << "\t";
-  outFile << imsi << "\t";
-  outFile << dlSchedulingCallbackInfo.frameNo << "\t";
-  outFile << dlSchedulingCallbackInfo.subframeNo << "\t";
-  outFile << dlSchedulingCallbackInfo.rnti << "\t";
-  outFile << (uint32_t) dlSchedulingCallbackInfo.mcsTb1 << "\t";
-  outFile << dlSchedulingCallbackInfo.sizeTb1 << "\t";
-  outFile << (uint32_t) dlSchedulingCallbackInfo.mcsTb2 << "\t";
-  outFile << dlSchedulingCallbackInfo.sizeTb2 << "\t";
-  outFile << (uint32_t) dlSchedulingCallbackInfo.componentCarrierId << std::endl;
-  outFile.close ();
+  m_dlFile->Write (Simulator::Now ().GetNanoSeconds () / (double) 1e9);
+  m_dlFile->Write (cellId);
+  m_dlFile->Write (imsi);
+  m_dlFile->Write (dlSchedulingCallbackInfo.frameNo);
+  m_dlFile->Write (dlSchedulingCallbackInfo.subframeNo);
+  m_dlFile->Write (dlSchedulingCallbackInfo.rnti);
+  m_dlFile->Write (dlSchedulingCallbackInfo.mcsTb1);
+  m_dlFile->Write (dlSchedulingCallbackInfo.sizeTb1);
+  m_dlFile->Write (dlSchedulingCallbackInfo.mcsTb2);
+  m_dlFile->Write (dlSchedulingCallbackInfo.sizeTb2);
+  m_dlFile->Write (dlSchedulingCallbackInfo.componentCarrierId);
 }
 
 void
@@ -177,39 +170,34 @@ MacStatsCalculator::UlScheduling (uint16_t cellId, uint64_t imsi, uint32_t frame
   NS_LOG_FUNCTION (this << cellId << imsi << frameNo << subframeNo << rnti << (uint32_t) mcsTb << size);
   NS_LOG_INFO ("Write UL Mac Stats in " << GetUlOutputFilename ().c_str ());
 
-  std::ofstream outFile;
-  if ( m_ulFirstWrite == true )
-    {
-      outFile.open (GetUlOutputFilename ().c_str ());
-      if (!outFile.is_open ())
-        {
-          NS_LOG_ERROR ("Can't open file " << GetUlOutputFilename ().c_str ());
-          return;
-        }
-      m_ulFirstWrite = false;
-      outFile << "% time\tcellId\tIMSI\tframe\tsframe\tRNTI\tmcs\tsize\tccId";
-      outFile << std::endl;
-    }
-  else
+  if (m_ulFile == 0)
     {
-      outFile.open (GetUlOutputFilename ().c_str (),  std::ios_base::app);
-      if (!outFile.is_open ())
+      Ptr<LteStatsFile> file = Create<LteStatsFile> ();
+      file->AddColumn ("time", LteStatsFile::DOUBLE);
+      file->AddColumn ("cellId", LteStatsFile::UINT16);
+      file->AddColumn ("IMSI", LteStatsFile::UINT64);
+      file->AddColumn ("frame", LteStatsFile::UINT32);
+      file->AddColumn ("sframe", LteStatsFile::UINT32);
+      file->AddColumn ("RNTI", LteStatsFile::UINT16);
+      file->AddColumn ("mcs", LteStatsFile::UINT8);
+      file->AddColumn ("size", LteStatsFile::UINT16);
+      file->AddColumn ("ccId", LteStatsFile::UINT8);
+      if (!OpenOutputFile (file, GetUlOutputFilename ()))
         {
-          NS_LOG_ERROR ("Can't open file " << GetUlOutputFilename ().c_str ());
           return;
         }
+      m_ulFile = file;
     }
 
-  outFile << Simulator::Now ().GetNanoSeconds () / (double) 1e9 << "\t";
-  outFile << (uint32_t) cellId << "\t";
-  outFile << imsi << "\t";
-  outFile << frameNo << "\t";
-  outFile << subframeNo << "\t";
-  outFile << rnti << "\t";
-  outFile << (uint32_t) mcsTb << "\t";
-  outFile << size << "\t";
-  outFile << (uint32_t) componentCarrierId << std::endl;
-  outFile.close ();
+  m_ulFile->Write (Simulator::Now ().GetNanoSeconds () / (double) 1e9);
+  m_ulFile->Write (cellId);
+  m_ulFile->Write (imsi);
+  m_ulFile->Write (frameNo);
+  m_ulFile->Write (subframeNo);
+  m_ulFile->Write (rnti);
+  m_ulFile->Write (mcsTb);
+  m_ulFile->Write (size);
+  m_ulFile->Write (componentCarrierId);
 }
 
 void
@@ -218,46 +206,48 @@ MacStatsCalculator::SlUeScheduling (SlUeMacStatParameters params)
   NS_LOG_FUNCTION (this << params.m_cellId << params.m_imsi << params.m_frameNo << params.m_subframeNo << params.m_rnti << (uint32_t) params.m_mcs << params.m_pscchRi << params.m_pscchFrame1 << params.m_pscchSubframe1 << params.m_pscchFrame2 << params.m_pscchSubframe2 << params.m_psschTxStartRB << params.m_psschTxLengthRB << params.m_psschItrp);
   NS_LOG_INFO ("Write SL UE Mac Stats in " << GetSlUeOutputFilename ().c_str ());
 
-  std::ofstream outFile;
-  if ( m_slUeFirstWrite == true )
+  if (m_slUeFile == 0)
     {
-      outFile.open (GetSlUeOutputFilename ().c_str ());
-      if (!outFile.is_open ())
+      Ptr<LteStatsFile> file = Create<LteStatsFile> ();
+      file->AddColumn ("time", LteStatsFile::UINT32);
+      file->AddColumn ("cellId", LteStatsFile::UINT16);
+      file->AddColumn ("IMSI", LteStatsFile::UINT64);
+      file->AddColumn ("RNTI", LteStatsFile::UINT16);
+      file->AddColumn ("frame", LteStatsFile::UINT32);
+      file->AddColumn ("sframe", LteStatsFile::UINT32);
+      file->AddColumn ("pscchRi", LteStatsFile::UINT16);
+      file->AddColumn ("pscchF1", LteStatsFile::UINT32);
+      file->AddColumn ("pscchSF1", LteStatsFile::UINT32);
+      file->AddColumn ("pscchF2", LteStatsFile::UINT32);
+      file->AddColumn ("pscchSF2", LteStatsFile::UINT32);
+      file->AddColumn ("mcs", LteStatsFile::UINT8);
+      file->AddColumn ("TBS", LteStatsFile::UINT16);
+      file->AddColumn ("psschRB", LteStatsFile::UINT16);
+      file->AddColumn ("psschLen", LteStatsFile::UINT16);
+      file->AddColumn ("pssch_itrp", LteStatsFile::UINT16);
+      if (!OpenOutputFile (file, GetSlUeOutputFilename ()))
         {
-          NS_LOG_ERROR ("Can't open file " << GetSlUeOutputFilename ().c_str ());
-          return;
-        }
-      m_slUeFirstWrite = false;
-      outFile << "% time\tcellId\tIMSI\tRNTI\tframe\tsframe\tpscchRi\tpscchF1\tpscchSF1\tpscchF2\tpscchSF2\tmcs\tTBS\tpsschRB\tpsschLen\tpssch_itrp";
-      outFile << std::endl;
-    }
-  else
-    {
-      outFile.open (GetSlUeOutputFilename ().c_str (),  std::ios_base::app);
-      if (!outFile.is_open ())
-        {
-          NS_LOG_ERROR ("Can't open file " << GetSlUeOutputFilename ().c_str ());
           return;
         }
+      m_slUeFile = file;
     }
 
-  outFile << (uint32_t) params.m_timestamp << "\t";
-  outFile << (uint32_t) params.m_cellId << "\t";
-  outFile << params.m_imsi << "\t";
-  outFile << params.m_rnti << "\t";
-  outFile << params.m_frameNo << "\t";
-  outFile << params.m_subframeNo << "\t";
-  outFile << params.m_pscchRi << "\t";
-  outFile << params.m_pscchFrame1 << "\t";
-  outFile << params.m_pscchSubframe1 << "\t";
-  outFile << params.m_pscchFrame2 << "\t";
-  outFile << params.m_pscchSubframe2 << "\t";
-  outFile << (uint32_t) params.m_mcs << "\t";
-  outFile << params.m_tbSize << "\t";
-  outFile << params.m_psschTxStartRB << "\t";
-  outFile << params.m_psschTxLengthRB << "\t";
-  outFile << params.m_psschItrp << std::endl;
-  outFile.close ();
+  m_slUeFile->Write (params.m_timestamp);
+  m_slUeFile->Write (params.m_cellId);
+  m_slUeFile->Write (params.m_imsi);
+  m_slUeFile->Write (params.m_rnti);
+  m_slUeFile->Write (params.m_frameNo);
+  m_slUeFile->Write (params.m_subframeNo);
+  m_slUeFile->Write (params.m_pscchRi);
+  m_slUeFile->Write (params.m_pscchFrame1);
+  m_slUeFile->Write (params.m_pscchSubframe1);
+  m_slUeFile->Write (params.m_pscchFrame2);
+  m_slUeFile->Write (params.m_pscchSubframe2);
+  m_slUeFile->Write (params.m_mcs);
+  m_slUeFile->Write (params.m_tbSize);
+  m_slUeFile->Write (params.m_psschTxStartRB);
+  m_slUeFile->Write (params.m_psschTxLengthRB);
+  m_slUeFile->Write (params.m_psschItrp);
 }
 
 void
@@ -266,44 +256,44 @@ MacStatsCalculator::SlSharedChUeScheduling (SlUeMacStatParameters params)
   NS_LOG_FUNCTION (this << params.m_cellId << params.m_imsi << params.m_rnti << params.m_frameNo << params.m_subframeNo << (uint32_t) params.m_mcs << params.m_tbSize << params.m_psschTxStartRB << params.m_psschTxLengthRB);
   NS_LOG_INFO ("Write SL Shared Channel UE Mac Stats in " << GetSlSchUeOutputFilename ().c_str ());
 
-  std::ofstream outFile;
-  if ( m_slSchUeFirstWrite == true )
-    {
-      outFile.open (GetSlSchUeOutputFilename ().c_str ());
-      if (!outFile.is_open ())
-        {
-          NS_LOG_ERROR ("Can't open file " << GetSlSchUeOutputFilename ().c_str ());
-          return;
-        }
-      m_slSchUeFirstWrite = false;
-      outFile << "% time\tcellId\tIMSI\tRNTI\tSlPframe\tSlPsframe\tSchStartframe\tSchSsframe\tframe\tsframe\tmcs\tTBS\tpsschRB\tpsschLen";
-      outFile << std::endl;
-    }
-  else
+  if (m_slSchUeFile == 0)
     {
-      outFile.open (GetSlSchUeOutputFilename ().c_str (),  std::ios_base::app);
-      if (!outFile.is_open ())
+      Ptr<LteStatsFile> file = Create<LteStatsFile> ();
+      file->AddColumn ("time", LteStatsFile::UINT32);
+      file->AddColumn ("cellId", LteStatsFile::UINT16);
+      file->AddColumn ("IMSI", LteStatsFile::UINT64);
+      file->AddColumn ("RNTI", LteStatsFile::UINT16);
+      file->AddColumn ("SlPframe", LteStatsFile::UINT32);
+      file->AddColumn ("SlPsframe", LteStatsFile::UINT32);
+      file->AddColumn ("SchStartframe", LteStatsFile::UINT32);
+      file->AddColumn ("SchSsframe", LteStatsFile::UINT32);
+      file->AddColumn ("frame", LteStatsFile::UINT32);
+      file->AddColumn ("sframe", LteStatsFile::UINT32);
+      file->AddColumn ("mcs", LteStatsFile::UINT8);
+      file->AddColumn ("TBS", LteStatsFile::UINT16);
+      file->AddColumn ("psschRB", LteStatsFile::UINT16);
+      file->AddColumn ("psschLen", LteStatsFile::UINT16);
+      if (!OpenOutputFile (file, GetSlSchUeOutputFilename ()))
         {
-          NS_LOG_ERROR ("Can't open file " << GetSlSchUeOutputFilename ().c_str ());
           return;
         }
+      m_slSchUeFile = file;
     }
 
-  outFile << (uint32_t) params.m_timestamp << "\t";
-  outFile << (uint32_t) params.m_cellId << "\t";
-  outFile << params.m_imsi << "\t";
-  outFile << params.m_rnti << "\t";
-  outFile << params.m_frameNo << "\t";
-  outFile << params.m_subframeNo << "\t";
-  outFile << params.m_psschFrameStart << "\t";
-  outFile << params.m_psschSubframeStart << "\t";
-  outFile << params.m_psschFrame << "\t";
-  outFile << params.m_psschSubframe << "\t";
-  outFile << (uint32_t) params.m_mcs << "\t";
-  outFile << params.m_tbSize << "\t";
-  outFile << params.m_psschTxStartRB << "\t";
-  outFile << params.m_psschTxLengthRB << std::endl;
-  outFile.close ();
+  m_slSchUeFile->Write (params.m_timestamp);
+  m_slSchUeFile->Write (params.m_cellId);
+  m_slSchUeFile->Write (params.m_imsi);
+  m_slSchUeFile->Write (params.m_rnti);
+  m_slSchUeFile->Write (params.m_frameNo);
+  m_slSchUeFile->Write (params.m_subframeNo);
+  m_slSchUeFile->Write (params.m_psschFrameStart);
+  m_slSchUeFile->Write (params.m_psschSubframeStart);
+  m_slSchUeFile->Write (params.m_psschFrame);
+  m_slSchUeFile->Write (params.m_psschSubframe);
+  m_slSchUeFile->Write (params.m_mcs);
+  m_slSchUeFile->Write (params.m_tbSize);
+  m_slSchUeFile->Write (params.m_psschTxStartRB);
+  m_slSchUeFile->Write (params.m_psschTxLengthRB);
 }
 
 void
@@ -199,36 +199,24 @@ public:
 
 private:
   /**
-   * When writing DL MAC statistics first time to file,
-   * columns description is added. Then next lines are
-   * appended to file. This value is true if output
-   * files have not been opened yet
+   * Output file of the DL MAC statistics, opened at the first write
    */
-  bool m_dlFirstWrite;
+  Ptr<LteStatsFile> m_dlFile;
 
   /**
-   * When writing UL MAC statistics first time to file,
-   * columns description is added. Then next lines are
-   * appended to file. This value is true if output
-   * files have not been opened yet
+   * Output file of the UL MAC statistics, opened at the first write
    */
-  bool m_ulFirstWrite;
+  Ptr<LteStatsFile> m_ulFile;
 
   /**
-   * When writing SL UE MAC statistics first time to file,
-   * columns description is added. Then next lines are
-   * appended to file. This value is true if output
-   * files have not been opened yet
+   * Output file of the SL UE MAC statistics, opened at the first write
    */
-  bool m_slUeFirstWrite;
+  Ptr<LteStatsFile> m_slUeFile;
 
   /**
-   * When writing SL Shared Channel UE MAC statistics first time to file,
-   * columns description is added. Then next lines are
-   * appended to file. This value is true if output
-   * files have not been opened yet
+   * Output file of the SL Shared Channel UE MAC statistics, opened at the first write
    */
-  bool m_slSchUeFirstWrite;
+  Ptr<LteStatsFile> m_slSchUeFile;
 
 };
 
@@ -34,10 +34,6 @@ NS_LOG_COMPONENT_DEFINE ("PhyRxStatsCalculator");
 NS_OBJECT_ENSURE_REGISTERED (PhyRxStatsCalculator);
 
 PhyRxStatsCalculator::PhyRxStatsCalculator ()
-  : m_dlRxFirstWrite (true),
-    m_ulRxFirstWrite (true),
-    m_slRxFirstWrite (true),
-    m_slPscchRxFirstWrite (true)
 {
   NS_LOG_FUNCTION (this);
 
@@ -133,43 +129,40 @@ PhyRxStatsCalculator::DlPhyReception (PhyReceptionStatParameters params)
   NS_LOG_FUNCTION (this << params.m_cellId << params.m_imsi << params.m_timestamp << params.m_rnti << params.m_layer << params.m_mcs << params.m_size << params.m_rv << params.m_ndi << params.m_correctness);
   NS_LOG_INFO ("Write DL Rx Phy Stats in " << GetDlRxOutputFilename ().c_str ());
 
-  std::ofstream outFile;
-  if ( m_dlRxFirstWrite == true )
+  if (m_dlRxFile == 0)
     {
-      outFile.open (GetDlRxOutputFilename ().c_str ());
-      if (!outFile.is_open ())
+      Ptr<LteStatsFile> file = Create<LteStatsFile> ();
+      file->AddColumn ("time", LteStatsFile::INT64);
+      file->AddColumn ("cellId", LteStatsFile::UINT16);
+      file->AddColumn ("IMSI", LteStatsFile::UINT64);
+      file->AddColumn ("RNTI", LteStatsFile::UINT16);
+      file->AddColumn ("txMode", LteStatsFile::UINT8);
+      file->AddColumn ("layer", LteStatsFile::UINT8);
+      file->AddColumn ("mcs", LteStatsFile::UINT8);
+      file->AddColumn ("size", LteStatsFile::UINT16);
+      file->AddColumn ("rv", LteStatsFile::UINT8);
+      file->AddColumn ("ndi", LteStatsFile::UINT8);
+      file->AddColumn ("correct", LteStatsFile::UINT8);
+      file->AddColumn ("ccId", LteStatsFile::UINT8);
+      if (!OpenOutputFile (file, GetDlRxOutputFilename ()))
         {
-          NS_LOG_ERROR ("Can't open file " << GetDlRxOutputFilename ().c_str ());
-          return;
-        }
-      m_dlRxFirstWrite = false;
-      outFile << "% time\tcellId\tIMSI\tRNTI\ttxMode\tlayer\tmcs\tsize\trv\tndi\tcorrect\tccId";
-      outFile << std::endl;
-    }
-  else
-    {
-      outFile.open (GetDlRxOutputFilename ().c_str (),  std::ios_base::app);
-      if (!outFile.is_open ())
-        {
-          NS_LOG_ERROR ("Can't open file " << GetDlRxOutputFilename ().c_str ());
           return;
         }
+      m_dlRxFile = file;
     }
 
-//   outFile << Simulator::Now ().GetNanoSeconds () / (double) 1e9 << "\t";
-  outFile << params.m_timestamp << "\t";
-  outFile << (uint32_t) params.m_cellId << "\t";
-  outFile << params.m_imsi << "\t";
-  outFile << params.m_rnti << "\t";
-  outFile << (uint32_t) params.m_txMode << "\t";
-  outFile << (uint32_t) params.m_layer << "\t";
-  outFile << (uint32_t) params.m_mcs << "\t";
-  outFile << params.m_size << "\t";
-  outFile << (uint32_t) params.m_rv << "\t";
-  outFile << (uint32_t) params.m_ndi << "\t";
-  outFile << (uint32_t) params.m_correctness << "\t";
-  outFile << (uint32_t) params.m_ccId << std::endl;
-  outFile.close ();
+  m_dlRxFile->Write (params.m_timestamp);
+  m_dlRxFile->Write (params.m_cellId);
+  m_dlRxFile->Write (params.m_imsi);
+  m_dlRxFile->Write (params.m_rnti);
+  m_dlRxFile->Write (params.m_txMode);
+  m_dlRxFile->Write (params.m_layer);
+  m_dlRxFile->Write (params.m_mcs);
+  m_dlRxFile->Write (params.m_size);
+  m_dlRxFile->Write (params.m_rv);
+  m_dlRxFile->Write (params.m_ndi);
+  m_dlRxFile->Write (params.m_correctness);
+  m_dlRxFile->Write (params.m_ccId);
 }
 
 void
@@ -178,42 +171,38 @@ PhyRxStatsCalculator::UlPhyReception (PhyReceptionStatParameters params)
   NS_LOG_FUNCTION (this << params.m_cellId << params.m_imsi << params.m_timestamp << params.m_rnti << params.m_layer << params.m_mcs << params.m_size << params.m_rv << params.m_ndi << params.m_correctness);
   NS_LOG_INFO ("Write UL Rx Phy Stats in " << GetUlRxOutputFilename ().c_str ());
 
-  std::ofstream outFile;
-  if ( m_ulRxFirstWrite == true )
+  if (m_ulRxFile == 0)
     {
-      outFile.open (GetUlRxOutputFilename ().c_str ());
-      if (!outFile.is_open ())
+      Ptr<LteStatsFile> file = Create<LteStatsFile> ();
+      file->AddColumn ("time", LteStatsFile::INT64);
+      file->AddColumn ("cellId", LteStatsFile::UINT16);
+      file->AddColumn ("IMSI", LteStatsFile::UINT64);
+      file->AddColumn ("RNTI", LteStatsFile::UINT16);
+      file->AddColumn ("layer", LteStatsFile::UINT8);
+      file->AddColumn ("mcs", LteStatsFile::UINT8);
+      file->AddColumn ("size", LteStatsFile::UINT16);
+      file->AddColumn ("rv", LteStatsFile::UINT8);
+      file->AddColumn ("ndi", LteStatsFile::UINT8);
+      file->AddColumn ("correct", LteStatsFile::UINT8);
+      file->AddColumn ("ccId", LteStatsFile::UINT8);
+      if (!OpenOutputFile (file, GetUlRxOutputFilename ()))
         {
-          NS_LOG_ERROR ("Can't open file " << GetUlRxOutputFilename ().c_str ());
-          return;
-        }
-      m_ulRxFirstWrite = false;
-      outFile << "% time\tcellId\tIMSI\tRNTI\tlayer\tmcs\tsize\trv\tndi\tcorrect\tccId";
-      outFile << std::endl;
-    }
-  else
-    {
-      outFile.open (GetUlRxOutputFilename ().c_str (),  std::ios_base::app);
-      if (!outFile.is_open ())
-        {
-          NS_LOG_ERROR ("Can't open file " << GetUlRxOutputFilename ().c_str ());
           return;
         }
+      m_ulRxFile = file;
     }
 
-//   outFile << Simulator::Now ().GetNanoSeconds () / (double) 1e9 << "\t";
-  outFile << params.m_timestamp << "\t";
-  outFile << (uint32_t) params.m_cellId << "\t";
-  outFile << params.m_imsi << "\t";
-  outFile << params.m_rnti << "\t";
-  outFile << (uint32_t) params.m_layer << "\t";
-  outFile << (uint32_t) params.m_mcs << "\t";
-  outFile << params.m_size << "\t";
-  outFile << (uint32_t) params.m_rv << "\t";
-  outFile << (uint32_t) params.m_ndi << "\t";
-  outFile << (uint32_t) params.m_correctness << "\t";
-  outFile << (uint32_t) params.m_ccId <<std::endl;
-  outFile.close ();
+  m_ulRxFile->Write (params.m_timestamp);
+  m_ulRxFile->Write (params.m_cellId);
+  m_ulRxFile->Write (params.m_imsi);
+  m_ulRxFile->Write (params.m_rnti);
+  m_ulRxFile->Write (params.m_layer);
+  m_ulRxFile->Write (params.m_mcs);
+  m_ulRxFile->Write (params.m_size);
+  m_ulRxFile->Write (params.m_rv);
+  m_ulRxFile->Write (params.m_ndi);
+  m_ulRxFile->Write (params.m_correctness);
+  m_ulRxFile->Write (params.m_ccId);
 }
 
 void
@@ -222,20 +211,36 @@ PhyRxStatsCalculator::SlPhyReception (PhyReceptionStatParameters params)
   NS_LOG_FUNCTION (this << params.m_cellId << params.m_imsi << params.m_timestamp << params.m_rnti << params.m_layer << params.m_mcs << params.m_size << params.m_rv << params.m_ndi << params.m_correctness);
   NS_LOG_INFO ("Write SL Rx Phy Stats in " << GetSlRxOutputFilename ().c_str ());
 
-  std::ofstream outFile;
-  if ( m_slRxFirstWrite == true )
+  if (m_slRxFile == 0)
     {
-      outFile.open (GetSlRxOutputFilename ().c_str ());
-      if (!outFile.is_open ())
+      Ptr<LteStatsFile> file = Create<LteStatsFile> ();
+      file->AddColumn ("time", LteStatsFile::INT64);
+      file->AddColumn ("cellId", LteStatsFile::UINT16);
+      file->AddColumn ("IMSI", LteStatsFile::UINT64);
+      file->AddColumn ("RNTI", LteStatsFile::UINT16);
+      file->AddColumn ("layer", LteStatsFile::UINT8);
+      file->AddColumn ("mcs", LteStatsFile::UINT8);
+      file->AddColumn ("size", LteStatsFile::UINT16);
+      file->AddColumn ("rv", LteStatsFile::UINT8);
+      file->AddColumn ("ndi", LteStatsFile::UINT8);
+      file->AddColumn ("correct", LteStatsFile::UINT8);
+      if (!OpenOutputFile (file, GetSlRxOutputFilename ()))
         {
-          NS_LOG_ERROR ("Can't open file " << GetSlRxOutputFilename ().c_str ());
           return;
         }
-      m_slRxFirstWrite = false;
-
-      outFile.open (GetSlRxOutputFilename ().c_str (),  std::ios_base::app);
-          NS_LOG_ERROR ("Can't open file " << GetSlRxOutputFilename ().c_str ());
+      m_slRxFile = file;
     }
+
+  m_slRxFile->Write (params.m_timestamp);
+  m_slRxFile->Write (params.m_cellId);
+  m_slRxFile->Write (params.m_imsi);
+  m_slRxFile->Write (params.m_rnti);
+  m_slRxFile->Write (params.m_layer);
+  m_slRxFile->Write (params.m_mcs);
+  m_slRxFile->Write (params.m_size);
+  m_slRxFile->Write (params.m_rv);
+  m_slRxFile->Write (params.m_ndi);
+  m_slRxFile->Write (params.m_correctness);
 }
 
 void
@@ -244,43 +249,28 @@ PhyRxStatsCalculator::SlPscchReception (PhyReceptionStatParameters params)
   NS_LOG_FUNCTION (this << params.m_cellId << params.m_imsi << params.m_timestamp << params.m_rnti << params.m_layer << params.m_mcs << params.m_size << params.m_rv << params.m_ndi << params.m_correctness);
   NS_LOG_INFO ("Write SL Rx PSCCH Stats in " << GetSlPscchRxOutputFilename ().c_str ());
 
-  std::ofstream outFile;
-  if ( m_slPscchRxFirstWrite == true )
-    {
-      outFile.open (GetSlPscchRxOutputFilename ().c_str ());
-      if (!outFile.is_open ())
-        {
-          NS_LOG_ERROR ("Can't open file " << GetSlPscchRxOutputFilename ().c_str ());
-          return;
-        }
-      m_slPscchRxFirstWrite = false;
-      outFile << "% time\tcellId\tIMSI\tRNTI\tlayer\tcorrect";
-      //outFile << "% time\tcellId\tIMSI\tRNTI\tlayer\tmcs\tsize\trbStart\trbLen\tcorrect";
-
-      outFile << std::endl;
-    }
-  else
+  if (m_slPscchRxFile == 0)
     {
-      outFile.open (GetSlPscchRxOutputFilename ().c_str (),  std::ios_base::app);
-      if (!outFile.is_open ())
+      Ptr<LteStatsFile> file = Create<LteStatsFile> ();
+      file->AddColumn ("time", LteStatsFile::INT64);
+      file->AddColumn ("cellId", LteStatsFile::UINT16);
+      file->AddColumn ("IMSI", LteStatsFile::UINT64);
+      file->AddColumn ("RNTI", LteStatsFile::UINT16);
+      file->AddColumn ("layer", LteStatsFile::UINT8);
+      file->AddColumn ("correct", LteStatsFile::UINT8);
+      if (!OpenOutputFile (file, GetSlPscchRxOutputFilename ()))
         {
-          NS_LOG_ERROR ("Can't open file " << GetSlPscchRxOutputFilename ().c_str ());
           return;
         }
+      m_slPscchRxFile = file;
     }
 
-//   outFile << Simulator::Now ().GetNanoSeconds () / (double) 1e9 << "\t";
-  outFile << params.m_timestamp << "\t";
-  outFile << (uint32_t) params.m_cellId << "\t";
-  outFile << params.m_imsi << "\t";
-  outFile << params.m_rnti << "\t";
-  outFile << (uint32_t) params.m_layer << "\t";
-  //outFile << (uint32_t) params.m_mcs << "\t";
-  //outFile << params.m_size << "\t";
-  //outFile << (uint32_t) params.m_rv << "\t"; // This is used for the rbStart
-  //outFile << (uint32_t) params.m_ndi << "\t";// This is used for the rbLen
-  outFile << (uint32_t) params.m_correctness << std::endl;
-  outFile.close ();
+  m_slPscchRxFile->Write (params.m_timestamp);
+  m_slPscchRxFile->Write (params.m_cellId);
+  m_slPscchRxFile->Write (params.m_imsi);
+  m_slPscchRxFile->Write (params.m_rnti);
+  m_slPscchRxFile->Write (params.m_layer);
+  m_slPscchRxFile->Write (params.m_correctness);
 }
 
 void
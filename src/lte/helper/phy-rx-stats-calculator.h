@@ -187,36 +187,24 @@ public:
 private:
 
   /**
-   * When writing DL RX PHY statistics first time to file,
-   * columns description is added. Then next lines are
-   * appended to file. This value is true if output
-   * files have not been opened yet
+   * Output file of the DL RX PHY statistics, opened at the first write
    */
-  bool m_dlRxFirstWrite;
+  Ptr<LteStatsFile> m_dlRxFile;
 
   /**
-   * When writing UL RX PHY statistics first time to file,
-   * columns description is added. Then next lines are
-   * appended to file. This value is true if output
-   * files have not been opened yet
+   * Output file of the UL RX PHY statistics, opened at the first write
    */
-  bool m_ulRxFirstWrite;
+  Ptr<LteStatsFile> m_ulRxFile;
 
   /**
-   * When writing SL RX PHY statistics first time to file,
-   * columns description is added. Then next lines are
-   * appended to file. This value is true if output
-   * files have not been opened yet
+   * Output file of the SL RX PHY statistics, opened at the first write
    */
-  bool m_slRxFirstWrite;
+  Ptr<LteStatsFile> m_slRxFile;
   
   /**
-   * When writing SL RX PSCCH statistics first time to file,
-   * columns description is added. Then next lines are
-   * appended to file. This value is true if output
-   * files have not been opened yet
+   * Output file of the SL RX PSCCH statistics, opened at the first write
    */
-  bool m_slPscchRxFirstWrite;
+  Ptr<LteStatsFile> m_slPscchRxFile;
 
 };
 
@@ -33,9 +33,6 @@ NS_LOG_COMPONENT_DEFINE ("PhyTxStatsCalculator");
 NS_OBJECT_ENSURE_REGISTERED (PhyTxStatsCalculator);
 
 PhyTxStatsCalculator::PhyTxStatsCalculator ()
-  : m_dlTxFirstWrite (true),
-    m_ulTxFirstWrite (true),
-    m_slTxFirstWrite (true)
 {
   NS_LOG_FUNCTION (this);
 
@@ -114,43 +111,37 @@ PhyTxStatsCalculator::DlPhyTransmission (PhyTransmissionStatParameters params)
   NS_LOG_FUNCTION (this << params.m_cellId << params.m_imsi << params.m_timestamp << params.m_rnti << params.m_layer << params.m_mcs << params.m_size << params.m_rv << params.m_ndi);
   NS_LOG_INFO ("Write DL Tx Phy Stats in " << GetDlTxOutputFilename ().c_str ());
 
-  std::ofstream outFile;
-  if ( m_dlTxFirstWrite == true )
+  if (m_dlTxFile == 0)
     {
-      outFile.open (GetDlOutputFilename ().c_str ());
-      if (!outFile.is_open ())
+      Ptr<LteStatsFile> file = Create<LteStatsFile> ();
+      file->AddColumn ("time", LteStatsFile::INT64);
+      file->AddColumn ("cellId", LteStatsFile::UINT16);
+      file->AddColumn ("IMSI", LteStatsFile::UINT64);
+      file->AddColumn ("RNTI", LteStatsFile::UINT16);
+      file->AddColumn ("layer", LteStatsFile::UINT8);
+      file->AddColumn ("mcs", LteStatsFile::UINT8);
+      file->AddColumn ("size", LteStatsFile::UINT16);
+      file->AddColumn ("rv", LteStatsFile::UINT8);
+      file->AddColumn ("ndi", LteStatsFile::UINT8);
+      file->AddColumn ("ccId", LteStatsFile::UINT8);
+      if (!OpenOutputFile (file, GetDlTxOutputFilename ()))
         {
-          NS_LOG_ERROR ("Can't open file " << GetDlTxOutputFilename ().c_str ());
-          return;
-        }
-      m_dlTxFirstWrite = false;
-      //outFile << "% time\tcellId\tIMSI\tRNTI\tlayer\tmcs\tsize\trv\tndi"; // txMode is not available at dl tx side
-      outFile << "% time\tcellId\tIMSI\tRNTI\tlayer\tmcs\tsize\trv\tndi\tccId";
-      outFile << std::endl;
-    }
-  else
-    {
-      outFile.open (GetDlTxOutputFilename ().c_str (),  std::ios_base::app);
-      if (!outFile.is_open ())
-        {
-          NS_LOG_ERROR ("Can't open file " << GetDlTxOutputFilename ().c_str ());
           return;
         }
+      m_dlTxFile = file;
     }
 
-//   outFile << Simulator::Now ().GetNanoSeconds () / (double) 1e9 << "\t";
-  outFile << params.m_timestamp << "\t";
-  outFile << (uint32_t) params.m_cellId << "\t";
-  outFile << params.m_imsi << "\t";
-  outFile << params.m_rnti << "\t";
-  //outFile << (uint32_t) params.m_txMode << "\t"; // txMode is not available at dl tx side
-  outFile << (uint32_t) params.m_layer << "\t";
-  outFile << (uint32_t) params.m_mcs << "\t";
-  outFile << params.m_size << "\t";
-  outFile << (uint32_t) params.m_rv << "\t";
-  outFile << (uint32_t) params.m_ndi << "\t";
-  outFile << (uint32_t) params.m_ccId << std::endl;
-  outFile.close ();
+  // txMode is not available at dl tx side
+  m_dlTxFile->Write (params.m_timestamp);
+  m_dlTxFile->Write (params.m_cellId);
+  m_dlTxFile->Write (params.m_imsi);
+  m_dlTxFile->Write (params.m_rnti);
+  m_dlTxFile->Write (params.m_layer);
+  m_dlTxFile->Write (params.m_mcs);
+  m_dlTxFile->Write (params.m_size);
+  m_dlTxFile->Write (params.m_rv);
+  m_dlTxFile->Write (params.m_ndi);
+  m_dlTxFile->Write (params.m_ccId);
 }
 
 void
@@ -159,43 +150,36 @@ PhyTxStatsCalculator::UlPhyTransmission (PhyTransmissionStatParameters params)
   NS_LOG_FUNCTION (this << params.m_cellId << params.m_imsi << params.m_timestamp << params.m_rnti << params.m_layer << params.m_mcs << params.m_size << params.m_rv << params.m_ndi);
   NS_LOG_INFO ("Write UL Tx Phy Stats in " << GetUlTxOutputFilename ().c_str ());
 
-  std::ofstream outFile;
-  if ( m_ulTxFirstWrite == true )
-    {
-      outFile.open (GetUlTxOutputFilename ().c_str ());
-      if (!outFile.is_open ())
-        {
-          NS_LOG_ERROR ("Can't open file " << GetUlTxOutputFilename ().c_str ());
-          return;
-        }
-      m_ulTxFirstWrite = false;
-//       outFile << "% time\tcellId\tIMSI\tRNTI\ttxMode\tlayer\tmcs\tsize\trv\tndi";
-      outFile << "% time\tcellId\tIMSI\tRNTI\tlayer\tmcs\tsize\trv\tndi\tccId";
-      outFile << std::endl;
-    }
-  else
+  if (m_ulTxFile == 0)
     {
-      outFile.open (GetUlTxOutputFilename ().c_str (),  std::ios_base::app);
-      if (!outFile.is_open ())
+      Ptr<LteStatsFile> file = Create<LteStatsFile> ();
+      file->AddColumn ("time", LteStatsFile::INT64);
+      file->AddColumn ("cellId", LteStatsFile::UINT16);
+      file->AddColumn ("IMSI", LteStatsFile::UINT64);
+      file->AddColumn ("RNTI", LteStatsFile::UINT16);
+      file->AddColumn ("layer", LteStatsFile::UINT8);
+      file->AddColumn ("mcs", LteStatsFile::UINT8);
+      file->AddColumn ("size", LteStatsFile::UINT16);
+      file->AddColumn ("rv", LteStatsFile::UINT8);
+      file->AddColumn ("ndi", LteStatsFile::UINT8);
+      file->AddColumn ("ccId", LteStatsFile::UINT8);
+      if (!OpenOutputFile (file, GetUlTxOutputFilename ()))
         {
-          NS_LOG_ERROR ("Can't open file " << GetUlTxOutputFilename ().c_str ());
           return;
         }
+      m_ulTxFile = file;
     }
 
-//   outFile << Simulator::Now ().GetNanoSeconds () / (double) 1e9 << "\t";
-  outFile << params.m_timestamp << "\t";
-  outFile << (uint32_t) params.m_cellId << "\t";
-  outFile << params.m_imsi << "\t";
-  outFile << params.m_rnti << "\t";
-  //outFile << (uint32_t) params.m_txMode << "\t";
-  outFile << (uint32_t) params.m_layer << "\t";
-  outFile << (uint32_t) params.m_mcs << "\t";
-  outFile << params.m_size << "\t";
-  outFile << (uint32_t) params.m_rv << "\t";
-  outFile << (uint32_t) params.m_ndi << "\t";
-  outFile << (uint32_t) params.m_ccId << std::endl;
-  outFile.close ();
+  m_ulTxFile->Write (params.m_timestamp);
+  m_ulTxFile->Write (params.m_cellId);
+  m_ulTxFile->Write (params.m_imsi);
+  m_ulTxFile->Write (params.m_rnti);
+  m_ulTxFile->Write (params.m_layer);
+  m_ulTxFile->Write (params.m_mcs);
+  m_ulTxFile->Write (params.m_size);
+  m_ulTxFile->Write (params.m_rv);
+  m_ulTxFile->Write (params.m_ndi);
+  m_ulTxFile->Write (params.m_ccId);
 }
 
 void
@@ -204,42 +188,34 @@ PhyTxStatsCalculator::SlPhyTransmission (PhyTransmissionStatParameters params)
   NS_LOG_FUNCTION (this << params.m_cellId << params.m_imsi << params.m_timestamp << params.m_rnti << params.m_layer << params.m_mcs << params.m_size << params.m_rv << params.m_ndi);
   NS_LOG_INFO ("Write SL Tx Phy Stats in " << GetSlTxOutputFilename ().c_str ());
 
-  std::ofstream outFile;
-  if ( m_slTxFirstWrite == true )
-    {
-      outFile.open (GetSlTxOutputFilename ().c_str ());
-      if (!outFile.is_open ())
-        {
-          NS_LOG_ERROR ("Can't open file " << GetSlTxOutputFilename ().c_str ());
-          return;
-        }
-      m_slTxFirstWrite = false;
-//       outFile << "% time\tcellId\tIMSI\tRNTI\ttxMode\tlayer\tmcs\tsize\trv\tndi";
-      outFile << "% time\tcellId\tIMSI\tRNTI\tlayer\tmcs\tsize\trv\tndi";
-      outFile << std::endl;
-    }
-  else
+  if (m_slTxFile == 0)
     {
-      outFile.open (GetSlTxOutputFilename ().c_str (),  std::ios_base::app);
-      if (!outFile.is_open ())
+      Ptr<LteStatsFile> file = Create<LteStatsFile> ();
+      file->AddColumn ("time", LteStatsFile::INT64);
+      file->AddColumn ("cellId", LteStatsFile::UINT16);
+      file->AddColumn ("IMSI", LteStatsFile::UINT64);
+      file->AddColumn ("RNTI", LteStatsFile::UINT16);
+      file->AddColumn ("layer", LteStatsFile::UINT8);
+      file->AddColumn ("mcs", LteStatsFile::UINT8);
+      file->AddColumn ("size", LteStatsFile::UINT16);
+      file->AddColumn ("rv", LteStatsFile::UINT8);
+      file->AddColumn ("ndi", LteStatsFile::UINT8);
+      if (!OpenOutputFile (file, GetSlTxOutputFilename ()))
         {
-          NS_LOG_ERROR ("Can't open file " << GetSlTxOutputFilename ().c_str ());
           return;
         }
+      m_slTxFile = file;
     }
 
-//   outFile << Simulator::Now ().GetNanoSeconds () / (double) 1e9 << "\t";
-  outFile << params.m_timestamp << "\t";
-  outFile << (uint32_t) params.m_cellId << "\t";
-  outFile << params.m_imsi << "\t";
-  outFile << params.m_rnti << "\t";
-  //outFile << (uint32_t) params.m_txMode << "\t";
-  outFile << (uint32_t) params.m_layer << "\t";
-  outFile << (uint32_t) params.m_mcs << "\t";
-  outFile << params.m_size << "\t";
-  outFile << (uint32_t) params.m_rv << "\t";
-  outFile << (uint32_t) params.m_ndi << std::endl;
-  outFile.close ();
+  m_slTxFile->Write (params.m_timestamp);
+  m_slTxFile->Write (params.m_cellId);
+  m_slTxFile->Write (params.m_imsi);
+  m_slTxFile->Write (params.m_rnti);
+  m_slTxFile->Write (params.m_layer);
+  m_slTxFile->Write (params.m_mcs);
+  m_slTxFile->Write (params.m_size);
+  m_slTxFile->Write (params.m_rv);
+  m_slTxFile->Write (params.m_ndi);
 }
 
 void
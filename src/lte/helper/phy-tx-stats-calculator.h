@@ -159,28 +159,19 @@ public:
 
 private:
   /**
-   * When writing DL TX PHY statistics first time to file,
-   * columns description is added. Then next lines are
-   * appended to file. This value is true if output
-   * files have not been opened yet
+   * Output file of the DL TX PHY statistics, opened at the first write
    */
-  bool m_dlTxFirstWrite;
+  Ptr<LteStatsFile> m_dlTxFile;
 
   /**
-   * When writing UL TX PHY statistics first time to file,
-   * columns description is added. Then next lines are
-   * appended to file. This value is true if output
-   * files have not been opened yet
+   * Output file of the UL TX PHY statistics, opened at the first write
    */
-  bool m_ulTxFirstWrite;
+  Ptr<LteStatsFile> m_ulTxFile;
 
   /**
-   * When writing SL TX PHY statistics first time to file,
-   * columns description is added. Then next lines are
-   * appended to file. This value is true if output
-   * files have not been opened yet
+   * Output file of the SL TX PHY statistics, opened at the first write
    */
-  bool m_slTxFirstWrite;
+  Ptr<LteStatsFile> m_slTxFile;
 
 };
 
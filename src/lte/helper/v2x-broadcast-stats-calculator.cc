@@ -0,0 +1,347 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "v2x-broadcast-stats-calculator.h"
+#include <ns3/lte-ue-net-device.h>
+#include <ns3/lte-ue-phy.h>
+#include <ns3/lte-spectrum-phy.h>
+#include <ns3/double.h>
+#include <ns3/simulator.h>
+#include <ns3/log.h>
+#include <ns3/abort.h>
+#include <cmath>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("V2xBroadcastStatsCalculator");
+
+NS_OBJECT_ENSURE_REGISTERED (V2xBroadcastStatsCalculator);
+
+V2xBroadcastStatsCalculator::V2xBroadcastStatsCalculator ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+V2xBroadcastStatsCalculator::~V2xBroadcastStatsCalculator ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+TypeId
+V2xBroadcastStatsCalculator::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::V2xBroadcastStatsCalculator")
+    .SetParent<Object> ()
+    .SetGroupName("Lte")
+    .AddConstructor<V2xBroadcastStatsCalculator> ()
+    .AddAttribute ("DistanceBinWidth",
+                   "Width in meters of the distance bins of the PRR.",
+                   DoubleValue (20.0),
+                   MakeDoubleAccessor (&V2xBroadcastStatsCalculator::m_distanceBinWidth),
+                   MakeDoubleChecker<double> (0.0))
+    .AddAttribute ("MaxDistance",
+                   "Maximum distance in meters between a transmitter and its expected receivers.",
+                   DoubleValue (500.0),
+                   MakeDoubleAccessor (&V2xBroadcastStatsCalculator::m_maxDistance),
+                   MakeDoubleChecker<double> (0.0))
+    .AddAttribute ("InterReceptionTimeBinWidth",
+                   "Width of the bins of the inter-reception time histogram.",
+                   TimeValue (MilliSeconds (10)),
+                   MakeTimeAccessor (&V2xBroadcastStatsCalculator::m_interReceptionTimeBinWidth),
+                   MakeTimeChecker ())
+    .AddAttribute ("MaxInterReceptionTime",
+                   "Maximum of the inter-reception time histogram.",
+                   TimeValue (Seconds (1)),
+                   MakeTimeAccessor (&V2xBroadcastStatsCalculator::m_maxInterReceptionTime),
+                   MakeTimeChecker ())
+    .AddAttribute ("LatencyBinWidth",
+                   "Width of the bins of the latency histogram.",
+                   TimeValue (MilliSeconds (1)),
+                   MakeTimeAccessor (&V2xBroadcastStatsCalculator::m_latencyBinWidth),
+                   MakeTimeChecker ())
+    .AddAttribute ("MaxLatency",
+                   "Maximum of the latency histogram.",
+                   TimeValue (MilliSeconds (100)),
+                   MakeTimeAccessor (&V2xBroadcastStatsCalculator::m_maxLatency),
+                   MakeTimeChecker ())
+  ;
+  return tid;
+}
+
+void
+V2xBroadcastStatsCalculator::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_stations.clear ();
+  m_links.clear ();
+  Object::DoDispose ();
+}
+
+void
+V2xBroadcastStatsCalculator::NotifyConstructionCompleted (void)
+{
+  NS_LOG_FUNCTION (this);
+  Object::NotifyConstructionCompleted ();
+  Reset ();
+}
+
+void
+V2xBroadcastStatsCalculator::Install (NetDeviceContainer devices)
+{
+  NS_LOG_FUNCTION (this);
+  for (NetDeviceContainer::Iterator it = devices.Begin (); it != devices.End (); ++it)
+    {
+      Install (*it);
+    }
+}
+
+void
+V2xBroadcastStatsCalculator::Install (Ptr<NetDevice> device)
+{
+  NS_LOG_FUNCTION (this << device);
+  Ptr<LteUeNetDevice> ueDevice = DynamicCast<LteUeNetDevice> (device);
+  NS_ABORT_MSG_IF (ueDevice == 0, "V2xBroadcastStatsCalculator requires LTE UE devices");
+  Ptr<Node> node = device->GetNode ();
+  AddNode (node);
+  Ptr<V2xBroadcastStatsCalculator> calculator = this;
+  // the sidelink is transmitted by the UL spectrum PHY and received by
+  // the SL spectrum PHY
+  ueDevice->GetPhy ()->GetUlSpectrumPhy ()->TraceConnectWithoutContext
+    ("TxStart", MakeCallback (&V2xBroadcastStatsCalculator::NotifyTx, calculator).Bind (node));
+  ueDevice->GetPhy ()->GetSlSpectrumPhy ()->TraceConnectWithoutContext
+    ("RxEndOk", MakeCallback (&V2xBroadcastStatsCalculator::NotifyRx, calculator).Bind (node));
+}
+
+void
+V2xBroadcastStatsCalculator::AddNode (Ptr<Node> node)
+{
+  NS_LOG_FUNCTION (this << node->GetId ());
+  Station station;
+  station.mobility = node->GetObject<MobilityModel> ();
+  NS_ABORT_MSG_IF (station.mobility == 0, "Node " << node->GetId () << " has no mobility model");
+  station.transmitted = false;
+  station.lastSequenceNumber = 0;
+  m_stations[node->GetId ()] = station;
+}
+
+uint32_t
+V2xBroadcastStatsCalculator::GetBin (double value, double width, uint32_t nBins)
+{
+  double bin = std::floor (value / width);
+  return bin < nBins - 1 ? static_cast<uint32_t> (bin) : nBins - 1;
+}
+
+bool
+V2xBroadcastStatsCalculator::IsNewMessage (const V2xMessageTag &tag)
+{
+  std::map<uint32_t, Station>::iterator it = m_stations.find (tag.GetStationId ());
+  if (it == m_stations.end ())
+    {
+      return false;
+    }
+  Station &station = it->second;
+  if (station.transmitted
+      && station.lastSequenceNumber == tag.GetSequenceNumber ()
+      && station.lastGenerationTime == tag.GetGenerationTime ())
+    {
+      return false;
+    }
+  station.transmitted = true;
+  station.lastSequenceNumber = tag.GetSequenceNumber ();
+  station.lastGenerationTime = tag.GetGenerationTime ();
+  return true;
+}
+
+void
+V2xBroadcastStatsCalculator::NotifyTx (Ptr<Node> node, Ptr<const PacketBurst> pb)
+{
+  NS_LOG_FUNCTION (this << node->GetId ());
+  if (pb == 0)
+    {
+      return;
+    }
+  for (std::list<Ptr<Packet> >::const_iterator p = pb->Begin (); p != pb->End (); ++p)
+    {
+      ByteTagIterator tags = (*p)->GetByteTagIterator ();
+      while (tags.HasNext ())
+        {
+          ByteTagIterator::Item item = tags.Next ();
+          if (item.GetTypeId () != V2xMessageTag::GetTypeId ())
+            {
+              continue;
+            }
+          V2xMessageTag tag;
+          item.GetTag (tag);
+          if (tag.GetStationId () != node->GetId () || !IsNewMessage (tag))
+            {
+              continue;
+            }
+          NS_LOG_LOGIC ("new message " << tag.GetSequenceNumber () << " of " << tag.GetStationId ());
+          for (std::map<uint32_t, Station>::const_iterator it = m_stations.begin (); it != m_stations.end (); ++it)
+            {
+              if (it->first == tag.GetStationId ())
+                {
+                  continue;
+                }
+              double distance = CalculateDistance (tag.GetPosition (), it->second.mobility->GetPosition ());
+              if (distance < m_maxDistance)
+                {
+                  m_expected[GetBin (distance, m_distanceBinWidth, m_expected.size ())]++;
+                }
+            }
+        }
+    }
+}
+
+void
+V2xBroadcastStatsCalculator::NotifyRx (Ptr<Node> node, Ptr<const Packet> packet)
+{
+  NS_LOG_FUNCTION (this << node->GetId ());
+  std::map<uint32_t, Station>::const_iterator rx = m_stations.find (node->GetId ());
+  if (rx == m_stations.end ())
+    {
+      return;
+    }
+  ByteTagIterator tags = packet->GetByteTagIterator ();
+  while (tags.HasNext ())
+    {
+      ByteTagIterator::Item item = tags.Next ();
+      if (item.GetTypeId () != V2xMessageTag::GetTypeId ())
+        {
+          continue;
+        }
+      V2xMessageTag tag;
+      item.GetTag (tag);
+      if (tag.GetStationId () == node->GetId ()
+          || m_stations.find (tag.GetStationId ()) == m_stations.end ())
+        {
+          continue;
+        }
+
+      Time now = Simulator::Now ();
+      uint64_t linkId = (static_cast<uint64_t> (node->GetId ()) << 32) | tag.GetStationId ();
+      std::map<uint64_t, Link>::iterator link = m_links.find (linkId);
+      if (link != m_links.end ())
+        {
+          if (link->second.lastSequenceNumber == tag.GetSequenceNumber ()
+              && link->second.lastGenerationTime == tag.GetGenerationTime ())
+            {
+              // duplicate reception
+              continue;
+            }
+          double interReceptionTime = (now - link->second.lastReceptionTime).GetSeconds ();
+          m_interReceptionTimes[GetBin (interReceptionTime, m_interReceptionTimeBinWidth.GetSeconds (),
+                                        m_interReceptionTimes.size ())]++;
+        }
+      else
+        {
+          link = m_links.insert (std::make_pair (linkId, Link ())).first;
+        }
+      link->second.lastSequenceNumber = tag.GetSequenceNumber ();
+      link->second.lastGenerationTime = tag.GetGenerationTime ();
+      link->second.lastReceptionTime = now;
+
+      double latency = (now - tag.GetGenerationTime ()).GetSeconds ();
+      m_latencies[GetBin (latency, m_latencyBinWidth.GetSeconds (), m_latencies.size ())]++;
+
+      double distance = CalculateDistance (tag.GetPosition (), rx->second.mobility->GetPosition ());
+      if (distance < m_maxDistance)
+        {
+          m_received[GetBin (distance, m_distanceBinWidth, m_received.size ())]++;
+        }
+    }
+}
+
+uint32_t
+V2xBroadcastStatsCalculator::GetNDistanceBins (void) const
+{
+  return m_expected.size ();
+}
+
+uint64_t
+V2xBroadcastStatsCalculator::GetNExpected (uint32_t bin) const
+{
+  NS_ASSERT (bin < m_expected.size ());
+  return m_expected[bin];
+}
+
+uint64_t
+V2xBroadcastStatsCalculator::GetNReceived (uint32_t bin) const
+{
+  NS_ASSERT (bin < m_received.size ());
+  return m_received[bin];
+}
+
+double
+V2xBroadcastStatsCalculator::GetPrr (uint32_t bin) const
+{
+  NS_ASSERT (bin < m_expected.size ());
+  return m_expected[bin] > 0 ? static_cast<double> (m_received[bin]) / m_expected[bin] : 0.0;
+}
+
+const std::vector<uint64_t> &
+V2xBroadcastStatsCalculator::GetInterReceptionTimeHistogram (void) const
+{
+  return m_interReceptionTimes;
+}
+
+const std::vector<uint64_t> &
+V2xBroadcastStatsCalculator::GetLatencyHistogram (void) const
+{
+  return m_latencies;
+}
+
+void
+V2xBroadcastStatsCalculator::Print (std::ostream &os) const
+{
+  os << "% distance\texpected\treceived\tPRR" << std::endl;
+  for (uint32_t i = 0; i < m_expected.size (); i++)
+    {
+      os << i * m_distanceBinWidth << "\t" << m_expected[i] << "\t"
+         << m_received[i] << "\t" << GetPrr (i) << std::endl;
+    }
+  os << "% interReceptionTime\tcount" << std::endl;
+  for (uint32_t i = 0; i < m_interReceptionTimes.size (); i++)
+    {
+      os << i * m_interReceptionTimeBinWidth.GetSeconds () << "\t" << m_interReceptionTimes[i] << std::endl;
+    }
+  os << "% latency\tcount" << std::endl;
+  for (uint32_t i = 0; i < m_latencies.size (); i++)
+    {
+      os << i * m_latencyBinWidth.GetSeconds () << "\t" << m_latencies[i] << std::endl;
+    }
+}
+
+void
+V2xBroadcastStatsCalculator::Reset (void)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ABORT_MSG_UNLESS (m_distanceBinWidth > 0 && m_interReceptionTimeBinWidth.IsStrictlyPositive ()
+                       && m_latencyBinWidth.IsStrictlyPositive (), "The bins must have a positive width");
+  uint32_t nDistanceBins = std::max (1.0, std::ceil (m_maxDistance / m_distanceBinWidth));
+  m_expected.assign (nDistanceBins, 0);
+  m_received.assign (nDistanceBins, 0);
+  // the last bin of the histograms counts the values beyond their maximum
+  m_interReceptionTimes.assign (std::ceil (m_maxInterReceptionTime.GetSeconds () / m_interReceptionTimeBinWidth.GetSeconds ()) + 1, 0);
+  m_latencies.assign (std::ceil (m_maxLatency.GetSeconds () / m_latencyBinWidth.GetSeconds ()) + 1, 0);
+  m_links.clear ();
+  for (std::map<uint32_t, Station>::iterator it = m_stations.begin (); it != m_stations.end (); ++it)
+    {
+      it->second.transmitted = false;
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,198 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef V2X_BROADCAST_STATS_CALCULATOR_H_
+#define V2X_BROADCAST_STATS_CALCULATOR_H_
+
+#include "ns3/object.h"
+#include "ns3/nstime.h"
+#include "ns3/node.h"
+#include "ns3/packet.h"
+#include "ns3/packet-burst.h"
+#include "ns3/mobility-model.h"
+#include "ns3/net-device-container.h"
+#include "ns3/v2x-message-tag.h"
+#include <map>
+#include <vector>
+#include <ostream>
+
+namespace ns3 {
+
+/**
+ * \ingroup lte
+ *
+ * Computes online the statistics of V2X broadcast messages: the packet
+ * reception ratio (PRR) per distance bin, and the histograms of the
+ * inter-reception time and of the latency of the messages.
+ *
+ * The messages carry a V2xMessageTag as a byte tag, whose station id is
+ * the id of the transmitting node. When a transmission of a message
+ * starts at the PHY of a node, every other node within MaxDistance of
+ * the position in the tag is an expected receiver, in the bin of its
+ * distance. When a receiver decodes a transport block with the message,
+ * the reception is counted in the bin of its distance to the position in
+ * the tag, and the time since the generation of the message and since
+ * the previous message of the same transmitter are added to the
+ * histograms. Retransmissions and duplicate receptions of a message are
+ * counted once.
+ *
+ * The last bin of each histogram counts the values beyond its maximum.
+ */
+class V2xBroadcastStatsCalculator : public Object
+{
+public:
+  V2xBroadcastStatsCalculator ();
+  virtual ~V2xBroadcastStatsCalculator ();
+
+  /**
+   *  Register this type.
+   *  \return The object TypeId.
+   */
+  static TypeId GetTypeId (void);
+
+  /**
+   * Connect to the sidelink PHY traces of LTE UE devices.
+   * \param devices the devices
+   */
+  void Install (NetDeviceContainer devices);
+
+  /**
+   * Connect to the sidelink PHY traces of an LTE UE device.
+   * \param device the device
+   */
+  void Install (Ptr<NetDevice> device);
+
+  /**
+   * Add a node to the stations, whose transmissions and receptions are
+   * notified by the caller; Install adds the nodes of the devices.
+   * \param node the node, which must have a mobility model
+   */
+  void AddNode (Ptr<Node> node);
+
+  /**
+   * Notify the start of a transmission by the PHY of a station.
+   * \param node the transmitting node
+   * \param pb the transmitted packets
+   */
+  void NotifyTx (Ptr<Node> node, Ptr<const PacketBurst> pb);
+
+  /**
+   * Notify a packet successfully decoded by the PHY of a station.
+   * \param node the receiving node
+   * \param packet the packet
+   */
+  void NotifyRx (Ptr<Node> node, Ptr<const Packet> packet);
+
+  /**
+   * \return the number of distance bins
+   */
+  uint32_t GetNDistanceBins (void) const;
+
+  /**
+   * \param bin the index of a distance bin
+   * \return the number of receivers of the messages in the bin
+   */
+  uint64_t GetNExpected (uint32_t bin) const;
+
+  /**
+   * \param bin the index of a distance bin
+   * \return the number of messages received in the bin
+   */
+  uint64_t GetNReceived (uint32_t bin) const;
+
+  /**
+   * \param bin the index of a distance bin
+   * \return the packet reception ratio in the bin, or 0 if no message
+   *         was expected
+   */
+  double GetPrr (uint32_t bin) const;
+
+  /**
+   * \return the number of inter-reception times per bin of
+   *         InterReceptionTimeBinWidth
+   */
+  const std::vector<uint64_t> & GetInterReceptionTimeHistogram (void) const;
+
+  /**
+   * \return the number of receptions per bin of LatencyBinWidth
+   */
+  const std::vector<uint64_t> & GetLatencyHistogram (void) const;
+
+  /**
+   * Print the PRR and the histograms.
+   * \param os the output stream
+   */
+  void Print (std::ostream &os) const;
+
+  /**
+   * Reset the statistics, with the bins set by the attributes; the
+   * stations are kept.
+   */
+  void Reset (void);
+
+protected:
+  virtual void DoDispose (void);
+  virtual void NotifyConstructionCompleted (void);
+
+private:
+  /**
+   * \param tag the tag of a message
+   * \return true if the tag is the first one of its message
+   */
+  bool IsNewMessage (const V2xMessageTag &tag);
+  /**
+   * \param value the value
+   * \param width the width of the bins
+   * \param nBins the number of bins, the last one counting the larger values
+   * \return the index of the bin of the value
+   */
+  static uint32_t GetBin (double value, double width, uint32_t nBins);
+
+  /// A station
+  struct Station
+  {
+    Ptr<MobilityModel> mobility; ///< mobility model of the node
+    bool transmitted; ///< whether the station transmitted a message
+    uint32_t lastSequenceNumber; ///< sequence number of the last message transmitted
+    Time lastGenerationTime; ///< generation time of the last message transmitted
+  };
+
+  /// The last message received by a station from another one
+  struct Link
+  {
+    uint32_t lastSequenceNumber; ///< sequence number of the message
+    Time lastGenerationTime; ///< generation time of the message
+    Time lastReceptionTime; ///< reception time of the message
+  };
+
+  double m_distanceBinWidth; ///< width of the distance bins, in meters
+  double m_maxDistance; ///< maximum distance of the expected receivers
+  Time m_interReceptionTimeBinWidth; ///< width of the inter-reception time bins
+  Time m_maxInterReceptionTime; ///< maximum of the inter-reception time histogram
+  Time m_latencyBinWidth; ///< width of the latency bins
+  Time m_maxLatency; ///< maximum of the latency histogram
+
+  std::map<uint32_t, Station> m_stations; ///< stations, indexed by node id
+  std::map<uint64_t, Link> m_links; ///< links, indexed by receiver and transmitter id
+  std::vector<uint64_t> m_expected; ///< number of expected receptions per distance bin
+  std::vector<uint64_t> m_received; ///< number of receptions per distance bin
+  std::vector<uint64_t> m_interReceptionTimes; ///< inter-reception time histogram
+  std::vector<uint64_t> m_latencies; ///< latency histogram
+};
+
+} // namespace ns3
+
+#endif /* V2X_BROADCAST_STATS_CALCULATOR_H_ */
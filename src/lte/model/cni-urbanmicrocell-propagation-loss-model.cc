@@ -22,6 +22,7 @@
 #include "ns3/log.h"
 #include "ns3/double.h"
 #include "ns3/enum.h"
+#include "ns3/uinteger.h"
 #include "ns3/mobility-model.h"
 #include <cmath>
 #include "cni-urbanmicrocell-propagation-loss-model.h"
@@ -44,6 +45,19 @@ CniUrbanmicrocellPropagationLossModel::GetTypeId (void)
                     DoubleValue (5900e6),
                     MakeDoubleAccessor (&CniUrbanmicrocellPropagationLossModel::m_frequency),
                     MakeDoubleChecker<double> ())
+    .AddAttribute ("MaxCachedPairs",
+                    "The maximum number of pairs of nodes whose LOS/NLOS random number and last "
+                    "loss are cached, the least recently used ones being evicted (0 for no limit). "
+                    "An evicted pair draws a new LOS/NLOS random number when it is used again.",
+                    UintegerValue (0),
+                    MakeUintegerAccessor (&CniUrbanmicrocellPropagationLossModel::m_maxCachedPairs),
+                    MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("PositionTolerance",
+                    "The maximum movement in meters of each node of a pair for which "
+                    "the last loss of the pair is reused (0 to reuse it only for static nodes)",
+                    DoubleValue (0.0),
+                    MakeDoubleAccessor (&CniUrbanmicrocellPropagationLossModel::m_positionTolerance),
+                    MakeDoubleChecker<double> (0.0))
     ;
 
   return tid;
@@ -66,19 +80,103 @@ CniUrbanmicrocellPropagationLossModel::~CniUrbanmicrocellPropagationLossModel ()
 {
 }
 
+size_t
+CniUrbanmicrocellPropagationLossModel::MobilityPairHash::operator() (const MobilityPair& pair) const
+{
+  size_t h1 = std::hash<const MobilityModel *> () (pair.first);
+  size_t h2 = std::hash<const MobilityModel *> () (pair.second);
+  return h1 ^ (h2 + 0x9e3779b9 + (h1 << 6) + (h1 >> 2));
+}
+
+uint32_t
+CniUrbanmicrocellPropagationLossModel::GetNCachedPairs () const
+{
+  return m_pairCache.size ();
+}
+
 double
 CniUrbanmicrocellPropagationLossModel::GetLoss (Ptr<MobilityModel> a, Ptr<MobilityModel> b) const
+{
+  Vector posA = a->GetPosition ();
+  Vector posB = b->GetPosition ();
+
+  // Look for the pair of nodes, whatever their order
+  bool swapped = PeekPointer (b) < PeekPointer (a);
+  MobilityPair pair = swapped ? MobilityPair (PeekPointer (b), PeekPointer (a)) : MobilityPair (PeekPointer (a), PeekPointer (b));
+  std::unordered_map<MobilityPair, PairState, MobilityPairHash>::iterator it = m_pairCache.find (pair);
+  if (it == m_pairCache.end ())
+    {
+      // Generate a random number between 0 and 1 to evaluate the LOS/NLOS situation
+      PairState state;
+      state.first = swapped ? b : a;
+      state.second = swapped ? a : b;
+      state.r = m_rand->GetValue (0,1);
+      state.lossValid[0] = false;
+      state.lossValid[1] = false;
+      m_pairLru.push_front (pair);
+      state.lruIt = m_pairLru.begin ();
+      it = m_pairCache.insert (std::make_pair (pair, state)).first;
+      if (m_maxCachedPairs > 0 && m_pairCache.size () > m_maxCachedPairs)
+        {
+          NS_LOG_LOGIC (this << " evicting the least recently used pair");
+          m_pairCache.erase (m_pairLru.back ());
+          m_pairLru.pop_back ();
+        }
+    }
+  else if (it->second.lruIt != m_pairLru.begin ())
+    {
+      m_pairLru.splice (m_pairLru.begin (), m_pairLru, it->second.lruIt);
+    }
+  PairState& state = it->second;
+
+  // Reuse the last loss if the nodes did not move, or less than the tolerance
+  const Vector& firstPos = swapped ? posB : posA;
+  const Vector& secondPos = swapped ? posA : posB;
+  if (state.lossValid[0] || state.lossValid[1])
+    {
+      bool moved;
+      if (m_positionTolerance > 0)
+        {
+          moved = CalculateDistance (firstPos, state.firstPosition) > m_positionTolerance
+            || CalculateDistance (secondPos, state.secondPosition) > m_positionTolerance;
+        }
+      else
+        {
+          moved = firstPos.x != state.firstPosition.x || firstPos.y != state.firstPosition.y || firstPos.z != state.firstPosition.z
+            || secondPos.x != state.secondPosition.x || secondPos.y != state.secondPosition.y || secondPos.z != state.secondPosition.z;
+        }
+      if (moved)
+        {
+          state.lossValid[0] = false;
+          state.lossValid[1] = false;
+        }
+    }
+  if (!state.lossValid[swapped])
+    {
+      if (!state.lossValid[!swapped])
+        {
+          state.firstPosition = firstPos;
+          state.secondPosition = secondPos;
+        }
+      state.loss[swapped] = CalculateLoss (posA, posB, state.r);
+      state.lossValid[swapped] = true;
+    }
+  return state.loss[swapped];
+}
+
+double
+CniUrbanmicrocellPropagationLossModel::CalculateLoss (const Vector& posA, const Vector& posB, double r) const
 {
   // Pathloss
   double loss = 0.0;
   // Frequency in GHz
   double fc = m_frequency / 1e9;
   // Distance between the two nodes in meter
-  double dist = a->GetDistanceFrom (b);
+  double dist = CalculateDistance (posA, posB);
 
   // Actual antenna heights (1.5m for UEs)
-  double hms = a->GetPosition().z;
-  double hbs = b->GetPosition().z;
+  double hms = posA.z;
+  double hbs = posB.z;
 
   // Effective antenna heights
   double hbs1 = hbs - 1;
@@ -100,33 +198,6 @@ CniUrbanmicrocellPropagationLossModel::GetLoss (Ptr<MobilityModel> a, Ptr<Mobili
   double loss_free  = 20*std::log10 (dist) + 46.4 + 20*std::log10(fc/5.0); 
   NS_LOG_INFO (this << "Outdoor , the free space loss = " << loss_free);
 
-  // Generate a random number between 0 and 1 (if it doesn't already exist) to evaluate the LOS/NLOS situation
-  double r = 0.0;
-   
-  MobilityDuo couple;
-  couple.a = a;
-  couple.b = b;
-  std::map<MobilityDuo, double>::iterator it_a = m_randomMap.find (couple);
-  if (it_a != m_randomMap.end ())
-  {
-    r = it_a->second;
-  }
-  else
-  {
-    couple.a = b;
-    couple.b = a;
-    std::map<MobilityDuo, double>::iterator it_b = m_randomMap.find (couple);
-    if (it_b != m_randomMap.end ())
-    {
-      r = it_b->second;
-    }
-    else
-    {
-      m_randomMap[couple] = m_rand->GetValue (0,1);
-      r = m_randomMap[couple];
-    }
-  }
-
   // Compute the pathloss based on 3GPP specifications
   // This model is only valid to a minimum distance of 3 meters 
   if (dist >= 3)
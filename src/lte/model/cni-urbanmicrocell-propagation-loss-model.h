@@ -25,6 +25,9 @@
 
 #include <ns3/propagation-loss-model.h>
 #include <ns3/propagation-environment.h>
+#include <ns3/vector.h>
+#include <list>
+#include <unordered_map>
 
 namespace ns3 {
 
@@ -93,19 +96,66 @@ public:
    */
   double GetLoss (Ptr<MobilityModel> a, Ptr<MobilityModel> b) const;
 
+  /**
+   * \return the number of pairs of nodes currently cached
+   */
+  uint32_t GetNCachedPairs () const;
+
 private:
 
   // inherited from PropagationLossModel
   virtual double DoCalcRxPower (double txPowerDbm, Ptr<MobilityModel> a, Ptr<MobilityModel> b) const;
   virtual int64_t DoAssignStreams (int64_t stream);
-  
+
+  /**
+   * Calculate the pathloss in dBm for the given positions
+   *
+   * \param posA the position of the first node
+   * \param posB the position of the second node
+   * \param r the random number used to evaluate the LOS/NLOS situation
+   *
+   * \return the loss in dBm
+   */
+  double CalculateLoss (const Vector& posA, const Vector& posB, double r) const;
+
+  /// a pair of nodes, identified by their mobility models in increasing address order
+  typedef std::pair<const MobilityModel *, const MobilityModel *> MobilityPair;
+
+  /// hash of a MobilityPair
+  struct MobilityPairHash
+  {
+    /**
+     * \param pair the pair of nodes
+     * \return the hash of the pair
+     */
+    size_t operator() (const MobilityPair& pair) const;
+  };
+
+  /// the state cached for a pair of nodes
+  struct PairState
+  {
+    Ptr<MobilityModel> first; ///< mobility model of the first node of the pair
+    Ptr<MobilityModel> second; ///< mobility model of the second node of the pair
+    double r; ///< random number drawn to evaluate the LOS/NLOS situation
+    Vector firstPosition; ///< position of the first node when the losses were computed
+    Vector secondPosition; ///< position of the second node when the losses were computed
+    bool lossValid[2]; ///< whether the loss from the first (0) or the second (1) node is valid
+    double loss[2]; ///< the loss from the first (0) or the second (1) node
+    std::list<MobilityPair>::iterator lruIt; ///< position of the pair in m_pairLru
+  };
+
   // The propagation frequency in Hz
   double m_frequency;
   bool m_isLosEnabled;
   Ptr<UniformRandomVariable> m_rand;
-  // Map to keep track of random numbers generated per pair of nodes
-  //mutable std::map<Ptr<MobilityModel>, std::map<Ptr<MobilityModel>, double> > m_randomMap;
-  mutable std::map<MobilityDuo, double> m_randomMap;
+  // Maximum number of pairs of nodes cached, 0 for no limit
+  uint32_t m_maxCachedPairs;
+  // Maximum movement of the nodes for which the cached loss of a pair is reused
+  double m_positionTolerance;
+  // Cache of the random numbers generated and of the last losses per pair of nodes
+  mutable std::unordered_map<MobilityPair, PairState, MobilityPairHash> m_pairCache;
+  // Pairs of nodes in m_pairCache, most recently used first
+  mutable std::list<MobilityPair> m_pairLru;
 
 };
 
@@ -0,0 +1,648 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "distributed-spectrum-channel.h"
+#include <ns3/log.h>
+#include <ns3/simulator.h>
+#include <ns3/abort.h>
+#include <ns3/double.h>
+#include <ns3/header.h>
+#include <ns3/node.h>
+#include <ns3/channel-list.h>
+#include <ns3/spectrum-phy.h>
+#include <ns3/spectrum-value.h>
+#include <ns3/propagation-loss-model.h>
+#include <ns3/antenna-model.h>
+#include <ns3/constant-position-mobility-model.h>
+#include <ns3/mpi-interface.h>
+#include <ns3/mpi-receiver.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("DistributedSpectrumChannel");
+
+NS_OBJECT_ENSURE_REGISTERED (DistributedSpectrumChannel);
+
+/**
+ * \ingroup lte
+ *
+ * The header of a signal sent by a DistributedSpectrumChannel to the
+ * other systems, followed by the parameters encoded by the codec.
+ *
+ * The PSD is sent as the runs of equal nonzero values, and its
+ * SpectrumModel by its number of bands and frequency range.
+ */
+class DistributedSpectrumHeader : public Header
+{
+public:
+  /** A run of equal nonzero values of the PSD. */
+  struct Run
+  {
+    uint32_t m_start;  //!< the first band
+    uint32_t m_length; //!< the number of bands
+    double m_value;    //!< the value
+  };
+
+  /** No codec encoded the parameters. */
+  static const uint8_t NO_CODEC = 0xff;
+
+  DistributedSpectrumHeader ();
+
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  virtual TypeId GetInstanceTypeId (void) const;
+  virtual void Print (std::ostream &os) const;
+  virtual uint32_t GetSerializedSize (void) const;
+  virtual void Serialize (Buffer::Iterator start) const;
+  virtual uint32_t Deserialize (Buffer::Iterator start);
+
+  /**
+   * \param psd the PSD to summarize
+   */
+  void SetPsd (Ptr<const SpectrumValue> psd);
+
+  /**
+   * \param model the SpectrumModel of the PSD
+   * \return the PSD
+   */
+  Ptr<SpectrumValue> GetPsd (Ptr<const SpectrumModel> model) const;
+
+  /**
+   * \param model a SpectrumModel
+   * \return whether model is the one of the PSD
+   */
+  bool IsSpectrumModel (Ptr<const SpectrumModel> model) const;
+
+  uint32_t m_channelId;   //!< the channel
+  uint8_t m_codec;        //!< the index of the codec, or NO_CODEC
+  uint32_t m_txNodeId;    //!< the node of the transmitter
+  bool m_hasPosition;     //!< whether the transmitter has a mobility model
+  Vector m_position;      //!< the position of the transmitter
+  Time m_duration;        //!< the duration of the signal
+  uint32_t m_numBands;    //!< the number of bands of the SpectrumModel
+  double m_fl;            //!< the lower limit of the first band
+  double m_fh;            //!< the upper limit of the last band
+  std::vector<Run> m_runs; //!< the nonzero values of the PSD
+
+private:
+  /**
+   * \param i the buffer
+   * \param value the value to write
+   */
+  static void WriteDouble (Buffer::Iterator &i, double value);
+  /**
+   * \param i the buffer
+   * \return the value read
+   */
+  static double ReadDouble (Buffer::Iterator &i);
+};
+
+NS_OBJECT_ENSURE_REGISTERED (DistributedSpectrumHeader);
+
+const uint8_t DistributedSpectrumHeader::NO_CODEC;
+
+DistributedSpectrumHeader::DistributedSpectrumHeader ()
+  : m_channelId (0),
+    m_codec (NO_CODEC),
+    m_txNodeId (0),
+    m_hasPosition (false),
+    m_numBands (0),
+    m_fl (0),
+    m_fh (0)
+{
+}
+
+TypeId
+DistributedSpectrumHeader::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::DistributedSpectrumHeader")
+    .SetParent<Header> ()
+    .SetGroupName ("Lte")
+    .AddConstructor<DistributedSpectrumHeader> ()
+  ;
+  return tid;
+}
+
+TypeId
+DistributedSpectrumHeader::GetInstanceTypeId (void) const
+{
+  return GetTypeId ();
+}
+
+void
+DistributedSpectrumHeader::Print (std::ostream &os) const
+{
+  os << "channel=" << m_channelId << " codec=" << (uint32_t) m_codec
+     << " txNode=" << m_txNodeId << " position=" << m_position
+     << " duration=" << m_duration << " bands=" << m_numBands
+     << " runs=" << m_runs.size ();
+}
+
+uint32_t
+DistributedSpectrumHeader::GetSerializedSize (void) const
+{
+  return 4 + 1 + 4 + 1 + 3 * 8 + 8 + 4 + 8 + 8 + 4 + m_runs.size () * (4 + 4 + 8);
+}
+
+void
+DistributedSpectrumHeader::WriteDouble (Buffer::Iterator &i, double value)
+{
+  uint64_t bits;
+  std::memcpy (&bits, &value, sizeof (bits));
+  i.WriteHtonU64 (bits);
+}
+
+double
+DistributedSpectrumHeader::ReadDouble (Buffer::Iterator &i)
+{
+  uint64_t bits = i.ReadNtohU64 ();
+  double value;
+  std::memcpy (&value, &bits, sizeof (value));
+  return value;
+}
+
+void
+DistributedSpectrumHeader::Serialize (Buffer::Iterator start) const
+{
+  Buffer::Iterator i = start;
+  i.WriteHtonU32 (m_channelId);
+  i.WriteU8 (m_codec);
+  i.WriteHtonU32 (m_txNodeId);
+  i.WriteU8 (m_hasPosition);
+  WriteDouble (i, m_position.x);
+  WriteDouble (i, m_position.y);
+  WriteDouble (i, m_position.z);
+  i.WriteHtonU64 (m_duration.GetTimeStep ());
+  i.WriteHtonU32 (m_numBands);
+  WriteDouble (i, m_fl);
+  WriteDouble (i, m_fh);
+  i.WriteHtonU32 (m_runs.size ());
+  for (std::vector<Run>::const_iterator run = m_runs.begin (); run != m_runs.end (); ++run)
+    {
+      i.WriteHtonU32 (run->m_start);
+      i.WriteHtonU32 (run->m_length);
+      WriteDouble (i, run->m_value);
+    }
+}
+
+uint32_t
+DistributedSpectrumHeader::Deserialize (Buffer::Iterator start)
+{
+  Buffer::Iterator i = start;
+  m_channelId = i.ReadNtohU32 ();
+  m_codec = i.ReadU8 ();
+  m_txNodeId = i.ReadNtohU32 ();
+  m_hasPosition = i.ReadU8 ();
+  m_position.x = ReadDouble (i);
+  m_position.y = ReadDouble (i);
+  m_position.z = ReadDouble (i);
+  m_duration = TimeStep (i.ReadNtohU64 ());
+  m_numBands = i.ReadNtohU32 ();
+  m_fl = ReadDouble (i);
+  m_fh = ReadDouble (i);
+  m_runs.resize (i.ReadNtohU32 ());
+  for (std::vector<Run>::iterator run = m_runs.begin (); run != m_runs.end (); ++run)
+    {
+      run->m_start = i.ReadNtohU32 ();
+      run->m_length = i.ReadNtohU32 ();
+      run->m_value = ReadDouble (i);
+    }
+  return GetSerializedSize ();
+}
+
+void
+DistributedSpectrumHeader::SetPsd (Ptr<const SpectrumValue> psd)
+{
+  Ptr<const SpectrumModel> model = psd->GetSpectrumModel ();
+  m_numBands = model->GetNumBands ();
+  m_fl = model->Begin ()->fl;
+  m_fh = (model->End () - 1)->fh;
+  m_runs.clear ();
+  for (uint32_t b = 0; b < m_numBands; b++)
+    {
+      double value = (*psd)[b];
+      if (value == 0)
+        {
+          continue;
+        }
+      if (!m_runs.empty () && m_runs.back ().m_start + m_runs.back ().m_length == b
+          && m_runs.back ().m_value == value)
+        {
+          m_runs.back ().m_length++;
+          continue;
+        }
+      Run run;
+      run.m_start = b;
+      run.m_length = 1;
+      run.m_value = value;
+      m_runs.push_back (run);
+    }
+}
+
+Ptr<SpectrumValue>
+DistributedSpectrumHeader::GetPsd (Ptr<const SpectrumModel> model) const
+{
+  Ptr<SpectrumValue> psd = Create<SpectrumValue> (model);
+  for (std::vector<Run>::const_iterator run = m_runs.begin (); run != m_runs.end (); ++run)
+    {
+      for (uint32_t b = run->m_start; b < run->m_start + run->m_length; b++)
+        {
+          (*psd)[b] = run->m_value;
+        }
+    }
+  return psd;
+}
+
+bool
+DistributedSpectrumHeader::IsSpectrumModel (Ptr<const SpectrumModel> model) const
+{
+  return model->GetNumBands () == m_numBands
+    && model->Begin ()->fl == m_fl
+    && (model->End () - 1)->fh == m_fh;
+}
+
+
+/**
+ * \ingroup lte
+ *
+ * The SpectrumPhy standing for a transmitter simulated by another
+ * system, which only has a position.
+ */
+class RemoteSpectrumPhy : public SpectrumPhy
+{
+public:
+  // inherited from SpectrumPhy
+  virtual void SetDevice (Ptr<NetDevice> d)
+  {
+  }
+  virtual Ptr<NetDevice> GetDevice () const
+  {
+    return 0;
+  }
+  virtual void SetMobility (Ptr<MobilityModel> m)
+  {
+    m_mobility = m;
+  }
+  virtual Ptr<MobilityModel> GetMobility ()
+  {
+    return m_mobility;
+  }
+  virtual void SetChannel (Ptr<SpectrumChannel> c)
+  {
+  }
+  virtual Ptr<const SpectrumModel> GetRxSpectrumModel () const
+  {
+    return 0;
+  }
+  virtual Ptr<AntennaModel> GetRxAntenna ()
+  {
+    return 0;
+  }
+  virtual void StartRx (Ptr<SpectrumSignalParameters> params)
+  {
+  }
+
+protected:
+  virtual void DoDispose ()
+  {
+    m_mobility = 0;
+    SpectrumPhy::DoDispose ();
+  }
+
+private:
+  Ptr<MobilityModel> m_mobility; //!< the position of the transmitter
+};
+
+
+/**
+ * \param position a position
+ * \param box a box
+ * \return the distance between position and box
+ */
+static double
+CalculateDistanceToBox (const Vector &position, const Box &box)
+{
+  double dx = std::max (std::max (box.xMin - position.x, position.x - box.xMax), 0.0);
+  double dy = std::max (std::max (box.yMin - position.y, position.y - box.yMax), 0.0);
+  double dz = std::max (std::max (box.zMin - position.z, position.z - box.zMax), 0.0);
+  return std::sqrt (dx * dx + dy * dy + dz * dz);
+}
+
+
+DistributedSpectrumChannel::DistributedSpectrumChannel ()
+  : m_systemId (MpiInterface::GetSystemId ()),
+    m_systemCount (MpiInterface::GetSize ())
+{
+  NS_LOG_FUNCTION (this);
+}
+
+TypeId
+DistributedSpectrumChannel::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::DistributedSpectrumChannel")
+    .SetParent<MultiModelSpectrumChannel> ()
+    .SetGroupName ("Lte")
+    .AddConstructor<DistributedSpectrumChannel> ()
+    .AddAttribute ("Lookahead",
+                   "The delay after which the other systems receive the signals "
+                   "transmitted by the local nodes which were not announced, and the "
+                   "minimum delay of the announcements (see AnnounceTx), which is "
+                   "also the lookahead of the parallel simulator. It cannot be "
+                   "changed after the creation of the channel.",
+                   TimeValue (MilliSeconds (1)),
+                   MakeTimeAccessor (&DistributedSpectrumChannel::m_lookahead),
+                   MakeTimeChecker (TimeStep (1)))
+    .AddAttribute ("InterferenceRange",
+                   "The maximum distance in meters between the transmitter of a "
+                   "signal and the region of a system (see SetRegion) for the signal "
+                   "to be sent to the system.",
+                   DoubleValue (1000),
+                   MakeDoubleAccessor (&DistributedSpectrumChannel::m_interferenceRange),
+                   MakeDoubleChecker<double> (0))
+  ;
+  return tid;
+}
+
+void
+DistributedSpectrumChannel::NotifyConstructionCompleted (void)
+{
+  NS_LOG_FUNCTION (this);
+  // any system may receive the signals of the local nodes as they move
+  for (uint32_t systemId = 0; systemId < m_systemCount; systemId++)
+    {
+      if (systemId != m_systemId)
+        {
+          MpiInterface::AddRemoteLink (systemId, this, m_lookahead);
+        }
+    }
+  MultiModelSpectrumChannel::NotifyConstructionCompleted ();
+}
+
+void
+DistributedSpectrumChannel::DoDispose ()
+{
+  NS_LOG_FUNCTION (this);
+  m_codecs.clear ();
+  m_anchors.clear ();
+  m_spectrumModels.clear ();
+  for (std::map<uint32_t, Ptr<SpectrumPhy> >::iterator it = m_remotePhys.begin (); it != m_remotePhys.end (); ++it)
+    {
+      it->second->Dispose ();
+    }
+  m_remotePhys.clear ();
+  m_announced.clear ();
+  MultiModelSpectrumChannel::DoDispose ();
+}
+
+void
+DistributedSpectrumChannel::AddCodec (Ptr<SpectrumSignalCodec> codec)
+{
+  NS_LOG_FUNCTION (this << codec);
+  NS_ABORT_MSG_IF (m_codecs.size () >= DistributedSpectrumHeader::NO_CODEC, "Too many codecs");
+  m_codecs.push_back (codec);
+}
+
+void
+DistributedSpectrumChannel::SetRegion (uint32_t systemId, const Box &region)
+{
+  NS_LOG_FUNCTION (this << systemId << region);
+  m_regions[systemId] = region;
+}
+
+Time
+DistributedSpectrumChannel::GetLookahead (void) const
+{
+  return m_lookahead;
+}
+
+uint32_t
+DistributedSpectrumChannel::GetSystemId (Ptr<const SpectrumPhy> phy) const
+{
+  Ptr<NetDevice> device = phy->GetDevice ();
+  if (device == 0 || device->GetNode () == 0)
+    {
+      // not attached to a node: simulated by every system
+      return m_systemId;
+    }
+  return device->GetNode ()->GetSystemId ();
+}
+
+void
+DistributedSpectrumChannel::AddSpectrumModel (Ptr<const SpectrumModel> model)
+{
+  if (std::find (m_spectrumModels.begin (), m_spectrumModels.end (), model) == m_spectrumModels.end ())
+    {
+      m_spectrumModels.push_back (model);
+    }
+}
+
+void
+DistributedSpectrumChannel::AddRx (Ptr<SpectrumPhy> phy)
+{
+  NS_LOG_FUNCTION (this << phy);
+  AddSpectrumModel (phy->GetRxSpectrumModel ());
+  uint32_t systemId = GetSystemId (phy);
+
+  // the signals sent to a system are received by the device of its
+  // first SpectrumPhy, the same on all the systems
+  Ptr<NetDevice> device = phy->GetDevice ();
+  if (device != 0 && device->GetNode () != 0 && m_anchors.find (systemId) == m_anchors.end ())
+    {
+      m_anchors[systemId] = device;
+      if (systemId == m_systemId && device->GetObject<MpiReceiver> () == 0)
+        {
+          Ptr<MpiReceiver> receiver = CreateObject<MpiReceiver> ();
+          receiver->SetReceiveCallback (MakeCallback (&DistributedSpectrumChannel::ReceiveRemote));
+          device->AggregateObject (receiver);
+        }
+    }
+
+  if (systemId == m_systemId)
+    {
+      MultiModelSpectrumChannel::AddRx (phy);
+    }
+}
+
+void
+DistributedSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> params)
+{
+  NS_LOG_FUNCTION (this << params);
+  NS_ASSERT (params->txPhy);
+  if (GetSystemId (params->txPhy) != m_systemId)
+    {
+      NS_LOG_LOGIC ("dropping the signal of a node of another system");
+      return;
+    }
+  Ptr<NetDevice> device = params->txPhy->GetDevice ();
+  if (m_announced.erase (params) > 0)
+    {
+      NS_LOG_LOGIC ("the signal was sent to the other systems when announced");
+    }
+  else if (m_systemCount > 1 && device != 0 && device->GetNode () != 0)
+    {
+      SendRemote (params, Time (0));
+    }
+  MultiModelSpectrumChannel::StartTx (params);
+}
+
+void
+DistributedSpectrumChannel::AnnounceTx (Ptr<SpectrumSignalParameters> params, Time delay)
+{
+  NS_LOG_FUNCTION (this << params << delay);
+  NS_ASSERT (params->txPhy);
+  NS_ABORT_MSG_IF (delay < m_lookahead, "A signal must be announced at least " << m_lookahead << " in advance");
+  if (GetSystemId (params->txPhy) != m_systemId)
+    {
+      NS_LOG_LOGIC ("dropping the signal of a node of another system");
+      return;
+    }
+  Ptr<NetDevice> device = params->txPhy->GetDevice ();
+  if (m_systemCount > 1 && device != 0 && device->GetNode () != 0)
+    {
+      SendRemote (params, delay);
+    }
+  m_announced.insert (params);
+}
+
+void
+DistributedSpectrumChannel::SendRemote (Ptr<const SpectrumSignalParameters> params, Time delay)
+{
+  NS_LOG_FUNCTION (this << params << delay);
+
+  DistributedSpectrumHeader header;
+  header.m_channelId = GetId ();
+  header.m_txNodeId = params->txPhy->GetDevice ()->GetNode ()->GetId ();
+  Ptr<MobilityModel> txMobility = params->txPhy->GetMobility ();
+  if (txMobility != 0)
+    {
+      // the position at the start of the transmission
+      Vector position = txMobility->GetPosition ();
+      Vector velocity = txMobility->GetVelocity ();
+      double seconds = delay.GetSeconds ();
+      header.m_hasPosition = true;
+      header.m_position = Vector (position.x + velocity.x * seconds,
+                                  position.y + velocity.y * seconds,
+                                  position.z + velocity.z * seconds);
+    }
+  header.m_duration = params->duration;
+  header.SetPsd (params->psd);
+  AddSpectrumModel (params->psd->GetSpectrumModel ());
+
+  Ptr<Packet> p;
+  for (uint32_t c = 0; c < m_codecs.size () && p == 0; c++)
+    {
+      p = m_codecs[c]->Encode (params);
+      header.m_codec = c;
+    }
+  if (p == 0)
+    {
+      p = Create<Packet> ();
+      header.m_codec = DistributedSpectrumHeader::NO_CODEC;
+    }
+  p->AddHeader (header);
+
+  // the signals which were not announced are delivered late
+  Time rxTime = Simulator::Now () + std::max (delay, m_lookahead);
+  for (std::map<uint32_t, Ptr<NetDevice> >::const_iterator anchor = m_anchors.begin (); anchor != m_anchors.end (); ++anchor)
+    {
+      if (anchor->first == m_systemId)
+        {
+          continue;
+        }
+      std::map<uint32_t, Box>::const_iterator region = m_regions.find (anchor->first);
+      if (region != m_regions.end () && header.m_hasPosition
+          && CalculateDistanceToBox (header.m_position, region->second) > m_interferenceRange)
+        {
+          continue;
+        }
+      NS_LOG_LOGIC ("sending the signal to system " << anchor->first);
+      MpiInterface::SendPacket (p, rxTime, anchor->second->GetNode ()->GetId (), anchor->second->GetIfIndex ());
+    }
+}
+
+void
+DistributedSpectrumChannel::ReceiveRemote (Ptr<Packet> p)
+{
+  DistributedSpectrumHeader header;
+  p->PeekHeader (header);
+  Ptr<DistributedSpectrumChannel> channel = DynamicCast<DistributedSpectrumChannel> (ChannelList::GetChannel (header.m_channelId));
+  NS_ABORT_MSG_IF (channel == 0, "Channel " << header.m_channelId << " is not a DistributedSpectrumChannel: "
+                   "the systems did not create the same channels");
+  channel->DoReceiveRemote (p);
+}
+
+void
+DistributedSpectrumChannel::DoReceiveRemote (Ptr<Packet> p)
+{
+  NS_LOG_FUNCTION (this << p);
+
+  DistributedSpectrumHeader header;
+  p->RemoveHeader (header);
+
+  Ptr<const SpectrumModel> model;
+  for (std::vector<Ptr<const SpectrumModel> >::const_iterator it = m_spectrumModels.begin ();
+       it != m_spectrumModels.end () && model == 0; ++it)
+    {
+      if (header.IsSpectrumModel (*it))
+        {
+          model = *it;
+        }
+    }
+  if (model == 0)
+    {
+      NS_LOG_LOGIC ("no SpectrumPhy of this system uses the SpectrumModel of the signal");
+      return;
+    }
+
+  Ptr<SpectrumSignalParameters> params;
+  if (header.m_codec != DistributedSpectrumHeader::NO_CODEC)
+    {
+      NS_ABORT_MSG_IF (header.m_codec >= m_codecs.size (), "Unknown codec " << (uint32_t) header.m_codec
+                       << ": the systems did not add the same codecs");
+      params = m_codecs[header.m_codec]->Decode (p);
+    }
+  else
+    {
+      params = Create<SpectrumSignalParameters> ();
+    }
+  params->duration = header.m_duration;
+  params->psd = header.GetPsd (model);
+
+  Ptr<SpectrumPhy> &txPhy = m_remotePhys[header.m_txNodeId];
+  if (txPhy == 0)
+    {
+      txPhy = CreateObject<RemoteSpectrumPhy> ();
+    }
+  if (header.m_hasPosition)
+    {
+      if (txPhy->GetMobility () == 0)
+        {
+          txPhy->SetMobility (CreateObject<ConstantPositionMobilityModel> ());
+        }
+      txPhy->GetMobility ()->SetPosition (header.m_position);
+    }
+  params->txPhy = txPhy;
+
+  MultiModelSpectrumChannel::StartTx (params);
+}
+
+} // namespace ns3
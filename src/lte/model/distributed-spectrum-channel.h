@@ -0,0 +1,168 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef DISTRIBUTED_SPECTRUM_CHANNEL_H
+#define DISTRIBUTED_SPECTRUM_CHANNEL_H
+
+#include <ns3/multi-model-spectrum-channel.h>
+#include <ns3/spectrum-signal-codec.h>
+#include <ns3/net-device.h>
+#include <ns3/box.h>
+#include <map>
+#include <set>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \ingroup lte
+ *
+ * A MultiModelSpectrumChannel spanning the systems of an MPI
+ * distributed simulation (see MpiInterface).
+ *
+ * The nodes are partitioned among the systems by their system id, and
+ * all the systems must create the same nodes, devices and channels, in
+ * the same order. Each system only delivers the signals to the
+ * SpectrumPhy of its own nodes, and only the SpectrumPhy of its own
+ * nodes may transmit.
+ *
+ * A signal transmitted by a local SpectrumPhy is also sent to the other
+ * systems, with the position of the transmitter, a summary of its PSD
+ * and the parameters encoded by the first SpectrumSignalCodec (see
+ * AddCodec) supporting it; the signals no codec supports are received
+ * by the other systems as plain SpectrumSignalParameters, i.e., as
+ * interference. If a region is set for a system (see SetRegion), the
+ * signals are only sent to it when their transmitter is within
+ * InterferenceRange of the region.
+ *
+ * A transmitter knowing its signal at least Lookahead in advance, which
+ * is also the lookahead of the parallel simulator, announces it with
+ * AnnounceTx: the signal is sent to the other systems right away, and
+ * all the systems deliver it at the start of its transmission. The other
+ * systems deliver the signals which were not announced Lookahead after
+ * the start of their transmission, i.e., one TTI late with the default
+ * Lookahead. The propagation loss of the remote links is computed by the
+ * receiving system, from a SpectrumPhy standing for the remote
+ * transmitter.
+ *
+ * MpiInterface::Enable must be called before the channel is created.
+ */
+class DistributedSpectrumChannel : public MultiModelSpectrumChannel
+{
+public:
+  DistributedSpectrumChannel ();
+
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  /**
+   * Add a codec for the signal parameters of a technology. The same
+   * codecs must be added on all the systems, in the same order.
+   *
+   * \param codec the codec
+   */
+  void AddCodec (Ptr<SpectrumSignalCodec> codec);
+
+  /**
+   * Set the region of the nodes of a system.
+   *
+   * \param systemId the system
+   * \param region the region
+   */
+  void SetRegion (uint32_t systemId, const Box &region);
+
+  /**
+   * \return the delay after which the other systems receive the signals
+   * which were not announced, and the minimum delay of the announcements
+   */
+  Time GetLookahead (void) const;
+
+  /**
+   * Announce a signal that a local SpectrumPhy starts to transmit after
+   * a delay, with StartTx. The signal is sent to the other systems, which
+   * deliver it at the start of its transmission; StartTx does not send it
+   * again. The position of the transmitter at the start of the
+   * transmission is extrapolated from its current velocity.
+   *
+   * \param params the parameters of the signal, which are passed to StartTx
+   * \param delay the delay of the start of the transmission, at least the lookahead
+   */
+  void AnnounceTx (Ptr<SpectrumSignalParameters> params, Time delay);
+
+  // inherited from SpectrumChannel
+  virtual void AddRx (Ptr<SpectrumPhy> phy);
+  virtual void StartTx (Ptr<SpectrumSignalParameters> params);
+
+protected:
+  virtual void DoDispose ();
+  virtual void NotifyConstructionCompleted (void);
+
+private:
+  /**
+   * Pass a signal received from another system to the channel it was
+   * sent on.
+   *
+   * \param p the message of the signal
+   */
+  static void ReceiveRemote (Ptr<Packet> p);
+
+  /**
+   * Start the transmission of a signal received from another system.
+   *
+   * \param p the message of the signal
+   */
+  void DoReceiveRemote (Ptr<Packet> p);
+
+  /**
+   * \param phy a SpectrumPhy
+   * \return the system simulating the node of phy
+   */
+  uint32_t GetSystemId (Ptr<const SpectrumPhy> phy) const;
+
+  /**
+   * Remember a SpectrumModel, to rebuild the PSD of the remote signals.
+   *
+   * \param model the SpectrumModel
+   */
+  void AddSpectrumModel (Ptr<const SpectrumModel> model);
+
+  /**
+   * Send a signal transmitted by a local SpectrumPhy to the other systems.
+   *
+   * \param params the parameters of the signal
+   * \param delay the delay of the start of the transmission
+   */
+  void SendRemote (Ptr<const SpectrumSignalParameters> params, Time delay);
+
+  Time m_lookahead;           //!< the delay of the signals sent to the other systems
+  double m_interferenceRange; //!< the maximum distance between a transmitter and the region of a system
+  uint32_t m_systemId;        //!< the local system
+  uint32_t m_systemCount;     //!< the number of systems
+
+  std::vector<Ptr<SpectrumSignalCodec> > m_codecs;      //!< the codecs, in the order they were added
+  std::map<uint32_t, Box> m_regions;                    //!< the region of each system
+  std::map<uint32_t, Ptr<NetDevice> > m_anchors;        //!< the device receiving the signals sent to each system
+  std::vector<Ptr<const SpectrumModel> > m_spectrumModels; //!< the SpectrumModels of the signals
+  std::map<uint32_t, Ptr<SpectrumPhy> > m_remotePhys;   //!< the SpectrumPhy standing for each remote transmitter
+  std::set<Ptr<const SpectrumSignalParameters> > m_announced; //!< the announced signals not transmitted yet
+};
+
+} // namespace ns3
+
+#endif /* DISTRIBUTED_SPECTRUM_CHANNEL_H */
@@ -53,6 +53,8 @@ LteInterference::DoDispose ()
   m_rxSignal = 0;
   m_allSignals = 0;
   m_noise = 0;
+  m_interf = 0;
+  m_sinr = 0;
   Object::DoDispose ();
 } 
 
@@ -134,8 +136,14 @@ LteInterference::EndRx ()
 void
 LteInterference::AddSignal (Ptr<const SpectrumValue> spd, const Time duration)
 {
-  NS_LOG_FUNCTION (this << *spd << duration);
-  DoAddSignal (spd);
+  AddSignal (spd, 1.0, duration);
+}
+
+void
+LteInterference::AddSignal (Ptr<const SpectrumValue> spd, double gain, const Time duration)
+{
+  NS_LOG_FUNCTION (this << *spd << gain << duration);
+  DoAddSignal (spd, gain);
   uint32_t signalId = ++m_lastSignalId;
   if (signalId == m_lastSignalIdBeforeReset)
     {
@@ -146,27 +154,27 @@ LteInterference::AddSignal (Ptr<const SpectrumValue> spd, const Time duration)
       // boundary further.
       m_lastSignalIdBeforeReset += 0x10000000;
     }
-  Simulator::Schedule (duration, &LteInterference::DoSubtractSignal, this, spd, signalId);
+  Simulator::Schedule (duration, &LteInterference::DoSubtractSignal, this, spd, gain, signalId);
 }
 
 
 void
-LteInterference::DoAddSignal  (Ptr<const SpectrumValue> spd)
+LteInterference::DoAddSignal  (Ptr<const SpectrumValue> spd, double gain)
 { 
-  NS_LOG_FUNCTION (this << *spd);
+  NS_LOG_FUNCTION (this << *spd << gain);
   ConditionallyEvaluateChunk ();
-  (*m_allSignals) += (*spd);
+  m_allSignals->AddScaled (*spd, gain);
 }
 
 void
-LteInterference::DoSubtractSignal  (Ptr<const SpectrumValue> spd, uint32_t signalId)
+LteInterference::DoSubtractSignal  (Ptr<const SpectrumValue> spd, double gain, uint32_t signalId)
 { 
-  NS_LOG_FUNCTION (this << *spd);
+  NS_LOG_FUNCTION (this << *spd << gain);
   ConditionallyEvaluateChunk ();   
   int32_t deltaSignalId = signalId - m_lastSignalIdBeforeReset;
   if (deltaSignalId > 0)
     {   
-      (*m_allSignals) -= (*spd);
+      m_allSignals->AddScaled (*spd, -gain);
     }
   else
     {
@@ -188,9 +196,9 @@ LteInterference::ConditionallyEvaluateChunk ()
     {
       NS_LOG_LOGIC (this << " signal = " << *m_rxSignal << " allSignals = " << *m_allSignals << " noise = " << *m_noise);
 
-      SpectrumValue interf =  (*m_allSignals) - (*m_rxSignal) + (*m_noise);
-
-      SpectrumValue sinr = (*m_rxSignal) / interf;
+      SpectrumValue& interf = *m_interf;
+      SpectrumValue& sinr = *m_sinr;
+      CalculateSinr (*m_rxSignal, *m_allSignals, *m_noise, interf, sinr);
       Time duration = Now () - m_lastChangeTime;
       for (std::list<Ptr<LteChunkProcessor> >::const_iterator it = m_sinrChunkProcessorList.begin (); it != m_sinrChunkProcessorList.end (); ++it)
         {
@@ -217,6 +225,8 @@ LteInterference::SetNoisePowerSpectralDensity (Ptr<const SpectrumValue> noisePsd
   // reset m_allSignals (will reset if already set previously)
   // this is needed since this method can potentially change the SpectrumModel
   m_allSignals = Create<SpectrumValue> (noisePsd->GetSpectrumModel ());
+  m_interf = Create<SpectrumValue> (noisePsd->GetSpectrumModel ());
+  m_sinr = Create<SpectrumValue> (noisePsd->GetSpectrumModel ());
   if (m_receiving == true)
     {
       // abort rx
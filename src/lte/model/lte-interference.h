@@ -109,6 +109,16 @@ public:
    */
   void AddSignal (Ptr<const SpectrumValue> spd, const Time duration);
 
+  /**
+   * notify that a new signal is being perceived in the medium, whose
+   * power spectral density is shared with other receivers
+   *
+   * @param spd the power spectral density of the new signal, not scaled
+   * @param gain the linear gain to be applied to spd
+   * @param duration the duration of the new signal
+   */
+  void AddSignal (Ptr<const SpectrumValue> spd, double gain, const Time duration);
+
 
   /**
    *
@@ -126,15 +136,17 @@ private:
    * Add signal function
    *
    * @param spd the power spectral density of the new signal
+   * @param gain the linear gain to be applied to spd
    */
-  void DoAddSignal  (Ptr<const SpectrumValue> spd);
+  void DoAddSignal  (Ptr<const SpectrumValue> spd, double gain);
   /**
    * Subtract signal
    *
    * @param spd the power spectral density of the new signal
+   * @param gain the linear gain to be applied to spd
    * @param signalId the signal ID
    */
-  void DoSubtractSignal  (Ptr<const SpectrumValue> spd, uint32_t signalId);
+  void DoSubtractSignal  (Ptr<const SpectrumValue> spd, double gain, uint32_t signalId);
 
 
 
@@ -152,6 +164,9 @@ private:
 
   Ptr<const SpectrumValue> m_noise; ///< the noise value
 
+  Ptr<SpectrumValue> m_interf; ///< the interference plus noise of the last chunk
+  Ptr<SpectrumValue> m_sinr; ///< the SINR of the last chunk
+
   Time m_lastChangeTime;     /**< the time of the last change in
                                 m_TotalPower */
 
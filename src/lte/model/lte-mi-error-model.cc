@@ -33,8 +33,10 @@
 #include <vector>
 #include <ns3/log.h>
 #include <ns3/pointer.h>
+#include <ns3/abort.h>
 #include <stdint.h>
 #include <cmath>
+#include <algorithm>
 #include "stdlib.h"
 #include <ns3/lte-mi-error-model.h>
 
@@ -338,80 +340,89 @@ LteMiErrorModel::Mib (const SpectrumValue& sinr, const std::vector<int>& map, ui
   
   double MI;
   double MIsum = 0.0;
-  SpectrumValue sinrCopy = sinr;
   
   for (uint32_t i = 0; i < map.size (); i++)
     {
-      double sinrLin = sinrCopy[map.at (i)];
-      if (mcs <= MI_QPSK_MAX_ID) // QPSK
-        {
+      double sinrLin = sinr[map.at (i)];
+      MI = MiPerRb (sinrLin, mcs);
+      NS_LOG_LOGIC (" RB " << map.at (i) << "Minimum SNR = " << 10 * std::log10 (sinrLin) << " dB, " << sinrLin << " V, MCS = " << (uint16_t)mcs << ", MI = " << MI);
+      MIsum += MI;
+    }
+  MI = MIsum / map.size ();
+  NS_LOG_LOGIC (" MI = " << MI);
+  return MI;
+}
+
+
+double
+LteMiErrorModel::MiPerRb (double sinrLin, uint8_t mcs)
+{
+  double MI;
 
-          if (sinrLin > MI_map_qpsk_axis[MI_MAP_QPSK_SIZE-1])
+  if (mcs <= MI_QPSK_MAX_ID) // QPSK
+    {
+
+      if (sinrLin > MI_map_qpsk_axis[MI_MAP_QPSK_SIZE-1])
+        {
+          MI = 1;
+        }
+      else 
+        { 
+          // since the values in MI_map_qpsk_axis are uniformly spaced, we have
+          // index = ((sinrLin - value[0]) / (value[SIZE-1] - value[0])) * (SIZE-1)
+          // the scaling coefficient is always the same, so we use a static const
+          // to speed up the calculation
+          static const double scalingCoeffQpsk = 
+            (MI_MAP_QPSK_SIZE - 1) / (MI_map_qpsk_axis[MI_MAP_QPSK_SIZE-1] - MI_map_qpsk_axis[0]);
+          double sinrIndexDouble = (sinrLin -  MI_map_qpsk_axis[0]) * scalingCoeffQpsk + 1;
+          uint32_t sinrIndex = std::max(0.0, std::floor (sinrIndexDouble));
+          NS_ASSERT_MSG (sinrIndex < MI_MAP_QPSK_SIZE, "MI map out of data");
+          MI = MI_map_qpsk[sinrIndex];
+        }
+    }
+  else
+    {
+      if (mcs > MI_QPSK_MAX_ID && mcs <= MI_16QAM_MAX_ID )	// 16-QAM
+        {
+          if (sinrLin > MI_map_16qam_axis[MI_MAP_16QAM_SIZE-1])
             {
               MI = 1;
             }
           else 
-            { 
-              // since the values in MI_map_qpsk_axis are uniformly spaced, we have
+            {
+              // since the values in MI_map_16QAM_axis are uniformly spaced, we have
               // index = ((sinrLin - value[0]) / (value[SIZE-1] - value[0])) * (SIZE-1)
               // the scaling coefficient is always the same, so we use a static const
               // to speed up the calculation
-              static const double scalingCoeffQpsk = 
-                (MI_MAP_QPSK_SIZE - 1) / (MI_map_qpsk_axis[MI_MAP_QPSK_SIZE-1] - MI_map_qpsk_axis[0]);
-              double sinrIndexDouble = (sinrLin -  MI_map_qpsk_axis[0]) * scalingCoeffQpsk + 1;
+              static const double scalingCoeff16qam = 
+                (MI_MAP_16QAM_SIZE - 1) / (MI_map_16qam_axis[MI_MAP_16QAM_SIZE-1] - MI_map_16qam_axis[0]);
+              double sinrIndexDouble = (sinrLin -  MI_map_16qam_axis[0]) * scalingCoeff16qam + 1;
               uint32_t sinrIndex = std::max(0.0, std::floor (sinrIndexDouble));
-              NS_ASSERT_MSG (sinrIndex < MI_MAP_QPSK_SIZE, "MI map out of data");
-              MI = MI_map_qpsk[sinrIndex];
+              NS_ASSERT_MSG (sinrIndex < MI_MAP_16QAM_SIZE, "MI map out of data");
+              MI = MI_map_16qam[sinrIndex];
             }
         }
-      else
+      else // 64-QAM
         {
-          if (mcs > MI_QPSK_MAX_ID && mcs <= MI_16QAM_MAX_ID )	// 16-QAM
+          if (sinrLin > MI_map_64qam_axis[MI_MAP_64QAM_SIZE-1])
             {
-              if (sinrLin > MI_map_16qam_axis[MI_MAP_16QAM_SIZE-1])
-                {
-                  MI = 1;
-                }
-              else 
-                {
-                  // since the values in MI_map_16QAM_axis are uniformly spaced, we have
-                  // index = ((sinrLin - value[0]) / (value[SIZE-1] - value[0])) * (SIZE-1)
-                  // the scaling coefficient is always the same, so we use a static const
-                  // to speed up the calculation
-                  static const double scalingCoeff16qam = 
-                    (MI_MAP_16QAM_SIZE - 1) / (MI_map_16qam_axis[MI_MAP_16QAM_SIZE-1] - MI_map_16qam_axis[0]);
-                  double sinrIndexDouble = (sinrLin -  MI_map_16qam_axis[0]) * scalingCoeff16qam + 1;
-                  uint32_t sinrIndex = std::max(0.0, std::floor (sinrIndexDouble));
-                  NS_ASSERT_MSG (sinrIndex < MI_MAP_16QAM_SIZE, "MI map out of data");
-                  MI = MI_map_16qam[sinrIndex];
-                }
+              MI = 1;
             }
-          else // 64-QAM
+          else
             {
-              if (sinrLin > MI_map_64qam_axis[MI_MAP_64QAM_SIZE-1])
-                {
-                  MI = 1;
-                }
-              else
-                {
-                  // since the values in MI_map_64QAM_axis are uniformly spaced, we have
-                  // index = ((sinrLin - value[0]) / (value[SIZE-1] - value[0])) * (SIZE-1)
-                  // the scaling coefficient is always the same, so we use a static const
-                  // to speed up the calculation
-                  static const double scalingCoeff64qam = 
-                    (MI_MAP_64QAM_SIZE - 1) / (MI_map_64qam_axis[MI_MAP_64QAM_SIZE-1] - MI_map_64qam_axis[0]);
-                  double sinrIndexDouble = (sinrLin -  MI_map_64qam_axis[0]) * scalingCoeff64qam + 1;
-                  uint32_t sinrIndex = std::max(0.0, std::floor (sinrIndexDouble));
-                  NS_ASSERT_MSG (sinrIndex < MI_MAP_64QAM_SIZE, "MI map out of data");
-                  MI = MI_map_64qam[sinrIndex];
-                }
+              // since the values in MI_map_64QAM_axis are uniformly spaced, we have
+              // index = ((sinrLin - value[0]) / (value[SIZE-1] - value[0])) * (SIZE-1)
+              // the scaling coefficient is always the same, so we use a static const
+              // to speed up the calculation
+              static const double scalingCoeff64qam = 
+                (MI_MAP_64QAM_SIZE - 1) / (MI_map_64qam_axis[MI_MAP_64QAM_SIZE-1] - MI_map_64qam_axis[0]);
+              double sinrIndexDouble = (sinrLin -  MI_map_64qam_axis[0]) * scalingCoeff64qam + 1;
+              uint32_t sinrIndex = std::max(0.0, std::floor (sinrIndexDouble));
+              NS_ASSERT_MSG (sinrIndex < MI_MAP_64QAM_SIZE, "MI map out of data");
+              MI = MI_map_64qam[sinrIndex];
             }
         }
-      NS_LOG_LOGIC (" RB " << map.at (i) << "Minimum SNR = " << 10 * std::log10 (sinrLin) << " dB, " << sinrLin << " V, MCS = " << (uint16_t)mcs << ", MI = " << MI);
-      MIsum += MI;
     }
-  MI = MIsum / map.size ();
-  NS_LOG_LOGIC (" MI = " << MI);
   return MI;
 }
 
@@ -558,7 +569,15 @@ LteMiErrorModel::GetTbDecodificationStats (const SpectrumValue& sinr, const std:
 {
   NS_LOG_FUNCTION (sinr << &map << (uint32_t) size << (uint32_t) mcs);
 
-  double tbMi = Mib(sinr, map, mcs);
+  return GetTbDecodificationStats (Mib (sinr, map, mcs), size, mcs, miHistory);
+}
+
+
+TbStats_t
+LteMiErrorModel::GetTbDecodificationStats (double tbMi, uint16_t size, uint8_t mcs, const HarqProcessInfoList_t& miHistory)
+{
+  NS_LOG_FUNCTION (tbMi << (uint32_t) size << (uint32_t) mcs);
+
   double MI = 0.0;
   double Reff = 0.0;
   NS_ASSERT (mcs < 29);
@@ -740,6 +759,129 @@ LteMiErrorModel::GetTbDecodificationStats (const SpectrumValue& sinr, const std:
 }
 
 
+std::set<const LteMiErrorModelCache*> LteMiErrorModelCache::m_caches;
+LteMiErrorModelCache::Stats LteMiErrorModelCache::m_retiredStats = { 0, 0, 0, 0.0, 0.0 };
+SystemMutex LteMiErrorModelCache::m_cachesMutex;
+
+// the bucket index of a MIB in [0, 1] is at most 1 / step, and has the 40
+// low bits of the key
+const double LteMiErrorModelCache::MIN_STEP = 1.0 / ((1ULL << 40) - 1);
+
+LteMiErrorModelCache::LteMiErrorModelCache ()
+  : m_step (0.0),
+    m_validationEnabled (false)
+{
+  m_stats = { 0, 0, 0, 0.0, 0.0 };
+  CriticalSection cs (m_cachesMutex);
+  m_caches.insert (this);
+}
+
+LteMiErrorModelCache::~LteMiErrorModelCache ()
+{
+  CriticalSection cs (m_cachesMutex);
+  Accumulate (m_retiredStats, m_stats);
+  m_caches.erase (this);
+}
+
+void
+LteMiErrorModelCache::SetStep (double step)
+{
+  NS_ABORT_MSG_IF (step != 0.0 && (step < MIN_STEP || step > 1.0),
+                   "The quantization step of the MIB must be 0 or in [" << MIN_STEP << ", 1], not " << step);
+  if (step != m_step)
+    {
+      m_tbStats.clear ();
+    }
+  m_step = step;
+}
+
+double
+LteMiErrorModelCache::GetStep () const
+{
+  return m_step;
+}
+
+void
+LteMiErrorModelCache::SetValidationEnabled (bool enabled)
+{
+  m_validationEnabled = enabled;
+}
+
+bool
+LteMiErrorModelCache::IsValidationEnabled () const
+{
+  return m_validationEnabled;
+}
+
+TbStats_t
+LteMiErrorModelCache::GetTbDecodificationStats (const SpectrumValue& sinr, const std::vector<int>& map, uint16_t size, uint8_t mcs, const HarqProcessInfoList_t& miHistory)
+{
+  if (m_step <= 0.0 || miHistory.size () > 0 || map.empty ())
+    {
+      return LteMiErrorModel::GetTbDecodificationStats (sinr, map, size, mcs, miHistory);
+    }
+
+  double mib = LteMiErrorModel::Mib (sinr, map, mcs);
+  uint64_t bucket = std::floor (mib / m_step + 0.5);
+  uint64_t key = ((uint64_t) mcs << 56) | ((uint64_t) size << 40) | bucket;
+
+  m_stats.lookups++;
+  TbStats_t ret;
+  std::map<uint64_t, TbStats_t>::const_iterator it = m_tbStats.find (key);
+  if (it != m_tbStats.end ())
+    {
+      m_stats.hits++;
+      ret = it->second;
+    }
+  else
+    {
+      ret = LteMiErrorModel::GetTbDecodificationStats (bucket * m_step, size, mcs, miHistory);
+      m_tbStats.insert (std::make_pair (key, ret));
+    }
+  ret.mi = mib;
+  NS_LOG_LOGIC ("cached TB stats for MCS " << (uint16_t) mcs << " size " << size << " MIB " << mib << ": TBLER " << ret.tbler);
+
+  if (m_validationEnabled)
+    {
+      TbStats_t exact = LteMiErrorModel::GetTbDecodificationStats (sinr, map, size, mcs, miHistory);
+      double error = std::abs (ret.tbler - exact.tbler);
+      m_stats.validated++;
+      m_stats.sumError += error;
+      m_stats.maxError = std::max (m_stats.maxError, error);
+      NS_LOG_DEBUG ("TBLER cached " << ret.tbler << " exact " << exact.tbler << " error " << error);
+    }
+  return ret;
+}
+
+LteMiErrorModelCache::Stats
+LteMiErrorModelCache::GetStats () const
+{
+  return m_stats;
+}
+
+LteMiErrorModelCache::Stats
+LteMiErrorModelCache::GetGlobalStats ()
+{
+  CriticalSection cs (m_cachesMutex);
+  Stats total = m_retiredStats;
+  for (std::set<const LteMiErrorModelCache*>::const_iterator it = m_caches.begin (); it != m_caches.end (); ++it)
+    {
+      Accumulate (total, (*it)->m_stats);
+    }
+  return total;
+}
+
+void
+LteMiErrorModelCache::Accumulate (Stats& total, const Stats& stats)
+{
+  total.lookups += stats.lookups;
+  total.hits += stats.hits;
+  total.validated += stats.validated;
+  total.sumError += stats.sumError;
+  total.maxError = std::max (total.maxError, stats.maxError);
+}
+
+
   
 
 } // namespace ns3
@@ -34,8 +34,11 @@
 
 
 #include <list>
+#include <map>
+#include <set>
 #include <vector>
 #include <ns3/ptr.h>
+#include <ns3/system-mutex.h>
 #include <stdint.h>
 #include <ns3/spectrum-value.h>
 #include <ns3/lte-harq-phy.h>
@@ -91,6 +94,13 @@ public:
    * \return the mmib
    */
   static double Mib (const SpectrumValue& sinr, const std::vector<int>& map, uint8_t mcs);
+  /**
+   * \brief find the mutual information of a single RB
+   * \param sinrLin the linear SINR of the RB
+   * \param mcs the MCS of the TB
+   * \return the mutual information
+   */
+  static double MiPerRb (double sinrLin, uint8_t mcs);
   /** 
    * \brief map the mmib (mean mutual information per bit) for different MCS
    * \param mib mean mutual information per bit of a code-block
@@ -110,6 +120,16 @@ public:
    * \return the TB error rate and MI
    */
   static TbStats_t GetTbDecodificationStats (const SpectrumValue& sinr, const std::vector<int>& map, uint16_t size, uint8_t mcs, HarqProcessInfoList_t miHistory);
+
+  /**
+   * \brief run the error-model algorithm for a TB of known MI
+   * \param tbMi the mmib of the TB, as returned by Mib
+   * \param size the size in bytes of the TB
+   * \param mcs the MCS of the TB
+   * \param miHistory  MI of past transmissions (in case of retx)
+   * \return the TB error rate and MI
+   */
+  static TbStats_t GetTbDecodificationStats (double tbMi, uint16_t size, uint8_t mcs, const HarqProcessInfoList_t& miHistory);
   
   /** 
   * \brief run the error-model algorithm for the specified PCFICH+PDCCH channels
@@ -126,6 +146,95 @@ public:
 };
 
 
+/**
+ * Memoization of the TB decodification statistics of first transmissions.
+ *
+ * The TB error rate of a first transmission only depends on its MCS, its
+ * size and its mean mutual information per bit (MIB, see
+ * LteMiErrorModel::Mib), so the statistics are keyed on (MCS, TB size,
+ * MIB), the MIB being quantized with a configurable step. The MIB is
+ * still computed over the RBs of the TB, a hit only saves the code block
+ * segmentation and the BLER mapping. The cached error rate is computed
+ * at the center of the quantization bucket, so it only depends on the
+ * key; the returned MI is the exact MIB. Retransmissions always use the
+ * exact path.
+ *
+ * Each cache must only be used by one thread at a time; the caches may
+ * be created and destroyed by concurrent threads.
+ */
+class LteMiErrorModelCache
+{
+public:
+  /// Lookup and validation counters
+  struct Stats
+  {
+    uint64_t lookups; ///< TBs evaluated through the cache
+    uint64_t hits; ///< TBs found in the cache
+    uint64_t validated; ///< TBs also evaluated with the exact path
+    double sumError; ///< sum of the absolute TBLER errors
+    double maxError; ///< maximum absolute TBLER error
+  };
+
+  LteMiErrorModelCache ();
+  ~LteMiErrorModelCache ();
+
+  /// The smallest nonzero quantization step of the MIB
+  static const double MIN_STEP;
+
+  /**
+   * \param step the quantization step of the MIB, in [MIN_STEP, 1];
+   *             0 disables the cache
+   */
+  void SetStep (double step);
+  /// \return the quantization step of the MIB
+  double GetStep () const;
+  /**
+   * \param enabled if true, every cached TB is also evaluated with the exact
+   *                path and the absolute TBLER error is accumulated
+   */
+  void SetValidationEnabled (bool enabled);
+  /// \return true if the validation mode is enabled
+  bool IsValidationEnabled () const;
+
+  /**
+   * \brief run the error-model algorithm for the specified TB, using the
+   * cache when possible
+   *
+   * The arguments are the ones of LteMiErrorModel::GetTbDecodificationStats.
+   * \param sinr the perceived sinrs in the whole bandwidth
+   * \param map the actives RBs for the TB
+   * \param size the size in bytes of the TB
+   * \param mcs the MCS of the TB
+   * \param miHistory  MI of past transmissions (in case of retx)
+   * \return the TB error rate and MI
+   */
+  TbStats_t GetTbDecodificationStats (const SpectrumValue& sinr, const std::vector<int>& map, uint16_t size, uint8_t mcs, const HarqProcessInfoList_t& miHistory);
+
+  /// \return the counters of this cache
+  Stats GetStats () const;
+  /// \return the counters of all the caches created so far
+  static Stats GetGlobalStats ();
+
+private:
+  /**
+   * Add the counters of a cache to a total
+   * \param total the total
+   * \param stats the counters to add
+   */
+  static void Accumulate (Stats& total, const Stats& stats);
+
+  double m_step; ///< quantization step of the MIB, 0 if disabled
+  bool m_validationEnabled; ///< whether the validation mode is enabled
+  std::map<uint64_t, TbStats_t> m_tbStats; ///< cached statistics
+  Stats m_stats; ///< counters
+
+  static std::set<const LteMiErrorModelCache*> m_caches; ///< live caches
+  static Stats m_retiredStats; ///< counters of the destroyed caches
+  static SystemMutex m_cachesMutex; ///< protects m_caches and m_retiredStats
+};
+
+
+
 } // namespace ns3
 
 #endif /* LTE_MI_ERROR_MODEL_H */
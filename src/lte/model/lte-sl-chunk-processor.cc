@@ -73,7 +73,27 @@ LteSlChunkProcessor::EvaluateChunk (uint32_t index, const SpectrumValue& sinr, T
     {
       m_chunkValues[index].m_sumValues = Create<SpectrumValue> (sinr.GetSpectrumModel ());
     }
-  *(m_chunkValues[index].m_sumValues) += sinr * duration.GetSeconds ();
+  m_chunkValues[index].m_sumValues->AddScaled (sinr, duration.GetSeconds ());
+  m_chunkValues[index].m_totDuration += duration;
+}
+
+void
+LteSlChunkProcessor::EvaluateChunk (uint32_t index, const SpectrumValue& sinr, const std::vector<LteRbPsdRun>& rbRuns, Time duration)
+{
+  NS_LOG_FUNCTION (this << index << duration);
+  if (m_chunkValues[index].m_sumValues == 0)
+    {
+      m_chunkValues[index].m_sumValues = Create<SpectrumValue> (sinr.GetSpectrumModel ());
+    }
+  SpectrumValue& sumValues = *(m_chunkValues[index].m_sumValues);
+  double durationSeconds = duration.GetSeconds ();
+  for (std::vector<LteRbPsdRun>::const_iterator it = rbRuns.begin (); it != rbRuns.end (); ++it)
+    {
+      for (uint16_t rb = it->rbStart; rb < it->rbStart + it->rbLen; rb++)
+        {
+          sumValues[rb] += sinr[rb] * durationSeconds;
+        }
+    }
   m_chunkValues[index].m_totDuration += duration;
 }
 
@@ -30,6 +30,7 @@
 #include <ns3/ptr.h>
 #include <ns3/nstime.h>
 #include <ns3/object.h>
+#include <ns3/lte-spectrum-value-helper.h>
 
 namespace ns3 {
 
@@ -89,6 +90,18 @@ struct LteSlChunkValue
     */
   virtual void EvaluateChunk (uint32_t index, const SpectrumValue& sinr, Time duration);
 
+  /**
+    * \brief Collect SpectrumValue and duration of signal, on some RBs only
+    *
+    * Same as above, but only the values of the RBs occupied by the
+    * message are collected, the other values of sinr are ignored.
+    * \param index The index of the message received
+    * \param sinr The sinr of the message received
+    * \param rbRuns The RBs occupied by the message received
+    * \param duration The duration of the reception
+    */
+  virtual void EvaluateChunk (uint32_t index, const SpectrumValue& sinr, const std::vector<LteRbPsdRun>& rbRuns, Time duration);
+
   /**
     * \brief Finish calculation and inform interested objects about calculated value
     *
@@ -25,6 +25,7 @@
 
 #include <ns3/simulator.h>
 #include <ns3/log.h>
+#include <ns3/lte-spectrum-value-helper.h>
 
 
 namespace ns3 {
@@ -54,6 +55,9 @@ LteSlInterference::DoDispose ()
   m_rxSignal.clear();
   m_allSignals = 0;
   m_noise = 0;
+  m_signal = 0;
+  m_interf = 0;
+  m_sinr = 0;
   Object::DoDispose ();
 } 
 
@@ -72,6 +76,13 @@ void
 LteSlInterference::StartRx (Ptr<const SpectrumValue> rxPsd)
 { 
   NS_LOG_FUNCTION (this << *rxPsd);
+  StartRx (LteSpectrumValueHelper::GetRbPsdRuns (*rxPsd), 1.0);
+}
+
+void
+LteSlInterference::StartRx (const std::vector<LteRbPsdRun>& rbRuns, double gain)
+{ 
+  NS_LOG_FUNCTION (this << rbRuns.size () << gain);
   bool init = !m_receiving;
 
   if (m_receiving == false) {
@@ -84,7 +95,10 @@ LteSlInterference::StartRx (Ptr<const SpectrumValue> rxPsd)
   }
 
   //In sidelink, each packet must be monitor seperatly
-  m_rxSignal.push_back (rxPsd->Copy ());
+  RxSignal rxSignal;
+  rxSignal.rbRuns = rbRuns;
+  rxSignal.gain = gain;
+  m_rxSignal.push_back (rxSignal);
   m_lastChangeTime = Now ();
   
   //trigger the initialization of each chunk processor 
@@ -135,6 +149,22 @@ LteSlInterference::AddSignal (Ptr<const SpectrumValue> spd, const Time duration)
 {
   NS_LOG_FUNCTION (this << *spd << duration);
   DoAddSignal (spd);
+  uint32_t signalId = NextSignalId ();
+  Simulator::Schedule (duration, &LteSlInterference::DoSubtractSignal, this, spd, signalId);
+}
+
+void
+LteSlInterference::AddSignal (const std::vector<LteRbPsdRun>& rbRuns, double gain, const Time duration)
+{
+  NS_LOG_FUNCTION (this << rbRuns.size () << gain << duration);
+  DoAddSignal (rbRuns, gain);
+  uint32_t signalId = NextSignalId ();
+  Simulator::Schedule (duration, &LteSlInterference::DoSubtractRbSignal, this, rbRuns, gain, signalId);
+}
+
+uint32_t
+LteSlInterference::NextSignalId ()
+{
   uint32_t signalId = ++m_lastSignalId;
   if (signalId == m_lastSignalIdBeforeReset)
     {
@@ -145,7 +175,7 @@ LteSlInterference::AddSignal (Ptr<const SpectrumValue> spd, const Time duration)
       // boundary further.
       m_lastSignalIdBeforeReset += 0x10000000;
     }
-  Simulator::Schedule (duration, &LteSlInterference::DoSubtractSignal, this, spd, signalId);
+  return signalId;
 }
 
 
@@ -157,6 +187,21 @@ LteSlInterference::DoAddSignal  (Ptr<const SpectrumValue> spd)
   (*m_allSignals) += (*spd);
 }
 
+void
+LteSlInterference::DoAddSignal  (const std::vector<LteRbPsdRun>& rbRuns, double gain)
+{ 
+  NS_LOG_FUNCTION (this << rbRuns.size () << gain);
+  ConditionallyEvaluateChunk ();
+  for (std::vector<LteRbPsdRun>::const_iterator it = rbRuns.begin (); it != rbRuns.end (); ++it)
+    {
+      double psd = it->psd * gain;
+      for (uint16_t rb = it->rbStart; rb < it->rbStart + it->rbLen; rb++)
+        {
+          (*m_allSignals)[rb] += psd;
+        }
+    }
+}
+
 void
 LteSlInterference::DoSubtractSignal  (Ptr<const SpectrumValue> spd, uint32_t signalId)
 { 
@@ -173,6 +218,29 @@ LteSlInterference::DoSubtractSignal  (Ptr<const SpectrumValue> spd, uint32_t sig
     }
 }
 
+void
+LteSlInterference::DoSubtractRbSignal  (std::vector<LteRbPsdRun> rbRuns, double gain, uint32_t signalId)
+{ 
+  NS_LOG_FUNCTION (this << rbRuns.size () << gain);
+  ConditionallyEvaluateChunk ();   
+  int32_t deltaSignalId = signalId - m_lastSignalIdBeforeReset;
+  if (deltaSignalId > 0)
+    {   
+      for (std::vector<LteRbPsdRun>::const_iterator it = rbRuns.begin (); it != rbRuns.end (); ++it)
+        {
+          double psd = it->psd * gain;
+          for (uint16_t rb = it->rbStart; rb < it->rbStart + it->rbLen; rb++)
+            {
+              (*m_allSignals)[rb] -= psd;
+            }
+        }
+    }
+  else
+    {
+      NS_LOG_INFO ("ignoring signal scheduled for subtraction before last reset");
+    }
+}
+
 
 void
 LteSlInterference::ConditionallyEvaluateChunk ()
@@ -185,26 +253,35 @@ LteSlInterference::ConditionallyEvaluateChunk ()
   NS_LOG_DEBUG (this << " now "  << Now () << " last " << m_lastChangeTime);
   if (m_receiving && (Now () > m_lastChangeTime))
     {
-      //compute values for each signal being received
+      //compute values for each signal being received, only on the RBs it occupies
       for (uint32_t index = 0 ; index < m_rxSignal.size() ; index++)
         {
-          NS_LOG_LOGIC (this << " signal = " << *(m_rxSignal[index]) << " allSignals = " << *m_allSignals << " noise = " << *m_noise);
-          
-          SpectrumValue interf =  (*m_allSignals) - (*(m_rxSignal[index])) + (*m_noise);
+          const RxSignal& rxSignal = m_rxSignal[index];
+          for (std::vector<LteRbPsdRun>::const_iterator runIt = rxSignal.rbRuns.begin (); runIt != rxSignal.rbRuns.end (); ++runIt)
+            {
+              double signal = runIt->psd * rxSignal.gain;
+              for (uint16_t rb = runIt->rbStart; rb < runIt->rbStart + runIt->rbLen; rb++)
+                {
+                  double interf = (*m_allSignals)[rb] - signal + (*m_noise)[rb];
+                  (*m_signal)[rb] = signal;
+                  (*m_interf)[rb] = interf;
+                  (*m_sinr)[rb] = signal / interf;
+                }
+            }
+          NS_LOG_LOGIC (this << " signal = " << *m_signal << " allSignals = " << *m_allSignals << " noise = " << *m_noise);
           
-          SpectrumValue sinr = (*(m_rxSignal[index])) / interf;
           Time duration = Now () - m_lastChangeTime;
           for (std::list<Ptr<LteSlChunkProcessor> >::const_iterator it = m_sinrChunkProcessorList.begin (); it != m_sinrChunkProcessorList.end (); ++it)
             {
-              (*it)->EvaluateChunk (index, sinr, duration);
+              (*it)->EvaluateChunk (index, *m_sinr, rxSignal.rbRuns, duration);
             }
           for (std::list<Ptr<LteSlChunkProcessor> >::const_iterator it = m_interfChunkProcessorList.begin (); it != m_interfChunkProcessorList.end (); ++it)
             {
-              (*it)->EvaluateChunk (index, interf, duration);
+              (*it)->EvaluateChunk (index, *m_interf, rxSignal.rbRuns, duration);
             }
           for (std::list<Ptr<LteSlChunkProcessor> >::const_iterator it = m_rsPowerChunkProcessorList.begin (); it != m_rsPowerChunkProcessorList.end (); ++it)
             {
-              (*it)->EvaluateChunk (index, *(m_rxSignal[index]), duration);
+              (*it)->EvaluateChunk (index, *m_signal, rxSignal.rbRuns, duration);
             }
         }
       m_lastChangeTime = Now ();
@@ -220,6 +297,9 @@ LteSlInterference::SetNoisePowerSpectralDensity (Ptr<const SpectrumValue> noiseP
   // reset m_allSignals (will reset if already set previously)
   // this is needed since this method can potentially change the SpectrumModel
   m_allSignals = Create<SpectrumValue> (noisePsd->GetSpectrumModel ());
+  m_signal = Create<SpectrumValue> (noisePsd->GetSpectrumModel ());
+  m_interf = Create<SpectrumValue> (noisePsd->GetSpectrumModel ());
+  m_sinr = Create<SpectrumValue> (noisePsd->GetSpectrumModel ());
   if (m_receiving == true)
     {
       // abort rx
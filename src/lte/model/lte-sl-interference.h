@@ -27,6 +27,7 @@
 #include <ns3/packet.h>
 #include <ns3/nstime.h>
 #include <ns3/spectrum-value.h>
+#include <ns3/lte-spectrum-value-helper.h>
 
 #include <list>
 
@@ -85,6 +86,15 @@ public:
    */
   void StartRx (Ptr<const SpectrumValue> rxPsd);
 
+  /**
+   * notify that the PHY is starting a RX attempt. The SINR, interference
+   * and power of the signal are only evaluated on the RBs it occupies.
+   *
+   * @param rbRuns the sparse power spectral density of the signal being RX, not scaled
+   * @param gain the linear gain to be applied to rbRuns
+   */
+  void StartRx (const std::vector<LteRbPsdRun>& rbRuns, double gain);
+
   /**
    * notify that the RX attempt has ended. The receiving PHY must call
    * this method when RX ends or RX is aborted.
@@ -103,6 +113,16 @@ public:
    */
   void AddSignal (Ptr<const SpectrumValue> spd, const Time duration);
 
+  /**
+   * notify that a new signal is being perceived in the medium, only
+   * updating the RBs it occupies
+   *
+   * @param rbRuns the sparse power spectral density of the new signal, not scaled
+   * @param gain the linear gain to be applied to rbRuns
+   * @param duration the duration of the new signal
+   */
+  void AddSignal (const std::vector<LteRbPsdRun>& rbRuns, double gain, const Time duration);
+
 
   /**
    *
@@ -114,12 +134,22 @@ public:
 private:
   void ConditionallyEvaluateChunk ();
   void DoAddSignal  (Ptr<const SpectrumValue> spd);
+  void DoAddSignal  (const std::vector<LteRbPsdRun>& rbRuns, double gain);
   void DoSubtractSignal  (Ptr<const SpectrumValue> spd, uint32_t signalId);
+  void DoSubtractRbSignal  (std::vector<LteRbPsdRun> rbRuns, double gain, uint32_t signalId);
+  uint32_t NextSignalId ();
 
    bool m_receiving;
 
-  std::vector <Ptr<SpectrumValue> > m_rxSignal; /**< stores the power spectral density of
-                                  * the signal whose RX is being
+  /// a signal being received: its sparse power spectral density and the gain to apply
+  struct RxSignal
+  {
+    std::vector<LteRbPsdRun> rbRuns;
+    double gain;
+  };
+
+  std::vector <RxSignal> m_rxSignal; /**< stores the power spectral density of
+                                  * the signals whose RX is being
                                   * attempted
                                   */
 
@@ -130,6 +160,11 @@ private:
 
   Ptr<const SpectrumValue> m_noise;
 
+  /// scratch values of the signal being evaluated, only valid on the RBs it occupies
+  Ptr<SpectrumValue> m_signal;
+  Ptr<SpectrumValue> m_interf;
+  Ptr<SpectrumValue> m_sinr;
+
   Time m_lastChangeTime;     /**< the time of the last change in
                                 m_TotalPower */
 
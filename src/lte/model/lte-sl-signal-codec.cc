@@ -0,0 +1,232 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "lte-sl-signal-codec.h"
+#include <ns3/log.h>
+#include <ns3/header.h>
+#include <ns3/packet-burst.h>
+#include <ns3/lte-spectrum-signal-parameters.h>
+#include <ns3/lte-control-messages.h>
+#include <vector>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("LteSlSignalCodec");
+
+NS_OBJECT_ENSURE_REGISTERED (LteSlSignalCodec);
+
+/**
+ * \ingroup lte
+ *
+ * The fields of a LteSpectrumSignalParametersSlFrame encoded by the
+ * LteSlSignalCodec, followed by the packets of the burst.
+ */
+class LteSlFrameHeader : public Header
+{
+public:
+  LteSlFrameHeader ();
+
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  virtual TypeId GetInstanceTypeId (void) const;
+  virtual void Print (std::ostream &os) const;
+  virtual uint32_t GetSerializedSize (void) const;
+  virtual void Serialize (Buffer::Iterator start) const;
+  virtual uint32_t Deserialize (Buffer::Iterator start);
+
+  uint32_t m_nodeId;     //!< the transmitting node
+  uint8_t m_groupId;     //!< the group
+  uint64_t m_slssId;     //!< the SLSS id
+  std::vector<SciListElementV2x> m_scis; //!< the SCI of the SCI_V2X messages
+  bool m_hasBurst;       //!< whether the frame has a packet burst
+  uint32_t m_nPackets;   //!< the number of packets of the burst
+};
+
+NS_OBJECT_ENSURE_REGISTERED (LteSlFrameHeader);
+
+LteSlFrameHeader::LteSlFrameHeader ()
+  : m_nodeId (0),
+    m_groupId (0),
+    m_slssId (0),
+    m_hasBurst (false),
+    m_nPackets (0)
+{
+}
+
+TypeId
+LteSlFrameHeader::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::LteSlFrameHeader")
+    .SetParent<Header> ()
+    .SetGroupName ("Lte")
+    .AddConstructor<LteSlFrameHeader> ()
+  ;
+  return tid;
+}
+
+TypeId
+LteSlFrameHeader::GetInstanceTypeId (void) const
+{
+  return GetTypeId ();
+}
+
+void
+LteSlFrameHeader::Print (std::ostream &os) const
+{
+  os << "node=" << m_nodeId << " group=" << (uint32_t) m_groupId << " slss=" << m_slssId
+     << " scis=" << m_scis.size () << " packets=" << m_nPackets;
+}
+
+uint32_t
+LteSlFrameHeader::GetSerializedSize (void) const
+{
+  // each SCI: rnti, prio, pRsvp, riv, sfGap, mcs, reTxIdx, resPscch, tbSize
+  return 4 + 1 + 8 + 4 + m_scis.size () * (2 + 1 + 2 + 2 + 1 + 1 + 1 + 2 + 2) + 1 + 4;
+}
+
+void
+LteSlFrameHeader::Serialize (Buffer::Iterator start) const
+{
+  Buffer::Iterator i = start;
+  i.WriteHtonU32 (m_nodeId);
+  i.WriteU8 (m_groupId);
+  i.WriteHtonU64 (m_slssId);
+  i.WriteHtonU32 (m_scis.size ());
+  for (std::vector<SciListElementV2x>::const_iterator sci = m_scis.begin (); sci != m_scis.end (); ++sci)
+    {
+      i.WriteHtonU16 (sci->m_rnti);
+      i.WriteU8 (sci->m_prio);
+      i.WriteHtonU16 (sci->m_pRsvp);
+      i.WriteHtonU16 (sci->m_riv);
+      i.WriteU8 (sci->m_sfGap);
+      i.WriteU8 (sci->m_mcs);
+      i.WriteU8 (sci->m_reTxIdx);
+      i.WriteHtonU16 (sci->m_resPscch);
+      i.WriteHtonU16 (sci->m_tbSize);
+    }
+  i.WriteU8 (m_hasBurst);
+  i.WriteHtonU32 (m_nPackets);
+}
+
+uint32_t
+LteSlFrameHeader::Deserialize (Buffer::Iterator start)
+{
+  Buffer::Iterator i = start;
+  m_nodeId = i.ReadNtohU32 ();
+  m_groupId = i.ReadU8 ();
+  m_slssId = i.ReadNtohU64 ();
+  m_scis.resize (i.ReadNtohU32 ());
+  for (std::vector<SciListElementV2x>::iterator sci = m_scis.begin (); sci != m_scis.end (); ++sci)
+    {
+      sci->m_rnti = i.ReadNtohU16 ();
+      sci->m_prio = i.ReadU8 ();
+      sci->m_pRsvp = i.ReadNtohU16 ();
+      sci->m_riv = i.ReadNtohU16 ();
+      sci->m_sfGap = i.ReadU8 ();
+      sci->m_mcs = i.ReadU8 ();
+      sci->m_reTxIdx = i.ReadU8 ();
+      sci->m_resPscch = i.ReadNtohU16 ();
+      sci->m_tbSize = i.ReadNtohU16 ();
+    }
+  m_hasBurst = i.ReadU8 ();
+  m_nPackets = i.ReadNtohU32 ();
+  return GetSerializedSize ();
+}
+
+
+TypeId
+LteSlSignalCodec::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::LteSlSignalCodec")
+    .SetParent<SpectrumSignalCodec> ()
+    .SetGroupName ("Lte")
+    .AddConstructor<LteSlSignalCodec> ()
+  ;
+  return tid;
+}
+
+Ptr<Packet>
+LteSlSignalCodec::Encode (Ptr<const SpectrumSignalParameters> params) const
+{
+  NS_LOG_FUNCTION (this << params);
+  Ptr<const LteSpectrumSignalParametersSlFrame> frame = DynamicCast<const LteSpectrumSignalParametersSlFrame> (params);
+  if (frame == 0)
+    {
+      return 0;
+    }
+
+  LteSlFrameHeader header;
+  header.m_nodeId = frame->nodeId;
+  header.m_groupId = frame->groupId;
+  header.m_slssId = frame->slssId;
+  for (std::list<Ptr<LteControlMessage> >::const_iterator msg = frame->ctrlMsgList.begin ();
+       msg != frame->ctrlMsgList.end (); ++msg)
+    {
+      if ((*msg)->GetMessageType () != LteControlMessage::SCI_V2X)
+        {
+          NS_LOG_LOGIC ("not sending a control message of type " << (*msg)->GetMessageType ());
+          continue;
+        }
+      header.m_scis.push_back (DynamicCast<SciLteControlMessageV2x> (*msg)->GetSci ());
+    }
+
+  Ptr<Packet> payload = Create<Packet> ();
+  if (frame->packetBurst != 0)
+    {
+      header.m_hasBurst = true;
+      header.m_nPackets = frame->packetBurst->GetNPackets ();
+      for (std::list<Ptr<Packet> >::const_iterator p = frame->packetBurst->Begin ();
+           p != frame->packetBurst->End (); ++p)
+        {
+          AddPacket (payload, *p);
+        }
+    }
+  payload->AddHeader (header);
+  return payload;
+}
+
+Ptr<SpectrumSignalParameters>
+LteSlSignalCodec::Decode (Ptr<Packet> payload) const
+{
+  NS_LOG_FUNCTION (this << payload);
+  LteSlFrameHeader header;
+  payload->RemoveHeader (header);
+
+  Ptr<LteSpectrumSignalParametersSlFrame> frame = Create<LteSpectrumSignalParametersSlFrame> ();
+  frame->nodeId = header.m_nodeId;
+  frame->groupId = header.m_groupId;
+  frame->slssId = header.m_slssId;
+  for (std::vector<SciListElementV2x>::const_iterator sci = header.m_scis.begin (); sci != header.m_scis.end (); ++sci)
+    {
+      Ptr<SciLteControlMessageV2x> msg = Create<SciLteControlMessageV2x> ();
+      msg->SetSci (*sci);
+      frame->ctrlMsgList.push_back (msg);
+    }
+  if (header.m_hasBurst)
+    {
+      frame->packetBurst = CreateObject<PacketBurst> ();
+      for (uint32_t n = 0; n < header.m_nPackets; n++)
+        {
+          frame->packetBurst->AddPacket (RemovePacket (payload));
+        }
+    }
+  return frame;
+}
+
+} // namespace ns3
@@ -0,0 +1,50 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef LTE_SL_SIGNAL_CODEC_H
+#define LTE_SL_SIGNAL_CODEC_H
+
+#include <ns3/spectrum-signal-codec.h>
+
+namespace ns3 {
+
+/**
+ * \ingroup lte
+ *
+ * The SpectrumSignalCodec of the V2X sidelink frames
+ * (LteSpectrumSignalParametersSlFrame): it encodes the transmitting
+ * node, the group, the SLSS id, the SCI of the SCI_V2X messages and the
+ * packet burst. The other control messages are not sent.
+ *
+ * The LteHelper adds it to the DistributedSpectrumChannel it creates.
+ */
+class LteSlSignalCodec : public SpectrumSignalCodec
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  // inherited from SpectrumSignalCodec
+  virtual Ptr<Packet> Encode (Ptr<const SpectrumSignalParameters> params) const;
+  virtual Ptr<SpectrumSignalParameters> Decode (Ptr<Packet> payload) const;
+};
+
+} // namespace ns3
+
+#endif /* LTE_SL_SIGNAL_CODEC_H */
@@ -45,6 +45,11 @@
 #include <ns3/node.h>
 #include "ns3/enum.h"
 #include <ns3/pointer.h>
+#include <ns3/wall-clock-profiler.h>
+#include <ns3/worker-pool.h>
+#include <ns3/parallel-simulator-impl.h>
+#include <ns3/abort.h>
+#include <algorithm>
 
 namespace ns3 {
 
@@ -210,10 +215,15 @@ operator < (const DiscTbId_t& a, const DiscTbId_t& b)
 
 NS_OBJECT_ENSURE_REGISTERED (LteSpectrumPhy);
 
+std::vector<LteSpectrumPhy*> LteSpectrumPhy::m_pendingSlRx;
+std::vector<LteSpectrumPhy*> LteSpectrumPhy::m_slRxBatch;
+
 LteSpectrumPhy::LteSpectrumPhy ()
   : m_state (IDLE),
     m_cellId (0),
     m_componentCarrierId (0),
+    m_parallelSlRxEnabled (false),
+    m_slRxPending (false),
     m_transmissionMode (0),
     m_layersNum (1),
     m_ulDataSlCheck (false),
@@ -247,6 +257,8 @@ void LteSpectrumPhy::DoDispose ()
 {
   NS_LOG_FUNCTION (this);
   m_channel = 0;
+  m_ltePhyAnnounceTxCallback = MakeNullCallback< void, Ptr<SpectrumSignalParameters>, Time > ();
+  m_startTxEvent.Cancel ();
   m_mobility = 0;
   m_device = 0;
   m_interferenceData->Dispose ();
@@ -256,6 +268,11 @@ void LteSpectrumPhy::DoDispose ()
   m_interferenceSl->Dispose ();
   m_interferenceSl = 0;
   m_ulDataSlCheck = false;
+  if (m_slRxPending)
+    {
+      m_pendingSlRx.erase (std::find (m_pendingSlRx.begin (), m_pendingSlRx.end (), this));
+      m_slRxPending = false;
+    }
   m_ltePhyRxDataEndErrorCallback = MakeNullCallback< void > ();
   m_ltePhyRxDataEndOkCallback    = MakeNullCallback< void, Ptr<Packet> >  ();
   m_ltePhyRxCtrlEndOkCallback = MakeNullCallback< void, std::list<Ptr<LteControlMessage> > > ();
@@ -393,6 +410,27 @@ LteSpectrumPhy::GetTypeId (void)
                    BooleanValue (true),
                    MakeBooleanAccessor (&LteSpectrumPhy::m_errorModelHarqD2dDiscoveryEnabled),
                    MakeBooleanChecker ())
+    .AddAttribute ("ParallelSlRxEnabled",
+                   "If true, the SL receptions ending at the same time are decoded in parallel on the WorkerPool "
+                   "and then delivered in the order of their end events (default false)",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&LteSpectrumPhy::m_parallelSlRxEnabled),
+                   MakeBooleanChecker ())
+    .AddAttribute ("MiErrorModelCacheStep",
+                   "Quantization step of the mean mutual information per bit used to memoize the TB error "
+                   "rates of the first transmissions evaluated with the MI error model (0 disables the cache, "
+                   "else at least LteMiErrorModelCache::MIN_STEP)",
+                   DoubleValue (0.0),
+                   MakeDoubleAccessor (&LteSpectrumPhy::SetMiErrorModelCacheStep,
+                                       &LteSpectrumPhy::GetMiErrorModelCacheStep),
+                   MakeDoubleChecker<double> (0.0, 1.0))
+    .AddAttribute ("MiErrorModelCacheValidationEnabled",
+                   "If true, the TBs evaluated through the MI error model cache are also evaluated with the exact "
+                   "path and the TBLER error is accumulated (see LteMiErrorModelCache::GetGlobalStats)",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&LteSpectrumPhy::SetMiErrorModelCacheValidationEnabled,
+                                        &LteSpectrumPhy::IsMiErrorModelCacheValidationEnabled),
+                   MakeBooleanChecker ())
   ;
   return tid;
 }
@@ -482,6 +520,7 @@ LteSpectrumPhy::Reset ()
   m_transmissionMode = 0;
   m_layersNum = 1;
   m_endTxEvent.Cancel ();
+  m_startTxEvent.Cancel ();
   m_endRxDataEvent.Cancel ();
   m_endRxDlCtrlEvent.Cancel ();
   m_endRxUlSrsEvent.Cancel ();
@@ -571,6 +610,12 @@ LteSpectrumPhy::GetRxAntenna ()
   return m_antenna;
 }
 
+bool
+LteSpectrumPhy::IsPsdGainSupported () const
+{
+  return true;
+}
+
 void
 LteSpectrumPhy::SetAntenna (Ptr<AntennaModel> a)
 {
@@ -670,9 +715,66 @@ bool
 LteSpectrumPhy::StartTxSlDataFrame (Ptr<PacketBurst> pb, std::list<Ptr<LteControlMessage> > ctrlMsgList, Time duration, uint8_t groupId)
 {
   NS_LOG_FUNCTION (this << pb);
+  return DoStartTxSlDataFrame (CreateSlDataFrame (pb, ctrlMsgList, duration, groupId));
+}
+
+void
+LteSpectrumPhy::ScheduleTxSlDataFrame (Ptr<PacketBurst> pb, std::list<Ptr<LteControlMessage> > ctrlMsgList, Time duration, uint8_t groupId, Time delay)
+{
+  NS_LOG_FUNCTION (this << pb << delay);
+  NS_ASSERT_MSG (!m_startTxEvent.IsRunning (), "a sidelink data frame is already scheduled");
+  Ptr<LteSpectrumSignalParametersSlFrame> txParams = CreateSlDataFrame (pb, ctrlMsgList, duration, groupId);
+  if (!m_ltePhyAnnounceTxCallback.IsNull ())
+    {
+      m_ltePhyAnnounceTxCallback (txParams, delay);
+    }
+  m_startTxEvent = Simulator::Schedule (delay, &LteSpectrumPhy::DoStartTxSlDataFrame, this, txParams);
+}
+
+Time
+LteSpectrumPhy::GetTxLookahead () const
+{
+  return m_txLookahead;
+}
+
+bool
+LteSpectrumPhy::IsTxSlDataFrameStarting () const
+{
+  return m_startTxEvent.IsRunning () && m_startTxEvent.GetTs () == (uint64_t) Simulator::Now ().GetTimeStep ();
+}
+
+Ptr<LteSpectrumSignalParametersSlFrame>
+LteSpectrumPhy::CreateSlDataFrame (Ptr<PacketBurst> pb, std::list<Ptr<LteControlMessage> > ctrlMsgList, Time duration, uint8_t groupId)
+{
+  //m_txPsd must be setted by the device, according to
+  //(i) the available subchannel for transmission
+  //(ii) the power transmission
+  NS_ASSERT (m_txPsd);
+
+  // we need to convey some PHY meta information to the receiver
+  // to be used for simulation purposes (e.g., the CellId). This
+  // is done by setting the ctrlMsgList parameter of
+  // LteSpectrumSignalParametersDataFrame
+  Ptr<LteSpectrumSignalParametersSlFrame> txParams = Create<LteSpectrumSignalParametersSlFrame> ();
+  txParams->duration = duration;
+  txParams->txPhy = GetObject<SpectrumPhy> ();
+  txParams->txAntenna = m_antenna;
+  txParams->psd = m_txPsd;
+  txParams->nodeId = GetDevice()->GetNode()->GetId();
+  txParams->groupId = groupId;
+  txParams->slssId = m_slssId;
+  txParams->packetBurst = pb;
+  txParams->ctrlMsgList = ctrlMsgList;
+  return txParams;
+}
+
+bool
+LteSpectrumPhy::DoStartTxSlDataFrame (Ptr<LteSpectrumSignalParametersSlFrame> txParams)
+{
+  NS_LOG_FUNCTION (this << txParams);
   NS_LOG_LOGIC (this << " ID:" << GetDevice()->GetNode()->GetId() << " state: " << m_state);
   
-  m_phyTxStartTrace (pb);
+  m_phyTxStartTrace (txParams->packetBurst);
   
   switch (m_state)
   {
@@ -691,34 +793,13 @@ LteSpectrumPhy::StartTxSlDataFrame (Ptr<PacketBurst> pb, std::list<Ptr<LteContro
     case TX_UL_V2X_SCI:
     case IDLE:
     {
-      
-      //m_txPsd must be setted by the device, according to
-      //(i) the available subchannel for transmission
-      //(ii) the power transmission
-      
-      NS_ASSERT (m_txPsd);
-      m_txPacketBurst = pb;
-      
-      // we need to convey some PHY meta information to the receiver
-      // to be used for simulation purposes (e.g., the CellId). This
-      // is done by setting the ctrlMsgList parameter of
-      // LteSpectrumSignalParametersDataFrame
+      m_txPacketBurst = txParams->packetBurst;
       ChangeState (TX_DATA);
       NS_ASSERT (m_channel);
-      Ptr<LteSpectrumSignalParametersSlFrame> txParams = Create<LteSpectrumSignalParametersSlFrame> ();
-      txParams->duration = duration;
-      txParams->txPhy = GetObject<SpectrumPhy> ();
-      txParams->txAntenna = m_antenna;
-      txParams->psd = m_txPsd;
-      txParams->nodeId = GetDevice()->GetNode()->GetId();
-      txParams->groupId = groupId;
-      txParams->slssId = m_slssId;
-      txParams->packetBurst = pb;
-      txParams->ctrlMsgList = ctrlMsgList;
       m_ulDataSlCheck = true;
 
       m_channel->StartTx (txParams);
-      m_endTxEvent = Simulator::Schedule (duration, &LteSpectrumPhy::EndTxData, this);
+      m_endTxEvent = Simulator::Schedule (txParams->duration, &LteSpectrumPhy::EndTxData, this);
     
       return false;
       break;
@@ -887,7 +968,6 @@ LteSpectrumPhy::StartRx (Ptr<SpectrumSignalParameters> spectrumRxParams)
   NS_LOG_FUNCTION (this << spectrumRxParams);
   NS_LOG_LOGIC (this << " state: " << m_state);
   
-  Ptr <const SpectrumValue> rxPsd = spectrumRxParams->psd;
   Time duration = spectrumRxParams->duration;
   
   // the device might start RX only if the signal is of a type
@@ -896,6 +976,18 @@ LteSpectrumPhy::StartRx (Ptr<SpectrumSignalParameters> spectrumRxParams)
   Ptr<LteSpectrumSignalParametersDlCtrlFrame> lteDlCtrlRxParams = DynamicCast<LteSpectrumSignalParametersDlCtrlFrame> (spectrumRxParams);
   Ptr<LteSpectrumSignalParametersUlSrsFrame> lteUlSrsRxParams = DynamicCast<LteSpectrumSignalParametersUlSrsFrame> (spectrumRxParams);
   Ptr<LteSpectrumSignalParametersSlFrame> lteSlRxParams = DynamicCast<LteSpectrumSignalParametersSlFrame> (spectrumRxParams);
+
+  // only the sidelink reception handles a psd shared with the other
+  // receivers, scale it here for the other types of signal
+  if (lteSlRxParams == 0 && spectrumRxParams->psdGain != 1.0)
+    {
+      Ptr<SpectrumValue> rxPsd = spectrumRxParams->psd->Copy ();
+      (*rxPsd) *= spectrumRxParams->psdGain;
+      spectrumRxParams->psd = rxPsd;
+      spectrumRxParams->psdGain = 1.0;
+    }
+  Ptr <const SpectrumValue> rxPsd = spectrumRxParams->psd;
+  double psdGain = spectrumRxParams->psdGain;
   if (lteDataRxParams != 0)
     {
       m_interferenceData->AddSignal (rxPsd, duration);
@@ -904,15 +996,20 @@ LteSpectrumPhy::StartRx (Ptr<SpectrumSignalParameters> spectrumRxParams)
     }
   else if (lteSlRxParams !=0)
     {
-      m_interferenceSl->AddSignal (rxPsd, duration); 
-      m_interferenceData->AddSignal (rxPsd, duration); //to compute UL/SL interference
+      // sidelink signals only occupy a few RBs, use their sparse representation
+      std::vector<LteRbPsdRun> rbRuns = LteSpectrumValueHelper::GetRbPsdRuns (*rxPsd);
+      m_interferenceSl->AddSignal (rbRuns, psdGain, duration); 
+      m_interferenceData->AddSignal (rxPsd, psdGain, duration); //to compute UL/SL interference
       if(m_ctrlFullDuplexEnabled && lteSlRxParams->ctrlMsgList.size () > 0) 
       { 
-        StartRxSlData (lteSlRxParams);
+        StartRxSlData (lteSlRxParams, rbRuns);
       }
-      else if (!m_halfDuplexPhy || m_halfDuplexPhy->GetState () == IDLE || !(m_halfDuplexPhy->m_ulDataSlCheck))
+      // a transmission scheduled in advance for this subframe excludes the
+      // reception whether it already started or not
+      else if (!m_halfDuplexPhy || ((m_halfDuplexPhy->GetState () == IDLE || !(m_halfDuplexPhy->m_ulDataSlCheck))
+                                    && !m_halfDuplexPhy->IsTxSlDataFrameStarting ()))
       {
-        StartRxSlData (lteSlRxParams);
+        StartRxSlData (lteSlRxParams, rbRuns);
       }
     }
   else if (lteDlCtrlRxParams!=0)
@@ -1012,7 +1109,7 @@ LteSpectrumPhy::StartRxData (Ptr<LteSpectrumSignalParametersDataFrame> params)
 }
 
 void
-LteSpectrumPhy::StartRxSlData (Ptr<LteSpectrumSignalParametersSlFrame> params)
+LteSpectrumPhy::StartRxSlData (Ptr<LteSpectrumSignalParametersSlFrame> params, const std::vector<LteRbPsdRun>& rbRuns)
 {
   NS_LOG_FUNCTION (this);
   NS_LOG_LOGIC (this << " ID:" << GetDevice()->GetNode()->GetId() << " state: " << m_state);
@@ -1055,7 +1152,9 @@ LteSpectrumPhy::StartRxSlData (Ptr<LteSpectrumSignalParametersSlFrame> params)
                         //Measure S-RSRP
                         if (!m_ltePhyRxSlssCallback.IsNull ())
                           {
-                            m_ltePhyRxSlssCallback (mibSL.slssid, params->psd);
+                            Ptr<SpectrumValue> rxPsd = params->psd->Copy ();
+                            (*rxPsd) *= params->psdGain;
+                            m_ltePhyRxSlssCallback (mibSL.slssid, rxPsd);
                           }
                         //Receive MIB-SL
                         if (m_rxPacketInfo.empty ())
@@ -1067,6 +1166,7 @@ LteSpectrumPhy::StartRxSlData (Ptr<LteSpectrumSignalParametersSlFrame> params)
                             NS_LOG_LOGIC (this << " scheduling EndRxSl with delay " << params->duration.GetSeconds () << "s");
                               
                             m_endRxDataEvent = Simulator::Schedule (params->duration, &LteSpectrumPhy::EndRxSlData, this);
+                            AddPendingSlRx ();
                           }
                         else
                           {
@@ -1079,20 +1179,22 @@ LteSpectrumPhy::StartRxSlData (Ptr<LteSpectrumSignalParametersSlFrame> params)
                                        && (m_firstRxDuration == params->duration));
                           }
                         ChangeState (RX_DATA);
-                        m_interferenceSl->StartRx (params->psd);
+                        m_interferenceSl->StartRx (rbRuns, params->psdGain);
                         SlRxPacketInfo_t packetInfo;
                         packetInfo.m_rxPacketBurst = params->packetBurst;
                         packetInfo.m_rxControlMessage = *ctrlIt;
                         //convert the PSD to RB map so we know which RBs were used to transmit the control message
                         //will be used later to compute error rate
                         std::vector <int> rbMap;
-                        int i = 0;
-                        for (Values::const_iterator it=params->psd->ConstValuesBegin (); it != params->psd->ConstValuesEnd () ; it++, i++)
+                        for (std::vector<LteRbPsdRun>::const_iterator it = rbRuns.begin (); it != rbRuns.end (); it++)
                           {
-                            if (*it != 0)
+                            if (it->psd * params->psdGain != 0)
                               {
-                                NS_LOG_INFO (this << " SL MIB-SL arriving on RB " << i);
-                                rbMap.push_back (i);
+                                NS_LOG_INFO (this << " SL MIB-SL arriving on RBs " << it->rbStart << " to " << it->rbStart + it->rbLen - 1);
+                                for (int i = it->rbStart; i < it->rbStart + it->rbLen; i++)
+                                  {
+                                    rbMap.push_back (i);
+                                  }
                               }
                           }
                         packetInfo.rbBitmap = rbMap;
@@ -1116,6 +1218,7 @@ LteSpectrumPhy::StartRxSlData (Ptr<LteSpectrumSignalParametersSlFrame> params)
                     m_firstRxDuration = params->duration;
                     NS_LOG_LOGIC (this << " scheduling EndRxSl with delay " << params->duration.GetSeconds () << "s");
                     m_endRxDataEvent = Simulator::Schedule (params->duration, &LteSpectrumPhy::EndRxSlData, this);
+                    AddPendingSlRx ();
                   }
                 else
                   {
@@ -1128,7 +1231,7 @@ LteSpectrumPhy::StartRxSlData (Ptr<LteSpectrumSignalParametersSlFrame> params)
                                && (m_firstRxDuration == params->duration));
                   }
                 ChangeState (RX_DATA);
-                m_interferenceSl->StartRx (params->psd);
+                m_interferenceSl->StartRx (rbRuns, params->psdGain);
 
                 SlRxPacketInfo_t packetInfo;
                 packetInfo.m_rxPacketBurst = params->packetBurst;
@@ -1140,13 +1243,15 @@ LteSpectrumPhy::StartRxSlData (Ptr<LteSpectrumSignalParametersSlFrame> params)
                 //convert the PSD to RB map so we know which RBs were used to transmit the control message
                 //will be used later to compute error rate
                 std::vector <int> rbMap;
-                int i = 0;
-                for (Values::const_iterator it=params->psd->ConstValuesBegin (); it != params->psd->ConstValuesEnd () ; it++, i++)
+                for (std::vector<LteRbPsdRun>::const_iterator it = rbRuns.begin (); it != rbRuns.end (); it++)
                   {
-                    if (*it != 0)
+                    if (it->psd * params->psdGain != 0)
                       {
-                        NS_LOG_INFO (this << " SL Message arriving on RB " << i);
-                        rbMap.push_back (i);
+                        NS_LOG_INFO (this << " SL Message arriving on RBs " << it->rbStart << " to " << it->rbStart + it->rbLen - 1);
+                        for (int i = it->rbStart; i < it->rbStart + it->rbLen; i++)
+                          {
+                            rbMap.push_back (i);
+                          }
                       }
                   }
                 packetInfo.rbBitmap = rbMap;
@@ -1511,7 +1616,7 @@ LteSpectrumPhy::EndRxData ()
                   harqInfoList = m_harqPhyModule->GetHarqProcessInfoUl ((*itTb).first.m_rnti, ulHarqId);
                 }
             }
-          TbStats_t tbStats = LteMiErrorModel::GetTbDecodificationStats (m_sinrPerceived, (*itTb).second.rbBitmap, (*itTb).second.size, (*itTb).second.mcs, harqInfoList);
+          TbStats_t tbStats = m_miErrorModelCache.GetTbDecodificationStats (m_sinrPerceived, (*itTb).second.rbBitmap, (*itTb).second.size, (*itTb).second.mcs, harqInfoList);
           (*itTb).second.mi = tbStats.mi;
           (*itTb).second.corrupt = m_random->GetValue () > tbStats.tbler ? false : true;
           NS_LOG_DEBUG (this << "RNTI " << (*itTb).first.m_rnti << " size " << (*itTb).second.size << " mcs " << (uint32_t)(*itTb).second.mcs << " bitmap " << (*itTb).second.rbBitmap.size () << " layer " << (uint16_t)(*itTb).first.m_layer << " TBLER " << tbStats.tbler << " corrupted " << (*itTb).second.corrupt);
@@ -1692,9 +1797,97 @@ void
 LteSpectrumPhy::EndRxSlData ()
 {
   NS_LOG_FUNCTION (this);
+  NS_PROFILE_SCOPE ("LteSpectrumPhy::EndRxSlData");
   NS_LOG_LOGIC (this << " ID:" << GetDevice()->GetNode()->GetId() << " state: " << m_state);
   NS_ASSERT (m_state == RX_DATA);
 
+  if (m_parallelSlRxEnabled)
+    {
+      EndRxSlDataBatch ();
+      return;
+    }
+  PrepareSlRx ();
+  DecodeSlRx ();
+  DeliverSlRx ();
+}
+
+void
+LteSpectrumPhy::AddPendingSlRx ()
+{
+  NS_LOG_FUNCTION (this);
+  if (m_parallelSlRxEnabled && !m_slRxPending)
+    {
+      NS_ABORT_MSG_IF (ParallelSimulatorImpl::IsRunningConcurrently (),
+                       "The sidelink PHYs share the batches of receptions and cannot run on several partitions of a ParallelSimulatorImpl");
+      m_slRxPending = true;
+      m_pendingSlRx.push_back (this);
+    }
+}
+
+void
+LteSpectrumPhy::EndRxSlDataBatch ()
+{
+  NS_LOG_FUNCTION (this);
+  // the receptions ending now are decoded together, then delivered in the
+  // order of their end events, which are cancelled
+  std::vector<std::pair<uint32_t, LteSpectrumPhy*> > ending;
+  std::vector<LteSpectrumPhy*> later;
+  for (std::vector<LteSpectrumPhy*>::iterator it = m_pendingSlRx.begin (); it != m_pendingSlRx.end (); it++)
+    {
+      LteSpectrumPhy* phy = *it;
+      if (phy == this || !phy->m_endRxDataEvent.IsRunning ())
+        {
+          // this reception or an aborted one
+          phy->m_slRxPending = false;
+        }
+      else if (Simulator::GetDelayLeft (phy->m_endRxDataEvent).IsZero ())
+        {
+          ending.push_back (std::make_pair (phy->m_endRxDataEvent.GetUid (), phy));
+        }
+      else
+        {
+          later.push_back (phy);
+        }
+    }
+  m_pendingSlRx.swap (later);
+  std::sort (ending.begin (), ending.end ());
+
+  std::vector<LteSpectrumPhy*> batch;
+  batch.push_back (this);
+  for (std::vector<std::pair<uint32_t, LteSpectrumPhy*> >::iterator it = ending.begin (); it != ending.end (); it++)
+    {
+      LteSpectrumPhy* phy = it->second;
+      NS_ASSERT (phy->m_state == RX_DATA);
+      phy->m_slRxPending = false;
+      phy->m_endRxDataEvent.Cancel ();
+      batch.push_back (phy);
+    }
+  NS_LOG_LOGIC ("decoding " << batch.size () << " sidelink receptions");
+
+  for (std::vector<LteSpectrumPhy*>::iterator it = batch.begin (); it != batch.end (); it++)
+    {
+      (*it)->PrepareSlRx ();
+    }
+  m_slRxBatch = batch;
+  WorkerPool::Get ()->Run (m_slRxBatch.size (), MakeCallback (&LteSpectrumPhy::DoDecodeSlRx));
+  m_slRxBatch.clear ();
+  for (std::vector<LteSpectrumPhy*>::iterator it = batch.begin (); it != batch.end (); it++)
+    {
+      (*it)->DeliverSlRx ();
+    }
+}
+
+void
+LteSpectrumPhy::DoDecodeSlRx (uint32_t index)
+{
+  m_slRxBatch[index]->DecodeSlRx ();
+}
+
+void
+LteSpectrumPhy::PrepareSlRx ()
+{
+  NS_LOG_FUNCTION (this);
+
   // this will trigger CQI calculation and Error Model evaluation
   // as a side effect, the error model should update the error status of all TBs
   m_interferenceSl->EndRx ();
@@ -1710,7 +1903,83 @@ LteSpectrumPhy::EndRxSlData ()
   //NS_LOG_DEBUG (this << " txMode " << (uint16_t)m_transmissionMode << " gain " << m_txModeGain.at (m_transmissionMode));
   NS_ASSERT (m_transmissionMode < m_txModeGain.size ());  
   //m_sinrPerceived *= m_txModeGain.at (m_transmissionMode);
-  
+
+  // Average gain for SIMO based on [CatreuxMIMO]
+  m_slSinrSimo.clear ();
+  for (uint32_t i = 0; i < m_slSinrPerceived.size (); i++)
+    {
+      m_slSinrSimo.push_back (m_slSinrPerceived[i] * 4);
+    }
+  MeasureSlV2x ();
+}
+
+void
+LteSpectrumPhy::MeasureSlV2x ()
+{
+  NS_LOG_FUNCTION (this);
+  // only the measurements of this reception may be passed with its SCIs
+  m_slV2xMeasurements.clear ();
+  // the signals are indexed in the order of the reception starts, as the
+  // packets; a signal carrying a SCI is measured on its own RBs only, so
+  // the work is linear in the number of transmitters
+  for (uint32_t i = 0; i < m_rxPacketInfo.size () && i < m_slSignalPerceived.size (); i++)
+    {
+      const SlRxPacketInfo_t& packetInfo = m_rxPacketInfo[i];
+      if (!packetInfo.m_rxControlMessage || packetInfo.m_rxControlMessage->GetMessageType () != LteControlMessage::SCI_V2X
+          || packetInfo.rbBitmap.empty ())
+        {
+          continue;
+        }
+      SciLteControlMessageV2x* msg = static_cast<SciLteControlMessageV2x*> (PeekPointer (packetInfo.m_rxControlMessage));
+      const SpectrumValue& signal = m_slSignalPerceived[i];
+      const SpectrumValue& interference = m_slInterferencePerceived[i];
+
+      SlV2xMeasurement_t measurement;
+      measurement.m_rnti = msg->GetSci ().m_rnti;
+      measurement.m_rbStart = packetInfo.rbBitmap.front ();
+      measurement.m_rbLen = packetInfo.rbBitmap.size ();
+      double sumRsrp = 0.0;
+      double sumRssi = 0.0;
+      uint16_t nRb = 0;
+      // skip the first two RBs, used by the PSCCH
+      for (uint32_t j = 2; j < packetInfo.rbBitmap.size (); j++)
+        {
+          int rb = packetInfo.rbBitmap[j];
+          // convert PSD [W/Hz] to linear power [W] for the single RE
+          double signalPowerTxW = (signal[rb] * 180000.0) / 12.0;
+          double interfPlusNoisePowerTxW = (interference[rb] * 180000.0) / 12.0;
+          sumRsrp += signalPowerTxW;
+          sumRssi += 2 * (interfPlusNoisePowerTxW + signalPowerTxW);
+          nRb++;
+        }
+      if (nRb == 0)
+        {
+          NS_LOG_LOGIC (this << " no PSSCH RB to measure the signal of rnti " << measurement.m_rnti);
+          continue;
+        }
+      measurement.m_rsrp = 10 * std::log10 (1000 * sumRsrp / nRb);
+      measurement.m_rssi = 10 * std::log10 (1000 * sumRssi / nRb);
+      NS_LOG_LOGIC (this << " rnti " << measurement.m_rnti << " S-RSRP " << measurement.m_rsrp << " dBm S-RSSI " << measurement.m_rssi << " dBm");
+      m_slV2xMeasurements[measurement.m_rnti] = measurement;
+    }
+}
+
+const SlV2xMeasurement_t*
+LteSpectrumPhy::GetSlV2xMeasurement (uint16_t rnti) const
+{
+  std::map<uint16_t, SlV2xMeasurement_t>::const_iterator it = m_slV2xMeasurements.find (rnti);
+  if (it == m_slV2xMeasurements.end ())
+    {
+      return 0;
+    }
+  return &it->second;
+}
+
+void
+LteSpectrumPhy::DecodeSlRx ()
+{
+  NS_LOG_FUNCTION (this);
+
   //Compute error on PSSCH
   //Create a mapping between the packet tag and the index of the packet bursts. We need this information to access the right SINR measurement.
   std::map <SlTbId_t, uint32_t> expectedTbToSinrIndex;
@@ -1749,8 +2018,9 @@ LteSpectrumPhy::EndRxSlData ()
       {
         if (m_rxPacketInfo[i].m_rxControlMessage->GetMessageType () == LteControlMessage::SCI_V2X)
         {
-          Ptr<LteControlMessage> rxCtrlMsg = m_rxPacketInfo[i].m_rxControlMessage;
-          Ptr<SciLteControlMessageV2x> msg = DynamicCast<SciLteControlMessageV2x> (rxCtrlMsg);
+          // the message is shared with the other receivers, it is not referenced
+          // so that the receivers can be decoded by concurrent threads
+          SciLteControlMessageV2x* msg = static_cast<SciLteControlMessageV2x*> (PeekPointer (m_rxPacketInfo[i].m_rxControlMessage));
           SciListElementV2x sci = msg->GetSci (); 
 
           SlV2xTbId_t tbId; 
@@ -1760,12 +2030,10 @@ LteSpectrumPhy::EndRxSlData ()
           std::list<Ptr<SidelinkCommResourcePoolV2x > >::iterator sciIt;
           for (sciIt = m_slV2xRxPools.begin(); sciIt != m_slV2xRxPools.end(); sciIt++)
           {
-            std::list<SidelinkCommResourcePoolV2x::SidelinkTransmissionInfo> m_psschTx = (*sciIt)->GetPsschTransmissions(sci.m_riv,sci.m_resPscch);
-            std::list<SidelinkCommResourcePoolV2x::SidelinkTransmissionInfo>::iterator rxIt = m_psschTx.begin(); 
-            if(rxIt != m_psschTx.end())
+            const SidelinkCommResourcePoolV2x::SidelinkTransmissionInfo* txIt = (*sciIt)->GetPsschRxResources(sci.m_riv,sci.m_resPscch);
+            if(txIt)
             {
               //reception
-              std::list<SidelinkCommResourcePoolV2x::SidelinkTransmissionInfo>::iterator txIt = m_psschTx.begin(); 
               std::vector<int> rbMap; 
               for (int i = txIt->rbStart; i< txIt->rbStart+txIt->rbLen; i++)
               {
@@ -1858,7 +2126,7 @@ LteSpectrumPhy::EndRxSlData ()
 
           if (!m_nistErrorModelEnabled)
             {
-              TbStats_t tbStats = LteMiErrorModel::GetTbDecodificationStats (m_slSinrPerceived[(*itSinr).second]*4 /* Average gain for SIMO based on [CatreuxMIMO] */, (*itTb).second.rbBitmap, (*itTb).second.size, (*itTb).second.mcs, harqInfoList);
+              TbStats_t tbStats = m_miErrorModelCache.GetTbDecodificationStats (m_slSinrSimo[(*itSinr).second], (*itTb).second.rbBitmap, (*itTb).second.size, (*itTb).second.mcs, harqInfoList);
               (*itTb).second.mi = tbStats.mi;
                 if(m_slBlerEnabled)
                   {
@@ -1872,7 +2140,7 @@ LteSpectrumPhy::EndRxSlData ()
             } 
           else 
             {
-              TbErrorStats_t tbStats = LtePhyErrorModel::GetPsschBler (m_fadingModel,LtePhyErrorModel::SISO, (*itTb).second.mcs, GetMeanSinr (m_slSinrPerceived[(*itSinr).second]*4 /* Average gain for SIMO based on [CatreuxMIMO] */, (*itTb).second.rbBitmap),  harqInfoList);
+              TbErrorStats_t tbStats = LtePhyErrorModel::GetPsschBler (m_fadingModel,LtePhyErrorModel::SISO, (*itTb).second.mcs, GetMeanSinr (m_slSinrSimo[(*itSinr).second], (*itTb).second.rbBitmap),  harqInfoList);
               (*itTb).second.sinr = tbStats.sinr;
               if(m_slBlerEnabled)
                 {
@@ -1891,9 +2159,8 @@ LteSpectrumPhy::EndRxSlData ()
           //     std::cout << (*itTb).second.rbBitmap.at(i) << ",";
           //   }
           // std::cout << std::endl;
-          // fire traces on SL reception PHY stats
+          // statistics of the SL reception, traced at the delivery
           PhyReceptionStatParameters params;
-          params.m_timestamp = Simulator::Now ().GetMilliSeconds ();
           params.m_cellId = m_cellId;
           params.m_imsi = 0; // it will be set by DlPhyTransmissionCallback in LteHelper
           params.m_rnti = (*itTb).first.m_rnti;
@@ -1904,10 +2171,10 @@ LteSpectrumPhy::EndRxSlData ()
           params.m_rv = (*itTb).second.rv;
           params.m_ndi = (*itTb).second.ndi;
           params.m_correctness = (uint8_t)!(*itTb).second.corrupt;
-          params.m_sinrPerRb = GetMeanSinr (m_slSinrPerceived[(*itSinr).second]*4 /* Average gain for SIMO based on [CatreuxMIMO] */, (*itTb).second.rbBitmap);
+          params.m_sinrPerRb = GetMeanSinr (m_slSinrSimo[(*itSinr).second], (*itTb).second.rbBitmap);
 
           params.m_rv = harqInfoList.size ();
-          m_slPhyReception (params);          
+          m_slRxTbStats.push_back (params);          
         }
       
       itTb++;
@@ -1948,7 +2215,7 @@ LteSpectrumPhy::EndRxSlData ()
           if (!m_nistErrorModelEnabled)
           {
             NS_LOG_LOGIC (this << " nist error model not enabled");
-            TbStats_t tbStats = LteMiErrorModel::GetTbDecodificationStats (m_slSinrPerceived[(*itSinrV2x).second]*4 /* Average gain for SIMO based on [CatreuxMIMO] */, (*itTbV2x).second.rbBitmap, (*itTbV2x).second.size, (*itTbV2x).second.mcs, harqInfoList);
+            TbStats_t tbStats = m_miErrorModelCache.GetTbDecodificationStats (m_slSinrSimo[(*itSinrV2x).second], (*itTbV2x).second.rbBitmap, (*itTbV2x).second.size, (*itTbV2x).second.mcs, harqInfoList);
             (*itTbV2x).second.mi = tbStats.mi;
               if(m_slBlerEnabled)
                 {
@@ -1962,7 +2229,7 @@ LteSpectrumPhy::EndRxSlData ()
           else 
           {
             NS_LOG_LOGIC (this << " nist error model enabled");
-            TbErrorStats_t tbStats = LtePhyErrorModel::GetPsschBler (m_fadingModel,LtePhyErrorModel::SISO, (*itTbV2x).second.mcs, GetMeanSinr (m_slSinrPerceived[(*itSinrV2x).second]*4 /* Average gain for SIMO based on [CatreuxMIMO] */, (*itTbV2x).second.rbBitmap),  harqInfoList);
+            TbErrorStats_t tbStats = LtePhyErrorModel::GetPsschBler (m_fadingModel,LtePhyErrorModel::SISO, (*itTbV2x).second.mcs, GetMeanSinr (m_slSinrSimo[(*itSinrV2x).second], (*itTbV2x).second.rbBitmap),  harqInfoList);
             (*itTbV2x).second.sinr = tbStats.sinr;
             if(m_slBlerEnabled)
               {
@@ -1986,9 +2253,8 @@ LteSpectrumPhy::EndRxSlData ()
                                 << " corrupted " << (*itTbV2x).second.corrupt);
           }
 
-        // fire traces on SL reception PHY stats
+        // statistics of the SL reception, traced at the delivery
         PhyReceptionStatParameters params;
-        params.m_timestamp = Simulator::Now ().GetMilliSeconds ();
         params.m_cellId = m_cellId;
         params.m_imsi = 0; // it will be set by DlPhyTransmissionCallback in LteHelper
         params.m_rnti = (*itTbV2x).first.m_rnti;
@@ -1997,121 +2263,17 @@ LteSpectrumPhy::EndRxSlData ()
         params.m_mcs = (*itTbV2x).second.mcs;
         params.m_size = (*itTbV2x).second.size;
         params.m_correctness = (uint8_t)!(*itTbV2x).second.corrupt;
-        params.m_sinrPerRb = GetMeanSinr (m_slSinrPerceived[(*itSinrV2x).second]*4 /* Average gain for SIMO based on [CatreuxMIMO] */, (*itTbV2x).second.rbBitmap);
-        m_slPhyReception (params);          
+        params.m_sinrPerRb = GetMeanSinr (m_slSinrSimo[(*itSinrV2x).second], (*itTbV2x).second.rbBitmap);
+        m_slRxTbStats.push_back (params);          
       }
       itTbV2x++;
     }
 
-  for (uint32_t i = 0 ; i < m_rxPacketInfo.size() ; i++)
-    {
-      //even though there may be multiple packets, they all have
-      //the same tag
-      if (m_rxPacketInfo[i].m_rxPacketBurst) //if data packet
-        {
-          for (std::list<Ptr<Packet> >::const_iterator j = m_rxPacketInfo[i].m_rxPacketBurst->Begin (); j != m_rxPacketInfo[i].m_rxPacketBurst->End (); ++j)
-            {
-              // retrieve TB info of this packet 
-              LteRadioBearerTag tag;
-              (*j)->PeekPacketTag (tag);
-              if (m_expectedSlV2xTbs.size() > 0)
-                {
-                  SlV2xTbId_t tbId;
-                  tbId.m_rnti = tag.GetRnti ();
-                  NS_LOG_INFO (this << " Packet of " << tbId.m_rnti);
-
-                  itTbV2x = m_expectedSlV2xTbs.find (tbId);
-                  if (itTbV2x!=m_expectedSlV2xTbs.end ())
-                    {
-                      if (!(*itTbV2x).second.corrupt)
-                        {
-                          NS_LOG_LOGIC (this << " packet OK");
-                          m_phyRxEndOkTrace (*j);
-                    
-                          if (!m_ltePhyRxDataEndOkCallback.IsNull ())
-                            {
-                              m_ltePhyRxDataEndOkCallback (*j);
-                            }
-                        }
-                      else
-                        {
-                          // TB received with errors
-                          NS_LOG_LOGIC (this << " TB received with errors");
-                          m_phyRxEndErrorTrace (*j);
-                        }
-                    }
-                  NS_ASSERT (itTb!=m_expectedSlTbs.end () || itTbV2x!=m_expectedSlV2xTbs.end ());
-                }
-              else
-                {
-                  SlTbId_t tbId;
-                  tbId.m_rnti = tag.GetRnti ();
-                  tbId.m_l1dst = tag.GetDestinationL2Id () & 0xFF;
-                  NS_LOG_INFO (this << " Packet of " << tbId.m_rnti << " group " <<  (uint16_t) tbId.m_l1dst);
-                  
-                  itTb = m_expectedSlTbs.find (tbId);
-                  if (itTb!=m_expectedSlTbs.end ())
-                    {
-                      if (!(*itTb).second.corrupt)
-                        {
-                          NS_LOG_LOGIC (this << " packet OK");
-                          m_phyRxEndOkTrace (*j);
-                    
-                          if (!m_ltePhyRxDataEndOkCallback.IsNull ())
-                            {
-                              m_ltePhyRxDataEndOkCallback (*j);
-                            }
-                        }
-                      else
-                        {
-                          // TB received with errors
-                          NS_LOG_LOGIC (this << " TB received with errors");
-                          m_phyRxEndErrorTrace (*j);
-                        }
-
-                      //store HARQ information
-                      if (!(*itTb).second.harqFeedbackSent)
-                        {
-                          (*itTb).second.harqFeedbackSent = true;
-                          //because we do not have feedbacks we do not reset HARQ now.
-                          //we will do it when we expect a new data
-                          if ((*itTb).second.corrupt)
-                            {
-                              if (!m_nistErrorModelEnabled)
-                                {
-                                  m_harqPhyModule->UpdateSlHarqProcessStatus (tbId.m_rnti, tbId.m_l1dst, (*itTb).second.mi, (*itTb).second.size, (*itTb).second.size / EffectiveCodingRate [(*itTb).second.mcs]);
-                                }
-                              else
-                                {
-                                  m_harqPhyModule->UpdateSlHarqProcessStatus (tbId.m_rnti, tbId.m_l1dst, (*itTb).second.sinr);
-                                }
-                            }
-                          else
-                            {
-                              //m_harqPhyModule->ResetSlHarqProcessStatus (tbId.m_rnti, tbId.m_l1dst);
-                            }
-                          /*
-                            if (!m_ltePhySlHarqFeedbackCallback.IsNull ())
-                            {
-                            m_ltePhySlHarqFeedbackCallback (harqSlInfo);
-                            }
-                          */
-                        }
-                    }
-                }
-            }
-        }
-    }
-
-
   /* Currently the MIB-SL is treated as a control message. Thus, the following logic applies also to the MIB-SL
    * The differences: calculation of BLER */
   // When control messages collide in the PSCCH, the receiver cannot know how many transmissions occured
   // we sort the messages by SINR and try to decode the ones with highest average SINR per RB first
   // only one message per RB can be decoded
-  std::list<Ptr<LteControlMessage> > rxControlMessageOkList;
-  bool error = true; 
-  bool ctrlMessageFound = false;
   std::multiset<SlCtrlPacketInfo_t> sortedControlMessages;
   rbDecodedBitmap.clear ();
 
@@ -2187,7 +2349,6 @@ LteSpectrumPhy::EndRxSlData ()
       int i = (*it).index;
 
       bool ctrlError = false;
-      ctrlMessageFound = true;
       
       if (m_ctrlErrorModelEnabled)
         {
@@ -2209,7 +2370,7 @@ LteSpectrumPhy::EndRxSlData ()
                   double  errorRate;
                   if (m_rxPacketInfo[i].m_rxControlMessage->GetMessageType() == LteControlMessage::SCI)
                     {
-                      errorRate = LtePhyErrorModel::GetPscchBler (m_fadingModel,LtePhyErrorModel::SISO, GetMeanSinr (m_slSinrPerceived[i]*4 /* Average gain for SIMO based on [CatreuxMIMO] */, m_rxPacketInfo[i].rbBitmap)).tbler;
+                      errorRate = LtePhyErrorModel::GetPscchBler (m_fadingModel,LtePhyErrorModel::SISO, GetMeanSinr (m_slSinrSimo[i], m_rxPacketInfo[i].rbBitmap)).tbler;
                       ctrlError = m_random->GetValue () > errorRate ? false : true;
                       NS_LOG_DEBUG (this << " PSCCH Decoding, errorRate " << errorRate << " error " << ctrlError);
                     }
@@ -2220,13 +2381,13 @@ LteSpectrumPhy::EndRxSlData ()
                       {
                         pscchBitmap.pop_back(); 
                       }
-                      errorRate = LtePhyErrorModel::GetPscchBler (m_fadingModel,LtePhyErrorModel::SISO, GetMeanSinr (m_slSinrPerceived[i]*4 /* Average gain for SIMO based on [CatreuxMIMO] */, pscchBitmap)).tbler;
+                      errorRate = LtePhyErrorModel::GetPscchBler (m_fadingModel,LtePhyErrorModel::SISO, GetMeanSinr (m_slSinrSimo[i], pscchBitmap)).tbler;
                       ctrlError = m_random->GetValue () > errorRate ? false : true;
                       NS_LOG_DEBUG (this << " PSCCH Decoding, errorRate " << errorRate << " error " << ctrlError);
                     }
                   else if (m_rxPacketInfo[i].m_rxControlMessage->GetMessageType() == LteControlMessage::MIB_SL)
                     {
-                      errorRate = LtePhyErrorModel::GetPsbchBler (m_fadingModel,LtePhyErrorModel::SISO, GetMeanSinr (m_slSinrPerceived[i]*4 /* Average gain for SIMO based on [CatreuxMIMO] */, m_rxPacketInfo[i].rbBitmap)).tbler;
+                      errorRate = LtePhyErrorModel::GetPsbchBler (m_fadingModel,LtePhyErrorModel::SISO, GetMeanSinr (m_slSinrSimo[i], m_rxPacketInfo[i].rbBitmap)).tbler;
                       ctrlError = m_random->GetValue () > errorRate ? false : true;
                       NS_LOG_DEBUG (this << " PSBCH Decoding, errorRate " << errorRate << " error " << ctrlError);
                     }
@@ -2238,11 +2399,153 @@ LteSpectrumPhy::EndRxSlData ()
             }
         }
 
+      if (!ctrlError)
+        {
+          rbDecodedBitmap.insert ( m_rxPacketInfo[i].rbBitmap.begin(), m_rxPacketInfo[i].rbBitmap.end());
+        }
+      m_slRxCtrlError.push_back (ctrlError);
+    }
+
+  m_slRxSortedCtrl.swap (sortedControlMessages);
+  m_slRxDecodedRbs.swap (rbDecodedBitmap);
+}
+
+void
+LteSpectrumPhy::DeliverSlRx ()
+{
+  NS_LOG_FUNCTION (this);
+
+  // fire traces on SL reception PHY stats
+  for (std::vector<PhyReceptionStatParameters>::iterator it = m_slRxTbStats.begin (); it != m_slRxTbStats.end (); it++)
+    {
+      (*it).m_timestamp = Simulator::Now ().GetMilliSeconds ();
+      m_slPhyReception (*it);
+    }
+
+  expectedSlTbs_t::iterator itTb = m_expectedSlTbs.end ();
+  expectedSlV2xTbs_t::iterator itTbV2x = m_expectedSlV2xTbs.end ();
+
+  for (uint32_t i = 0 ; i < m_rxPacketInfo.size() ; i++)
+    {
+      //even though there may be multiple packets, they all have
+      //the same tag
+      if (m_rxPacketInfo[i].m_rxPacketBurst) //if data packet
+        {
+          for (std::list<Ptr<Packet> >::const_iterator j = m_rxPacketInfo[i].m_rxPacketBurst->Begin (); j != m_rxPacketInfo[i].m_rxPacketBurst->End (); ++j)
+            {
+              // retrieve TB info of this packet 
+              LteRadioBearerTag tag;
+              (*j)->PeekPacketTag (tag);
+              if (m_expectedSlV2xTbs.size() > 0)
+                {
+                  SlV2xTbId_t tbId;
+                  tbId.m_rnti = tag.GetRnti ();
+                  NS_LOG_INFO (this << " Packet of " << tbId.m_rnti);
+
+                  itTbV2x = m_expectedSlV2xTbs.find (tbId);
+                  if (itTbV2x!=m_expectedSlV2xTbs.end ())
+                    {
+                      if (!(*itTbV2x).second.corrupt)
+                        {
+                          NS_LOG_LOGIC (this << " packet OK");
+                          m_phyRxEndOkTrace (*j);
+                    
+                          if (!m_ltePhyRxDataEndOkCallback.IsNull ())
+                            {
+                              m_ltePhyRxDataEndOkCallback (*j);
+                            }
+                        }
+                      else
+                        {
+                          // TB received with errors
+                          NS_LOG_LOGIC (this << " TB received with errors");
+                          m_phyRxEndErrorTrace (*j);
+                        }
+                    }
+                  NS_ASSERT (itTb!=m_expectedSlTbs.end () || itTbV2x!=m_expectedSlV2xTbs.end ());
+                }
+              else
+                {
+                  SlTbId_t tbId;
+                  tbId.m_rnti = tag.GetRnti ();
+                  tbId.m_l1dst = tag.GetDestinationL2Id () & 0xFF;
+                  NS_LOG_INFO (this << " Packet of " << tbId.m_rnti << " group " <<  (uint16_t) tbId.m_l1dst);
+                  
+                  itTb = m_expectedSlTbs.find (tbId);
+                  if (itTb!=m_expectedSlTbs.end ())
+                    {
+                      if (!(*itTb).second.corrupt)
+                        {
+                          NS_LOG_LOGIC (this << " packet OK");
+                          m_phyRxEndOkTrace (*j);
+                    
+                          if (!m_ltePhyRxDataEndOkCallback.IsNull ())
+                            {
+                              m_ltePhyRxDataEndOkCallback (*j);
+                            }
+                        }
+                      else
+                        {
+                          // TB received with errors
+                          NS_LOG_LOGIC (this << " TB received with errors");
+                          m_phyRxEndErrorTrace (*j);
+                        }
+
+                      //store HARQ information
+                      if (!(*itTb).second.harqFeedbackSent)
+                        {
+                          (*itTb).second.harqFeedbackSent = true;
+                          //because we do not have feedbacks we do not reset HARQ now.
+                          //we will do it when we expect a new data
+                          if ((*itTb).second.corrupt)
+                            {
+                              if (!m_nistErrorModelEnabled)
+                                {
+                                  m_harqPhyModule->UpdateSlHarqProcessStatus (tbId.m_rnti, tbId.m_l1dst, (*itTb).second.mi, (*itTb).second.size, (*itTb).second.size / EffectiveCodingRate [(*itTb).second.mcs]);
+                                }
+                              else
+                                {
+                                  m_harqPhyModule->UpdateSlHarqProcessStatus (tbId.m_rnti, tbId.m_l1dst, (*itTb).second.sinr);
+                                }
+                            }
+                          else
+                            {
+                              //m_harqPhyModule->ResetSlHarqProcessStatus (tbId.m_rnti, tbId.m_l1dst);
+                            }
+                          /*
+                            if (!m_ltePhySlHarqFeedbackCallback.IsNull ())
+                            {
+                            m_ltePhySlHarqFeedbackCallback (harqSlInfo);
+                            }
+                          */
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+
+  // deliver the control messages, in the order they were decoded
+  std::list<Ptr<LteControlMessage> > rxControlMessageOkList;
+  bool error = true; 
+  bool ctrlMessageFound = false;
+  std::multiset<SlCtrlPacketInfo_t> sortedControlMessages;
+  sortedControlMessages.swap (m_slRxSortedCtrl);
+  std::set<int> rbDecodedBitmap;
+  rbDecodedBitmap.swap (m_slRxDecodedRbs);
+  std::vector<bool>::const_iterator itCtrlError = m_slRxCtrlError.begin ();
+  for (std::multiset<SlCtrlPacketInfo_t>::iterator it = sortedControlMessages.begin(); it != sortedControlMessages.end() ; it++, itCtrlError++)
+    {
+      int i = (*it).index;
+
+      bool ctrlError = *itCtrlError;
+      ctrlMessageFound = true;
+
       if (!ctrlError)
         {
           error = false; //at least one control packet is OK
           rxControlMessageOkList.push_back (m_rxPacketInfo[i].m_rxControlMessage);
-          rbDecodedBitmap.insert ( m_rxPacketInfo[i].rbBitmap.begin(), m_rxPacketInfo[i].rbBitmap.end());
         }
 
       if(m_rxPacketInfo[i].m_rxControlMessage->GetMessageType () == LteControlMessage::SCI)
@@ -2387,7 +2690,7 @@ LteSpectrumPhy::EndRxSlData ()
                 } 
               else 
                 {
-                  TbErrorStats_t tbStats = LtePhyErrorModel::GetPsdchBler (m_fadingModel,LtePhyErrorModel::SISO, GetMeanSinr (m_slSinrPerceived[(*itSinrDisc).second]*4 /* Average gain for SIMO based on [CatreuxMIMO] */, (*itTbDisc).second.rbBitmap),  harqInfoList);
+                  TbErrorStats_t tbStats = LtePhyErrorModel::GetPsdchBler (m_fadingModel,LtePhyErrorModel::SISO, GetMeanSinr (m_slSinrSimo[(*itSinrDisc).second], (*itTbDisc).second.rbBitmap),  harqInfoList);
                   (*itTbDisc).second.sinr = tbStats.sinr;
                   (*itTbDisc).second.corrupt = m_random->GetValue () > tbStats.tbler ? false : true;
                   NS_LOG_DEBUG (this << " from RNTI " << (*itTbDisc).first.m_rnti << " TBLER " << tbStats.tbler << " corrupted " << (*itTbDisc).second.corrupt);
@@ -2408,7 +2711,7 @@ LteSpectrumPhy::EndRxSlData ()
               params.m_rv = (*itTbDisc).second.rv;
               params.m_ndi = (*itTbDisc).second.ndi;
               params.m_correctness = (uint8_t)!(*itTbDisc).second.corrupt;
-              params.m_sinrPerRb = GetMeanSinr (m_slSinrPerceived[(*itSinrDisc).second]*4 /* Average gain for SIMO based on [CatreuxMIMO] */, (*itTbDisc).second.rbBitmap);
+              params.m_sinrPerRb = GetMeanSinr (m_slSinrSimo[(*itSinrDisc).second], (*itTbDisc).second.rbBitmap);
               params.m_rv = harqInfoList.size ();
               m_slPhyReception (params);  
             }
@@ -2607,7 +2910,7 @@ LteSpectrumPhy::EndRxSlData ()
                     }
                   if (ok)
                     {
-                      double  errorRate = LtePhyErrorModel::GetPscchBler (m_fadingModel,LtePhyErrorModel::SISO, GetMeanSinr (m_slSinrPerceived[i]*4 /* Average gain for SIMO based on [CatreuxMIMO] */, m_rxPacketInfo[i].rbBitmap)).tbler;
+                      double  errorRate = LtePhyErrorModel::GetPscchBler (m_fadingModel,LtePhyErrorModel::SISO, GetMeanSinr (m_slSinrSimo[i], m_rxPacketInfo[i].rbBitmap)).tbler;
                       ctrlError = m_random->GetValue () > errorRate ? false : true;
                       NS_LOG_DEBUG (this << " Discovery Decodification, errorRate " << errorRate << " error " << ctrlError);
                     } 
@@ -2663,6 +2966,9 @@ LteSpectrumPhy::EndRxSlData ()
   m_expectedSlTbs.clear ();
   m_expectedSlV2xTbs.clear ();
   m_expectedDiscTbs.clear ();
+  m_slSinrSimo.clear ();
+  m_slRxTbStats.clear ();
+  m_slRxCtrlError.clear ();
 }
 
 void
@@ -2811,6 +3117,36 @@ LteSpectrumPhy::SetTransmissionMode (uint8_t txMode)
 }
 
 
+void
+LteSpectrumPhy::SetMiErrorModelCacheStep (double step)
+{
+  NS_LOG_FUNCTION (this << step);
+  m_miErrorModelCache.SetStep (step);
+}
+
+
+double
+LteSpectrumPhy::GetMiErrorModelCacheStep () const
+{
+  return m_miErrorModelCache.GetStep ();
+}
+
+
+void
+LteSpectrumPhy::SetMiErrorModelCacheValidationEnabled (bool enabled)
+{
+  NS_LOG_FUNCTION (this << enabled);
+  m_miErrorModelCache.SetValidationEnabled (enabled);
+}
+
+
+bool
+LteSpectrumPhy::IsMiErrorModelCacheValidationEnabled () const
+{
+  return m_miErrorModelCache.IsValidationEnabled ();
+}
+
+
 void 
 LteSpectrumPhy::SetTxModeGain (uint8_t txMode, double gain)
 {
@@ -2848,11 +3184,10 @@ LteSpectrumPhy::AssignStreams (int64_t stream)
 double 
 LteSpectrumPhy::GetMeanSinr (const SpectrumValue& sinr, const std::vector<int>& map)
 {
-  SpectrumValue sinrCopy = sinr;
   double sinrLin = 0;
   for (uint32_t i = 0; i < map.size (); i++)
     {
-      sinrLin += sinrCopy[map.at (i)];
+      sinrLin += sinr[map.at (i)];
     }
   return sinrLin / map.size();
 }
@@ -2877,6 +3212,14 @@ LteSpectrumPhy::SetLtePhyRxSlssCallback (LtePhyRxSlssCallback c)
   m_ltePhyRxSlssCallback = c;
 }
 
+void
+LteSpectrumPhy::SetLtePhyAnnounceTxCallback (Time lookahead, LtePhyAnnounceTxCallback c)
+{
+  NS_LOG_FUNCTION (this << lookahead);
+  m_txLookahead = lookahead;
+  m_ltePhyAnnounceTxCallback = c;
+}
+
 void 
 LteSpectrumPhy::SetRxPool (Ptr<SidelinkDiscResourcePool> newpool)
 {
@@ -42,8 +42,10 @@
 #include <ns3/lte-interference.h>
 #include <ns3/lte-sl-interference.h>
 #include <ns3/lte-phy-error-model.h>
+#include <ns3/lte-mi-error-model.h>
 #include "ns3/random-variable-stream.h"
 #include <map>
+#include <set>
 #include <ns3/ff-mac-common.h>
 #include <ns3/lte-harq-phy.h>
 #include <ns3/lte-common.h>
@@ -191,6 +193,19 @@ struct SlRxPacketInfo_t
   Ptr<LteControlMessage> m_rxControlMessage;
 };
 
+/**
+ * Measurement of a received V2X sidelink signal, computed once at the end
+ * of the reception for the sensing of the UE
+ */
+struct SlV2xMeasurement_t
+{
+  uint16_t m_rnti; ///< RNTI of the transmitter
+  double m_rsrp; ///< S-RSRP on the PSSCH RBs, in dBm
+  double m_rssi; ///< S-RSSI on the PSSCH RBs, in dBm
+  uint16_t m_rbStart; ///< first RB of the signal
+  uint16_t m_rbLen; ///< number of RBs of the signal
+};
+
 struct SlCtrlPacketInfo_t
 {
   double sinr;
@@ -243,6 +258,16 @@ typedef Callback< void, uint16_t, Ptr<SpectrumValue> > LtePhyRxPssCallback;
 */
 typedef Callback< void, uint16_t, Ptr<SpectrumValue> > LtePhyRxSlssCallback;
 
+/**
+* This method is used by the LteSpectrumPhy to announce a sidelink frame
+* starting after a delay to the other systems of a distributed
+* simulation, e.g. with DistributedSpectrumChannel::AnnounceTx.
+*
+* @param params the parameters of the frame
+* @param delay the delay of the start of the transmission
+*/
+typedef Callback< void, Ptr<SpectrumSignalParameters>, Time > LtePhyAnnounceTxCallback;
+
 /**
 * This method is used by the LteSpectrumPhy to notify the PHY about
 * the status of a certain DL HARQ process
@@ -298,6 +323,7 @@ public:
   Ptr<const SpectrumModel> GetRxSpectrumModel () const;
   Ptr<AntennaModel> GetRxAntenna ();
   void StartRx (Ptr<SpectrumSignalParameters> params);
+  bool IsPsdGainSupported () const;
   /**
    * \brief Start receive data function
    * \param params Ptr<LteSpectrumSignalParametersDataFrame>
@@ -311,8 +337,9 @@ public:
   /**
    * \brief Start receive SL data function
    * \param params Ptr<LteSpectrumSignalParametersSlFrame>
+   * \param rbRuns the RBs occupied by the signal
    */
-  void StartRxSlData (Ptr<LteSpectrumSignalParametersSlFrame> params);
+  void StartRxSlData (Ptr<LteSpectrumSignalParametersSlFrame> params, const std::vector<LteRbPsdRun>& rbRuns);
   /**
    * \brief Start receive UL SRS function
    * \param lteUlSrsRxParams Ptr<LteSpectrumSignalParametersUlSrsFrame>
@@ -389,6 +416,26 @@ public:
   */
   bool StartTxSlDataFrame (Ptr<PacketBurst> pb, std::list<Ptr<LteControlMessage> > ctrlMsgList, Time duration, uint8_t groupId);
 
+  /**
+  * Start a transmission of sidelink data frame after a delay. The frame
+  * is built with the current transmit PSD. If a callback is set with
+  * SetLtePhyAnnounceTxCallback, the frame is announced to the other
+  * systems, which receive it at the start of its transmission.
+  *
+  * @param pb the burst of packets to be transmitted in PSSCH
+  * @param ctrlMsgList the list of LteControlMessage to send
+  * @param duration the duration of the data frame
+  * @param groupId the destination group
+  * @param delay the delay of the start of the transmission
+  */
+  void ScheduleTxSlDataFrame (Ptr<PacketBurst> pb, std::list<Ptr<LteControlMessage> > ctrlMsgList, Time duration, uint8_t groupId, Time delay);
+
+  /**
+  * @return the minimum delay of the transmissions announced to the other
+  * systems (see ScheduleTxSlDataFrame), or zero if they are not announced
+  */
+  Time GetTxLookahead () const;
+
   /**
   * Start a transmission of control frame in DL
   *
@@ -659,6 +706,14 @@ public:
   */
   void UpdateSlIntPerceived (std::vector <SpectrumValue> interference);
 
+  /**
+   * \param rnti the RNTI of a V2X transmitter
+   * \return the measurement of the signal carrying a SCI received from
+   *         the transmitter in the last reception, or 0 if none was
+   *         received or it had no PSSCH RB
+   */
+  const SlV2xMeasurement_t* GetSlV2xMeasurement (uint16_t rnti) const;
+
   /** 
   * 
   * 
@@ -686,6 +741,15 @@ public:
     */
   void SetLtePhyRxSlssCallback (LtePhyRxSlssCallback c);
 
+   /**
+    * set the callback announcing the sidelink frames scheduled with
+    * ScheduleTxSlDataFrame to the other systems of a distributed simulation
+    *
+    * @param lookahead the minimum delay of the announced frames
+    * @param c the callback
+    */
+  void SetLtePhyAnnounceTxCallback (Time lookahead, LtePhyAnnounceTxCallback c);
+
   /// allow LteUePhy class friend access
   friend class LteUePhy;
   
@@ -715,6 +779,29 @@ private:
   * \param newState the new state to set
   */
   void ChangeState (State newState);
+  /**
+  * Create a sidelink data frame with the current transmit PSD
+  *
+  * \param pb the burst of packets to be transmitted in PSSCH
+  * \param ctrlMsgList the list of LteControlMessage to send
+  * \param duration the duration of the data frame
+  * \param groupId the destination group
+  * \return the parameters of the frame
+  */
+  Ptr<LteSpectrumSignalParametersSlFrame> CreateSlDataFrame (Ptr<PacketBurst> pb, std::list<Ptr<LteControlMessage> > ctrlMsgList, Time duration, uint8_t groupId);
+  /**
+  * Start the transmission of a sidelink data frame
+  *
+  * \param txParams the parameters of the frame
+  * \return true if an error occurred and the transmission was not
+  * started, false otherwise.
+  */
+  bool DoStartTxSlDataFrame (Ptr<LteSpectrumSignalParametersSlFrame> txParams);
+  /**
+  * \return whether a sidelink data frame scheduled with
+  * ScheduleTxSlDataFrame starts now
+  */
+  bool IsTxSlDataFrameStarting () const;
   /// End transmit data function
   void EndTxData ();
   /// End transmit DL control function
@@ -729,6 +816,40 @@ private:
   void EndRxUlSrs ();
   /// End reveive SL data function
   void EndRxSlData ();
+  /// Register the reception ending with m_endRxDataEvent to the parallel SL reception stage
+  void AddPendingSlRx ();
+  /// End the SL receptions of all the PHYs ending now: decode them in parallel and deliver them in order
+  void EndRxSlDataBatch ();
+  /**
+   * Decode the SL reception of a PHY of the running batch
+   * \param index index of the PHY in the batch
+   */
+  static void DoDecodeSlRx (uint32_t index);
+  /// Finalize the SINR of the SL reception
+  void PrepareSlRx ();
+  /// Measure the S-RSRP and S-RSSI of each V2X signal of the SL reception
+  void MeasureSlV2x ();
+  /**
+   * Compute the errors of the TBs and control messages of the SL reception.
+   * The PHY state, its random variable, the pools and the received messages
+   * are only read, without taking references to the shared objects, so that
+   * the PHYs can be decoded by concurrent threads.
+   */
+  void DecodeSlRx ();
+  /// Fire the traces and deliver the decoded SL reception to the upper layers
+  void DeliverSlRx ();
+
+  /**
+   * \param step the quantization step in dB of the MI error model cache,
+   *             0 disables it
+   */
+  void SetMiErrorModelCacheStep (double step);
+  /// \return the quantization step in dB of the MI error model cache
+  double GetMiErrorModelCacheStep () const;
+  /// \param enabled whether the MI error model cache is validated against the exact path
+  void SetMiErrorModelCacheValidationEnabled (bool enabled);
+  /// \return whether the MI error model cache is validated against the exact path
+  bool IsMiErrorModelCacheValidationEnabled () const;
   
   /** 
   * \brief Set transmit mode gain function
@@ -747,6 +868,8 @@ private:
   Ptr<NetDevice> m_device; ///< the device
 
   Ptr<SpectrumChannel> m_channel; ///< the channel
+  LtePhyAnnounceTxCallback m_ltePhyAnnounceTxCallback; ///< the announcement of the sidelink frames, if any
+  Time m_txLookahead; ///< the minimum delay of the announced frames
 
   Ptr<const SpectrumModel> m_rxSpectrumModel; ///< the spectrum model
   Ptr<SpectrumValue> m_txPsd; ///< the transmit PSD
@@ -793,6 +916,22 @@ private:
   std::vector<SpectrumValue> m_slInterferencePerceived; //Interference for each D2D packet received
   //std::map<Ptr<LteControlMessage>, std::vector <int> > m_rxControlMessageRbMap;
   std::vector<SlRxPacketInfo_t> m_rxPacketInfo;
+  std::vector<SpectrumValue> m_slSinrSimo; //SINR with the SIMO gain for each D2D packet received
+  std::map<uint16_t, SlV2xMeasurement_t> m_slV2xMeasurements; // measurement of each V2X transmitter of the last reception
+
+  // decoded SL reception, waiting for its delivery
+  std::vector<PhyReceptionStatParameters> m_slRxTbStats; // statistics of the decoded TBs
+  std::multiset<SlCtrlPacketInfo_t> m_slRxSortedCtrl; // control messages by decreasing SINR
+  std::vector<bool> m_slRxCtrlError; // error of each control message of m_slRxSortedCtrl
+  std::set<int> m_slRxDecodedRbs; // RBs of the decoded control messages
+
+  // parallel SL reception stage: the receptions ending at the same time are decoded together
+  bool m_parallelSlRxEnabled; ///< parallel SL reception stage enabled
+  bool m_slRxPending; ///< the reception is registered in m_pendingSlRx
+  static std::vector<LteSpectrumPhy*> m_pendingSlRx; ///< PHYs with a SL reception in progress
+  static std::vector<LteSpectrumPhy*> m_slRxBatch; ///< PHYs decoded by the running batch
+
+  LteMiErrorModelCache m_miErrorModelCache; ///< memoized TB statistics of the MI error model
 
   // Information for sidelink V2x communication
   expectedSlV2xTbs_t m_expectedSlV2xTbs;
@@ -857,6 +996,7 @@ private:
   TracedCallback<PhyReceptionStatParameters> m_slPscchReception;
 
   EventId m_endTxEvent; ///< end transmit event
+  EventId m_startTxEvent; ///< start of the sidelink data frame scheduled in advance
   EventId m_endRxDataEvent; ///< end receive data event
   EventId m_endRxDlCtrlEvent; ///< end receive DL control event
   EventId m_endRxUlSrsEvent; ///< end receive UL SRS event
@@ -386,4 +386,31 @@ LteSpectrumValueHelper::CreateNoisePowerSpectralDensity (double noiseFigureDb, P
   return noisePsd;
 }
 
+std::vector<LteRbPsdRun>
+LteSpectrumValueHelper::GetRbPsdRuns (const SpectrumValue& psd)
+{
+  std::vector<LteRbPsdRun> rbRuns;
+  uint16_t rb = 0;
+  for (Values::const_iterator it = psd.ConstValuesBegin (); it != psd.ConstValuesEnd (); ++it, ++rb)
+    {
+      if (*it == 0)
+        {
+          continue;
+        }
+      if (!rbRuns.empty () && rbRuns.back ().rbStart + rbRuns.back ().rbLen == rb && rbRuns.back ().psd == *it)
+        {
+          rbRuns.back ().rbLen++;
+        }
+      else
+        {
+          LteRbPsdRun rbRun;
+          rbRun.rbStart = rb;
+          rbRun.rbLen = 1;
+          rbRun.psd = *it;
+          rbRuns.push_back (rbRun);
+        }
+    }
+  return rbRuns;
+}
+
 } // namespace ns3
@@ -25,10 +25,26 @@
 
 #include <ns3/spectrum-value.h>
 #include <vector>
+#include <map>
 
 namespace ns3 {
 
 
+/**
+ * \ingroup lte
+ *
+ * \brief A run of contiguous Resource Blocks having the same non-zero
+ * power spectral density, used as a sparse representation of the
+ * signals occupying a small part of the bandwidth, e.g., sidelink ones
+ */
+struct LteRbPsdRun
+{
+  uint16_t rbStart; ///< the first RB of the run
+  uint16_t rbLen; ///< the number of RBs of the run
+  double psd; ///< the power spectral density of each RB of the run
+};
+
+
 /**
  * \ingroup lte
  *
@@ -191,6 +207,15 @@ public:
    */
   static Ptr<SpectrumValue> CreateNoisePowerSpectralDensity (double noiseFigure, Ptr<SpectrumModel> spectrumModel);
 
+  /**
+   * get the sparse representation of a power spectral density
+   *
+   * \param psd the power spectral density
+   *
+   * \return the runs of RBs having the same non-zero power spectral density, by increasing RB
+   */
+  static std::vector<LteRbPsdRun> GetRbPsdRuns (const SpectrumValue& psd);
+
 };
 
 
@@ -41,8 +41,13 @@
 #include <ns3/enum.h>
 
 #include <ns3/boolean.h>
+#include <ns3/wall-clock-profiler.h>
+#include <ns3/worker-pool.h>
+#include <ns3/parallel-simulator-impl.h>
+#include <ns3/abort.h>
 #include <bitset>
 #include <algorithm>
+#include <limits>
 
 
 #include "ns3/lte-rlc-tag.h"
@@ -53,8 +58,20 @@ namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("LteUeMac");
 
+/// Number of slots of the sensing window ring (divides SidelinkCommResourcePoolV2x::SUBFRAME_CYCLE so slots stay consistent over the frame wrap-around)
+static const uint32_t SL_V2X_SENSING_RING_SIZE = 1024;
+/// Maximum age in subframes of the sensed data kept in the sensing window
+static const uint32_t SL_V2X_SENSING_WINDOW = 1000;
+/// Marks a subframe index without projected reservations
+static const uint32_t SL_V2X_NO_PROJECTION = 0xFFFFFFFF;
+/// Sensing step in subframes between the monitored subframes of partial sensing
+static const uint32_t SL_V2X_SENSING_STEP = 100;
+
 NS_OBJECT_ENSURE_REGISTERED (LteUeMac);
 
+std::vector<LteUeMac*> LteUeMac::m_pendingReselections;
+std::vector<LteUeMac*> LteUeMac::m_reselectionBatch;
+
 
 ///////////////////////////////////////////////////////////
 // SAP forwarders
@@ -309,6 +326,8 @@ public:
   virtual void ReceiveLteControlMessage (Ptr<LteControlMessage> msg);
   virtual void NotifyChangeOfTiming (uint32_t frameNo, uint32_t subframeNo);
   virtual void PassSensingData(uint32_t frameNo, uint32_t subframeNo, uint16_t pRsvp, uint8_t rbStart, uint8_t rbLen, uint8_t prio, double slRsrp, double slRssi); 
+  virtual bool IsSensingSubframe (uint32_t frameNo, uint32_t subframeNo); 
+  virtual uint32_t GetV2xIdleSubframes (); 
 
 private:
   LteUeMac* m_mac; ///< the UE MAC
@@ -349,6 +368,18 @@ UeMemberLteUePhySapUser::PassSensingData(uint32_t frameNo, uint32_t subframeNo,
 	m_mac->DoPassSensingData (frameNo, subframeNo, pRsvp, rbStart, rbLen, prio, slRsrp, slRssi);
 }
 
+bool 
+UeMemberLteUePhySapUser::IsSensingSubframe (uint32_t frameNo, uint32_t subframeNo)
+{
+	return m_mac->DoIsSensingSubframe (frameNo, subframeNo);
+}
+
+uint32_t 
+UeMemberLteUePhySapUser::GetV2xIdleSubframes ()
+{
+	return m_mac->DoGetV2xIdleSubframes ();
+}
+
 
 
 //////////////////////////////////////////////////////////
@@ -449,6 +480,22 @@ LteUeMac::GetTypeId (void)
 					BooleanValue(false),
                    	MakeBooleanAccessor (&LteUeMac::m_partialSensing),
                    	MakeBooleanChecker ())
+	.AddAttribute ("PartialSensingNumCandidateSf",
+					"Number Y of candidate subframes drawn in the selection window [n+T1, n+T2] at each resource (re)selection with partial sensing (default 20)",
+					UintegerValue(20),
+					MakeUintegerAccessor (&LteUeMac::m_numCandidateSf),
+					MakeUintegerChecker<uint8_t> (1, 100))
+	.AddAttribute ("PartialSensingGapCandidateSensing",
+					"Bitmap of the subframes monitored with partial sensing, if bit k-1 is set the subframe k*100 subframes before each candidate subframe is monitored (default 0x3FF)",
+					UintegerValue(0x3FF),
+					MakeUintegerAccessor (&LteUeMac::m_gapCandidateSensing),
+					MakeUintegerChecker<uint16_t> (1, 0x3FF))
+	.AddAttribute ("ParallelReselection",
+					"If true, the resource reselections expected in a subframe are evaluated in parallel on the WorkerPool, "
+					"the results are identical to the sequential evaluation (default false)",
+					BooleanValue(false),
+					MakeBooleanAccessor (&LteUeMac::m_parallelReselection),
+					MakeBooleanChecker ())
 	.AddTraceSource ("SlUeScheduling",
 				     "Information regarding SL UE scheduling",
 				     MakeTraceSourceAccessor (&LteUeMac::m_slUeScheduling),
@@ -513,6 +560,11 @@ LteUeMac::LteUeMac ()
 
   m_amc = CreateObject <LteAmc> ();
 	m_ueSelectedUniformVariable = CreateObject<UniformRandomVariable> ();
+	m_sensingVersion = 0; 
+	m_parallelReselection = false; 
+	m_reselectionPending = false; 
+	m_reselectionEvaluated = false; 
+	m_reselectionSensingVersion = 0; 
 	//m_slDiversity.status = SlDiversity::disabled; // enabled should be default!
   
   m_p1UniformVariable = CreateObject<UniformRandomVariable> ();
@@ -540,6 +592,12 @@ void
 LteUeMac::DoDispose ()
 {
   NS_LOG_FUNCTION (this);
+  if (m_reselectionPending)
+    {
+      m_pendingReselections.erase (std::find (m_pendingReselections.begin (), m_pendingReselections.end (), this));
+      m_reselectionPending = false;
+    }
+  m_reselectionPool = 0;
   m_miUlHarqProcessesPacket.clear ();
   delete m_macSapProvider;
   delete m_cmacSapProvider;
@@ -3041,7 +3099,14 @@ uint8_t
 LteUeMac::GetRndmReselectionCounter(uint16_t pRsvp)
 {   
 	uint8_t min, max;  
+	GetReselectionCounterRange (pRsvp, min, max); 
+	// the draws of each UE, unlike rand (), do not depend on the other UEs 
+	return m_ueSelectedUniformVariable->GetInteger (min, max); 
+}
 
+void
+LteUeMac::GetReselectionCounterRange (uint16_t pRsvp, uint8_t& min, uint8_t& max)
+{
 	switch(pRsvp) {
 		case 20: 	
 			min = 25;
@@ -3068,7 +3133,6 @@ LteUeMac::GetRndmReselectionCounter(uint16_t pRsvp)
 			NS_FATAL_ERROR ("VALUE NOT SUPPORTED!");
 			break;
 	}
-	return (rand()%((max+1)-min))+min; 
 }
 
 uint8_t
@@ -3092,114 +3156,110 @@ LteUeMac::GetSlThresPsschRsrpVal(uint8_t a, uint8_t b)
 	return rsrpVal; 
 }
 
-void 
-LteUeMac::UpdateSensingWindow(SidelinkCommResourcePoolV2x::SubframeInfo subframe)
+const LteUeMac::SensingSlot*
+LteUeMac::GetSensingSlot (uint32_t sfIdx, uint32_t nowIdx) const
 {
-	std::list<SensingData>::iterator it = m_sensingData.begin();
-	while (it != m_sensingData.end())
-	{	
-		uint32_t tmpFrameNo = it->m_rxInfo.subframe.frameNo + 100; 
-		if (tmpFrameNo > 1024)
-		{	
-			// if frameNo+100 is here less than 1024 a new superframe is already started
-			// but the beginning of the sensing window is still in the last superframe
-			if((subframe.frameNo + 100) < 1024) {
-				tmpFrameNo -= 1024; 	
-			}
-		}
+	// sensed data older than the sensing window is ignored 
+	// and the slots are reused when the ring wraps around
+	if (m_sensingWindow.empty ())
+	{
+		return 0; 
+	}
+	const SensingSlot& slot = m_sensingWindow[sfIdx % SL_V2X_SENSING_RING_SIZE];
+	if (slot.m_sfIdx != (int32_t) sfIdx)
+	{
+		return 0; 
+	}
+	// check if the subframe is still in the sensing window
+	uint32_t age = SidelinkCommResourcePoolV2x::SubframeInfo::GetIndexDistance (sfIdx, nowIdx); 
+	if (age > SL_V2X_SENSING_WINDOW)
+	{
+		return 0; 
+	}
+	return &slot; 
+}
 
-		// check if the actual data is still in the sensing window
-		// if true the data is outside the sensing window and have to be removed
-		// if false iterate next sensed element
-		if (tmpFrameNo < subframe.frameNo || ((tmpFrameNo == subframe.frameNo) && (it->m_rxInfo.subframe.subframeNo < subframe.subframeNo))){
-			it = m_sensingData.erase(it); 
-		}
-		else {
-			it++;
+uint32_t
+LteUeMac::GetSubchannelMask (uint16_t rbStart, uint16_t rbLen) const
+{
+	NS_ASSERT (m_numSubchannel <= 32 && m_sizeSubchannel > 0 && rbLen > 0);
+	uint16_t first = rbStart > m_startRbSubchannel ? (rbStart - m_startRbSubchannel) / m_sizeSubchannel : 0; 
+	uint16_t last = rbStart + rbLen - 1 > m_startRbSubchannel ? (rbStart + rbLen - 1 - m_startRbSubchannel) / m_sizeSubchannel : 0; 
+	uint32_t mask = 0; 
+	for (uint16_t i = first; i <= last && i < m_numSubchannel; i++)
+	{
+		mask |= (1u << i); 
+	}
+	return mask; 
+}
+
+void
+LteUeMac::SelectCandidateSubframes (SidelinkCommResourcePoolV2x::SubframeInfo subframe)
+{
+	// randomly select Y of the subframes of the selection window [n+T1, n+T2], 
+	// without the last subframe of a 100 ms window as GetCandidateResources 
+	uint16_t lastSf = (m_t2 == 100) ? m_t2 - 1 : m_t2; 
+	std::vector<uint16_t> positions; 
+	for (uint16_t sf = m_t1; sf <= lastSf; sf++)
+	{
+		positions.push_back (sf); 
+	}
+	m_candidateSf.clear (); 
+	for (uint16_t i = 0; i < m_numCandidateSf && i < positions.size (); i++)
+	{
+		std::swap (positions[i], positions[m_ueSelectedUniformVariable->GetInteger (i, positions.size ()-1)]); 
+		m_candidateSf.push_back (subframe.Offset (positions[i]).GetIndex ()); 
+	}
+	std::sort (m_candidateSf.begin (), m_candidateSf.end ()); 
+	NS_LOG_LOGIC (this << " " << m_candidateSf.size () << " candidate subframes after " << subframe.frameNo << "/" << subframe.subframeNo); 
+}
+
+bool
+LteUeMac::IsCandidateSubframe (uint32_t sfIdx) const
+{
+	return std::binary_search (m_candidateSf.begin (), m_candidateSf.end (), sfIdx); 
+}
+
+bool
+LteUeMac::HasCandidateSubframes (SidelinkCommResourcePoolV2x::SubframeInfo subframe) const
+{
+	uint32_t startIdx = subframe.GetIndex (); 
+	for (std::vector<uint32_t>::const_iterator it = m_candidateSf.begin (); it != m_candidateSf.end (); it++)
+	{
+		uint32_t distance = SidelinkCommResourcePoolV2x::SubframeInfo::GetIndexDistance (startIdx, *it); 
+		if (distance >= m_t1 && distance <= m_t2)
+		{
+			return true; 
 		}
 	}
+	return false; 
 }
 
 std::list<LteUeMac::SidelinkTransmissionInfoExtended>
 LteUeMac::GetReTxResources(SidelinkCommResourcePoolV2x::SubframeInfo initialTx, std::list<SidelinkCommResourcePoolV2x::SidelinkTransmissionInfo> txOpps)
 {
 	std::list<SidelinkCommResourcePoolV2x::SidelinkTransmissionInfo>::iterator it;
-	std::list<SidelinkTransmissionInfoExtended>::iterator it2;
-
-
 	std::list<SidelinkTransmissionInfoExtended> reTxOpps;
-	std::list<SidelinkTransmissionInfoExtended> allPossibleFrames; 
-	SidelinkTransmissionInfoExtended tmpPlus;
-	SidelinkTransmissionInfoExtended tmpMinus;
-	bool erase = true; 
 
+	// a tx opportunity can be used for the retransmission if it is at most 15 subframes 
+	// after (reTxIdx = 0) or before (reTxIdx = 1) the initial transmission
 	for(it = txOpps.begin(); it != txOpps.end(); it++)
 	{
 		SidelinkTransmissionInfoExtended tmp; 
 		tmp.m_txInfo = (*it);
-		reTxOpps.push_back(tmp);
-	}
-
-	tmpMinus.m_txInfo.subframe = initialTx;
-	tmpMinus.m_reTxIdx = 1;
-	tmpPlus.m_txInfo.subframe = initialTx; 
-	tmpPlus.m_reTxIdx = 0; 
-	for(uint8_t i = 1; i <= 15; i++)
-	{
-		tmpPlus.m_sfGap = i; 
-		// Calculate all SubframeInfos for k = -1 .. -15
-        if (tmpMinus.m_txInfo.subframe.subframeNo == 1)
-        {
-            tmpMinus.m_txInfo.subframe.subframeNo = 10; 
-            if (tmpMinus.m_txInfo.subframe.frameNo == 1){
-                tmpMinus.m_txInfo.subframe.frameNo = 1024;
-            }
-            else {
-                tmpMinus.m_txInfo.subframe.frameNo -= 1; 
-            }
-        }
-        else
-        {
-            tmpMinus.m_txInfo.subframe.subframeNo -= 1; 
-        }		
-		allPossibleFrames.push_back(tmpMinus);
-		
-		tmpMinus.m_sfGap = i; 
-		// Calculate all SubframeInfos for k = 1 .. 15
-		tmpPlus.m_txInfo.subframe.subframeNo += 1;
-        if (tmpPlus.m_txInfo.subframe.subframeNo > 10)
-        {
-            ++tmpPlus.m_txInfo.subframe.frameNo;
-            if(tmpPlus.m_txInfo.subframe.frameNo > 1024){
-                tmpPlus.m_txInfo.subframe.frameNo = 1;
-            }
-            tmpPlus.m_txInfo.subframe.subframeNo -= 10;
-        }
-		allPossibleFrames.push_back(tmpPlus);
-	}
-
-	// check if there is a tx opportunity which frameNo/subframeNo matches with the previous
-	// calculated SubframeInfos 
-	it2 = reTxOpps.begin();
-	while(it2 != reTxOpps.end())
-	{	
-		for(std::list<SidelinkTransmissionInfoExtended>::iterator infoIt = allPossibleFrames.begin(); infoIt != allPossibleFrames.end(); infoIt++)
+		uint32_t after = SidelinkCommResourcePoolV2x::SubframeInfo::GetDistance (initialTx, it->subframe); 
+		uint32_t before = SidelinkCommResourcePoolV2x::SubframeInfo::GetDistance (it->subframe, initialTx); 
+		if (after >= 1 && after <= 15)
 		{
-			// if true there is a tx opportunity for retransmission
-			// if false there is no tx opportunity for retransmission and the element have to be erased
-			if (infoIt->m_txInfo.subframe.frameNo == it2->m_txInfo.subframe.frameNo && infoIt->m_txInfo.subframe.subframeNo == it2->m_txInfo.subframe.subframeNo){
-				erase = false;
-				it2->m_sfGap = infoIt->m_sfGap; 
-				it2->m_reTxIdx = infoIt->m_reTxIdx;
-				break; 
-			}
+			tmp.m_sfGap = after; 
+			tmp.m_reTxIdx = 0; 
+			reTxOpps.push_back(tmp);
 		}
-
-		if(erase){
-			it2 = reTxOpps.erase(it2); 
-		}
-		else{
-			it2++; 
+		else if (before >= 1 && before <= 15)
+		{
+			tmp.m_sfGap = before; 
+			tmp.m_reTxIdx = 1; 
+			reTxOpps.push_back(tmp);
 		}
 	}
 	return reTxOpps; 
@@ -3208,236 +3268,376 @@ LteUeMac::GetReTxResources(SidelinkCommResourcePoolV2x::SubframeInfo initialTx,
 std::list<SidelinkCommResourcePoolV2x::SidelinkTransmissionInfo>
 LteUeMac::GetTxResources(SidelinkCommResourcePoolV2x::SubframeInfo subframe, PoolInfoV2x pool)
 { 		
+	NS_PROFILE_SCOPE ("LteUeMac::GetTxResources");
 	NS_LOG_INFO (this << "Start Resource Allocation - Semi Persistent Scheduling"); 
-	std::list<SidelinkCommResourcePoolV2x::SidelinkTransmissionInfo> csrA, csrB, copyCsrA; 
+
+	// with partial sensing the candidate subframes are drawn, and monitored, ahead of 
+	// the (re)selection; without candidates in the window, e.g. at the first selection, 
+	// they are drawn now and nothing of them was sensed 
+	if (m_partialSensing && !HasCandidateSubframes (subframe))
+	{
+		SelectCandidateSubframes (subframe); 
+	}
+
+	// use the evaluation of the parallel reselection stage if it was made 
+	// for this subframe and nothing was sensed since then 
+	if (m_reselectionPending)
+	{
+		EvaluatePendingReselections (); 
+	}
+	bool prefetched = m_reselectionEvaluated && m_reselectionTime == Simulator::Now () 
+		&& m_reselectionSensingVersion == m_sensingVersion && m_reselectionPool == pool.m_pool 
+		&& m_reselectionEval.m_subframe == subframe && m_reselectionEval.m_numCtr >= m_reselCtr; 
+	m_reselectionEvaluated = false; 
+	if (prefetched)
+	{
+		NS_LOG_LOGIC (this << " using the candidate resources evaluated by the parallel reselection stage"); 
+		return SelectTxResources (m_reselectionEval); 
+	}
+	CandidateEvaluation eval; 
+	EvaluateCandidateResources (subframe, pool.m_pool, m_reselCtr, eval); 
+	return SelectTxResources (eval); 
+}
+
+void
+LteUeMac::EvaluateCandidateResources (SidelinkCommResourcePoolV2x::SubframeInfo subframe, const Ptr<SidelinkCommResourcePoolV2x>& pool, uint8_t numCtr, CandidateEvaluation& eval) const
+{
+	std::list<SidelinkCommResourcePoolV2x::SidelinkTransmissionInfo> csrA; 
 	std::list<SidelinkCommResourcePoolV2x::SidelinkTransmissionInfo>::iterator csrIt;
-	std::list<CandidateResource>::iterator sortedCsrIt; 
-	std::list<SensingData>::iterator sensingIt;  
-
-	uint16_t numCsr; // number of all Candidate Resources
-	int threshRsrp; 
-	bool erase; 
-
-	if(m_partialSensing) 
-	{		
-		// Partial Sensing not implemented yet 
-	} // endif m_partialSensing
-	else  
-    {				
-		// init
-		csrA = pool.m_pool->GetCandidateResources(subframe, m_t1, m_t2, m_subchLen); // SA = {ALL CSRs}
-		numCsr = csrA.size();
-		copyCsrA = csrA; 
-		//std::cout << "---------------" << std::endl; 
-
-		//std::cout << subframe.frameNo << "/" << subframe.subframeNo <<"\t NumCsr=" << (int) csrA.size() << std::endl; 
-		threshRsrp = -110;
-
-		/*for (csrIt = csrA.begin(); csrIt != csrA.end(); ++csrIt)
+
+	// init
+	csrA = pool->GetCandidateResources(subframe, m_t1, m_t2, m_subchLen); // SA = {ALL CSRs}
+	if (m_partialSensing)
+	{
+		// with partial sensing only the CSRs of the Y candidate subframes are considered 
+		NS_ASSERT (!m_candidateSf.empty ()); 
+		csrIt = csrA.begin(); 
+		while (csrIt != csrA.end())
+		{
+			if (IsCandidateSubframe (csrIt->subframe.GetIndex ()))
+			{
+				csrIt++; 
+			}
+			else
+			{
+				csrIt = csrA.erase (csrIt); 
+			}
+		}
+	}
+	uint16_t numCsr = csrA.size(); 
+	uint32_t nowIdx = subframe.GetIndex (); 
+	eval.m_subframe = subframe; 
+	eval.m_numCtr = numCtr; 
+	eval.m_csr.assign (csrA.begin(), csrA.end()); 
+	const std::vector<SidelinkCommResourcePoolV2x::SidelinkTransmissionInfo>& allCsr = eval.m_csr; 
+
+	// Step 6: the subframes reserved by a candidate resource are projected with the 
+	// reservation interval; each projected subframe index gets a row holding, per 
+	// subchannel, the highest S-RSRP of the sensed transmissions reserving it 
+	std::vector<uint32_t> projectedRow (SidelinkCommResourcePoolV2x::SUBFRAME_CYCLE, SL_V2X_NO_PROJECTION); 
+	std::vector<double> projectedRsrp; 
+	std::vector<uint32_t> csrRows (numCsr*numCtr); 
+	std::vector<uint32_t> csrMask (numCsr); 
+	for (uint16_t i = 0; i < numCsr; i++)
+	{
+		csrMask[i] = GetSubchannelMask (allCsr[i].rbStart, allCsr[i].rbLen); 
+		uint32_t csrIdx = allCsr[i].subframe.GetIndex (); 
+		for (uint8_t ctr = 0; ctr < numCtr; ctr++)
 		{
-			std::cout << " " << csrIt->subframe.frameNo << "/" << csrIt->subframe.subframeNo << "\t rbStart=" << (int) csrIt->rbStart << "\t rbLen=" << (int) csrIt->rbLen << std::endl; 
-		}*/
+			uint32_t txIdx = SidelinkCommResourcePoolV2x::SubframeInfo::OffsetIndex (csrIdx, 10*(ctr*m_pRsvp/10)); 
+			if (projectedRow[txIdx] == SL_V2X_NO_PROJECTION)
+			{
+				projectedRow[txIdx] = projectedRsrp.size() / m_numSubchannel; 
+				projectedRsrp.resize (projectedRsrp.size() + m_numSubchannel, -std::numeric_limits<double>::infinity ()); 
+			}
+			csrRows[i*numCtr+ctr] = projectedRow[txIdx]; 
+		}
+	}
 
-		/*std::cout << "Sensed Data" << std::endl; 
-		for (sensingIt = m_sensingData.begin(); sensingIt != m_sensingData.end(); ++sensingIt)
+	// sensed subframes: with partial sensing only the subframes monitored for the candidate 
+	// subframes, i.e. k*100 subframes before them for the k set in the gap bitmap 
+	std::vector<const SensingSlot*> sensedSlots; 
+	if (m_partialSensing)
+	{
+		std::vector<bool> visited (SL_V2X_SENSING_RING_SIZE, false); 
+		for (uint16_t i = 0; i < numCsr; i++)
 		{
-			std::cout << " " << sensingIt->m_rxInfo.subframe.frameNo << "/" << sensingIt->m_rxInfo.subframe.subframeNo << "\t rbStart=" << (int) sensingIt->m_rxInfo.rbStart << "\t rbLen=" << (int) sensingIt->m_rxInfo.rbLen << std::endl; 
-		}*/
-
-		do
-		{	
-			csrA = copyCsrA; 	
-
-			// iterate over all Candidate Resources 	
-			csrIt = csrA.begin();	
-			while (csrIt != csrA.end())
-			{	
-				erase = false; 
-
-				// calculate all proposed transmissions of current candidate resource
-				SidelinkCommResourcePoolV2x::SidelinkTransmissionInfo csrTransmission; 
-				csrTransmission.subframe.subframeNo = csrIt->subframe.subframeNo;
-				csrTransmission.rbStart = csrIt->rbStart;
-				csrTransmission.rbLen = csrIt->rbLen;
-
-				std::list<SidelinkCommResourcePoolV2x::SidelinkTransmissionInfo> csrTx;
-				for (uint8_t ctr = 0; ctr < m_reselCtr; ctr++)
+			uint32_t csrIdx = allCsr[i].subframe.GetIndex (); 
+			for (uint8_t k = 1; k <= SL_V2X_SENSING_WINDOW/SL_V2X_SENSING_STEP; k++)
+			{
+				uint32_t sensingIdx = SidelinkCommResourcePoolV2x::SubframeInfo::OffsetIndex (csrIdx, -(int32_t) (k*SL_V2X_SENSING_STEP)); 
+				if ((m_gapCandidateSensing & (1u << (k-1))) && !visited[sensingIdx % SL_V2X_SENSING_RING_SIZE])
 				{
-					csrTransmission.subframe.frameNo = csrIt->subframe.frameNo + ctr*m_pRsvp/10;
-					if (csrTransmission.subframe.frameNo > 2048) {
-						csrTransmission.subframe.frameNo -= 2048; 
-					}
-					else if (csrTransmission.subframe.frameNo > 1024) {
-						csrTransmission.subframe.frameNo -= 1024; 
-					}
-					csrTx.push_back (csrTransmission);
-				}
-
-				// check all sensed data
-				for (sensingIt = m_sensingData.begin(); sensingIt != m_sensingData.end(); sensingIt++)
-				{	
-					// calculate all possible transmissions of sensed data
-					SidelinkCommResourcePoolV2x::SidelinkTransmissionInfo sensTransmission;
-					sensTransmission.subframe.subframeNo = sensingIt->m_rxInfo.subframe.subframeNo; 
-					sensTransmission.rbStart = sensingIt->m_rxInfo.rbStart;
-					sensTransmission.rbLen = sensingIt->m_rxInfo.rbLen; 
-
-					std::list<SidelinkCommResourcePoolV2x::SidelinkTransmissionInfo> sensTx; 
-					for(uint8_t ctr = 1; ctr <= 15; ctr++)
+					visited[sensingIdx % SL_V2X_SENSING_RING_SIZE] = true; 
+					const SensingSlot* slot = GetSensingSlot (sensingIdx, nowIdx); 
+					if (slot != 0)
 					{
-						sensTransmission.subframe.frameNo = sensingIt->m_rxInfo.subframe.frameNo + ctr*sensingIt->m_pRsvpRx/10; 
-						if (sensTransmission.subframe.frameNo > 2048) {
-							sensTransmission.subframe.frameNo -= 2048; 
-						}
-						else if (sensTransmission.subframe.frameNo > 1024) {
-							sensTransmission.subframe.frameNo -= 1024; 
-						}
-						sensTx.push_back (sensTransmission); 
+						sensedSlots.push_back (slot); 
 					}
-
-					// for all proposed transmissions of current candidate resource
-					std::list<SidelinkCommResourcePoolV2x::SidelinkTransmissionInfo>::iterator csrTxIt; 
-					for (csrTxIt = csrTx.begin(); csrTxIt != csrTx.end(); csrTxIt++)
-					{
-						NS_ASSERT (csrTxIt->subframe.frameNo > 0 && csrTxIt->subframe.frameNo <= 1024 && csrTxIt->subframe.subframeNo > 0 && csrTxIt->subframe.subframeNo <= 10);
-				
-						std::list<SidelinkCommResourcePoolV2x::SidelinkTransmissionInfo>::iterator sensTxIt; 
-						for (sensTxIt = sensTx.begin(); sensTxIt != sensTx.end(); sensTxIt++)
-						{
-							// check if candidate resource transmission and possible transmission
-							// of sensed data occur in the same subframe
-							if(csrTxIt->subframe.frameNo == sensTxIt->subframe.frameNo && csrTxIt->subframe.subframeNo == sensTxIt->subframe.subframeNo)
-							{	
-								// check if the utilizied RBs overlaps with candidate resource RBs
-								for (int i = csrTxIt->rbStart; i < csrTxIt->rbStart+csrTxIt->rbLen; i++)
-								{
-									for(int j = sensTxIt->rbStart; j < sensTxIt->rbStart+sensTxIt->rbLen; j++)
-									{
-										if (i == j && sensingIt->m_slRsrp > threshRsrp) {
-											erase = true; 
-											break;
-										}	
-									}
-									if (erase) break;
-								}			
-							}
-							if (erase) break;
-						}
-					} // end for all proposed transmission of current candidate resource
-					if (erase) break;
-				} // end for all sensed data
-				if (erase) {
-					//std::cout << "erase \t" << csrIt->subframe.frameNo << "/" << csrIt->subframe.subframeNo << "\t rbStart=" << (int) csrIt->rbStart << "\t rbLen=" << (int) csrIt->rbLen << std::endl; 
-					csrIt = csrA.erase(csrIt);
 				}
-				else {
-					csrIt++; 
-				}	
-			} // end while
-			threshRsrp += 3; 
-		} // end do 
-		while(csrA.size() < 0.2*numCsr); // Step 7: Repeat until the size of the resulting CSR-list is greater than the 20% of the size of all CSR
-		
-		/*std::cout << "remaining csrs " << (int) csrA.size() << std::endl; 
-		for (csrIt = csrA.begin(); csrIt != csrA.end(); csrIt++)
-		{
-			std::cout << " " << csrIt->subframe.frameNo << "/" << csrIt->subframe.subframeNo << "\t rbStart=" << (int) csrIt->rbStart << "\t rbLen=" << (int) csrIt->rbLen << std::endl; 
-		}*/
-
-		// Step 8: Calculate metric E defined as the linear average of S-RSSI
-		std::list <CandidateResource> m_csr; 
-		for(csrIt = csrA.begin(); csrIt != csrA.end(); csrIt++) // for all remaining CSRs
-		{
-			double avg_rssi = 0; 
-			uint8_t nbTx = 0; 
-			
-			// Calculate the first transmission of current CSR frameNo/subframeNo in the sensing Window 
-			SidelinkCommResourcePoolV2x::SidelinkTransmissionInfo sensingWindowTransmission; 
-			sensingWindowTransmission.subframe.subframeNo = csrIt->subframe.subframeNo;
-			sensingWindowTransmission.rbStart = csrIt->rbStart;
-			sensingWindowTransmission.rbLen = csrIt->rbLen;  
-
-			if (csrIt->subframe.frameNo <= 100) {
-				uint8_t diff = 100 - csrIt->subframe.frameNo; 
-				sensingWindowTransmission.subframe.frameNo = 1024 - diff; 
 			}
-			else {
-				sensingWindowTransmission.subframe.frameNo = csrIt->subframe.frameNo - 100;
+		}
+	}
+	else
+	{
+		for (std::vector<SensingSlot>::const_iterator slotIt = m_sensingWindow.begin(); slotIt != m_sensingWindow.end(); slotIt++)
+		{
+			if (slotIt->m_sfIdx >= 0 && GetSensingSlot (slotIt->m_sfIdx, nowIdx) != 0)
+			{
+				sensedSlots.push_back (&(*slotIt)); 
 			}
+		}
+	}
 
-			// For the last 10 transmissions on CSR frameNo/subframeNo calculate
-			// the average S-RSSI 
-			for (uint8_t i = 0; i < 10; i++)
+	// Step 5: project the next 15 reservations of all sensed transmissions 
+	for (std::vector<const SensingSlot*>::const_iterator slotIt = sensedSlots.begin(); slotIt != sensedSlots.end(); slotIt++)
+	{
+		std::vector<SensingData>::const_iterator rxIt; 
+		for (rxIt = (*slotIt)->m_rx.begin(); rxIt != (*slotIt)->m_rx.end(); rxIt++)
+		{
+			for (uint8_t ctr = 1; ctr <= 15; ctr++)
 			{
-				sensingWindowTransmission.subframe.frameNo +=  10; 
-				if(sensingWindowTransmission.subframe.frameNo > 1024) {
-					sensingWindowTransmission.subframe.frameNo -= 1024; 
-				} 
-				// check if we received data on the frameNo/subframeNo and same subchannel
-				for (sensingIt = m_sensingData.begin(); sensingIt != m_sensingData.end(); sensingIt++)
+				uint32_t rxIdx = SidelinkCommResourcePoolV2x::SubframeInfo::OffsetIndex ((*slotIt)->m_sfIdx, 10*(ctr*rxIt->m_pRsvpRx/10)); 
+				if (projectedRow[rxIdx] == SL_V2X_NO_PROJECTION)
+				{
+					continue; // no candidate resource reserves this subframe
+				}
+				double* rsrp = &projectedRsrp[projectedRow[rxIdx]*m_numSubchannel]; 
+				for (uint8_t j = 0; j < m_numSubchannel; j++)
 				{
-					//if (sensingWindowTransmission.subframe.frameNo == sensingIt->m_rxInfo.subframe.frameNo && sensingWindowTransmission.subframe.subframeNo == sensingIt->m_rxInfo.subframe.subframeNo)
-					if (sensingWindowTransmission.subframe.frameNo == sensingIt->m_rxInfo.subframe.frameNo && sensingWindowTransmission.subframe.subframeNo == sensingIt->m_rxInfo.subframe.subframeNo && sensingWindowTransmission.rbStart == sensingIt->m_rxInfo.rbStart)
+					if ((rxIt->m_subchMask & (1u << j)) && rxIt->m_slRsrp > rsrp[j])
 					{
-						nbTx++;
-						avg_rssi += sensingIt->m_slRssi; 
-						break; // if we find frameNo/subframeNo we can skip to next transmission 
+						rsrp[j] = rxIt->m_slRsrp; 
 					}
 				}
 			}
+		}
+	}
 
-			if(nbTx != 0) {
-				avg_rssi = avg_rssi / nbTx; 
+	// highest S-RSRP of the reservations overlapping each candidate resource, 
+	// for the first 1..numCtr reservations 
+	eval.m_rsrp.assign (numCsr*numCtr, -std::numeric_limits<double>::infinity ()); 
+	for (uint16_t i = 0; i < numCsr; i++)
+	{
+		double csrRsrp = -std::numeric_limits<double>::infinity (); 
+		for (uint8_t ctr = 0; ctr < numCtr; ctr++)
+		{
+			const double* rsrp = &projectedRsrp[csrRows[i*numCtr+ctr]*m_numSubchannel]; 
+			for (uint8_t j = 0; j < m_numSubchannel; j++)
+			{
+				if ((csrMask[i] & (1u << j)) && rsrp[j] > csrRsrp)
+				{
+					csrRsrp = rsrp[j]; 
+				}
 			}
-			else {
-				avg_rssi = -200.0; // assumend that nothing is received
+			eval.m_rsrp[i*numCtr+ctr] = csrRsrp; 
+		}
+	}
+
+	// Step 8: Calculate metric E defined as the linear average of S-RSSI
+	// over the last 10 transmissions on CSR frameNo/subframeNo in the sensing window, 
+	// with partial sensing over the monitored subframes 
+	std::vector<uint32_t> rssiOffsets; 
+	for (uint8_t i = 1; i <= 10; i++)
+	{
+		uint32_t offset = SL_V2X_SENSING_WINDOW - SL_V2X_SENSING_STEP*i; 
+		if (m_partialSensing)
+		{
+			offset += SL_V2X_SENSING_STEP; 
+			if (!(m_gapCandidateSensing & (1u << (offset/SL_V2X_SENSING_STEP - 1))))
+			{
+				continue; 
 			}
+		}
+		rssiOffsets.push_back (offset); 
+	}
 
-			CandidateResource csr; 
-			csr.m_txInfo = *csrIt;
-			csr.m_avg_rssi = avg_rssi; 			
-			m_csr.push_back(csr);
+	eval.m_rssi.resize (numCsr); 
+	for (uint16_t i = 0; i < numCsr; i++)
+	{
+		double avg_rssi = 0; 
+		uint8_t nbTx = 0; 
+		
+		uint32_t csrIdx = allCsr[i].subframe.GetIndex (); 
+		for (std::vector<uint32_t>::const_iterator offsetIt = rssiOffsets.begin(); offsetIt != rssiOffsets.end(); offsetIt++)
+		{
+			uint32_t sensingIdx = SidelinkCommResourcePoolV2x::SubframeInfo::OffsetIndex (csrIdx, -(int32_t) *offsetIt); 
+			const SensingSlot* slot = GetSensingSlot (sensingIdx, nowIdx); 
+			if (slot == 0)
+			{
+				continue; 
+			}
+			// check if we received data on the same subchannel
+			std::vector<SensingData>::const_iterator rxIt; 
+			for (rxIt = slot->m_rx.begin(); rxIt != slot->m_rx.end(); rxIt++)
+			{
+				if (rxIt->m_rbStart == allCsr[i].rbStart)
+				{
+					nbTx++;
+					avg_rssi += rxIt->m_slRssi; 
+					break; // if we find frameNo/subframeNo we can skip to next transmission 
+				}
+			}
 		}
 
-		// mix values in m_csr otherwise only the first resources in 
-		// selection window will be choosen 
-		std::list<CandidateResource> copy = m_csr; 
-		m_csr.clear(); 
-
-		while (copy.size() != 0)
-		{	
-			std::list<CandidateResource>::iterator it = copy.begin(); 
-			std::advance(it, m_ueSelectedUniformVariable->GetInteger (0, copy.size()-1));
-			m_csr.push_back((*it)); 
-			copy.erase(it); 
+		if(nbTx != 0) {
+			avg_rssi = avg_rssi / nbTx; 
 		}
+		else {
+			avg_rssi = -200.0; // assumend that nothing is received
+		}
+		eval.m_rssi[i] = avg_rssi; 
+	}
+}
+
+std::list<SidelinkCommResourcePoolV2x::SidelinkTransmissionInfo>
+LteUeMac::SelectTxResources (const CandidateEvaluation& eval)
+{
+	std::list<SidelinkCommResourcePoolV2x::SidelinkTransmissionInfo> csrB; 
+	std::list<CandidateResource>::iterator sortedCsrIt; 
+	NS_ASSERT (m_reselCtr > 0 && m_reselCtr <= eval.m_numCtr); 
+
+	uint16_t numCsr = eval.m_csr.size(); // number of all Candidate Resources
+	int threshRsrp = -110;
+
+	// highest S-RSRP of the m_reselCtr reservations overlapping each candidate resource
+	std::vector<double> csrRsrp (numCsr); 
+	for (uint16_t i = 0; i < numCsr; i++)
+	{
+		csrRsrp[i] = eval.m_rsrp[i*eval.m_numCtr+m_reselCtr-1]; 
+	}
 
-		// Step 9: Select CSRs with smallest metric until the size of SB is greater than or equal to 20% of the size of all CSRs 
-		// sort by average RSSI
-		if (m_csr.size() != 0)
+	// Step 7: the threshold is increased by 3 dB until at least 20% of all CSRs remain. 
+	// A CSR remains if its highest overlapping S-RSRP does not exceed the threshold, so the 
+	// final threshold is the first step reaching the S-RSRP of the CSR ranked at 20% 
+	uint16_t minCsr = std::ceil (0.2*numCsr); 
+	if (minCsr > 0)
+	{
+		std::vector<double> sortedRsrp (csrRsrp); 
+		std::nth_element (sortedRsrp.begin(), sortedRsrp.begin() + minCsr - 1, sortedRsrp.end()); 
+		while (sortedRsrp[minCsr-1] > threshRsrp)
 		{
-			m_csr.sort([](const CandidateResource & a, const CandidateResource & b){return a.m_avg_rssi < b.m_avg_rssi;}); 
+			threshRsrp += 3; 
 		}
-		
-		for(sortedCsrIt = m_csr.begin(); sortedCsrIt != m_csr.end(); sortedCsrIt++)
+	}
+
+	// Step 8: metric E of the remaining CSRs 
+	std::list <CandidateResource> m_csr; 
+	for (uint16_t i = 0; i < numCsr; i++)
+	{
+		if (csrRsrp[i] <= threshRsrp)
 		{
-			if(csrB.size() >= 0.2*numCsr) {
-				break;
-			}
-			else {
-				csrB.push_back((sortedCsrIt->m_txInfo)); 
-			}
+			CandidateResource csr; 
+			csr.m_txInfo = eval.m_csr[i];
+			csr.m_avg_rssi = eval.m_rssi[i]; 			
+			m_csr.push_back(csr);
+		}
+	}
+
+	// mix values in m_csr otherwise only the first resources in 
+	// selection window will be choosen 
+	std::list<CandidateResource> copy = m_csr; 
+	m_csr.clear(); 
+
+	while (copy.size() != 0)
+	{	
+		std::list<CandidateResource>::iterator it = copy.begin(); 
+		std::advance(it, m_ueSelectedUniformVariable->GetInteger (0, copy.size()-1));
+		m_csr.push_back((*it)); 
+		copy.erase(it); 
+	}
+
+	// Step 9: Select CSRs with smallest metric until the size of SB is greater than or equal to 20% of the size of all CSRs 
+	// sort by average RSSI
+	if (m_csr.size() != 0)
+	{
+		m_csr.sort([](const CandidateResource & a, const CandidateResource & b){return a.m_avg_rssi < b.m_avg_rssi;}); 
+	}
+	
+	for(sortedCsrIt = m_csr.begin(); sortedCsrIt != m_csr.end(); sortedCsrIt++)
+	{
+		if(csrB.size() >= 0.2*numCsr) {
+			break;
+		}
+		else {
+			csrB.push_back((sortedCsrIt->m_txInfo)); 
 		}
 	}
 
 	/*std::cout << "remaining csrs " << (int) csrB.size() << std::endl; 
-	for (csrIt = csrB.begin(); csrIt != csrB.end(); csrIt++)
+	for (std::list<SidelinkCommResourcePoolV2x::SidelinkTransmissionInfo>::iterator csrIt = csrB.begin(); csrIt != csrB.end(); csrIt++)
 	{
 		std::cout << " " << csrIt->subframe.frameNo << "/" << csrIt->subframe.subframeNo << "\t rbStart=" << (int) csrIt->rbStart << "\t rbLen=" << (int) csrIt->rbLen << std::endl; 
 	}*/
 	return csrB; 
 }
 
+void
+LteUeMac::ScheduleReselectionEvaluation (SidelinkCommResourcePoolV2x::SubframeInfo subframe)
+{
+	if (m_sidelinkTxPoolsMapV2x.size () != 1 || m_sidelinkTxPoolsMapV2x.begin ()->second.m_pool->GetSchedulingType () != SidelinkCommResourcePoolV2x::UE_SELECTED)
+	{
+		return; 
+	}
+	// the reselection happens at the subframe indication where rndmStart reaches zero 
+	uint32_t delay = std::max<uint32_t> (1, rndmStart); 
+	Time time = Simulator::Now () + MilliSeconds (delay); 
+	if (m_reselectionPending && m_reselectionTime == time)
+	{
+		return; 
+	}
+	if (!m_reselectionPending)
+	{
+		NS_ABORT_MSG_IF (ParallelSimulatorImpl::IsRunningConcurrently (), "The V2X UEs share the batches of reselections and cannot run on several partitions of a ParallelSimulatorImpl"); 
+		m_pendingReselections.push_back (this); 
+	}
+	m_reselectionPending = true; 
+	m_reselectionEvaluated = false; 
+	m_reselectionTime = time; 
+	m_reselectionEval.m_subframe = subframe.Offset (delay); 
+	m_reselectionPool = m_sidelinkTxPoolsMapV2x.begin ()->second.m_pool; 
+}
+
+void
+LteUeMac::EvaluatePendingReselections (void)
+{
+	NS_PROFILE_SCOPE ("LteUeMac::EvaluatePendingReselections");
+	// the reselections expected now are evaluated in parallel, the others wait for their time 
+	std::vector<LteUeMac*> batch; 
+	std::vector<LteUeMac*> later; 
+	for (std::vector<LteUeMac*>::iterator it = m_pendingReselections.begin (); it != m_pendingReselections.end (); it++)
+	{
+		LteUeMac* mac = *it; 
+		if (mac->m_reselectionTime > Simulator::Now ())
+		{
+			later.push_back (mac); 
+			continue; 
+		}
+		mac->m_reselectionPending = false; 
+		// the candidate subframes of partial sensing missing from the selection window 
+		// are drawn by the sequential run 
+		if (mac->m_reselectionTime == Simulator::Now () && (!mac->m_partialSensing || mac->HasCandidateSubframes (mac->m_reselectionEval.m_subframe)))
+		{
+			mac->m_reselectionSensingVersion = mac->m_sensingVersion; 
+			batch.push_back (mac); 
+		}
+	}
+	m_pendingReselections.swap (later); 
+	NS_LOG_LOGIC ("evaluating " << batch.size () << " resource reselections"); 
+	m_reselectionBatch.swap (batch); 
+	WorkerPool::Get ()->Run (m_reselectionBatch.size (), MakeCallback (&LteUeMac::DoEvaluateReselection)); 
+	m_reselectionBatch.clear (); 
+}
+
+void
+LteUeMac::DoEvaluateReselection (uint32_t i)
+{
+	LteUeMac* mac = m_reselectionBatch[i]; 
+	uint8_t minCtr, maxCtr; 
+	GetReselectionCounterRange (mac->m_pRsvp, minCtr, maxCtr); 
+	mac->EvaluateCandidateResources (mac->m_reselectionEval.m_subframe, mac->m_reselectionPool, maxCtr, mac->m_reselectionEval); 
+	mac->m_reselectionEvaluated = true; 
+}
 
 void
 LteUeMac::DoSubframeIndication (uint32_t frameNo, uint32_t subframeNo)
@@ -3446,6 +3646,14 @@ LteUeMac::DoSubframeIndication (uint32_t frameNo, uint32_t subframeNo)
 	m_frameNo = frameNo;
 	m_subframeNo = subframeNo;
 
+	// the PHY may skip the idle subframes of a V2X UE (lazy subframe indication)
+	uint32_t elapsedSubframes = 1; 
+	if (!m_subframeIndicationLast.IsStrictlyNegative ())
+	{
+		elapsedSubframes = std::max<int64_t> (1, (Simulator::Now () - m_subframeIndicationLast) / MilliSeconds (1)); 
+	}
+	m_subframeIndicationLast = Simulator::Now (); 
+
 	//RefreshHarqProcessesPacketBuffer ();
 	if ((Simulator::Now () >= m_bsrLast + m_bsrPeriodicity) && (m_freshUlBsr == true))
 		{
@@ -3458,16 +3666,12 @@ LteUeMac::DoSubframeIndication (uint32_t frameNo, uint32_t subframeNo)
   	//sidelink processes
 
 	//there is a delay between the MAC scheduling and the transmission so we assume that we are ahead
-	subframeNo += 4;
-	if (subframeNo > 10)
-	{
-		++frameNo;
-		if (frameNo > 1024)
-		{
-			frameNo = 1;
-		}
-		subframeNo -= 10;
-	}
+	SidelinkCommResourcePoolV2x::SubframeInfo adjusted; 
+	adjusted.frameNo = frameNo; 
+	adjusted.subframeNo = subframeNo; 
+	adjusted = adjusted.Offset (4); 
+	frameNo = adjusted.frameNo; 
+	subframeNo = adjusted.subframeNo; 
 	NS_LOG_INFO (this << " Adjusted Frame no. " << frameNo << " subframe no. " << subframeNo);
 
 
@@ -3959,13 +4163,9 @@ LteUeMac::DoSubframeIndication (uint32_t frameNo, uint32_t subframeNo)
 	}
 	// V2X communication
 	std::map<uint32_t, PoolInfoV2x>::iterator poolIt2; 
-	SidelinkCommResourcePoolV2x::SubframeInfo tmp; 
-	tmp.frameNo = frameNo; 
-	tmp.subframeNo = subframeNo; 
-	UpdateSensingWindow(tmp); 
-
 	if (rndmStart != 0) {
-		rndmStart--; // decrease counter until the value is equal to zero
+		// decrease counter until the value is equal to zero
+		rndmStart = (rndmStart > elapsedSubframes) ? rndmStart - elapsedSubframes : 0; 
 	}
 
 	for(poolIt2 = m_sidelinkTxPoolsMapV2x.begin(); poolIt2 != m_sidelinkTxPoolsMapV2x.end(); poolIt2++)
@@ -3992,21 +4192,11 @@ LteUeMac::DoSubframeIndication (uint32_t frameNo, uint32_t subframeNo)
 				
 				// if true reuse the previous resource
 				// if false calculcate new resource
-				double randVal = (double) rand() / (double) RAND_MAX;
+				double randVal = m_ueSelectedUniformVariable->GetValue (0, 1);
 				if(randVal < m_probResourceKeep && firstTx == false)
 				{
 					NS_ASSERT_MSG (m_probResourceKeep >= 0 && m_probResourceKeep <= 0.8, "Parameter probResourceKeep must be between 0 and 0.8"); 
-					txInfo.subframe.subframeNo = subframeNo + (m_pRsvp-1)%10; 
-					txInfo.subframe.frameNo = frameNo + (m_pRsvp-1)/10;
-					if (txInfo.subframe.subframeNo > 10)
-					{
-						txInfo.subframe.frameNo++;
-						txInfo.subframe.subframeNo -= 10; 
-					}
-					if (txInfo.subframe.frameNo > 1024)
-					{
-						txInfo.subframe.frameNo -= 1024; 
-					}
+					txInfo.subframe = adjusted.Offset (m_pRsvp-1); 
 				}
 				else
 				{
@@ -4109,6 +4299,16 @@ LteUeMac::DoSubframeIndication (uint32_t frameNo, uint32_t subframeNo)
 					NS_ASSERT (txIt->subframe.subframeNo > 0 && txIt->subframe.subframeNo <= 10 && txIt->subframe.frameNo > 0 && txIt->subframe.frameNo <= 1024);
 				}
 
+				// with partial sensing, draw the candidate subframes of the next (re)selection, 
+				// which happens after the PSCCH transmission decrementing the counter to zero, 
+				// so that the subframes k*100 subframes before them are monitored until then 
+				if (m_partialSensing && m_reselCtr > 0 && (size_t) m_reselCtr <= poolIt2->second.m_pscchTx.size ())
+				{
+					std::list<SidelinkCommResourcePoolV2x::SidelinkTransmissionInfo>::const_iterator lastTx = poolIt2->second.m_pscchTx.begin (); 
+					std::advance (lastTx, m_reselCtr-1); 
+					SelectCandidateSubframes (lastTx->subframe.Offset (1)); 
+				}
+
 				//compute the tb size
 				if (m_adjacency) {
 					stats_params.m_psschTxLengthRB = m_subchLen*m_sizeSubchannel-2;
@@ -4277,6 +4477,15 @@ LteUeMac::DoSubframeIndication (uint32_t frameNo, uint32_t subframeNo)
 			poolIt2->second.m_psschTx.erase (allocItPssch);
 		}
 	}
+
+	// announce the next resource reselection to the parallel reselection stage
+	if (m_parallelReselection && m_reselCtr == 0)
+	{
+		SidelinkCommResourcePoolV2x::SubframeInfo current; 
+		current.frameNo = frameNo; 
+		current.subframeNo = subframeNo; 
+		ScheduleReselectionEvaluation (current); 
+	}
 }
 
 int64_t
@@ -4320,29 +4529,107 @@ void
 LteUeMac::DoPassSensingData(uint32_t frameNo, uint32_t subframeNo, uint16_t pRsvp, uint8_t rbStart, uint8_t rbLen, uint8_t prio, double slRsrp, double slRssi)
 {
 	SensingData sensingData;
-	sensingData.m_rxInfo.rbStart = rbStart;
-	sensingData.m_rxInfo.rbLen = rbLen;
+	sensingData.m_rbStart = rbStart;
+	sensingData.m_rbLen = rbLen;
+	sensingData.m_subchMask = GetSubchannelMask (rbStart, rbLen); 
 	sensingData.m_pRsvpRx = pRsvp;
 	sensingData.m_prioRx = prio; 
 	sensingData.m_slRsrp = slRsrp;
 	sensingData.m_slRssi = slRssi; 
 
-	if (frameNo == 1 && subframeNo == 1)
+	// the SCI was received in the previous subframe
+	SidelinkCommResourcePoolV2x::SubframeInfo subframe; 
+	subframe.frameNo = frameNo; 
+	subframe.subframeNo = subframeNo; 
+	uint32_t sfIdx = subframe.Offset (-1).GetIndex (); 
+
+	if (m_sensingWindow.empty ())
 	{
-		sensingData.m_rxInfo.subframe.frameNo = 1024;
-		sensingData.m_rxInfo.subframe.subframeNo = 10; 
+		SensingSlot emptySlot; 
+		emptySlot.m_sfIdx = -1; 
+		m_sensingWindow.resize (SL_V2X_SENSING_RING_SIZE, emptySlot); 
 	}
-	else if (subframeNo == 1)
+	SensingSlot& slot = m_sensingWindow[sfIdx % SL_V2X_SENSING_RING_SIZE]; 
+	if (slot.m_sfIdx != (int32_t) sfIdx)
 	{
-		sensingData.m_rxInfo.subframe.frameNo = frameNo-1; 
-		sensingData.m_rxInfo.subframe.subframeNo = 10; 
+		// the slot still holds a subframe which left the sensing window
+		slot.m_sfIdx = sfIdx; 
+		slot.m_rx.clear (); 
 	}
-	else 
+	slot.m_rx.push_back (sensingData);
+	m_sensingVersion++; 
+}
+
+bool 
+LteUeMac::DoIsSensingSubframe (uint32_t frameNo, uint32_t subframeNo)
+{
+	if (!m_partialSensing)
+	{
+		return true; 
+	}
+	// with partial sensing the subframe is monitored if it is k*100 subframes 
+	// before a candidate subframe for a k set in the gap bitmap
+	SidelinkCommResourcePoolV2x::SubframeInfo subframe; 
+	subframe.frameNo = frameNo; 
+	subframe.subframeNo = subframeNo; 
+	uint32_t sfIdx = subframe.Offset (-1).GetIndex (); 
+	for (uint8_t k = 1; k <= SL_V2X_SENSING_WINDOW/SL_V2X_SENSING_STEP; k++)
+	{
+		if ((m_gapCandidateSensing & (1u << (k-1))) && IsCandidateSubframe (SidelinkCommResourcePoolV2x::SubframeInfo::OffsetIndex (sfIdx, k*SL_V2X_SENSING_STEP)))
+		{
+			return true; 
+		}
+	}
+	return false; 
+}
+
+uint32_t 
+LteUeMac::DoGetV2xIdleSubframes ()
+{
+	// uplink, discovery and legacy sidelink procedures run every subframe
+	if (m_rachConfigured || m_freshUlBsr || m_discTxPools.m_pool || !m_sidelinkTxPoolsMap.empty ())
 	{
-		sensingData.m_rxInfo.subframe.frameNo = frameNo;
-		sensingData.m_rxInfo.subframe.subframeNo = subframeNo-1;
+		return 0; 
+	}
+
+	uint32_t idleSubframes = std::numeric_limits<uint32_t>::max (); 
+	if (m_sidelinkTxPoolsMapV2x.empty ())
+	{
+		return idleSubframes; 
+	}
+	// the resource selection starts when rndmStart reaches zero
+	if (m_reselCtr == 0)
+	{
+		if (rndmStart <= 1)
+		{
+			return 0; 
+		}
+		idleSubframes = rndmStart - 1; 
+	}
+
+	// there is a delay between the MAC scheduling and the transmission so we assume that we are ahead
+	SidelinkCommResourcePoolV2x::SubframeInfo now; 
+	now.frameNo = m_frameNo; 
+	now.subframeNo = m_subframeNo; 
+	now = now.Offset (4); 
+	std::map<uint32_t, PoolInfoV2x>::iterator poolIt; 
+	for (poolIt = m_sidelinkTxPoolsMapV2x.begin (); poolIt != m_sidelinkTxPoolsMapV2x.end (); poolIt++)
+	{
+		if (poolIt->second.m_pool->GetSchedulingType () != SidelinkCommResourcePoolV2x::UE_SELECTED || poolIt->second.m_grant_received)
+		{
+			return 0; 
+		}
+		if (!poolIt->second.m_pscchTx.empty ())
+		{
+			uint32_t distance = SidelinkCommResourcePoolV2x::SubframeInfo::GetDistance (now, poolIt->second.m_pscchTx.begin ()->subframe); 
+			if (distance <= 1)
+			{
+				return 0; 
+			}
+			idleSubframes = std::min (idleSubframes, distance - 1); 
+		}
 	}
-	m_sensingData.push_back(sensingData);
+	return idleSubframes; 
 }
 
 void
@@ -421,6 +421,8 @@ private:
   bool m_v2xHarqEnabled; ///< harq enabled?
   bool m_adjacency; ///< adjacent PSCCH+PSSCH scheme enabled
   bool m_partialSensing; ///< partial sensing enabled
+  uint8_t m_numCandidateSf; ///< number Y of candidate subframes per sensing step (partial sensing)
+  uint16_t m_gapCandidateSensing; ///< bitmap of the sensing steps k monitored before a candidate subframe (partial sensing)
   double m_probResourceKeep; ///< probability for selecting the previous resource again 
   uint8_t m_t1; ///< defining the size of the selection window
   uint8_t m_t2; ///< defining the size of the selection window
@@ -429,6 +431,7 @@ private:
   uint8_t m_startRbSubchannel; ///< resource block index where the subchannels begin
   uint16_t m_pRsvp; ///< Resource Reservation Interval in ms 
   uint16_t rndmStart = (rand()%((3000+1)-2000))+2000; ///< counter for random start of resource allocation process
+  Time m_subframeIndicationLast = Seconds (-1); ///< time of the last subframe indication, negative before the first one
   bool firstTx = true; 
   
   std::list<SidelinkCommResourcePoolV2x::SidelinkTransmissionInfo> txOpps; // list with all tx opportunities calculated by SPS 
@@ -539,20 +542,52 @@ private:
   };
 
   struct SensingData{
-    SidelinkCommResourcePoolV2x::SidelinkTransmissionInfo m_rxInfo;
+    uint16_t m_rbStart; // first RB of the sensed PSSCH
+    uint16_t m_rbLen; // number of RBs of the sensed PSSCH
+    uint32_t m_subchMask; // bitmask of the subchannels occupied by the sensed PSSCH
     uint8_t m_prioRx; 
     uint16_t m_pRsvpRx; 
     double m_slRsrp;
     double m_slRssi; 
   };
 
-  std::list<SensingData> m_sensingData; 
+  // all transmissions sensed in one subframe of the sensing window
+  struct SensingSlot{
+    int32_t m_sfIdx; // subframe index (see SidelinkCommResourcePoolV2x::SubframeInfo::GetIndex) stored in this slot, -1 if unused
+    std::vector<SensingData> m_rx; 
+  };
+
+  // ring of sensed subframes, the slot of a subframe is its subframe index modulo the ring size
+  std::vector<SensingSlot> m_sensingWindow; 
+  uint64_t m_sensingVersion; // number of transmissions added to the sensing window
+  std::vector<uint32_t> m_candidateSf; // sorted subframe indices of the Y candidate subframes of the next (re)selection window (partial sensing)
 
   struct CandidateResource{
     SidelinkCommResourcePoolV2x::SidelinkTransmissionInfo m_txInfo; 
     double m_avg_rssi;  
   };
 
+  // S-RSRP and S-RSSI metrics of all the candidate resources of a resource selection
+  struct CandidateEvaluation{
+    SidelinkCommResourcePoolV2x::SubframeInfo m_subframe; // subframe of the resource selection
+    uint8_t m_numCtr; // number of reservations the S-RSRP is evaluated for
+    std::vector<SidelinkCommResourcePoolV2x::SidelinkTransmissionInfo> m_csr; // all candidate resources
+    std::vector<double> m_rsrp; // at i*m_numCtr+k, highest S-RSRP overlapping the first k+1 reservations of candidate i
+    std::vector<double> m_rssi; // average S-RSSI of each candidate resource
+  };
+
+  // parallel reselection stage: the evaluation of the next resource reselection is made 
+  // together with the other UEs reselecting in the same subframe
+  bool m_parallelReselection; ///< parallel reselection stage enabled
+  bool m_reselectionPending; ///< the next reselection waits for its evaluation
+  bool m_reselectionEvaluated; ///< m_reselectionEval holds the evaluation of the next reselection
+  Time m_reselectionTime; ///< time of the subframe indication of the next reselection
+  Ptr<SidelinkCommResourcePoolV2x> m_reselectionPool; ///< pool of the next reselection
+  uint64_t m_reselectionSensingVersion; ///< sensing window version m_reselectionEval was evaluated with
+  CandidateEvaluation m_reselectionEval; ///< evaluation of the next reselection
+  static std::vector<LteUeMac*> m_pendingReselections; ///< MACs waiting for the evaluation of their next reselection
+  static std::vector<LteUeMac*> m_reselectionBatch; ///< MACs evaluated by the running batch
+
   struct SidelinkTransmissionInfoExtended {
     SidelinkCommResourcePoolV2x::SidelinkTransmissionInfo m_txInfo;
     uint8_t m_sfGap; 
@@ -622,11 +657,44 @@ private:
 
   // The PHY pass the sensing data for SPS to MAC
  void DoPassSensingData (uint32_t frameNo, uint32_t subframeNo, uint16_t pRsvp, uint8_t rbStart, uint8_t rbLen, uint8_t prio, double slRsrp, double slRssi); 
+  // The PHY asks if the sensing data of the previous subframe is used by the MAC
+ bool DoIsSensingSubframe (uint32_t frameNo, uint32_t subframeNo); 
+  // The PHY asks for how many subframes the MAC has nothing to do (lazy subframe indication)
+ uint32_t DoGetV2xIdleSubframes (); 
   
   /**
-   * Update the sensing window (1000 ms) 
+   * Returns the sensed transmissions of a subframe if the subframe is inside the sensing window (1000 ms)
+   * \param sfIdx the subframe index (see SidelinkCommResourcePoolV2x::SubframeInfo::GetIndex)
+   * \param nowIdx the subframe index of the end of the sensing window
+   * \return the slot of the subframe or 0 if nothing was sensed in it
+   */
+  const SensingSlot* GetSensingSlot (uint32_t sfIdx, uint32_t nowIdx) const;
+  /**
+   * Returns the subchannels of the V2X pool overlapped by a range of RBs
+   * \param rbStart first RB
+   * \param rbLen number of RBs
+   * \return bitmask with bit i set if subchannel i is overlapped
+   */
+  uint32_t GetSubchannelMask (uint16_t rbStart, uint16_t rbLen) const;
+  /**
+   * Returns true if a subframe is one of the Y candidate subframes of partial sensing
+   * \param sfIdx the subframe index (see SidelinkCommResourcePoolV2x::SubframeInfo::GetIndex)
+   * \return true if the subframe can be selected for transmission
+   */
+  bool IsCandidateSubframe (uint32_t sfIdx) const;
+  /**
+   * Returns true if some candidate subframes of partial sensing are in the selection window
+   * of a resource (re)selection
+   * \param subframe the subframe of the (re)selection
+   * \return true if the window [subframe+T1, subframe+T2] has candidate subframes
+   */
+  bool HasCandidateSubframes (SidelinkCommResourcePoolV2x::SubframeInfo subframe) const;
+  /**
+   * Randomly selects the Y candidate subframes of partial sensing in the selection window
+   * of a resource (re)selection
+   * \param subframe the subframe of the (re)selection
    */
-  void UpdateSensingWindow (SidelinkCommResourcePoolV2x::SubframeInfo subframe);
+  void SelectCandidateSubframes (SidelinkCommResourcePoolV2x::SubframeInfo subframe);
    /**
    * \brief See 36.213 section 14.1.1.7 V15.0.0
    */
@@ -635,10 +703,47 @@ private:
    * \brief See 36.213 section 14.1.1.6 V15.0.0
    */
   std::list<SidelinkCommResourcePoolV2x::SidelinkTransmissionInfo> GetTxResources (SidelinkCommResourcePoolV2x::SubframeInfo subframe, PoolInfoV2x pool);
+  /**
+   * Evaluates the S-RSRP and S-RSSI of the candidate resources (steps 5 to 8 of 36.213 section 14.1.1.6),
+   * reads only the state of the MAC so that the MACs can be evaluated in parallel
+   * \param subframe the subframe of the resource selection
+   * \param pool the pool
+   * \param numCtr the number of reservations the S-RSRP is evaluated for
+   * \param eval the evaluation
+   */
+  void EvaluateCandidateResources (SidelinkCommResourcePoolV2x::SubframeInfo subframe, const Ptr<SidelinkCommResourcePoolV2x>& pool, uint8_t numCtr, CandidateEvaluation& eval) const;
+  /**
+   * Selects the candidate resources for m_reselCtr reservations from their evaluation 
+   * (steps 7 to 9 of 36.213 section 14.1.1.6)
+   * \param eval the evaluation of the candidate resources
+   * \return the selected candidate resources
+   */
+  std::list<SidelinkCommResourcePoolV2x::SidelinkTransmissionInfo> SelectTxResources (const CandidateEvaluation& eval);
+  /**
+   * Announces the next resource reselection to the parallel reselection stage
+   * \param subframe the current subframe
+   */
+  void ScheduleReselectionEvaluation (SidelinkCommResourcePoolV2x::SubframeInfo subframe);
+  /**
+   * Evaluates in parallel the candidate resources of the reselections expected now
+   */
+  static void EvaluatePendingReselections (void);
+  /**
+   * Evaluates the candidate resources of a reselection of the running batch
+   * \param i index of the MAC in the batch
+   */
+  static void DoEvaluateReselection (uint32_t i);
   /**
    * \brief See 36.321 section 5.14.1.1 V15.0.0
    */
   uint8_t GetRndmReselectionCounter(uint16_t pRsvp); 
+  /**
+   * Returns the range of the reselection counter
+   * \param pRsvp resource reservation interval in ms
+   * \param min the smallest counter
+   * \param max the largest counter
+   */
+  static void GetReselectionCounterRange (uint16_t pRsvp, uint8_t& min, uint8_t& max);
   /** 
    * \brief See 36.331 section 6.3.8 V15.0.1
    */
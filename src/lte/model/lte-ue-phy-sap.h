@@ -116,6 +116,23 @@ public:
    * \param rsrpVal the measured RSRP value over the used resource blocks
    */
   virtual void PassSensingData (uint32_t frameNo, uint32_t subframeNo, uint16_t pRsvp, uint8_t rbStart, uint8_t rbLen, uint8_t prio, double slRsrp, double slRssi) = 0;
+
+  /**
+   * Ask the MAC if the sensing information of the previous subframe is used,
+   * i.e. if the subframe is monitored (always true without partial sensing)
+   * \param frameNo the current PHY frame number
+   * \param subframeNo the current PHY subframe number
+   * \return true if the sensing information has to be passed to the MAC
+   */
+  virtual bool IsSensingSubframe (uint32_t frameNo, uint32_t subframeNo) = 0;
+
+  /**
+   * Ask the MAC for the number of subframes following the current one in
+   * which it neither selects nor transmits V2X resources, so that the PHY
+   * can skip their subframe indications
+   * \return the number of idle subframes, 0 if the next subframe is needed
+   */
+  virtual uint32_t GetV2xIdleSubframes () = 0;
 };
 
 
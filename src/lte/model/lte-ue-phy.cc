@@ -66,7 +66,13 @@ static const Time UL_DATA_DURATION = NanoSeconds (1e6 - 71429 - 1);
  * Delay from subframe start to transmission of SRS.
  * Equals to "TTI length - 1 symbol for SRS".
  */
-static const Time UL_SRS_DELAY_FROM_SUBFRAME_START = NanoSeconds (1e6 - 71429); 
+static const Time UL_SRS_DELAY_FROM_SUBFRAME_START = NanoSeconds (1e6 - 71429);
+
+/**
+ * Maximum number of subframes skipped at once by a V2X UE with lazy
+ * subframe indication.
+ */
+static const uint32_t V2X_MAX_IDLE_SUBFRAMES = 1000; 
 
 
 
@@ -160,6 +166,9 @@ LteUePhy::LteUePhy (Ptr<LteSpectrumPhy> dlPhy, Ptr<LteSpectrumPhy> ulPhy)
     m_rsReceivedPowerUpdated (false),
     m_rsInterferencePowerUpdated (false),
     m_dataInterferencePowerUpdated (false),
+    m_v2xLazySubframeIndication (false),
+    m_lastFrameNo (0),
+    m_lastSubframeNo (0),
     m_pssReceived (false),
     m_ueMeasurementsFilterPeriod (MilliSeconds (200)),
     m_ueMeasurementsFilterLast (MilliSeconds (0)),
@@ -407,6 +416,12 @@ LteUePhy::GetTypeId (void)
                    BooleanValue (false),
                    MakeBooleanAccessor (&LteUePhy::m_v2xEnabled),
                    MakeBooleanChecker ())
+    .AddAttribute ("EnableV2xLazySubframeIndication",
+                   "If true, a V2X UE out of coverage skips the subframes in which "
+                   "it has nothing to transmit or receive on the sidelink.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&LteUePhy::m_v2xLazySubframeIndication),
+                   MakeBooleanChecker ())
   ;
   return tid;
 }
@@ -538,6 +553,7 @@ LteUePhy::DoSendMacPdu (Ptr<Packet> p)
   NS_LOG_FUNCTION (this);
 
   SetMacPdu (p);
+  WakeUpSubframeIndication ();
 }
 
 void
@@ -967,6 +983,7 @@ LteUePhy::DoSendLteControlMessage (Ptr<LteControlMessage> msg)
   NS_LOG_FUNCTION (this << msg);
 
   SetControlMessages (msg);
+  WakeUpSubframeIndication ();
 }
 
 void 
@@ -1212,10 +1229,19 @@ LteUePhy::ReceiveLteControlMessageList (std::list<Ptr<LteControlMessage> > msgLi
               txInfo.m_grant.m_reTxIdx = sci1.m_reTxIdx; 
               txInfo.m_grant.m_tbSize = sci1.m_tbSize; 
               txInfo.m_grant.m_resPscch = sci1.m_resPscch;  
+              // measured by the spectrum PHY at the end of this reception
+              const SlV2xMeasurement_t* measurement = m_sidelinkSpectrumPhy->GetSlV2xMeasurement (sci1.m_rnti);
+              txInfo.m_hasMeasurement = (measurement != 0);
+              if (measurement)
+                {
+                  txInfo.m_measurement = *measurement;
+                }
 
               // insert grant
               NS_LOG_LOGIC (this << " insert grant for rnti " << sci1.m_rnti << " with size " << sci1.m_tbSize);
               poolIt->m_currentGrants.insert (std::pair<uint16_t, SidelinkGrantInfoV2x> (sci1.m_rnti,txInfo));              
+              // the reception slots are computed in the next subframe
+              WakeUpSubframeIndication ();
             }
         }
       else if (msg->GetMessageType() == LteControlMessage::MIB_SL)
@@ -1512,9 +1538,16 @@ LteUePhy::SubframeIndication (uint32_t frameNo, uint32_t subframeNo)
                       NS_LOG_INFO (this << " PSSCH Rx " << rxIt->subframe.frameNo << "/"<< rxIt->subframe.subframeNo << ": rbStart=" << (uint32_t) rxIt->rbStart << ", rbLen=" << (uint32_t) rxIt->rbLen);
                     }
 
-                  double slRsrp_dBm = GetSidelinkRsrp(m_sidelinkSpectrumPhy->GetSlSignalPerceived()); 
-                  double slRssi_dBm = GetSidelinkRssi(m_sidelinkSpectrumPhy->GetSlSignalPerceived(), m_sidelinkSpectrumPhy->GetSlInterferencePerceived());
-                  m_uePhySapUser->PassSensingData(frameNo, subframeNo, grantIt->second.m_grant.m_pRsvp, grantIt->second.m_psschTx.begin()->rbStart, grantIt->second.m_psschTx.begin()->rbLen, grantIt->second.m_grant.m_prio, slRsrp_dBm, slRssi_dBm); 
+                  // measure and pass the sensing data only if the MAC monitors the subframe (partial sensing)
+                  if (!grantIt->second.m_hasMeasurement)
+                    {
+                      NS_LOG_WARN (this << " no measurement of the SCI received from rnti " << grantIt->first << ", not sensed");
+                    }
+                  else if (m_uePhySapUser->IsSensingSubframe (frameNo, subframeNo))
+                    {
+                      const SlV2xMeasurement_t& measurement = grantIt->second.m_measurement;
+                      m_uePhySapUser->PassSensingData(frameNo, subframeNo, grantIt->second.m_grant.m_pRsvp, grantIt->second.m_psschTx.begin()->rbStart, grantIt->second.m_psschTx.begin()->rbLen, grantIt->second.m_grant.m_prio, measurement.m_rsrp, measurement.m_rssi); 
+                    }
 
                   grantIt->second.m_grant_received = false;
                 }
@@ -1928,186 +1961,8 @@ LteUePhy::SubframeIndication (uint32_t frameNo, uint32_t subframeNo)
           else if(m_v2xEnabled)
             {
               NS_LOG_LOGIC (this << " V2X");
-              // send packets in queue
-              NS_LOG_LOGIC (this << " UE - start slot for PSSCH + PSCCH - RNTI " << m_rnti << " CELLID " << m_cellId);
-              // send the current burst of packets
-              // send only PSCCH (ideal: fake null bandwidth signal)
-             
-              //if (ctrlMsg.size ()>0 && sciDiscfound)
-              if (ctrlMsg.size ()>0)
-                { 
-                  std::list<Ptr<LteControlMessage> >::iterator msgIt = ctrlMsg.begin();
-                  //skiping the MIB-SL if it is the first in the list
-                  if((*msgIt)->GetMessageType () != LteControlMessage::SCI_V2X && (*msgIt)->GetMessageType () != LteControlMessage::SL_DISC_MSG)
-                    {
-                      NS_LOG_LOGIC (this << " skiping the MIB-SL if it is the first in the list");
-                      msgIt++;
-                    }
-                  else if ((*msgIt)->GetMessageType () == LteControlMessage::SCI_V2X)
-                    {
-                      NS_LOG_LOGIC (this << " UE - start TX PSCCH");
-                      //access the control message to store the PSSCH grant and be able to
-                      //determine the subframes/RBs for PSSCH transmissions
-                      
-                      NS_ASSERT_MSG ((*msgIt)->GetMessageType () == LteControlMessage::SCI_V2X, "Received " << (*msgIt)->GetMessageType ());
-
-                      Ptr<SciLteControlMessageV2x> msg2 = DynamicCast<SciLteControlMessageV2x> (*msgIt);
-                      SciListElementV2x sci1 = msg2->GetSci ();
-
-                      std::map<uint16_t, SidelinkGrantInfoV2x>::iterator grantIt = m_slTxPoolInfoV2x.m_currentGrants.find (sci1.m_rnti);
-                      if (grantIt == m_slTxPoolInfoV2x.m_currentGrants.end ())
-                        {
-                          SidelinkGrantInfoV2x grantInfo; 
-                          // this is the first transmission of PSCCH
-                          grantInfo.m_grant_received = true;
-                          grantInfo.m_grant.m_rnti = sci1.m_rnti; 
-                          grantInfo.m_grant.m_prio = sci1.m_prio; 
-                          grantInfo.m_grant.m_pRsvp = sci1.m_pRsvp;
-                          grantInfo.m_grant.m_reTxIdx = sci1.m_reTxIdx; 
-                          grantInfo.m_grant.m_riv = sci1.m_riv;
-                          grantInfo.m_grant.m_sfGap = sci1.m_sfGap; 
-                          grantInfo.m_grant.m_mcs = sci1.m_mcs;  
-
-                          grantInfo.m_grant.m_resPscch = sci1.m_resPscch;
-                          grantInfo.m_grant.m_tbSize = sci1.m_tbSize;
-
-                          grantInfo.m_grant.frameNo = frameNo; 
-                          grantInfo.m_grant.subframeNo = subframeNo; 
-
-                          SidelinkCommResourcePoolV2x::SubframeInfo tmp;
-                          tmp.frameNo = frameNo;
-                          tmp.subframeNo = subframeNo; 
-                                      
-                          grantInfo.m_pscchTx = m_slTxPoolInfoV2x.m_pool->GetPscchTransmissions(tmp, sci1.m_riv, sci1.m_pRsvp, sci1.m_sfGap, sci1.m_reTxIdx, sci1.m_resPscch, 1);
-                          grantInfo.m_psschTx = m_slTxPoolInfoV2x.m_pool->GetPsschTransmissions(tmp, sci1.m_riv, sci1.m_pRsvp, sci1.m_sfGap, sci1.m_reTxIdx, sci1.m_resPscch, 1); 
-
-                          std::list<SidelinkCommResourcePoolV2x::SidelinkTransmissionInfo>::iterator txIt;
-                          for (txIt = grantInfo.m_pscchTx.begin (); txIt != grantInfo.m_pscchTx.end (); txIt++)
-                            {
-                              NS_ASSERT (txIt->subframe.frameNo == frameNo && txIt->subframe.subframeNo == subframeNo);
-                              //std::cout << " Rnti="<< grantInfo.m_grant.m_rnti << "\t PHY PSCCH TX at " << txIt->subframe.frameNo << "/" << txIt->subframe.subframeNo << "\t rbStart=" << (uint32_t) txIt->rbStart << "\t rbLen=" << (uint32_t) txIt->rbLen << std::endl;
-                              NS_LOG_INFO (this << "PSCCH Tx " << txIt->subframe.frameNo << "/" << txIt->subframe.subframeNo << "\t rbStart=" << (uint32_t) txIt->rbStart << "\t rbLen=" << (uint32_t) txIt->rbLen);
-                            }
-                          //std::cout << "----" << std::endl; 
-                          for (txIt = grantInfo.m_psschTx.begin (); txIt != grantInfo.m_psschTx.end (); txIt++)
-                            {
-                              NS_ASSERT (txIt->subframe.frameNo == frameNo && txIt->subframe.subframeNo == subframeNo);
-                              //std::cout << "Rnti=" << grantInfo.m_grant.m_rnti << "\t PHY PSSCH TX at " << txIt->subframe.frameNo << "/" << txIt->subframe.subframeNo << "\t rbStart=" << (uint32_t) txIt->rbStart << "\t rbLen=" << (uint32_t) txIt->rbLen << std::endl;
-                              NS_LOG_INFO (this << "PSSCH TX " << txIt->subframe.frameNo << "/" << txIt->subframe.subframeNo << "\t rbStart=" << (uint32_t) txIt->rbStart << "\t rbLen=" << (uint32_t) txIt->rbLen);
-                            }
-                          //insert grant
-                          m_slTxPoolInfoV2x.m_currentGrants.insert (std::pair <uint16_t, SidelinkGrantInfoV2x> (sci1.m_rnti, grantInfo));
-                          NS_LOG_DEBUG (this <<  " Creating grant at " << grantInfo.m_grant.frameNo << "/" << grantInfo.m_grant.subframeNo);
-                        }
-
-                      std::list<SidelinkCommResourcePoolV2x::SidelinkTransmissionInfo>::iterator txIt = m_slTxPoolInfoV2x.m_currentGrants.begin()->second.m_pscchTx.begin ();
-                      NS_ASSERT (txIt != m_slTxPoolInfoV2x.m_currentGrants.begin()->second.m_pscchTx.end()); //must be at least one element
-                      std::vector <int> pscchRbs;
-                      for (int i = txIt->rbStart ; i < txIt->rbStart + txIt->rbLen ; i++)
-                        {
-                          NS_LOG_LOGIC (this << " Transmitting PSCCH on RB " << i);
-                          pscchRbs.push_back (i);
-                        }
-                      m_slTxPoolInfoV2x.m_currentGrants.begin()->second.m_pscchTx.erase (txIt);
-
-                      if (m_enableUplinkPowerControl)
-                        {
-                          m_txPowerPscch = m_powerControl->GetPscchTxPower (pscchRbs);
-                        }
-
-                      //Synchronization has priority over communication
-                      //The PSCCH is transmitted only if no synchronization operations are being performed
-                      if (!mibSLfound)
-                        {
-                          if(m_ueSlssScanningInProgress)
-                            {
-                              NS_LOG_LOGIC(this << "trying to do a PSCCH transmission while there is a scanning in progress... Ignoring transmission");
-
-                            }
-                          else if(m_ueSlssMeasurementsSched.find(Simulator::Now().GetMilliSeconds()) != m_ueSlssMeasurementsSched.end()) //Measurement in this subframe
-                            {
-                              NS_LOG_LOGIC(this << " trying to do a PSCCH transmission while measuring S-RSRP in the same subframe... Ignoring transmission");
-                            }
-                          else
-                            {
-                              //SetSubChannelsForTransmission (slRb);
-                              //m_uplinkSpectrumPhy->StartTxSlDataFrame (pb, ctrlMsg, UL_DATA_DURATION, 0);
-                              m_uplinkSpectrumPhy->ChangeState (LteSpectrumPhy::State::TX_UL_V2X_SCI);
-                            }
-                        }
-                      else
-                        {
-                          NS_LOG_LOGIC(this << " trying to do a PSCCH transmission while there is a PSBCH (SLSS) transmission scheduled... Ignoring transmission ");
-                        }
-                    }                  
-                  else
-                    {
-                      NS_LOG_LOGIC (this << " UE - SL/UL NOTHING TO SEND");
-                    }
-                }
-              if (pb)
-                {
-                  NS_LOG_LOGIC (this << " UE - start TX PSSCH");
-                  NS_LOG_DEBUG (this << " TX Burst containing " << pb->GetNPackets() << " packets");
-
-                  //tx pool only has 1 grant so we can go straight to the first element
-                  //find the matching transmission opportunity. This is needed in case some opportunities
-                  //were skipped because the queue was empty
-                  std::list<SidelinkCommResourcePoolV2x::SidelinkTransmissionInfo>::iterator txIt = m_slTxPoolInfoV2x.m_currentGrants.begin()->second.m_psschTx.begin ();
-
-                  NS_ASSERT (txIt != m_slTxPoolInfoV2x.m_currentGrants.begin()->second.m_psschTx.end()); //must be at least one element
-                  NS_ASSERT_MSG (txIt->subframe.frameNo == frameNo && txIt->subframe.subframeNo == subframeNo, "Found " << txIt->subframe.frameNo << "/" << txIt->subframe.subframeNo << "," << frameNo << "/" << subframeNo); //there must be an opportunity in this subframe
-                  NS_ASSERT (rbMask.size() == 0);
-                  
-                  std::vector<int> psschRbs; 
-                  for (int i = txIt->rbStart ; i < txIt->rbStart + txIt->rbLen ; i++)
-                  {
-                    NS_LOG_LOGIC (this << " Transmitting PSSCH on RB " << i);
-                    psschRbs.push_back(i); 
-                  }
-
-                  for (int i = txIt->rbStart-2 ; i < txIt->rbStart + txIt->rbLen ; i++)
-                  {
-                    rbMask.push_back (i);
-                  }
-
-                  m_slTxPoolInfoV2x.m_currentGrants.begin()->second.m_psschTx.erase (txIt);
-
-                  if (m_slTxPoolInfoV2x.m_currentGrants.begin()->second.m_psschTx.size() == 0) 
-                    {
-                      //no more PSSCH transmission, clear the grant
-                      m_slTxPoolInfoV2x.m_currentGrants.clear ();
-                    }
-
-                  if (m_enableUplinkPowerControl)
-                    {
-                      //m_txPower = m_powerControl->GetPsschTxPower (rbMask);
-                      m_txPowerPssch = m_powerControl->GetPscchTxPower (psschRbs);
-                    }
-
-                  //Synchronization has priority over communication
-                  //The PSSCH is transmitted only if no synchronization operations are being performed
-                  if (!mibSLfound)
-                    {
-                      if(m_ueSlssScanningInProgress)
-                        {
-                          NS_LOG_LOGIC(this <<" trying to do a PSSCH transmission while there is a scanning in progress... Ignoring transmission");
-                        }
-                      else if(m_ueSlssMeasurementsSched.find(Simulator::Now().GetMilliSeconds()) != m_ueSlssMeasurementsSched.end())
-                        {
-                          NS_LOG_LOGIC(this << " trying to do a PSSCH transmission while measuring S-RSRP in the same subframe... Ignoring transmission");
-                        }
-                      else
-                        {
-                          SetSubChannelsForTransmission (rbMask);
-                          m_uplinkSpectrumPhy->StartTxSlDataFrame (pb, ctrlMsg, UL_DATA_DURATION, 0);
-                        }
-                    }
-                  else
-                    {
-                      NS_LOG_LOGIC(this << " trying to do a PSSCH transmission while there is a PSBCH (SLSS) transmission scheduled... Ignoring transmission ");
-                    }
-                }                                                            
+              NS_ASSERT (rbMask.size() == 0);
+              SendSlV2x (frameNo, subframeNo, pb, ctrlMsg, mibSLfound, Seconds (0));
             } //end if V2X
           else
             {
@@ -2159,24 +2014,376 @@ LteUePhy::SubframeIndication (uint32_t frameNo, uint32_t subframeNo)
                 }
             }
         }
+
+      // with a distributed channel, the V2X transmission of the next subframe
+      // is started now so that the other systems receive it at its start
+      if (m_v2xEnabled && m_slTxPoolInfoV2x.m_pool && !m_resyncRequested
+          && m_uplinkSpectrumPhy->GetTxLookahead ().IsStrictlyPositive ())
+        {
+          SendNextSlV2x (frameNo, subframeNo);
+        }
     }  // m_configured
 
   // trigger the MAC
   m_uePhySapUser->SubframeIndication (frameNo, subframeNo);
 
+  m_lastSubframeIndicationTime = Simulator::Now ();
+  m_lastFrameNo = frameNo;
+  m_lastSubframeNo = subframeNo;
+  uint32_t idleSubframes = 0;
+  if (m_v2xLazySubframeIndication)
+    {
+      idleSubframes = GetV2xIdleSubframes ();
+    }
+
   m_subframeNo = subframeNo;
-  ++subframeNo;
-  if (subframeNo > 10)
+  if (idleSubframes > 0)
     {
-      ++frameNo;
-      if (frameNo > 1024) {
-          frameNo = 1;
-      }
-      subframeNo = 1;
+      NS_LOG_LOGIC (this << " skipping " << idleSubframes << " idle subframes");
     }
+  SidelinkCommResourcePoolV2x::SubframeInfo next;
+  next.frameNo = frameNo;
+  next.subframeNo = subframeNo;
+  next = next.Offset (1 + idleSubframes);
+  frameNo = next.frameNo;
+  subframeNo = next.subframeNo;
 
   // schedule next subframe indication
-  Simulator::Schedule (Seconds (GetTti ()), &LteUePhy::SubframeIndication, this, frameNo, subframeNo);
+  m_subframeIndicationEvent = Simulator::Schedule (Seconds (GetTti ()) * (int64_t) (1 + idleSubframes), &LteUePhy::SubframeIndication, this, frameNo, subframeNo);
+}
+
+void
+LteUePhy::SendNextSlV2x (uint32_t frameNo, uint32_t subframeNo)
+{
+  NS_LOG_FUNCTION (this << frameNo << subframeNo);
+  Time tti = Seconds (GetTti ());
+  NS_ABORT_MSG_IF (m_uplinkSpectrumPhy->GetTxLookahead () > tti,
+                   "The V2X transmissions are started one TTI in advance, the lookahead of the channel cannot be longer");
+
+  // the packets and messages of the next subframe are at the head of the queues
+  std::list<Ptr<LteControlMessage> > &ctrlQueue = m_controlMessagesQueue.at (0);
+  bool sciFound = false;
+  std::list<Ptr<LteControlMessage> >::iterator ctrlIt;
+  for (ctrlIt = ctrlQueue.begin (); ctrlIt != ctrlQueue.end (); ctrlIt++)
+    {
+      if ((*ctrlIt)->GetMessageType () == LteControlMessage::MIB_SL)
+        {
+          // the SLSS is sent in its own subframe
+          return;
+        }
+      sciFound |= (*ctrlIt)->GetMessageType () == LteControlMessage::SCI_V2X;
+    }
+  if (!m_subChannelsForTransmissionQueue.at (0).empty ()
+      || (m_packetBurstQueue.at (0)->GetSize () == 0 && !sciFound))
+    {
+      return;
+    }
+
+  Ptr<PacketBurst> pb;
+  if (m_packetBurstQueue.at (0)->GetSize () > 0)
+    {
+      pb = m_packetBurstQueue.at (0)->Copy ();
+      m_packetBurstQueue.at (0) = CreateObject <PacketBurst> ();
+    }
+  // the sidelink has priority over the uplink feedback
+  std::list<Ptr<LteControlMessage> > ctrlMsg;
+  for (ctrlIt = ctrlQueue.begin (); ctrlIt != ctrlQueue.end (); ctrlIt++)
+    {
+      if ((*ctrlIt)->GetMessageType () != LteControlMessage::DL_CQI
+          && (*ctrlIt)->GetMessageType () != LteControlMessage::BSR)
+        {
+          ctrlMsg.push_back (*ctrlIt);
+        }
+    }
+  ctrlQueue.clear ();
+
+  SidelinkCommResourcePoolV2x::SubframeInfo next;
+  next.frameNo = frameNo;
+  next.subframeNo = subframeNo;
+  next = next.Offset (1);
+  SendSlV2x (next.frameNo, next.subframeNo, pb, ctrlMsg, false, tti);
+}
+
+void
+LteUePhy::SendSlV2x (uint32_t frameNo, uint32_t subframeNo, Ptr<PacketBurst> pb, std::list<Ptr<LteControlMessage> > ctrlMsg, bool mibSLfound, Time delay)
+{
+  NS_LOG_FUNCTION (this << frameNo << subframeNo << delay);
+  // send packets in queue
+  NS_LOG_LOGIC (this << " UE - start slot for PSSCH + PSCCH - RNTI " << m_rnti << " CELLID " << m_cellId);
+  // send the current burst of packets
+  // send only PSCCH (ideal: fake null bandwidth signal)
+ 
+  //if (ctrlMsg.size ()>0 && sciDiscfound)
+  if (ctrlMsg.size ()>0)
+    { 
+      std::list<Ptr<LteControlMessage> >::iterator msgIt = ctrlMsg.begin();
+      //skiping the MIB-SL if it is the first in the list
+      if((*msgIt)->GetMessageType () != LteControlMessage::SCI_V2X && (*msgIt)->GetMessageType () != LteControlMessage::SL_DISC_MSG)
+        {
+          NS_LOG_LOGIC (this << " skiping the MIB-SL if it is the first in the list");
+          msgIt++;
+        }
+      else if ((*msgIt)->GetMessageType () == LteControlMessage::SCI_V2X)
+        {
+          NS_LOG_LOGIC (this << " UE - start TX PSCCH");
+          //access the control message to store the PSSCH grant and be able to
+          //determine the subframes/RBs for PSSCH transmissions
+          
+          NS_ASSERT_MSG ((*msgIt)->GetMessageType () == LteControlMessage::SCI_V2X, "Received " << (*msgIt)->GetMessageType ());
+
+          Ptr<SciLteControlMessageV2x> msg2 = DynamicCast<SciLteControlMessageV2x> (*msgIt);
+          SciListElementV2x sci1 = msg2->GetSci ();
+
+          std::map<uint16_t, SidelinkGrantInfoV2x>::iterator grantIt = m_slTxPoolInfoV2x.m_currentGrants.find (sci1.m_rnti);
+          if (grantIt == m_slTxPoolInfoV2x.m_currentGrants.end ())
+            {
+              SidelinkGrantInfoV2x grantInfo; 
+              // this is the first transmission of PSCCH
+              grantInfo.m_grant_received = true;
+              grantInfo.m_hasMeasurement = false;
+              grantInfo.m_grant.m_rnti = sci1.m_rnti; 
+              grantInfo.m_grant.m_prio = sci1.m_prio; 
+              grantInfo.m_grant.m_pRsvp = sci1.m_pRsvp;
+              grantInfo.m_grant.m_reTxIdx = sci1.m_reTxIdx; 
+              grantInfo.m_grant.m_riv = sci1.m_riv;
+              grantInfo.m_grant.m_sfGap = sci1.m_sfGap; 
+              grantInfo.m_grant.m_mcs = sci1.m_mcs;  
+
+              grantInfo.m_grant.m_resPscch = sci1.m_resPscch;
+              grantInfo.m_grant.m_tbSize = sci1.m_tbSize;
+
+              grantInfo.m_grant.frameNo = frameNo; 
+              grantInfo.m_grant.subframeNo = subframeNo; 
+
+              SidelinkCommResourcePoolV2x::SubframeInfo tmp;
+              tmp.frameNo = frameNo;
+              tmp.subframeNo = subframeNo; 
+                          
+              grantInfo.m_pscchTx = m_slTxPoolInfoV2x.m_pool->GetPscchTransmissions(tmp, sci1.m_riv, sci1.m_pRsvp, sci1.m_sfGap, sci1.m_reTxIdx, sci1.m_resPscch, 1);
+              grantInfo.m_psschTx = m_slTxPoolInfoV2x.m_pool->GetPsschTransmissions(tmp, sci1.m_riv, sci1.m_pRsvp, sci1.m_sfGap, sci1.m_reTxIdx, sci1.m_resPscch, 1); 
+
+              std::list<SidelinkCommResourcePoolV2x::SidelinkTransmissionInfo>::iterator txIt;
+              for (txIt = grantInfo.m_pscchTx.begin (); txIt != grantInfo.m_pscchTx.end (); txIt++)
+                {
+                  NS_ASSERT (txIt->subframe.frameNo == frameNo && txIt->subframe.subframeNo == subframeNo);
+                  //std::cout << " Rnti="<< grantInfo.m_grant.m_rnti << "\t PHY PSCCH TX at " << txIt->subframe.frameNo << "/" << txIt->subframe.subframeNo << "\t rbStart=" << (uint32_t) txIt->rbStart << "\t rbLen=" << (uint32_t) txIt->rbLen << std::endl;
+                  NS_LOG_INFO (this << "PSCCH Tx " << txIt->subframe.frameNo << "/" << txIt->subframe.subframeNo << "\t rbStart=" << (uint32_t) txIt->rbStart << "\t rbLen=" << (uint32_t) txIt->rbLen);
+                }
+              //std::cout << "----" << std::endl; 
+              for (txIt = grantInfo.m_psschTx.begin (); txIt != grantInfo.m_psschTx.end (); txIt++)
+                {
+                  NS_ASSERT (txIt->subframe.frameNo == frameNo && txIt->subframe.subframeNo == subframeNo);
+                  //std::cout << "Rnti=" << grantInfo.m_grant.m_rnti << "\t PHY PSSCH TX at " << txIt->subframe.frameNo << "/" << txIt->subframe.subframeNo << "\t rbStart=" << (uint32_t) txIt->rbStart << "\t rbLen=" << (uint32_t) txIt->rbLen << std::endl;
+                  NS_LOG_INFO (this << "PSSCH TX " << txIt->subframe.frameNo << "/" << txIt->subframe.subframeNo << "\t rbStart=" << (uint32_t) txIt->rbStart << "\t rbLen=" << (uint32_t) txIt->rbLen);
+                }
+              //insert grant
+              m_slTxPoolInfoV2x.m_currentGrants.insert (std::pair <uint16_t, SidelinkGrantInfoV2x> (sci1.m_rnti, grantInfo));
+              NS_LOG_DEBUG (this <<  " Creating grant at " << grantInfo.m_grant.frameNo << "/" << grantInfo.m_grant.subframeNo);
+            }
+
+          std::list<SidelinkCommResourcePoolV2x::SidelinkTransmissionInfo>::iterator txIt = m_slTxPoolInfoV2x.m_currentGrants.begin()->second.m_pscchTx.begin ();
+          NS_ASSERT (txIt != m_slTxPoolInfoV2x.m_currentGrants.begin()->second.m_pscchTx.end()); //must be at least one element
+          std::vector <int> pscchRbs;
+          for (int i = txIt->rbStart ; i < txIt->rbStart + txIt->rbLen ; i++)
+            {
+              NS_LOG_LOGIC (this << " Transmitting PSCCH on RB " << i);
+              pscchRbs.push_back (i);
+            }
+          m_slTxPoolInfoV2x.m_currentGrants.begin()->second.m_pscchTx.erase (txIt);
+
+          if (m_enableUplinkPowerControl)
+            {
+              m_txPowerPscch = m_powerControl->GetPscchTxPower (pscchRbs);
+            }
+
+          //Synchronization has priority over communication
+          //The PSCCH is transmitted only if no synchronization operations are being performed
+          if (!mibSLfound)
+            {
+              if(m_ueSlssScanningInProgress)
+                {
+                  NS_LOG_LOGIC(this << "trying to do a PSCCH transmission while there is a scanning in progress... Ignoring transmission");
+
+                }
+              else if(m_ueSlssMeasurementsSched.find((Simulator::Now() + delay).GetMilliSeconds()) != m_ueSlssMeasurementsSched.end()) //Measurement in this subframe
+                {
+                  NS_LOG_LOGIC(this << " trying to do a PSCCH transmission while measuring S-RSRP in the same subframe... Ignoring transmission");
+                }
+              else
+                {
+                  //SetSubChannelsForTransmission (slRb);
+                  //m_uplinkSpectrumPhy->StartTxSlDataFrame (pb, ctrlMsg, UL_DATA_DURATION, 0);
+                  if (delay.IsZero ())
+                    {
+                      m_uplinkSpectrumPhy->ChangeState (LteSpectrumPhy::State::TX_UL_V2X_SCI);
+                    }
+                  else
+                    {
+                      Simulator::Schedule (delay, &LteSpectrumPhy::ChangeState, m_uplinkSpectrumPhy, LteSpectrumPhy::TX_UL_V2X_SCI);
+                    }
+                }
+            }
+          else
+            {
+              NS_LOG_LOGIC(this << " trying to do a PSCCH transmission while there is a PSBCH (SLSS) transmission scheduled... Ignoring transmission ");
+            }
+        }                  
+      else
+        {
+          NS_LOG_LOGIC (this << " UE - SL/UL NOTHING TO SEND");
+        }
+    }
+  if (pb)
+    {
+      NS_LOG_LOGIC (this << " UE - start TX PSSCH");
+      NS_LOG_DEBUG (this << " TX Burst containing " << pb->GetNPackets() << " packets");
+
+      //tx pool only has 1 grant so we can go straight to the first element
+      //find the matching transmission opportunity. This is needed in case some opportunities
+      //were skipped because the queue was empty
+      std::list<SidelinkCommResourcePoolV2x::SidelinkTransmissionInfo>::iterator txIt = m_slTxPoolInfoV2x.m_currentGrants.begin()->second.m_psschTx.begin ();
+
+      NS_ASSERT (txIt != m_slTxPoolInfoV2x.m_currentGrants.begin()->second.m_psschTx.end()); //must be at least one element
+      NS_ASSERT_MSG (txIt->subframe.frameNo == frameNo && txIt->subframe.subframeNo == subframeNo, "Found " << txIt->subframe.frameNo << "/" << txIt->subframe.subframeNo << "," << frameNo << "/" << subframeNo); //there must be an opportunity in this subframe
+      std::vector<int> rbMask;
+      
+      std::vector<int> psschRbs; 
+      for (int i = txIt->rbStart ; i < txIt->rbStart + txIt->rbLen ; i++)
+      {
+        NS_LOG_LOGIC (this << " Transmitting PSSCH on RB " << i);
+        psschRbs.push_back(i); 
+      }
+
+      for (int i = txIt->rbStart-2 ; i < txIt->rbStart + txIt->rbLen ; i++)
+      {
+        rbMask.push_back (i);
+      }
+
+      m_slTxPoolInfoV2x.m_currentGrants.begin()->second.m_psschTx.erase (txIt);
+
+      if (m_slTxPoolInfoV2x.m_currentGrants.begin()->second.m_psschTx.size() == 0) 
+        {
+          //no more PSSCH transmission, clear the grant
+          m_slTxPoolInfoV2x.m_currentGrants.clear ();
+        }
+
+      if (m_enableUplinkPowerControl)
+        {
+          //m_txPower = m_powerControl->GetPsschTxPower (rbMask);
+          m_txPowerPssch = m_powerControl->GetPscchTxPower (psschRbs);
+        }
+
+      //Synchronization has priority over communication
+      //The PSSCH is transmitted only if no synchronization operations are being performed
+      if (!mibSLfound)
+        {
+          if(m_ueSlssScanningInProgress)
+            {
+              NS_LOG_LOGIC(this <<" trying to do a PSSCH transmission while there is a scanning in progress... Ignoring transmission");
+            }
+          else if(m_ueSlssMeasurementsSched.find((Simulator::Now() + delay).GetMilliSeconds()) != m_ueSlssMeasurementsSched.end())
+            {
+              NS_LOG_LOGIC(this << " trying to do a PSSCH transmission while measuring S-RSRP in the same subframe... Ignoring transmission");
+            }
+          else
+            {
+              SetSubChannelsForTransmission (rbMask);
+              if (delay.IsZero ())
+                {
+                  m_uplinkSpectrumPhy->StartTxSlDataFrame (pb, ctrlMsg, UL_DATA_DURATION, 0);
+                }
+              else
+                {
+                  m_uplinkSpectrumPhy->ScheduleTxSlDataFrame (pb, ctrlMsg, UL_DATA_DURATION, 0, delay);
+                }
+            }
+        }
+      else
+        {
+          NS_LOG_LOGIC(this << " trying to do a PSSCH transmission while there is a PSBCH (SLSS) transmission scheduled... Ignoring transmission ");
+        }
+    }
+}
+
+uint32_t
+LteUePhy::GetV2xIdleSubframes ()
+{
+  NS_LOG_FUNCTION (this);
+
+  // only a V2X UE out of coverage without other sidelink services can skip subframes
+  if (!m_v2xEnabled || !m_ulConfigured || m_cellId != 0 || m_slTxPoolInfo.m_pool || m_discTxPools.m_pool
+      || !m_sidelinkRxPools.empty () || !m_discRxPools.empty () || m_resyncRequested
+      || m_ueSlssScanningInProgress || m_ueSlssMeasurementInProgress || !m_ueSlssMeasurementsSched.empty ()
+      || m_uplinkSpectrumPhy->GetTxLookahead ().IsStrictlyPositive ())
+    {
+      // the transmissions over a distributed channel are started in the
+      // previous subframe (see SendNextSlV2x)
+      return 0;
+    }
+
+  // messages and packets delivered by the MAC are sent in the coming subframes
+  for (uint8_t i = 0; i < m_macChTtiDelay; i++)
+    {
+      if (m_packetBurstQueue.at (i)->GetSize () > 0 || !m_controlMessagesQueue.at (i).empty ()
+          || !m_subChannelsForTransmissionQueue.at (i).empty ())
+        {
+          return 0;
+        }
+    }
+
+  uint32_t idleSubframes = std::min (m_uePhySapUser->GetV2xIdleSubframes (), (uint32_t) V2X_MAX_IDLE_SUBFRAMES);
+
+  // pending receptions of the PSSCH
+  SidelinkCommResourcePoolV2x::SubframeInfo now;
+  now.frameNo = m_lastFrameNo;
+  now.subframeNo = m_lastSubframeNo;
+  std::list <PoolInfoV2x>::iterator poolIt;
+  for (poolIt = m_sidelinkRxPoolsV2x.begin (); poolIt != m_sidelinkRxPoolsV2x.end () && idleSubframes > 0; poolIt++)
+    {
+      std::map <uint16_t, SidelinkGrantInfoV2x>::iterator grantIt;
+      for (grantIt = poolIt->m_currentGrants.begin (); grantIt != poolIt->m_currentGrants.end (); grantIt++)
+        {
+          if (grantIt->second.m_grant_received)
+            {
+              return 0;
+            }
+          if (!grantIt->second.m_psschTx.empty ())
+            {
+              uint32_t distance = SidelinkCommResourcePoolV2x::SubframeInfo::GetDistance (now, grantIt->second.m_psschTx.begin ()->subframe);
+              if (distance <= 1)
+                {
+                  return 0;
+                }
+              idleSubframes = std::min (idleSubframes, distance - 1);
+            }
+        }
+    }
+
+  return idleSubframes;
+}
+
+void
+LteUePhy::WakeUpSubframeIndication ()
+{
+  if (!m_v2xLazySubframeIndication || !m_subframeIndicationEvent.IsRunning ())
+    {
+      return;
+    }
+
+  // first subframe boundary after now
+  Time tti = Seconds (GetTti ());
+  int64_t elapsed = (Simulator::Now () - m_lastSubframeIndicationTime) / tti + 1;
+  Time next = m_lastSubframeIndicationTime + tti * elapsed;
+  if (m_subframeIndicationEvent.GetTs () > (uint64_t) next.GetTimeStep ())
+    {
+      SidelinkCommResourcePoolV2x::SubframeInfo wakeUp;
+      wakeUp.frameNo = m_lastFrameNo;
+      wakeUp.subframeNo = m_lastSubframeNo;
+      wakeUp = wakeUp.Offset (elapsed);
+      NS_LOG_LOGIC (this << " wake up at subframe " << wakeUp.frameNo << "/" << wakeUp.subframeNo);
+      m_subframeIndicationEvent.Cancel ();
+      m_subframeIndicationEvent = Simulator::Schedule (next - Simulator::Now (), &LteUePhy::SubframeIndication, this, wakeUp.frameNo, wakeUp.subframeNo);
+    }
 }
 
 
@@ -2275,6 +2482,7 @@ LteUePhy::DoSynchronizeWithEnb (uint16_t cellId)
 
   m_dlConfigured = false;
   m_ulConfigured = false;
+  WakeUpSubframeIndication ();
 
   SwitchToState (SYNCHRONIZED);
 }
@@ -2461,6 +2669,7 @@ LteUePhy::DoSetSlV2xTxPool (Ptr<SidelinkTxCommResourcePoolV2x> pool)
   m_slTxPoolInfoV2x.m_currentGrants.clear();
   m_slTxPoolInfoV2x.m_currentFrameInfo.frameNo = 0; //init to 0 to make it invalid
   m_slTxPoolInfoV2x.m_currentFrameInfo.subframeNo = 0; //init to 0 to make it invalid
+  WakeUpSubframeIndication ();
 }
 
 void
@@ -2476,6 +2685,7 @@ LteUePhy::DoRemoveSlV2xTxPool ()
 {
   m_slTxPoolInfoV2x.m_pool = NULL;
   m_slTxPoolInfoV2x.m_currentGrants.clear(); 
+  WakeUpSubframeIndication ();
 }
 
 void
@@ -2533,6 +2743,8 @@ LteUePhy::DoSetSlV2xRxPools (std::list<Ptr<SidelinkRxCommResourcePoolV2x> > pool
       m_sidelinkSpectrumPhy->SetRxPool (newpool.m_pool);
     }
   }
+  // the MAC may have new transmission pools as well
+  WakeUpSubframeIndication ();
 }
 
 
@@ -2653,6 +2865,7 @@ LteUePhy::ReceiveLteDlHarqFeedback (DlInfoListElement_s m)
   Ptr<DlHarqFeedbackLteControlMessage> msg = Create<DlHarqFeedbackLteControlMessage> ();
   msg->SetDlHarqFeedback (m);
   SetControlMessages (msg);
+  WakeUpSubframeIndication ();
 }
 
 void
@@ -2693,80 +2906,6 @@ Time LteUePhy::GetFirstScanningTime(){
   return m_tFirstScanning;
 }
 
-double LteUePhy::GetSidelinkRsrp (std::vector<SpectrumValue> p)
-{
-  // Measure instantaneous S-RSRP...
-  double sum = 0.0;
-  uint16_t nRB = 0; 
-  uint8_t ctr = 0; 
-
-  for(std::vector<SpectrumValue>::iterator it = p.begin(); it != p.end(); it++)
-  {
-    for (Values::const_iterator itPi = it->ConstValuesBegin(); itPi != it->ConstValuesEnd(); itPi++)
-      {
-        if((*itPi))
-          { 
-            // skip first two values because the RBs are used for PSCCH
-            if(ctr <= 1)
-            {
-              ctr++; 
-            }
-            else
-            {
-              double powerTxW = ((*itPi) * 180000.0) / 12.0; // convert PSD [W/Hz] to linear power [W]
-              sum += powerTxW;
-              nRB++;
-            }
-          }
-      }
-  }
-    
-  double s_rsrp_W = (sum / (double) nRB);
-  double s_rsrp_dBm = 10 * log10(1000 * (s_rsrp_W)); 
-
-  return s_rsrp_dBm; 
-}
-
-double LteUePhy::GetSidelinkRssi (std::vector<SpectrumValue> sig, std::vector<SpectrumValue> interference)
-{
-  // Measure instantaneous S-RSSI ...
-  double sum = 0.0;
-  uint16_t nRB = 0; 
-  uint8_t ctr = 0; 
-
-  std::vector<SpectrumValue>::iterator itSig = sig.begin();
-  std::vector<SpectrumValue>::iterator itInt = interference.begin(); 
-
-  for(itSig = sig.begin() ; itSig != sig.end(); itSig++, itInt++)
-  {
-      Values::const_iterator itIntN = itSig->ConstValuesBegin ();
-      Values::const_iterator itPj = itInt->ConstValuesBegin ();
-      
-      for (itPj = itSig->ConstValuesBegin ();
-               itPj != itSig->ConstValuesEnd ();
-               itIntN++, itPj++)
-            {
-              if(ctr <= 1)
-              {
-                ctr++;
-              }
-              else
-              {
-                  nRB++;
-                  // convert PSD [W/Hz] to linear power [W] for the single RE
-                  double interfPlusNoisePowerTxW = ((*itIntN) * 180000.0) / 12.0;
-                  double signalPowerTxW = ((*itPj) * 180000.0) / 12.0;
-                  sum += (2 * (interfPlusNoisePowerTxW + signalPowerTxW));
-              }
-            }
-  }
-    
-  double s_rssi_W = (sum / (double) nRB);
-  double s_rssi_dBm = 10 * log10(1000 * (s_rssi_W)); 
-
-  return s_rssi_dBm; 
-}
-
 void LteUePhy::ReceiveSlss(uint16_t slssid, Ptr<SpectrumValue> p)
 {
   NS_LOG_FUNCTION(this << slssid);
@@ -2896,6 +3035,7 @@ void LteUePhy::StartSlssScanning()
   NS_LOG_FUNCTION (this);
   m_ueSlssScanningInProgress = true;
   m_detectedMibSl.clear();
+  WakeUpSubframeIndication ();
   Simulator::Schedule(m_ueSlssScanningPeriod, &LteUePhy::EndSlssScanning, this);
 
 }
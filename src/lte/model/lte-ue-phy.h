@@ -256,6 +256,42 @@ public:
   */
   void SubframeIndication (uint32_t frameNo, uint32_t subframeNo);
 
+  /**
+   * \brief Get the number of subframes following the current one in which
+   * a V2X UE has nothing to transmit or receive (lazy subframe indication)
+   *
+   * \return the number of subframes that can be skipped, 0 if the next
+   * subframe must be processed
+   */
+  uint32_t GetV2xIdleSubframes ();
+
+  /**
+   * \brief Start the V2X transmission of the next subframe one TTI in
+   * advance, so that a distributed channel announces it to the other
+   * systems before it starts
+   *
+   * \param frameNo the current frame number
+   * \param subframeNo the current subframe number
+   */
+  void SendNextSlV2x (uint32_t frameNo, uint32_t subframeNo);
+
+  /**
+   * \brief Send the PSCCH and PSSCH of a V2X subframe
+   *
+   * \param frameNo the frame number of the transmission
+   * \param subframeNo the subframe number of the transmission
+   * \param pb the burst of packets of the PSSCH
+   * \param ctrlMsg the control messages of the subframe
+   * \param mibSLfound whether a MIB-SL is sent in the subframe
+   * \param delay the time from now to the start of the subframe
+   */
+  void SendSlV2x (uint32_t frameNo, uint32_t subframeNo, Ptr<PacketBurst> pb, std::list<Ptr<LteControlMessage> > ctrlMsg, bool mibSLfound, Time delay);
+
+  /**
+   * \brief Bring the next subframe indication forward to the next subframe
+   * boundary when idle subframes are being skipped
+   */
+  void WakeUpSubframeIndication ();
 
   /**
    * \brief Send the SRS signal in the last symbols of the frame
@@ -557,19 +593,6 @@ private:
    */
   void DoSetSlV2xRxPools (std::list<Ptr<SidelinkRxCommResourcePoolV2x> > pools);
 
-  /**
-   * Return the S-RSRP value in dBm
-   * \param p vector of signal perceived per each RB per sidelink packet
-   */
-  double GetSidelinkRsrp (std::vector <SpectrumValue> sig);
-
-  /**
-   * Return the S-RSSI value in dBm
-   * \param sig vector of signal perceived per each RB per sidelink packet
-   * \param interference vector of interference perceived per each RB per sidelink packet
-   */
-  double GetSidelinkRssi (std::vector <SpectrumValue> sig, std::vector <SpectrumValue> interference);
-
   // UE PHY SAP methods 
   virtual void DoSendMacPdu (Ptr<Packet> p);
   /**
@@ -672,6 +695,17 @@ private:
 
   bool m_v2xEnabled; 
 
+  /**
+   * The `EnableV2xLazySubframeIndication` attribute. Skip the subframe
+   * indications of a V2X UE out of coverage while it has no sidelink
+   * activity.
+   */
+  bool m_v2xLazySubframeIndication;
+  EventId m_subframeIndicationEvent; ///< next subframe indication event
+  Time m_lastSubframeIndicationTime; ///< time of the last subframe indication
+  uint32_t m_lastFrameNo; ///< frame number of the last subframe indication
+  uint32_t m_lastSubframeNo; ///< subframe number of the last subframe indication
+
   bool m_pssReceived; ///< PSS received?
   /// PssElement structure
   struct PssElement 
@@ -833,6 +867,8 @@ private:
     std::list<SidelinkCommResourcePoolV2x::SidelinkTransmissionInfo> m_pscchTx;
     std::list<SidelinkCommResourcePoolV2x::SidelinkTransmissionInfo> m_psschTx; 
     bool m_grant_received;
+    bool m_hasMeasurement; // whether the signal of the SCI was measured
+    SlV2xMeasurement_t m_measurement; // S-RSRP/S-RSSI of the signal of the SCI
   };
 
   struct PoolInfoV2x {
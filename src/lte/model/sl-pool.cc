@@ -21,6 +21,7 @@
  */
 
 #include "sl-pool.h"
+#include <limits>
 
 namespace ns3 {
   /**
@@ -680,6 +681,8 @@ namespace ns3 {
     ///// SidelinkV2XResourcePool ///// 
     ///////////////////////////////////
 
+  const uint32_t SidelinkCommResourcePoolV2x::SUBFRAME_CYCLE;
+
   SidelinkCommResourcePoolV2x::SidelinkCommResourcePoolV2x (void) : m_type (SidelinkCommResourcePoolV2x::UNKNOWN)
   {
     m_preconfigured = false; 
@@ -749,6 +752,7 @@ namespace ns3 {
   {
     ComputeNumberOfPscchResources ();
     ComputeNumberOfPsschResources ();
+    ComputeRivTables ();
   }
 
   SidelinkCommResourcePoolV2x::SlPoolType
@@ -810,6 +814,62 @@ namespace ns3 {
     m_rbpssch = m_rbpsschVector.size();
   }
 
+  void
+  SidelinkCommResourcePoolV2x::ComputeRivTables ()
+  {
+    uint16_t numSubchannel = LteRrcSap::numSubchannelAsInt(m_numSubchannel);
+    uint16_t sizeSubch = LteRrcSap::sizeSubchannelAsInt(m_sizeSubchannel);
+    uint16_t startRbSubch = LteRrcSap::startRbSubchannelAsInt(m_startRbSubchannel);
+    bool adjacency = LteRrcSap::adjacencyAsBool(m_adjacencyPscchPssch);
+
+    // 36.213 14.1.1.4C, RIVs which are not valid for the pool decode to zero
+    RivValues noValues = {0, 0};
+    m_rivValues.assign (256, noValues);
+    std::vector<bool> validRiv (256, false);
+    for(uint16_t n=1; n<=numSubchannel;n++)
+    {
+      for(uint16_t m=0; m<=(numSubchannel-n);m++)
+      {
+        uint16_t riv;
+        if((n-1) <= std::floor(numSubchannel/2))
+        {
+          riv = numSubchannel*(n-1)+m;
+        }
+        else
+        {
+          riv = numSubchannel*(numSubchannel-n+1)+(numSubchannel-1-m);
+        }
+        if (riv < 256)
+        {
+          m_rivValues[riv].subchLen = n;
+          m_rivValues[riv].subchReTxIdx = m;
+          validRiv[riv] = true;
+        }
+      }
+    }
+
+    // RBs of the PSSCH transmission indicated by each valid RIV and PSCCH resource
+    m_rivOffset.assign (256, std::numeric_limits<uint16_t>::max ());
+    m_psschRxResources.clear ();
+    SidelinkCommResourcePoolV2x::SidelinkTransmissionInfo info;
+    info.subframe.frameNo = 0;
+    info.subframe.subframeNo = 0;
+    for (uint16_t riv = 0; riv < 256; riv++)
+    {
+      if (!validRiv[riv])
+      {
+        continue;
+      }
+      m_rivOffset[riv] = m_psschRxResources.size ();
+      for (uint16_t pscchResource = 0; pscchResource < numSubchannel; pscchResource++)
+      {
+        info.rbStart = pscchResource*sizeSubch + startRbSubch + (adjacency ? 2 : 0);
+        info.rbLen = m_rivValues[riv].subchLen*sizeSubch-2;
+        m_psschRxResources.push_back (info);
+      }
+    }
+  }
+
   std::list<SidelinkCommResourcePoolV2x::SidelinkTransmissionInfo>
   SidelinkCommResourcePoolV2x::GetCandidateResources (SidelinkCommResourcePoolV2x::SubframeInfo subframe, uint16_t t1, uint16_t t2, uint16_t subchLen)
   { 
@@ -820,24 +880,14 @@ namespace ns3 {
     uint16_t sizeSubch = LteRrcSap::sizeSubchannelAsInt(m_sizeSubchannel); 
     uint16_t numSubch = LteRrcSap::numSubchannelAsInt(m_numSubchannel);
     uint16_t startRbSubch = LteRrcSap::startRbSubchannelAsInt(m_startRbSubchannel);
-    uint16_t lenSelectionWindow = t2-t1; 
+
+    // due to half duplex the UE doesn't receive SCIs in the subframes in which it transmits itself
+    // so it should not choose the last transmission subframe as candidate resource
+    uint16_t lastSf = (t2 == 100) ? t2 - 1 : t2; 
 
     std::list<SidelinkCommResourcePoolV2x::SidelinkTransmissionInfo> txInfo;
     SidelinkCommResourcePoolV2x::SidelinkTransmissionInfo info;   
 
-    info.subframe.subframeNo = subframe.subframeNo + t1 - 1;
-    info.subframe.frameNo = subframe.frameNo; 
- 
-    if(info.subframe.subframeNo > 10)
-    {
-      ++info.subframe.frameNo;
-      if(info.subframe.frameNo > 1024) 
-      {
-        info.subframe.frameNo = 1; 
-      }
-      info.subframe.subframeNo -= 10; 
-    }
- 
     if(adjacency) 
     {
       info.rbLen = subchLen*sizeSubch-2;
@@ -847,25 +897,10 @@ namespace ns3 {
       info.rbLen = subchLen*sizeSubch;
     }
 
-    for(uint16_t sfCtr = 0; sfCtr <= lenSelectionWindow; sfCtr++) 
+    uint32_t startIdx = subframe.GetIndex (); 
+    for(uint16_t sf = t1; sf <= lastSf; sf++) 
       {
-        // due to half duplex the UE doesn't receive SCIs in the subframes in which it transmits itself
-        // so it should not choose the last transmission subframe as candidate resource
-        if(t2 == 100 && sfCtr == lenSelectionWindow-1) 
-        {
-          continue; 
-        }
-
-        ++info.subframe.subframeNo;  
-        if (info.subframe.subframeNo > 10) 
-        {
-          ++info.subframe.frameNo; 
-          if (info.subframe.frameNo > 1024) 
-          {
-            info.subframe.frameNo = 1; 
-          }
-          info.subframe.subframeNo -= 10;
-        }
+        info.subframe = SubframeInfo::FromIndex (startIdx + sf);
 
         for(uint16_t subchCtr = 0; subchCtr < numSubch; subchCtr++)
         {
@@ -886,6 +921,38 @@ namespace ns3 {
     return txInfo;
   }
 
+  std::list<SidelinkCommResourcePoolV2x::SidelinkTransmissionInfo>
+  SidelinkCommResourcePoolV2x::GetTransmissions (SubframeInfo subframe, uint16_t pRsvp, uint8_t sfGap, uint8_t reTxIdx, uint8_t reselCtr, SidelinkTransmissionInfo first, SidelinkTransmissionInfo second)
+  {
+    std::list<SidelinkCommResourcePoolV2x::SidelinkTransmissionInfo> txInfo;
+    uint32_t startIdx = subframe.GetIndex (); 
+    for (uint8_t ctr = 0; ctr < reselCtr; ctr++)
+    {
+      // the reservations are spaced by whole frames
+      uint32_t firstIdx = startIdx + 10*(ctr*pRsvp/10); 
+      first.subframe = SubframeInfo::FromIndex (firstIdx);
+      if (sfGap == 0)
+      {
+        txInfo.push_back (first); 
+      }
+      else if (reTxIdx == 0)
+      {
+        // retransmission occurs after initial transmission
+        second.subframe = SubframeInfo::FromIndex (firstIdx + sfGap);
+        txInfo.push_back (first); 
+        txInfo.push_back (second); 
+      }
+      else
+      {
+        // retransmission occurs before initial transmission
+        second.subframe = SubframeInfo::FromIndex (SubframeInfo::OffsetIndex (firstIdx, -(int32_t) sfGap));
+        txInfo.push_back (second); 
+        txInfo.push_back (first); 
+      }
+    }
+    return txInfo;
+  }
+
   std::list<SidelinkCommResourcePoolV2x::SidelinkTransmissionInfo>
   SidelinkCommResourcePoolV2x::GetPscchTransmissions (SidelinkCommResourcePoolV2x::SubframeInfo subframe, uint8_t riv, uint16_t pRsvp, uint8_t sfGap, uint8_t reTxIdx, uint8_t pscchResource, uint8_t reselCtr)
   { 
@@ -896,493 +963,55 @@ namespace ns3 {
     uint16_t startRbSubch = LteRrcSap::startRbSubchannelAsInt(m_startRbSubchannel); 
     uint16_t startRbPscch = LteRrcSap::startRbPscchPoolAsInt(m_startRbPscchPool); 
 
-    uint8_t* tmp = GetValsFromRiv(riv);
-    uint8_t subchReTxIdx = tmp[1]; // index for the subchannel of the retransmission
+    uint8_t subchReTxIdx = GetValsFromRiv(riv).subchReTxIdx; // index for the subchannel of the retransmission
 
     // 36.213 14.1.1.4C
-    std::list<SidelinkCommResourcePoolV2x::SidelinkTransmissionInfo> txInfo;
     SidelinkCommResourcePoolV2x::SidelinkTransmissionInfo first;
+    SidelinkCommResourcePoolV2x::SidelinkTransmissionInfo second;
+    first.rbLen = 2;
+    second.rbLen = 2;
 
     if (adjacency)
     {
-      first.subframe.subframeNo = subframe.subframeNo; 
       first.rbStart = startRbSubch + pscchResource*sizeSubch;
-      first.rbLen = 2;
-
-      if (sfGap != 0)
-      {
-        SidelinkCommResourcePoolV2x::SidelinkTransmissionInfo second; 
-        second.rbStart = startRbSubch + subchReTxIdx*sizeSubch;
-        second.rbLen = 2;
-
-        if (reTxIdx == 0)
-        {
-          // adjacent, retransmission occurs after initial transmission
-          for (uint8_t ctr = 0; ctr < reselCtr; ctr++)
-          {
-            first.subframe.frameNo = subframe.frameNo + ctr*pRsvp/10;
-   
-            if (first.subframe.subframeNo + sfGap > 20)
-            {
-              second.subframe.frameNo = first.subframe.frameNo + 2; 
-              second.subframe.subframeNo = first.subframe.subframeNo + sfGap - 20; 
-            }
-            else if (first.subframe.subframeNo + sfGap > 10)
-            {
-              second.subframe.frameNo = first.subframe.frameNo + 1;
-              second.subframe.subframeNo = first.subframe.subframeNo + sfGap - 10; 
-            }
-            else
-            {
-              second.subframe.frameNo = first.subframe.frameNo; 
-              second.subframe.subframeNo = first.subframe.subframeNo + sfGap; 
-            }
-
-            if (first.subframe.frameNo > 2048) 
-            {
-              first.subframe.frameNo -= 2048;
-              second.subframe.frameNo -= 2048;
-            }
-            else if (second.subframe.frameNo > 2048)
-            {
-              second.subframe.frameNo -= 2048; 
-            }
-            else if (first.subframe.frameNo > 1024)
-            {
-              first.subframe.frameNo -= 1024;
-              second.subframe.frameNo -= 1024; 
-            }
-            else if (second.subframe.frameNo > 1024)
-            {
-              second.subframe.frameNo -= 1024; 
-            }
-            txInfo.push_back(first);
-            txInfo.push_back(second);
-          }
-        } // endif reTxIdx == 0
-        else 
-        {          
-          // adjacent, retransmission occurs before initial transmission
-          for (uint8_t ctr = 0; ctr < reselCtr; ctr++)
-          { 
-            first.subframe.frameNo = subframe.frameNo + ctr*pRsvp/10;
-
-            if (sfGap >= first.subframe.subframeNo + 10)
-            {
-              if(first.subframe.frameNo == 2)
-              {
-                second.subframe.frameNo = 1024;
-              }
-              else if (first.subframe.frameNo == 1)
-              {
-                second.subframe.frameNo = 1023;
-              }
-              else
-              {
-                second.subframe.frameNo = first.subframe.frameNo - 2; 
-              }
-              second.subframe.subframeNo = first.subframe.subframeNo + 20 - sfGap;               
-            }
-            else if (sfGap >= first.subframe.subframeNo)
-            {
-              if(first.subframe.frameNo == 1)
-              {
-                second.subframe.frameNo = 1024; 
-              }
-              else
-              {
-                second.subframe.frameNo = first.subframe.frameNo - 1; 
-              }
-              second.subframe.subframeNo = first.subframe.subframeNo + 10 - sfGap; 
-            }
-            else 
-            {
-              second.subframe.frameNo = first.subframe.frameNo;
-              second.subframe.subframeNo = first.subframe.subframeNo - sfGap; 
-            }
-
-            txInfo.push_back(second);
-            txInfo.push_back(first);
-          }
-        }
-      } // endif sfGap != 0
-      else
-      { 
-        // adjacent, no retransmission 
-        for (uint8_t ctr = 0; ctr < reselCtr; ctr++)
-        {
-          first.subframe.frameNo = subframe.frameNo + ctr*pRsvp/10; 
-          if (first.subframe.frameNo > 2048) 
-          {
-            first.subframe.frameNo -= 2048; 
-          }
-          else if (first.subframe.frameNo > 1024) 
-          {
-            first.subframe.frameNo -= 1024; 
-          }
-          txInfo.push_back(first); 
-        }
-      }
-    } // endif adjacency
+      second.rbStart = startRbSubch + subchReTxIdx*sizeSubch;
+    }
     else // non-adjacent
     {
-      first.subframe.subframeNo = subframe.subframeNo; 
       first.rbStart = startRbPscch + 2*pscchResource;
-      first.rbLen = 2;
-
-      if (sfGap != 0) 
-      {
-        SidelinkCommResourcePoolV2x::SidelinkTransmissionInfo second;
-        second.rbStart = startRbSubch + 2*subchReTxIdx;
-        second.rbLen = 2;
-
-        if (reTxIdx == 0)
-        {
-          // non-adjacent, retransmission occurs after initial transmission
-          for (uint8_t ctr = 0; ctr < reselCtr; ctr++)
-          { 
-            first.subframe.frameNo = subframe.frameNo + ctr*pRsvp/10; 
-
-            if (first.subframe.subframeNo + sfGap > 20)
-            {
-              second.subframe.frameNo = first.subframe.frameNo + 2; 
-              second.subframe.subframeNo = first.subframe.subframeNo + sfGap - 20; 
-            }
-            else if (first.subframe.subframeNo + sfGap > 10)
-            {
-              second.subframe.frameNo = first.subframe.frameNo + 1;
-              second.subframe.subframeNo = first.subframe.subframeNo + sfGap - 10; 
-            }
-            else
-            {
-              second.subframe.frameNo = first.subframe.frameNo; 
-              second.subframe.subframeNo = first.subframe.subframeNo + sfGap; 
-            }
-            if (first.subframe.frameNo > 2048) {
-              first.subframe.frameNo -= 2048; 
-            }
-            else if (first.subframe.frameNo > 1024) {
-              first.subframe.frameNo -= 1024;
-              second.subframe.frameNo -= 1024; 
-            }
-
-            txInfo.push_back(first);
-            txInfo.push_back(second);
-          }
-        }
-        else 
-        {
-          // non-adjacent, retransmission occurs before initial transmission
-          for (uint8_t ctr = 0; ctr < reselCtr; ctr++)
-          {
-            first.subframe.frameNo = subframe.frameNo + ctr*pRsvp/10; 
-
-            if (sfGap >= first.subframe.subframeNo + 10)
-            {
-              if(first.subframe.frameNo == 2)
-              {
-                second.subframe.frameNo = 1024;
-              }
-              else if (first.subframe.frameNo == 1)
-              {
-                second.subframe.frameNo = 1023;
-              }
-              else
-              {
-                second.subframe.frameNo = first.subframe.frameNo - 2; 
-              }
-              second.subframe.subframeNo = first.subframe.subframeNo + 20 - sfGap;               
-            }
-            else if (sfGap >= first.subframe.subframeNo)
-            {
-              if(first.subframe.frameNo == 1)
-              {
-                second.subframe.frameNo = 1024; 
-              }
-              else
-              {
-                second.subframe.frameNo = first.subframe.frameNo - 1; 
-              }
-              second.subframe.subframeNo = first.subframe.subframeNo + 10 - sfGap; 
-            }
-            else 
-            {
-              second.subframe.frameNo = first.subframe.frameNo;
-              second.subframe.subframeNo = first.subframe.subframeNo - sfGap; 
-            }
-            txInfo.push_back(second);
-            txInfo.push_back(first); 
-          }
-        }
-      } // endif sfGap != 0
-      else 
-      {
-        // non-adjacent, no retransmission
-        for(uint8_t ctr = 0; ctr < reselCtr; ctr++)
-        {
-          first.subframe.frameNo = subframe.frameNo + ctr*pRsvp/10; 
-          if (first.subframe.frameNo > 2048) 
-          {
-            first.subframe.frameNo -= 2048; 
-          }
-          else if (first.subframe.frameNo > 1024) 
-          {
-            first.subframe.frameNo -= 1024; 
-          }
-          txInfo.push_back(first); 
-        }
-      }
+      second.rbStart = startRbSubch + 2*subchReTxIdx;
     }
-    return txInfo;
+    return GetTransmissions (subframe, pRsvp, sfGap, reTxIdx, reselCtr, first, second);
   }
 
   std::list<SidelinkCommResourcePoolV2x::SidelinkTransmissionInfo>
   SidelinkCommResourcePoolV2x::GetPsschTransmissions (SidelinkCommResourcePoolV2x::SubframeInfo subframe, uint8_t riv, uint16_t pRsvp, uint8_t sfGap, uint8_t reTxIdx, uint8_t pscchResource, uint8_t reselCtr)
   {
     NS_ASSERT (subframe.frameNo > 0 && subframe.frameNo <= 1024 && subframe.subframeNo > 0 && subframe.subframeNo <= 10);
-
     bool adjacency = LteRrcSap::adjacencyAsBool(m_adjacencyPscchPssch);
-    uint8_t* tmp = GetValsFromRiv(riv);
-    uint16_t subchLen = tmp[0]; // number of contigious subchannels 
-    uint8_t subchReTxIdx = tmp[1]; // index for the subchannel of the retransmission
+    const RivValues& rivValues = GetValsFromRiv(riv);
+    uint16_t subchLen = rivValues.subchLen; // number of contigious subchannels 
+    uint8_t subchReTxIdx = rivValues.subchReTxIdx; // index for the subchannel of the retransmission
     uint16_t sizeSubch = LteRrcSap::sizeSubchannelAsInt(m_sizeSubchannel);
     uint16_t startRbSubch = LteRrcSap::startRbSubchannelAsInt(m_startRbSubchannel); // start of the resource pool for transmission
 
     // 36.213 14.1.1.4C
-    std::list<SidelinkCommResourcePoolV2x::SidelinkTransmissionInfo> txInfo;
     SidelinkCommResourcePoolV2x::SidelinkTransmissionInfo first;
+    SidelinkCommResourcePoolV2x::SidelinkTransmissionInfo second;
+    second.rbStart = startRbSubch + subchReTxIdx*sizeSubch+2;
+    second.rbLen = subchLen*sizeSubch-2;
 
     if(adjacency)
     { 
-      first.subframe.subframeNo = subframe.subframeNo; 
       first.rbStart = startRbSubch + pscchResource*sizeSubch+2;
       first.rbLen = subchLen*sizeSubch-2;
-
-      if(sfGap != 0)
-      {
-        SidelinkCommResourcePoolV2x::SidelinkTransmissionInfo second;
-        second.rbStart = startRbSubch + subchReTxIdx*sizeSubch+2;
-        second.rbLen = subchLen*sizeSubch-2;
-
-        if (reTxIdx == 0)
-        {
-          // adjacent, retransmission occurs after initial transmission
-          for (uint8_t ctr = 0; ctr < reselCtr; ctr++)
-          {
-            first.subframe.frameNo = subframe.frameNo + ctr*pRsvp/10;
-
-            if (first.subframe.subframeNo + sfGap > 20)
-            {
-              second.subframe.frameNo = subframe.frameNo + (ctr*pRsvp/10) + 2; 
-              second.subframe.subframeNo = first.subframe.subframeNo + sfGap - 20; 
-            }
-            else if (first.subframe.subframeNo + sfGap > 10)
-            {
-              second.subframe.frameNo = subframe.frameNo + (ctr*pRsvp/10) + 1;
-              second.subframe.subframeNo = first.subframe.subframeNo + sfGap - 10; 
-            }
-            else 
-            {
-              second.subframe.frameNo = subframe.frameNo + (ctr*pRsvp/10); 
-              second.subframe.subframeNo = first.subframe.subframeNo + sfGap; 
-            }
-
-            if (first.subframe.frameNo > 1024) {
-              first.subframe.frameNo -= 1024;
-              second.subframe.frameNo -= 1024; 
-            }
-            else if (first.subframe.frameNo > 2048) {
-              first.subframe.frameNo -= 2048;
-              second.subframe.frameNo -= 2048; 
-            }
-            else if (second.subframe.frameNo > 2048) {
-              second.subframe.frameNo -= 2048; 
-            }
-            else if (second.subframe.frameNo > 1024) {
-              second.subframe.frameNo -= 1024; 
-            }
-            txInfo.push_back(first);
-            txInfo.push_back(second);
-          }   
-        } // endif reTxIdx == 0
-        else
-        {
-          // adjacent, retransmission occurs before initial transmission+
-          for (uint8_t ctr = 0; ctr < reselCtr; ctr++)
-          {
-            first.subframe.frameNo = subframe.frameNo + ctr*pRsvp/10; 
-
-            if (sfGap >= first.subframe.subframeNo + 10)
-            {
-              if(first.subframe.frameNo == 2)
-              {
-                second.subframe.frameNo = 1024;
-              }
-              else if (first.subframe.frameNo == 1)
-              {
-                second.subframe.frameNo = 1023;
-              }
-              else
-              {
-                second.subframe.frameNo = first.subframe.frameNo - 2; 
-              }
-              second.subframe.subframeNo = first.subframe.subframeNo + 20 - sfGap;               
-            }
-            else if (sfGap >= first.subframe.subframeNo)
-            {
-              if(first.subframe.frameNo == 1)
-              {
-                second.subframe.frameNo = 1024; 
-              }
-              else
-              {
-                second.subframe.frameNo = first.subframe.frameNo - 1; 
-              }
-              second.subframe.subframeNo = first.subframe.subframeNo + 10 - sfGap; 
-            }
-            else 
-            {
-              second.subframe.frameNo = first.subframe.frameNo;
-              second.subframe.subframeNo = first.subframe.subframeNo - sfGap; 
-            }
-
-            txInfo.push_back(second);
-            txInfo.push_back(first); 
-          }
-        }
-      } // endif sfGap != 0
-      else
-      {
-        // adjacent, no retransmission
-        for(uint8_t ctr = 0; ctr < reselCtr; ctr++)
-        {
-          first.subframe.frameNo = subframe.frameNo + ctr*pRsvp/10; 
-          if (first.subframe.frameNo > 2048) 
-          {
-            first.subframe.frameNo -= 2048; 
-          }
-          else if (first.subframe.frameNo > 1024) 
-          {
-            first.subframe.frameNo -= 1024;
-          }
-
-          txInfo.push_back(first); 
-        }
-      }
-    } // endif adjacenct
+    }
     else 
     {
-      first.subframe.subframeNo = subframe.subframeNo; 
       first.rbStart = startRbSubch + pscchResource*sizeSubch;
       first.rbLen = subchLen*sizeSubch;
-
-      if (sfGap != 0)
-      {
-        SidelinkCommResourcePoolV2x::SidelinkTransmissionInfo second;
-        second.rbStart = startRbSubch + subchReTxIdx*sizeSubch+2;
-        second.rbLen = subchLen*sizeSubch-2;        
-
-        if (reTxIdx == 0)
-        {
-          // non-adjacent, retransmission occurs after initial transmission
-          for(uint8_t ctr = 0; ctr < reselCtr; ctr++)
-          {
-            first.subframe.frameNo = subframe.frameNo + ctr*pRsvp; 
-
-            if (first.subframe.subframeNo + sfGap > 20)
-            {
-              second.subframe.frameNo = first.subframe.frameNo + 2; 
-              second.subframe.subframeNo = first.subframe.subframeNo + sfGap - 20; 
-            }
-            else if (first.subframe.subframeNo + sfGap > 10)
-            {
-              second.subframe.frameNo = first.subframe.frameNo + 1;
-              second.subframe.subframeNo = first.subframe.subframeNo + sfGap - 10; 
-            }
-            else
-            {
-              second.subframe.frameNo = first.subframe.frameNo; 
-              second.subframe.subframeNo = first.subframe.subframeNo + sfGap; 
-            }
-            if (first.subframe.frameNo > 2048) {
-              first.subframe.frameNo -= 2048;
-              second.subframe.frameNo -= 2048;  
-            }
-            else if (first.subframe.frameNo > 1024)
-            {
-              first.subframe.frameNo -= 1024;
-              second.subframe.frameNo -= 1024; 
-            }
-
-            txInfo.push_back(first);
-            txInfo.push_back(second);
-          }
-        }
-        else
-        {
-          // non-adjacent, retransmission occurs before initial transmission
-          for(uint8_t ctr = 0; ctr < reselCtr; ctr++)
-          {
-            first.subframe.frameNo = subframe.frameNo + ctr*pRsvp; 
-
-            if (sfGap >= first.subframe.subframeNo + 10)
-            {
-              if(first.subframe.frameNo == 2)
-              {
-                second.subframe.frameNo = 1024;
-              }
-              else if (first.subframe.frameNo == 1)
-              {
-                second.subframe.frameNo = 1023;
-              }
-              else
-              {
-                second.subframe.frameNo = first.subframe.frameNo - 2; 
-              }
-              second.subframe.subframeNo = first.subframe.subframeNo + 20 - sfGap;               
-            }
-            else if (sfGap >= first.subframe.subframeNo)
-            {
-              if(first.subframe.frameNo == 1)
-              {
-                second.subframe.frameNo = 1024; 
-              }
-              else
-              {
-                second.subframe.frameNo = first.subframe.frameNo - 1; 
-              }
-              second.subframe.subframeNo = first.subframe.subframeNo + 10 - sfGap; 
-            }
-            else 
-            {
-              second.subframe.frameNo = first.subframe.frameNo;
-              second.subframe.subframeNo = first.subframe.subframeNo - sfGap; 
-            }
-            txInfo.push_back(first);
-            txInfo.push_back(second);
-          }
-        }
-      } // endif sfGap != 0
-      else
-      {
-        // non-adjacent, no retransmission 
-        for(uint8_t ctr = 0; ctr < reselCtr; ctr++)
-        {
-          first.subframe.frameNo = subframe.frameNo + ctr*pRsvp/10; 
-
-          if (first.subframe.frameNo > 2048)
-          {
-            first.subframe.frameNo -= 2048; 
-          }
-          else if (first.subframe.frameNo > 1024)
-          {
-            first.subframe.frameNo -= 1024; 
-          }
-          txInfo.push_back(first); 
-        }
-      }
     }
-    return txInfo;  
+    return GetTransmissions (subframe, pRsvp, sfGap, reTxIdx, reselCtr, first, second);
   }
   
   std::list<SidelinkCommResourcePoolV2x::SidelinkTransmissionInfo>
@@ -1391,8 +1020,7 @@ namespace ns3 {
     bool adjacency = LteRrcSap::adjacencyAsBool(m_adjacencyPscchPssch);
     uint16_t sizeSubch = LteRrcSap::sizeSubchannelAsInt(m_sizeSubchannel);
     uint16_t startRbSubch = LteRrcSap::startRbSubchannelAsInt(m_startRbSubchannel); // start of the resource pool for transmission
-    uint8_t* tmp = GetValsFromRiv(riv);
-    uint8_t subchLen = tmp[0]; // number of contigious subchannels 
+    uint8_t subchLen = GetValsFromRiv(riv).subchLen; // number of contigious subchannels 
 
     // 36.213 14.1.1.4C
     std::list<SidelinkCommResourcePoolV2x::SidelinkTransmissionInfo> txInfo;
@@ -1411,37 +1039,23 @@ namespace ns3 {
     return txInfo;  
   }
 
-  uint8_t*
-  SidelinkCommResourcePoolV2x::GetValsFromRiv(uint8_t riv)
+  const SidelinkCommResourcePoolV2x::SidelinkTransmissionInfo*
+  SidelinkCommResourcePoolV2x::GetPsschRxResources (uint8_t riv, uint8_t pscchResource) const
   {
-    uint16_t numSubchannel = LteRrcSap::numSubchannelAsInt(m_numSubchannel); // Number of subchannels per subframe
-    uint8_t *ptr; 
-    uint8_t vals[2]; // vals[0] := L_subCH, vals[1] := startSubchannelIdx
-    ptr = vals; 
-
-    for(uint16_t n=1; n<=numSubchannel;n++)
+    NS_ASSERT_MSG (!m_rivOffset.empty (), "the pool is not configured");
+    uint16_t offset = m_rivOffset[riv];
+    if (offset == std::numeric_limits<uint16_t>::max () || pscchResource >= LteRrcSap::numSubchannelAsInt(m_numSubchannel))
     {
-      for(uint16_t m=0; m<=(numSubchannel-n);m++)
-      {
-          if((n-1) <= std::floor(numSubchannel/2))
-          {
-              if(riv == (numSubchannel*(n-1)+m))
-              {
-                  vals[0] = n;
-                  vals[1] = m;
-              }
-          }
-          else
-          {
-              if(riv == (numSubchannel*(numSubchannel-n+1)+(numSubchannel-1-m)))
-              {
-                  vals[0] = n;
-                  vals[1] = m;
-              } 
-          } 
-      } 
+      return 0;
     }
-    return ptr; 
+    return &m_psschRxResources[offset + pscchResource];
+  }
+
+  const SidelinkCommResourcePoolV2x::RivValues&
+  SidelinkCommResourcePoolV2x::GetValsFromRiv(uint8_t riv) const
+  {
+    NS_ASSERT_MSG (!m_rivValues.empty (), "the pool is not configured");
+    return m_rivValues[riv];
   }
 
   uint16_t 
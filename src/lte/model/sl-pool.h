@@ -24,6 +24,7 @@
 #define SL_POOL_H
 
 #include <map>
+#include <ns3/assert.h>
 #include "lte-rrc-sap.h"
 
 namespace ns3 {
@@ -340,10 +341,86 @@ namespace ns3 {
       UE_SELECTED
     };
 
+    /** Number of subframes in the cycle of the system frame numbers (1024 frames of 10 subframes) */
+    static const uint32_t SUBFRAME_CYCLE = 10240;
+
     /** Identify the location of a subframe by its frame number and subframe number */
     struct SubframeInfo {
-      uint32_t frameNo; //!<The frame number
-      uint32_t subframeNo; //!<The subframe number
+      uint32_t frameNo; //!<The frame number [1..1024]
+      uint32_t subframeNo; //!<The subframe number [1..10]
+
+    /**
+     * Returns the absolute position of the subframe in the cycle of 1024 frames
+     * \return the subframe index [0..SUBFRAME_CYCLE-1]
+     */
+    uint32_t GetIndex (void) const
+    {
+      NS_ASSERT (frameNo > 0 && frameNo <= 1024 && subframeNo > 0 && subframeNo <= 10);
+      return 10 * (frameNo - 1) + subframeNo - 1;
+    }
+
+    /**
+     * Returns the subframe at an absolute position of the cycle of 1024 frames
+     * \param index the subframe index, taken modulo SUBFRAME_CYCLE
+     * \return the subframe location
+     */
+    static SubframeInfo FromIndex (uint32_t index)
+    {
+      SubframeInfo res;
+      index %= SUBFRAME_CYCLE;
+      res.frameNo = index / 10 + 1;
+      res.subframeNo = index % 10 + 1;
+      return res;
+    }
+
+    /**
+     * Returns the index of the subframe located a number of subframes after
+     * (or before if negative) a subframe index, wrapping around the cycle of
+     * 1024 frames
+     * \param index the subframe index, taken modulo SUBFRAME_CYCLE
+     * \param delta the number of subframes
+     * \return the subframe index [0..SUBFRAME_CYCLE-1]
+     */
+    static uint32_t OffsetIndex (uint32_t index, int32_t delta)
+    {
+      int32_t res = (int32_t) (index % SUBFRAME_CYCLE) + delta % (int32_t) SUBFRAME_CYCLE;
+      return (res + SUBFRAME_CYCLE) % SUBFRAME_CYCLE;
+    }
+
+    /**
+     * Returns the number of subframes from a subframe index to a later one,
+     * wrapping around the cycle of 1024 frames
+     * \param from the index of the earlier subframe
+     * \param to the index of the later subframe
+     * \return the distance in subframes [0..SUBFRAME_CYCLE-1]
+     */
+    static uint32_t GetIndexDistance (uint32_t from, uint32_t to)
+    {
+      return (to % SUBFRAME_CYCLE + SUBFRAME_CYCLE - from % SUBFRAME_CYCLE) % SUBFRAME_CYCLE;
+    }
+
+    /**
+     * Returns the subframe located a number of subframes after (or before
+     * if negative) this one, wrapping around the cycle of 1024 frames
+     * \param delta the number of subframes
+     * \return the subframe location
+     */
+    SubframeInfo Offset (int32_t delta) const
+    {
+      return FromIndex (OffsetIndex (GetIndex (), delta));
+    }
+
+    /**
+     * Returns the number of subframes from a subframe to a later one,
+     * wrapping around the cycle of 1024 frames
+     * \param from the earlier subframe
+     * \param to the later subframe
+     * \return the distance in subframes [0..SUBFRAME_CYCLE-1]
+     */
+    static uint32_t GetDistance (const SubframeInfo& from, const SubframeInfo& to)
+    {
+      return GetIndexDistance (from.GetIndex (), to.GetIndex ());
+    }
 
     /**
      * Adds two subframe locations and return the new location
@@ -452,6 +529,16 @@ namespace ns3 {
      */    
     std::list<SidelinkTransmissionInfo> GetPsschTransmissions (uint8_t riv, uint8_t pscchResource);
 
+    /**
+     * Returns the RBs associated with the transmission on PSSCH indicated by
+     * a received SCI, from the table computed when the pool is configured
+     * \param riv The resource indication value
+     * \param pscchResource The resource of the control data
+     * \return the RBs associated with the transmission on PSSCH, or 0 if the
+     *         RIV or the resource of the control data is not valid for the pool
+     */
+    const SidelinkTransmissionInfo* GetPsschRxResources (uint8_t riv, uint8_t pscchResource) const;
+
     /**
      * Returns the subframes and RBs associated with the transmission on PSCCH
      * \param subframe The actual subframe
@@ -489,6 +576,13 @@ namespace ns3 {
 
   private: 
 
+    /** Frequency allocation indicated by a resource indication value */
+    struct RivValues
+    {
+      uint8_t subchLen; //!< The number of contiguous subchannels
+      uint8_t subchReTxIdx; //!< The index of the subchannel of the retransmission
+    };
+
     /**
      * Compute the frames/RBs that are part of the PSCCH pool
      */
@@ -497,6 +591,24 @@ namespace ns3 {
      * Compute the frame/RBS that are part of the PSSCH pool
      */
     void ComputeNumberOfPsschResources ();
+    /**
+     * Decode all the resource indication values of the pool and compute the
+     * RBs of the PSSCH transmissions they indicate
+     */
+    void ComputeRivTables ();
+    /**
+     * Place the initial transmissions and the retransmissions of a grant in time,
+     * in the order they occur
+     * \param subframe first subframe of the grant
+     * \param pRsvp resource reservation interval in ms
+     * \param sfGap gap in subframes between the initial transmission and the retransmission (0 if none)
+     * \param reTxIdx 0 if the retransmission follows the initial transmission, 1 if it precedes it
+     * \param reselCtr number of reservations
+     * \param first the RBs of the initial transmission
+     * \param second the RBs of the retransmission
+     * \return the transmissions
+     */
+    static std::list<SidelinkTransmissionInfo> GetTransmissions (SubframeInfo subframe, uint16_t pRsvp, uint8_t sfGap, uint8_t reTxIdx, uint8_t reselCtr, SidelinkTransmissionInfo first, SidelinkTransmissionInfo second);
 
     /**
      * \brief See 36.213 section 14.2.1 V15.0.0  
@@ -505,16 +617,20 @@ namespace ns3 {
    
     /**
      * \brief See 36.213 section 14.1.1.4C V15.0.0  
-     * \return frequency location of initial transmission and retransmission; return [startSubchannelIdx,lSubchannel]
+     * \return frequency location of initial transmission and retransmission
      * \param riv(resource indication value)
      */
-    uint8_t* GetValsFromRiv(uint8_t riv); 
+    const RivValues& GetValsFromRiv(uint8_t riv) const; 
 
     uint32_t m_rbpscch;
     std::vector <uint32_t> m_rbpscchVector; // list of RBs that belong to PSCCH pool
     uint32_t m_rbpssch;
     std::vector <uint32_t> m_rbpsschVector; // list of Rbs that belong to PSSCH pool
 
+    std::vector <RivValues> m_rivValues; // decoded resource indication values, indexed by RIV
+    std::vector <uint16_t> m_rivOffset; // offset of the entries of each RIV in m_psschRxResources, indexed by RIV
+    std::vector <SidelinkTransmissionInfo> m_psschRxResources; // PSSCH RBs of each valid RIV, indexed by PSCCH resource
+
     bool m_preconfigured; // indicates if the pool is preconfigured
 
   }; 
@@ -0,0 +1,137 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "spectrum-signal-codec.h"
+#include <ns3/log.h>
+#include <ns3/abort.h>
+#include <ns3/buffer.h>
+#include <ns3/tag.h>
+#include <ns3/tag-buffer.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("SpectrumSignalCodec");
+
+NS_OBJECT_ENSURE_REGISTERED (SpectrumSignalCodec);
+
+TypeId
+SpectrumSignalCodec::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::SpectrumSignalCodec")
+    .SetParent<Object> ()
+    .SetGroupName ("Lte")
+  ;
+  return tid;
+}
+
+SpectrumSignalCodec::~SpectrumSignalCodec ()
+{
+}
+
+void
+SpectrumSignalCodec::AddPacket (Ptr<Packet> payload, Ptr<const Packet> p)
+{
+  NS_LOG_FUNCTION (payload << p);
+
+  // length, packet size, packet, number of tags
+  uint32_t packetSize = p->GetSerializedSize ();
+  uint32_t size = 4 + 4 + packetSize + 4;
+
+  std::vector<std::pair<std::string, std::vector<uint8_t> > > tags;
+  PacketTagIterator it = p->GetPacketTagIterator ();
+  while (it.HasNext ())
+    {
+      PacketTagIterator::Item item = it.Next ();
+      TypeId tid = item.GetTypeId ();
+      NS_ABORT_MSG_UNLESS (tid.HasConstructor (), "The packet tag " << tid.GetName () << " has no constructor");
+      Tag *tag = dynamic_cast<Tag *> (tid.GetConstructor () ());
+      NS_ASSERT (tag != 0);
+      item.GetTag (*tag);
+      std::vector<uint8_t> data (tag->GetSerializedSize ());
+      tag->Serialize (TagBuffer (data.data (), data.data () + data.size ()));
+      delete tag;
+      // name length, name, tag size, tag
+      size += 2 + tid.GetName ().size () + 4 + data.size ();
+      tags.push_back (std::make_pair (tid.GetName (), data));
+    }
+
+  std::vector<uint8_t> packetData (packetSize);
+  p->Serialize (packetData.data (), packetSize);
+
+  Buffer buffer;
+  buffer.AddAtStart (size);
+  Buffer::Iterator i = buffer.Begin ();
+  i.WriteHtonU32 (size - 4);
+  i.WriteHtonU32 (packetSize);
+  i.Write (packetData.data (), packetSize);
+  i.WriteHtonU32 (tags.size ());
+  for (std::vector<std::pair<std::string, std::vector<uint8_t> > >::const_iterator tag = tags.begin ();
+       tag != tags.end (); ++tag)
+    {
+      i.WriteHtonU16 (tag->first.size ());
+      i.Write (reinterpret_cast<const uint8_t *> (tag->first.data ()), tag->first.size ());
+      i.WriteHtonU32 (tag->second.size ());
+      i.Write (tag->second.data (), tag->second.size ());
+    }
+  payload->AddAtEnd (Create<Packet> (buffer.PeekData (), size));
+}
+
+Ptr<Packet>
+SpectrumSignalCodec::RemovePacket (Ptr<Packet> payload)
+{
+  NS_LOG_FUNCTION (payload);
+
+  NS_ASSERT (payload->GetSize () >= 4);
+  uint8_t lengthData[4];
+  payload->CopyData (lengthData, 4);
+  uint32_t size = 4 + ((uint32_t (lengthData[0]) << 24) | (uint32_t (lengthData[1]) << 16)
+                       | (uint32_t (lengthData[2]) << 8) | uint32_t (lengthData[3]));
+  NS_ASSERT (payload->GetSize () >= size);
+  std::vector<uint8_t> data (size);
+  payload->CopyData (data.data (), size);
+  payload->RemoveAtStart (size);
+
+  Buffer buffer;
+  buffer.AddAtStart (size);
+  buffer.Begin ().Write (data.data (), size);
+  Buffer::Iterator i = buffer.Begin ();
+  i.Next (4);
+  uint32_t packetSize = i.ReadNtohU32 ();
+  std::vector<uint8_t> packetData (packetSize);
+  i.Read (packetData.data (), packetSize);
+  Ptr<Packet> p = Create<Packet> (packetData.data (), packetSize, true);
+
+  uint32_t nTags = i.ReadNtohU32 ();
+  for (uint32_t n = 0; n < nTags; n++)
+    {
+      std::string name (i.ReadNtohU16 (), '\0');
+      i.Read (reinterpret_cast<uint8_t *> (&name[0]), name.size ());
+      std::vector<uint8_t> tagData (i.ReadNtohU32 ());
+      i.Read (tagData.data (), tagData.size ());
+      TypeId tid = TypeId::LookupByName (name);
+      Tag *tag = dynamic_cast<Tag *> (tid.GetConstructor () ());
+      NS_ASSERT (tag != 0);
+      tag->Deserialize (TagBuffer (tagData.data (), tagData.data () + tagData.size ()));
+      p->AddPacketTag (*tag);
+      delete tag;
+    }
+  return p;
+}
+
+} // namespace ns3
@@ -0,0 +1,83 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef SPECTRUM_SIGNAL_CODEC_H
+#define SPECTRUM_SIGNAL_CODEC_H
+
+#include <ns3/object.h>
+#include <ns3/packet.h>
+#include <ns3/spectrum-signal-parameters.h>
+
+namespace ns3 {
+
+/**
+ * \ingroup lte
+ *
+ * Convert the signal parameters specific to a wireless technology to
+ * bytes and back, so that a DistributedSpectrumChannel can send the
+ * signals to the receivers simulated by the other systems.
+ *
+ * The generic parameters (psd, duration, txPhy and txAntenna) are
+ * handled by the channel.
+ */
+class SpectrumSignalCodec : public Object
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  virtual ~SpectrumSignalCodec ();
+
+  /**
+   * \param params the parameters of a transmitted signal
+   * \return the encoded parameters specific to the technology, or 0 if
+   * the codec does not support the type of params
+   */
+  virtual Ptr<Packet> Encode (Ptr<const SpectrumSignalParameters> params) const = 0;
+
+  /**
+   * \param payload the packet returned by Encode
+   * \return the decoded parameters, with the generic parameters unset
+   */
+  virtual Ptr<SpectrumSignalParameters> Decode (Ptr<Packet> payload) const = 0;
+
+protected:
+  /**
+   * Append a packet to a payload, along with its packet tags, which
+   * Packet::Serialize leaves out.
+   *
+   * The tags must have a constructor registered in their TypeId.
+   *
+   * \param payload the payload
+   * \param p the packet
+   */
+  static void AddPacket (Ptr<Packet> payload, Ptr<const Packet> p);
+
+  /**
+   * Remove from the start of a payload a packet appended by AddPacket.
+   *
+   * \param payload the payload
+   * \return the packet, with its packet tags
+   */
+  static Ptr<Packet> RemovePacket (Ptr<Packet> payload);
+};
+
+} // namespace ns3
+
+#endif /* SPECTRUM_SIGNAL_CODEC_H */
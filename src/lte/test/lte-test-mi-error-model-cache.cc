@@ -0,0 +1,154 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <ns3/log.h>
+#include <ns3/test.h>
+#include <ns3/lte-mi-error-model.h>
+#include <cmath>
+
+
+NS_LOG_COMPONENT_DEFINE ("LteTestMiErrorModelCache");
+
+using namespace ns3;
+
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * Check the TB statistics returned by LteMiErrorModelCache against the
+ * exact LteMiErrorModel path, and its lookup and validation counters.
+ */
+class LteMiErrorModelCacheTestCase : public TestCase
+{
+public:
+  LteMiErrorModelCacheTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+LteMiErrorModelCacheTestCase::LteMiErrorModelCacheTestCase ()
+  : TestCase ("MI error model cache")
+{
+}
+
+void
+LteMiErrorModelCacheTestCase::DoRun (void)
+{
+  const uint8_t mcs = 10;
+  const uint16_t size = 190;
+  std::vector<double> freqs;
+  for (uint32_t i = 0; i < 50; i++)
+    {
+      freqs.push_back (5.9e9 + i * 180e3);
+    }
+  SpectrumValue sinr (Create<SpectrumModel> (freqs));
+  std::vector<int> map;
+  for (int i = 10; i < 20; i++)
+    {
+      map.push_back (i);
+    }
+  HarqProcessInfoList_t noHistory;
+
+  // disabled cache: exact path
+  LteMiErrorModelCache cache;
+  sinr = std::pow (10.0, 0.3);
+  TbStats_t exact = LteMiErrorModel::GetTbDecodificationStats (sinr, map, size, mcs, noHistory);
+  TbStats_t stats = cache.GetTbDecodificationStats (sinr, map, size, mcs, noHistory);
+  NS_TEST_ASSERT_MSG_EQ (stats.tbler, exact.tbler, "disabled cache differs from the exact path");
+  NS_TEST_ASSERT_MSG_EQ (cache.GetStats ().lookups, (uint64_t) 0, "disabled cache was looked up");
+
+  // first lookup: the exact MIB and the TBLER at the center of its bucket, then a hit
+  cache.SetStep (0.01);
+  double center = std::floor (exact.mi / 0.01 + 0.5) * 0.01;
+  TbStats_t centerStats = LteMiErrorModel::GetTbDecodificationStats (center, size, mcs, noHistory);
+  stats = cache.GetTbDecodificationStats (sinr, map, size, mcs, noHistory);
+  NS_TEST_ASSERT_MSG_EQ_TOL (stats.tbler, centerStats.tbler, 1e-12, "wrong cached TBLER");
+  NS_TEST_ASSERT_MSG_EQ (stats.mi, exact.mi, "the returned MI is not the exact MIB");
+  stats = cache.GetTbDecodificationStats (sinr, map, size, mcs, noHistory);
+  NS_TEST_ASSERT_MSG_EQ_TOL (stats.tbler, centerStats.tbler, 1e-12, "wrong TBLER on a cache hit");
+  NS_TEST_ASSERT_MSG_EQ (cache.GetStats ().lookups, (uint64_t) 2, "wrong number of lookups");
+  NS_TEST_ASSERT_MSG_EQ (cache.GetStats ().hits, (uint64_t) 1, "wrong number of hits");
+
+  // the same MIB on fewer RBs is a hit
+  std::vector<int> halfMap (map.begin (), map.begin () + map.size () / 2);
+  stats = cache.GetTbDecodificationStats (sinr, halfMap, size, mcs, noHistory);
+  NS_TEST_ASSERT_MSG_EQ (cache.GetStats ().hits, (uint64_t) 2, "the same MIB on fewer RBs was not a hit");
+  NS_TEST_ASSERT_MSG_EQ_TOL (stats.tbler, centerStats.tbler, 1e-12, "wrong TBLER on fewer RBs");
+
+  // retransmissions bypass the cache
+  HarqProcessInfoList_t history;
+  HarqProcessInfoElement_t el;
+  el.m_mi = exact.mi;
+  el.m_rv = 1;
+  el.m_sinr = 0.0;
+  el.m_infoBits = size * 8;
+  el.m_codeBits = size * 8 / 0.5;
+  history.push_back (el);
+  exact = LteMiErrorModel::GetTbDecodificationStats (sinr, map, size, mcs, history);
+  stats = cache.GetTbDecodificationStats (sinr, map, size, mcs, history);
+  NS_TEST_ASSERT_MSG_EQ (stats.tbler, exact.tbler, "retransmission did not use the exact path");
+  NS_TEST_ASSERT_MSG_EQ (cache.GetStats ().lookups, (uint64_t) 3, "retransmission was looked up");
+
+  // validation of MIBs off the bucket centers, in a frequency selective
+  // channel: the error must decrease with a finer quantization
+  LteMiErrorModelCache fineCache;
+  fineCache.SetStep (0.001);
+  cache.SetValidationEnabled (true);
+  fineCache.SetValidationEnabled (true);
+  double maxError = 0.0;
+  for (uint32_t k = 0; k < 20; k++)
+    {
+      for (uint32_t i = 0; i < map.size (); i++)
+        {
+          sinr[map[i]] = std::pow (10.0, (1.0 + 0.13 * k + (i % 2 ? 0.2 : -0.2)) / 10);
+        }
+      exact = LteMiErrorModel::GetTbDecodificationStats (sinr, map, size, mcs, noHistory);
+      stats = cache.GetTbDecodificationStats (sinr, map, size, mcs, noHistory);
+      maxError = std::max (maxError, std::abs (stats.tbler - exact.tbler));
+      fineCache.GetTbDecodificationStats (sinr, map, size, mcs, noHistory);
+    }
+  LteMiErrorModelCache::Stats cacheStats = cache.GetStats ();
+  LteMiErrorModelCache::Stats fineStats = fineCache.GetStats ();
+  NS_TEST_ASSERT_MSG_EQ (cacheStats.validated, (uint64_t) 20, "wrong number of validated TBs");
+  NS_TEST_ASSERT_MSG_EQ_TOL (cacheStats.maxError, maxError, 1e-12, "wrong maximum error");
+  NS_TEST_ASSERT_MSG_LT_OR_EQ (cacheStats.sumError, 20 * cacheStats.maxError, "inconsistent error sum");
+  NS_TEST_ASSERT_MSG_LT (fineStats.maxError, cacheStats.maxError, "finer step did not reduce the maximum error");
+  NS_TEST_ASSERT_MSG_LT (fineStats.sumError, cacheStats.sumError, "finer step did not reduce the mean error");
+  NS_TEST_ASSERT_MSG_LT (fineStats.maxError, 0.01, "TBLER error too large for a 0.001 MIB step");
+  NS_TEST_ASSERT_MSG_GT_OR_EQ (LteMiErrorModelCache::GetGlobalStats ().validated, (uint64_t) 40, "cache missing from the global counters");
+}
+
+
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * Test suite of the MI error model cache.
+ */
+class LteMiErrorModelCacheTestSuite : public TestSuite
+{
+public:
+  LteMiErrorModelCacheTestSuite ();
+};
+
+LteMiErrorModelCacheTestSuite::LteMiErrorModelCacheTestSuite ()
+  : TestSuite ("lte-mi-error-model-cache", UNIT)
+{
+  AddTestCase (new LteMiErrorModelCacheTestCase, TestCase::QUICK);
+}
+
+static LteMiErrorModelCacheTestSuite g_lteMiErrorModelCacheTestSuite;
@@ -0,0 +1,148 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <ns3/log.h>
+#include <ns3/test.h>
+#include <ns3/packet-burst.h>
+#include <ns3/lte-sl-signal-codec.h>
+#include <ns3/lte-spectrum-signal-parameters.h>
+#include <ns3/lte-control-messages.h>
+#include <ns3/lte-radio-bearer-tag.h>
+#include <ns3/lte-rlc-tag.h>
+
+
+NS_LOG_COMPONENT_DEFINE ("LteTestSlSignalCodec");
+
+using namespace ns3;
+
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * Encode a V2X sidelink frame with the LteSlSignalCodec, as sent to the
+ * other systems by a DistributedSpectrumChannel, and check the decoded
+ * frame: the SCI, the packets and their packet tags.
+ */
+class LteSlSignalCodecTestCase : public TestCase
+{
+public:
+  LteSlSignalCodecTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+LteSlSignalCodecTestCase::LteSlSignalCodecTestCase ()
+  : TestCase ("Sidelink frame encoding")
+{
+}
+
+void
+LteSlSignalCodecTestCase::DoRun (void)
+{
+  Ptr<LteSlSignalCodec> codec = CreateObject<LteSlSignalCodec> ();
+
+  Ptr<LteSpectrumSignalParametersSlFrame> frame = Create<LteSpectrumSignalParametersSlFrame> ();
+  frame->nodeId = 42;
+  frame->groupId = 3;
+  frame->slssId = 0x123456789aULL;
+  SciListElementV2x sci;
+  sci.m_rnti = 17;
+  sci.m_prio = 2;
+  sci.m_pRsvp = 100;
+  sci.m_riv = 513;
+  sci.m_sfGap = 4;
+  sci.m_mcs = 20;
+  sci.m_reTxIdx = 1;
+  sci.m_resPscch = 6;
+  sci.m_tbSize = 1544;
+  Ptr<SciLteControlMessageV2x> msg = Create<SciLteControlMessageV2x> ();
+  msg->SetSci (sci);
+  frame->ctrlMsgList.push_back (msg);
+  frame->packetBurst = CreateObject<PacketBurst> ();
+  for (uint32_t n = 0; n < 2; n++)
+    {
+      Ptr<Packet> p = Create<Packet> (190 + n);
+      p->AddPacketTag (LteRadioBearerTag (17, 3 + n, 0x11, 0x22));
+      p->AddPacketTag (RlcTag (MilliSeconds (1500 + n)));
+      frame->packetBurst->AddPacket (p);
+    }
+
+  Ptr<Packet> payload = codec->Encode (frame);
+  NS_TEST_ASSERT_MSG_NE (payload, 0, "the sidelink frame is not supported");
+  NS_TEST_ASSERT_MSG_EQ (codec->Encode (Create<LteSpectrumSignalParametersDataFrame> ()), 0, "a data frame is supported");
+
+  // as received by another system
+  uint32_t size = payload->GetSerializedSize ();
+  std::vector<uint8_t> buffer (size);
+  payload->Serialize (buffer.data (), size);
+  Ptr<LteSpectrumSignalParametersSlFrame> decoded = DynamicCast<LteSpectrumSignalParametersSlFrame> (codec->Decode (Create<Packet> (buffer.data (), size, true)));
+  NS_TEST_ASSERT_MSG_NE (decoded, 0, "not a sidelink frame");
+
+  NS_TEST_ASSERT_MSG_EQ (decoded->nodeId, 42, "wrong node");
+  NS_TEST_ASSERT_MSG_EQ ((uint32_t) decoded->groupId, 3, "wrong group");
+  NS_TEST_ASSERT_MSG_EQ (decoded->slssId, 0x123456789aULL, "wrong SLSS id");
+  NS_TEST_ASSERT_MSG_EQ (decoded->ctrlMsgList.size (), 1, "wrong number of control messages");
+  Ptr<SciLteControlMessageV2x> decodedMsg = DynamicCast<SciLteControlMessageV2x> (decoded->ctrlMsgList.front ());
+  NS_TEST_ASSERT_MSG_EQ (decodedMsg->GetMessageType (), LteControlMessage::SCI_V2X, "wrong control message");
+  SciListElementV2x decodedSci = decodedMsg->GetSci ();
+  NS_TEST_ASSERT_MSG_EQ (decodedSci.m_rnti, sci.m_rnti, "wrong RNTI");
+  NS_TEST_ASSERT_MSG_EQ ((uint32_t) decodedSci.m_prio, (uint32_t) sci.m_prio, "wrong priority");
+  NS_TEST_ASSERT_MSG_EQ (decodedSci.m_pRsvp, sci.m_pRsvp, "wrong reservation interval");
+  NS_TEST_ASSERT_MSG_EQ (decodedSci.m_riv, sci.m_riv, "wrong RIV");
+  NS_TEST_ASSERT_MSG_EQ ((uint32_t) decodedSci.m_sfGap, (uint32_t) sci.m_sfGap, "wrong subframe gap");
+  NS_TEST_ASSERT_MSG_EQ ((uint32_t) decodedSci.m_mcs, (uint32_t) sci.m_mcs, "wrong MCS");
+  NS_TEST_ASSERT_MSG_EQ ((uint32_t) decodedSci.m_reTxIdx, (uint32_t) sci.m_reTxIdx, "wrong retransmission index");
+  NS_TEST_ASSERT_MSG_EQ (decodedSci.m_resPscch, sci.m_resPscch, "wrong PSCCH resource");
+  NS_TEST_ASSERT_MSG_EQ (decodedSci.m_tbSize, sci.m_tbSize, "wrong TB size");
+
+  NS_TEST_ASSERT_MSG_EQ (decoded->packetBurst->GetNPackets (), 2, "wrong number of packets");
+  uint32_t n = 0;
+  for (std::list<Ptr<Packet> >::const_iterator p = decoded->packetBurst->Begin (); p != decoded->packetBurst->End (); ++p, ++n)
+    {
+      NS_TEST_ASSERT_MSG_EQ ((*p)->GetSize (), 190 + n, "wrong packet size");
+      LteRadioBearerTag bearerTag;
+      NS_TEST_ASSERT_MSG_EQ ((*p)->PeekPacketTag (bearerTag), true, "missing bearer tag");
+      NS_TEST_ASSERT_MSG_EQ (bearerTag.GetRnti (), 17, "wrong RNTI in the bearer tag");
+      NS_TEST_ASSERT_MSG_EQ ((uint32_t) bearerTag.GetLcid (), 3 + n, "wrong LCID in the bearer tag");
+      NS_TEST_ASSERT_MSG_EQ (bearerTag.GetDestinationL2Id (), 0x22, "wrong destination in the bearer tag");
+      RlcTag rlcTag;
+      NS_TEST_ASSERT_MSG_EQ ((*p)->PeekPacketTag (rlcTag), true, "missing RLC tag");
+      NS_TEST_ASSERT_MSG_EQ (rlcTag.GetSenderTimestamp (), MilliSeconds (1500 + n), "wrong RLC timestamp");
+    }
+}
+
+
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * Test suite of the encoding of the sidelink frames sent to the other
+ * systems of a distributed simulation.
+ */
+class LteSlSignalCodecTestSuite : public TestSuite
+{
+public:
+  LteSlSignalCodecTestSuite ();
+};
+
+LteSlSignalCodecTestSuite::LteSlSignalCodecTestSuite ()
+  : TestSuite ("lte-sl-signal-codec", UNIT)
+{
+  AddTestCase (new LteSlSignalCodecTestCase, TestCase::QUICK);
+}
+
+static LteSlSignalCodecTestSuite g_lteSlSignalCodecTestSuite;
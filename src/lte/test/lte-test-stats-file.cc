@@ -0,0 +1,209 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <ns3/log.h>
+#include <ns3/test.h>
+#include <ns3/simulator.h>
+#include <ns3/lte-stats-file.h>
+#include <ns3/phy-tx-stats-calculator.h>
+#include <fstream>
+#include <sstream>
+
+
+NS_LOG_COMPONENT_DEFINE ("LteTestStatsFile");
+
+using namespace ns3;
+
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * Write the same records to a text and a binary LteStatsFile, and check
+ * the text file against the line format of the statistics calculators and
+ * the conversion of the binary file against the text file.
+ */
+class LteStatsFileTestCase : public TestCase
+{
+public:
+  LteStatsFileTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Write the test records
+   * \param filename the name of the file
+   * \param binary whether the file is in the binary format
+   */
+  void WriteRecords (std::string filename, bool binary);
+  /**
+   * \param filename the name of a file
+   * \return the content of the file
+   */
+  static std::string ReadFile (std::string filename);
+};
+
+LteStatsFileTestCase::LteStatsFileTestCase ()
+  : TestCase ("Stats file text and binary formats")
+{
+}
+
+void
+LteStatsFileTestCase::WriteRecords (std::string filename, bool binary)
+{
+  Ptr<LteStatsFile> file = Create<LteStatsFile> ();
+  file->AddColumn ("time", LteStatsFile::INT64);
+  file->AddColumn ("IMSI", LteStatsFile::UINT64);
+  file->AddColumn ("RNTI", LteStatsFile::UINT16);
+  file->AddColumn ("mcs", LteStatsFile::UINT8);
+  file->AddColumn ("frame", LteStatsFile::UINT32);
+  file->AddColumn ("sinr", LteStatsFile::DOUBLE);
+  NS_TEST_ASSERT_MSG_EQ (file->Open (filename, binary), true, "can't open " << filename);
+  for (uint32_t i = 0; i < 3; i++)
+    {
+      file->Write ((int64_t) (1000 + i));
+      file->Write ((uint64_t) 123456789012ULL * i);
+      file->Write ((uint16_t) (i + 1));
+      file->Write ((uint8_t) (20 + i));
+      file->Write ((uint32_t) 1024 * i);
+      file->Write (0.1 * i + 1.0 / 3);
+    }
+}
+
+std::string
+LteStatsFileTestCase::ReadFile (std::string filename)
+{
+  std::ifstream in (filename.c_str (), std::ios_base::in | std::ios_base::binary);
+  std::ostringstream content;
+  content << in.rdbuf ();
+  return content.str ();
+}
+
+void
+LteStatsFileTestCase::DoRun (void)
+{
+  std::string textFilename = CreateTempDirFilename ("stats.txt");
+  std::string binaryFilename = CreateTempDirFilename ("stats.bin");
+  WriteRecords (textFilename, false);
+  WriteRecords (binaryFilename, true);
+  // the files are flushed when the simulation is destroyed
+  Simulator::Destroy ();
+
+  // same lines as the ones written by the statistics calculators
+  std::ostringstream expected;
+  expected << "% time\tIMSI\tRNTI\tmcs\tframe\tsinr" << std::endl;
+  for (uint32_t i = 0; i < 3; i++)
+    {
+      expected << (int64_t) (1000 + i) << "\t";
+      expected << (uint64_t) 123456789012ULL * i << "\t";
+      expected << (uint16_t) (i + 1) << "\t";
+      expected << (uint32_t) (uint8_t) (20 + i) << "\t";
+      expected << (uint32_t) 1024 * i << "\t";
+      expected << 0.1 * i + 1.0 / 3 << std::endl;
+    }
+  std::string text = ReadFile (textFilename);
+  NS_TEST_ASSERT_MSG_EQ (text, expected.str (), "wrong text file");
+
+  std::ifstream binary (binaryFilename.c_str (), std::ios_base::in | std::ios_base::binary);
+  std::ostringstream converted;
+  NS_TEST_ASSERT_MSG_EQ (LteStatsFile::ConvertToText (binary, converted, '\t', true), true, "invalid binary file");
+  NS_TEST_ASSERT_MSG_EQ (converted.str (), text, "binary file not converted to the text file");
+
+  binary.clear ();
+  binary.seekg (0);
+  std::ostringstream csv;
+  NS_TEST_ASSERT_MSG_EQ (LteStatsFile::ConvertToText (binary, csv, ',', false), true, "invalid binary file");
+  NS_TEST_ASSERT_MSG_EQ (csv.str ().substr (0, csv.str ().find ('\n')), "time,IMSI,RNTI,mcs,frame,sinr", "wrong CSV header");
+
+  std::istringstream notBinary (text);
+  std::ostringstream dummy;
+  NS_TEST_ASSERT_MSG_EQ (LteStatsFile::ConvertToText (notBinary, dummy, ',', false), false, "text file accepted as binary");
+}
+
+
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * Write a record with a statistics calculator and check that
+ * FlushOutputFiles writes it to the file before the simulation is
+ * destroyed.
+ */
+class LteStatsCalculatorFlushTestCase : public TestCase
+{
+public:
+  LteStatsCalculatorFlushTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+LteStatsCalculatorFlushTestCase::LteStatsCalculatorFlushTestCase ()
+  : TestCase ("Flush the output files of a statistics calculator")
+{
+}
+
+void
+LteStatsCalculatorFlushTestCase::DoRun (void)
+{
+  std::string filename = CreateTempDirFilename ("DlTxPhyStats.txt");
+  Ptr<PhyTxStatsCalculator> calculator = CreateObject<PhyTxStatsCalculator> ();
+  calculator->SetDlTxOutputFilename (filename);
+  PhyTransmissionStatParameters params;
+  params.m_timestamp = 1000;
+  params.m_cellId = 1;
+  params.m_imsi = 2;
+  params.m_rnti = 3;
+  params.m_txMode = 0;
+  params.m_layer = 0;
+  params.m_mcs = 20;
+  params.m_size = 1000;
+  params.m_rv = 0;
+  params.m_ndi = 1;
+  params.m_ccId = 0;
+  calculator->DlPhyTransmission (params);
+  calculator->FlushOutputFiles ();
+
+  std::ifstream in (filename.c_str ());
+  std::string header;
+  std::string record;
+  std::getline (in, header);
+  std::getline (in, record);
+  NS_TEST_ASSERT_MSG_EQ (header.substr (0, 7), "% time\t", "wrong header");
+  NS_TEST_ASSERT_MSG_EQ (record, "1000\t1\t2\t3\t0\t20\t1000\t0\t1\t0", "record not written by FlushOutputFiles");
+  Simulator::Destroy ();
+}
+
+
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * Test suite of the output files of the statistics calculators.
+ */
+class LteStatsFileTestSuite : public TestSuite
+{
+public:
+  LteStatsFileTestSuite ();
+};
+
+LteStatsFileTestSuite::LteStatsFileTestSuite ()
+  : TestSuite ("lte-stats-file", UNIT)
+{
+  AddTestCase (new LteStatsFileTestCase, TestCase::QUICK);
+  AddTestCase (new LteStatsCalculatorFlushTestCase, TestCase::QUICK);
+}
+
+static LteStatsFileTestSuite g_lteStatsFileTestSuite;
@@ -0,0 +1,169 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <ns3/log.h>
+#include <ns3/test.h>
+#include <ns3/simulator.h>
+#include <ns3/node-container.h>
+#include <ns3/mobility-helper.h>
+#include <ns3/position-allocator.h>
+#include <ns3/v2x-broadcast-stats-calculator.h>
+
+
+NS_LOG_COMPONENT_DEFINE ("LteTestV2xBroadcastStats");
+
+using namespace ns3;
+
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * Notify the transmissions and receptions of tagged messages between
+ * three static stations to a V2xBroadcastStatsCalculator, and check its
+ * PRR per distance bin and its histograms.
+ */
+class V2xBroadcastStatsTestCase : public TestCase
+{
+public:
+  V2xBroadcastStatsTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Create a message as sent to the lower layers: a tagged payload,
+   * fragmented and concatenated to another packet, as done by the RLC.
+   * \param node the transmitting node
+   * \param sequenceNumber the sequence number of the message
+   * \return the packet
+   */
+  static Ptr<Packet> CreateMessage (Ptr<Node> node, uint32_t sequenceNumber);
+  /**
+   * Transmit a packet
+   * \param node the transmitting node
+   * \param packet the packet
+   */
+  void Transmit (Ptr<Node> node, Ptr<Packet> packet);
+
+  Ptr<V2xBroadcastStatsCalculator> m_calculator; ///< the calculator
+};
+
+V2xBroadcastStatsTestCase::V2xBroadcastStatsTestCase ()
+  : TestCase ("V2X broadcast statistics")
+{
+}
+
+Ptr<Packet>
+V2xBroadcastStatsTestCase::CreateMessage (Ptr<Node> node, uint32_t sequenceNumber)
+{
+  Ptr<Packet> payload = Create<Packet> (190);
+  V2xMessageTag tag;
+  tag.SetStationId (node->GetId ());
+  tag.SetSequenceNumber (sequenceNumber);
+  tag.SetGenerationTime (Simulator::Now ());
+  tag.SetPosition (node->GetObject<MobilityModel> ()->GetPosition ());
+  payload->AddByteTag (tag);
+  Ptr<Packet> pdu = Create<Packet> (2);
+  pdu->AddAtEnd (payload->CreateFragment (0, 100));
+  pdu->AddAtEnd (payload->CreateFragment (100, 90));
+  return pdu;
+}
+
+void
+V2xBroadcastStatsTestCase::Transmit (Ptr<Node> node, Ptr<Packet> packet)
+{
+  Ptr<PacketBurst> pb = Create<PacketBurst> ();
+  pb->AddPacket (packet);
+  m_calculator->NotifyTx (node, pb);
+}
+
+void
+V2xBroadcastStatsTestCase::DoRun (void)
+{
+  NodeContainer nodes;
+  nodes.Create (3);
+  Ptr<ListPositionAllocator> positions = CreateObject<ListPositionAllocator> ();
+  positions->Add (Vector (0, 0, 0));
+  positions->Add (Vector (30, 0, 0));
+  positions->Add (Vector (250, 0, 0));
+  MobilityHelper mobility;
+  mobility.SetPositionAllocator (positions);
+  mobility.Install (nodes);
+
+  m_calculator = CreateObject<V2xBroadcastStatsCalculator> ();
+  for (uint32_t i = 0; i < nodes.GetN (); i++)
+    {
+      m_calculator->AddNode (nodes.Get (i));
+    }
+  NS_TEST_ASSERT_MSG_EQ (m_calculator->GetNDistanceBins (), (uint32_t) 25, "wrong number of distance bins");
+
+  // message 1 of node 0, retransmitted, received twice by node 1
+  Ptr<Packet> first = CreateMessage (nodes.Get (0), 1);
+  Simulator::Schedule (MilliSeconds (2), &V2xBroadcastStatsTestCase::Transmit, this, nodes.Get (0), first);
+  Simulator::Schedule (MilliSeconds (3), &V2xBroadcastStatsTestCase::Transmit, this, nodes.Get (0), first);
+  Simulator::Schedule (MilliSeconds (5), &V2xBroadcastStatsCalculator::NotifyRx, m_calculator, nodes.Get (1), first->Copy ());
+  Simulator::Schedule (MilliSeconds (6), &V2xBroadcastStatsCalculator::NotifyRx, m_calculator, nodes.Get (1), first->Copy ());
+  // message 2 of node 0, generated at 100 ms and received by node 1 at 113 ms
+  Simulator::Schedule (MilliSeconds (100), &V2xBroadcastStatsCalculator::NotifyTx, m_calculator, nodes.Get (0), Ptr<const PacketBurst> (0));
+  Simulator::Run ();
+  Ptr<Packet> second = CreateMessage (nodes.Get (0), 2);
+  Transmit (nodes.Get (0), second);
+  Simulator::Schedule (MilliSeconds (13), &V2xBroadcastStatsCalculator::NotifyRx, m_calculator, nodes.Get (1), second);
+  Simulator::Run ();
+
+  for (uint32_t bin = 0; bin < m_calculator->GetNDistanceBins (); bin++)
+    {
+      uint64_t expected = (bin == 1 || bin == 12) ? 2 : 0;
+      uint64_t received = (bin == 1) ? 2 : 0;
+      NS_TEST_ASSERT_MSG_EQ (m_calculator->GetNExpected (bin), expected, "wrong expected receptions in bin " << bin);
+      NS_TEST_ASSERT_MSG_EQ (m_calculator->GetNReceived (bin), received, "wrong receptions in bin " << bin);
+    }
+  NS_TEST_ASSERT_MSG_EQ_TOL (m_calculator->GetPrr (1), 1.0, 1e-12, "wrong PRR at 30 m");
+  NS_TEST_ASSERT_MSG_EQ_TOL (m_calculator->GetPrr (12), 0.0, 1e-12, "wrong PRR at 250 m");
+
+  // latencies of 5 ms and 13 ms, inter-reception time of 108 ms
+  std::vector<uint64_t> latencies = m_calculator->GetLatencyHistogram ();
+  NS_TEST_ASSERT_MSG_EQ (latencies.size (), (std::size_t) 101, "wrong number of latency bins");
+  NS_TEST_ASSERT_MSG_EQ (latencies[5], (uint64_t) 1, "wrong latency of the first message");
+  NS_TEST_ASSERT_MSG_EQ (latencies[13], (uint64_t) 1, "wrong latency of the second message");
+  std::vector<uint64_t> interReceptionTimes = m_calculator->GetInterReceptionTimeHistogram ();
+  NS_TEST_ASSERT_MSG_EQ (interReceptionTimes.size (), (std::size_t) 101, "wrong number of inter-reception time bins");
+  NS_TEST_ASSERT_MSG_EQ (interReceptionTimes[10], (uint64_t) 1, "wrong inter-reception time");
+
+  m_calculator->Reset ();
+  NS_TEST_ASSERT_MSG_EQ (m_calculator->GetNExpected (1), (uint64_t) 0, "statistics not reset");
+  Simulator::Destroy ();
+}
+
+
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * Test suite of the V2X broadcast statistics calculator.
+ */
+class V2xBroadcastStatsTestSuite : public TestSuite
+{
+public:
+  V2xBroadcastStatsTestSuite ();
+};
+
+V2xBroadcastStatsTestSuite::V2xBroadcastStatsTestSuite ()
+  : TestSuite ("lte-v2x-broadcast-stats", UNIT)
+{
+  AddTestCase (new V2xBroadcastStatsTestCase, TestCase::QUICK);
+}
+
+static V2xBroadcastStatsTestSuite g_v2xBroadcastStatsTestSuite;
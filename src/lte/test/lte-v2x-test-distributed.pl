@@ -0,0 +1,47 @@
+#!/usr/bin/perl
+use strict;
+
+# Check that the distributed simulation of the sidelink V2X Mode 4 model
+# (lena-v2x-distributed) receives the same packets, at the same times, as
+# the sequential simulation of the same scenario, for 2, 3 and 4 processes.
+# ns-3 must be configured with --enable-mpi --enable-examples.
+
+my @numProcesses = (2, 3, 4);
+my $args = "--numVeh=40 --simTime=4";
+my $status = 0;
+
+# Compile first the program
+my $out = `./waf build 2>&1`;
+die "build failed\n$out" if $?;
+
+sub ReadReceptions
+{
+   my @lines;
+   foreach my $file (@_)
+   {
+      open( FILE, "<$file" ) or die "cannot open $file";
+      push @lines, <FILE>;
+      close( FILE );
+      unlink $file;
+   }
+   return sort @lines;
+}
+
+$out = `./waf --run \'lena-v2x-distributed $args --outputFile=v2x-seq.txt\' 2>&1`;
+die "sequential simulation failed\n$out" if $?;
+my @reference = ReadReceptions ("v2x-seq.txt");
+print "sequential: " . scalar (@reference) . " packets received\n";
+die "no packet received\n" if !@reference;
+
+foreach my $np (@numProcesses)
+{
+   $out = `mpirun -np $np ./waf --run \'lena-v2x-distributed $args --distributed=1 --outputFile=v2x-dist.txt\' 2>&1`;
+   die "distributed simulation failed\n$out" if $?;
+   my @receptions = ReadReceptions (map { "v2x-dist.txt-$_" } (0 .. $np - 1));
+   my $equal = (join ("", @receptions) eq join ("", @reference));
+   print "$np processes: " . scalar (@receptions) . " packets received, "
+     . ($equal ? "PASS" : "FAIL") . "\n";
+   $status = 1 if !$equal;
+}
+
+exit $status;
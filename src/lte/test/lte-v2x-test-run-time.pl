@@ -0,0 +1,63 @@
+#!/usr/bin/perl
+use strict;
+
+# Sweep the sidelink V2X Mode 4 scalability benchmark (lena-v2x-profiling)
+# over the number of vehicles, the subchannel configuration, the resource
+# reservation interval and the traffic density, on a freeway and on an
+# urban grid, and collect its results in lteV2xTimes.csv
+
+my $simTime = 4;
+
+open( FILE, '>lteV2xTimes.csv' );
+print FILE "#scenario\tnumVeh\ttxRatio\tsizeSubchannel\tnumSubchannel\tpRsvp\tlenCam\t"
+  . "setupTime\ttimePerSimSecond\teventsPerSecond\tpeakRssKb\t"
+  . "shareGetTxResources\tshareStartTx\tshareEndRxSlData\tsharePathloss\n";
+
+my @scenario = ("freeway", "urban");
+my @numVeh = (10, 50, 100, 200, 500, 1000, 2000);
+# (sizeSubchannel, numSubchannel)
+my @subchannels = ([10, 3], [10, 5], [20, 2], [5, 10]);
+my @pRsvp = (100, 50, 20);
+# (txRatio, lenCam)
+my @traffic = ([1.0, 190], [0.5, 190], [1.0, 300]);
+
+# Configure and compile first the program to avoid counting compilation time as running time
+my $launch = "CXXFLAGS=\"-O3 -w\" ./waf -d optimized configure --enable-examples --enable-modules=lte";
+my $out = `$launch 2>&1`;
+$launch = "./waf --run \'lena-v2x-profiling --simTime=0.1 --numVeh=2\'";
+$out = `$launch 2>&1`;
+
+foreach my $scen (@scenario)
+{
+   foreach my $veh (@numVeh)
+   {
+      foreach my $sub (@subchannels)
+      {
+         my ($size, $num) = @$sub;
+         foreach my $rsvp (@pRsvp)
+         {
+            foreach my $traf (@traffic)
+            {
+               my ($ratio, $len) = @$traf;
+               $launch = "./waf --run \'lena-v2x-profiling --scenario=$scen --numVeh=$veh --txRatio=$ratio "
+                 . "--lenCam=$len --sizeSubchannel=$size --numSubchannel=$num --pRsvp=$rsvp --simTime=$simTime\'";
+               print "$launch\n";
+               $out = `$launch 2>&1`;
+               if ($out !~ /^RESULT (.*)$/m)
+               {
+                  print "no result\n";
+                  next;
+               }
+               my %res = map { split /=/, $_, 2 } split / /, $1;
+               print FILE "$scen\t$veh\t$ratio\t$size\t$num\t$rsvp\t$len\t"
+                 . "$res{setupTime}\t$res{timePerSimSecond}\t$res{eventsPerSecond}\t$res{peakRssKb}\t"
+                 . ($res{"share:LteUeMac::GetTxResources"} || 0) . "\t"
+                 . ($res{"share:MultiModelSpectrumChannel::StartTx"} || 0) . "\t"
+                 . ($res{"share:LteSpectrumPhy::EndRxSlData"} || 0) . "\t"
+                 . ($res{"share:PropagationLossModel::CalcRxPower"} || 0) . "\n";
+            }
+         }
+      }
+   }
+}
+close( FILE );
@@ -0,0 +1,123 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <ns3/log.h>
+#include <ns3/test.h>
+#include <ns3/double.h>
+#include <ns3/uinteger.h>
+#include <ns3/constant-position-mobility-model.h>
+#include <ns3/cni-urbanmicrocell-propagation-loss-model.h>
+#include <vector>
+
+
+NS_LOG_COMPONENT_DEFINE ("TestCniUrbanmicrocellPropagationLossModel");
+
+using namespace ns3;
+
+
+/**
+ * Check that the pair cache of the CniUrbanmicrocellPropagationLossModel
+ * reuses the loss of static pairs, recomputes it when the nodes move
+ * beyond the tolerance, keeps the LOS/NLOS draw of a pair and bounds its
+ * number of pairs.
+ */
+class CniUrbanmicrocellPairCacheTestCase : public TestCase
+{
+public:
+  CniUrbanmicrocellPairCacheTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Create a mobility model at the given position
+   * \param x the x coordinate
+   * \return the mobility model
+   */
+  Ptr<ConstantPositionMobilityModel> CreateMobility (double x);
+};
+
+CniUrbanmicrocellPairCacheTestCase::CniUrbanmicrocellPairCacheTestCase ()
+  : TestCase ("Check the pair cache of the CniUrbanmicrocellPropagationLossModel")
+{
+}
+
+Ptr<ConstantPositionMobilityModel>
+CniUrbanmicrocellPairCacheTestCase::CreateMobility (double x)
+{
+  Ptr<ConstantPositionMobilityModel> mob = CreateObject<ConstantPositionMobilityModel> ();
+  mob->SetPosition (Vector (x, 0, 1.5));
+  return mob;
+}
+
+void
+CniUrbanmicrocellPairCacheTestCase::DoRun (void)
+{
+  Ptr<CniUrbanmicrocellPropagationLossModel> model = CreateObject<CniUrbanmicrocellPropagationLossModel> ();
+  Ptr<ConstantPositionMobilityModel> a = CreateMobility (0);
+  Ptr<ConstantPositionMobilityModel> b = CreateMobility (50);
+
+  double loss50 = model->GetLoss (a, b);
+  NS_TEST_ASSERT_MSG_EQ (model->GetLoss (a, b), loss50, "loss of a static pair changed");
+  NS_TEST_ASSERT_MSG_EQ (model->GetLoss (b, a), loss50, "loss of a static pair with the same heights depends on the order");
+  NS_TEST_ASSERT_MSG_EQ (model->GetNCachedPairs (), 1, "a pair is cached once whatever the order of its nodes");
+
+  b->SetPosition (Vector (200, 0, 1.5));
+  NS_TEST_ASSERT_MSG_GT (model->GetLoss (a, b), loss50, "loss not recomputed after a node moved");
+  b->SetPosition (Vector (50, 0, 1.5));
+  NS_TEST_ASSERT_MSG_EQ (model->GetLoss (a, b), loss50, "LOS/NLOS draw of the pair not kept");
+
+  model->SetAttribute ("PositionTolerance", DoubleValue (1.0));
+  b->SetPosition (Vector (50.5, 0, 1.5));
+  NS_TEST_ASSERT_MSG_EQ (model->GetLoss (a, b), loss50, "loss recomputed for a movement within the tolerance");
+  b->SetPosition (Vector (52, 0, 1.5));
+  NS_TEST_ASSERT_MSG_GT (model->GetLoss (a, b), loss50, "loss not recomputed for a movement beyond the tolerance");
+
+  Ptr<CniUrbanmicrocellPropagationLossModel> boundedModel = CreateObject<CniUrbanmicrocellPropagationLossModel> ();
+  boundedModel->SetAttribute ("MaxCachedPairs", UintegerValue (2));
+  std::vector<Ptr<ConstantPositionMobilityModel> > mobs;
+  for (uint32_t i = 0; i < 4; i++)
+    {
+      mobs.push_back (CreateMobility (20.0 * i));
+    }
+  for (uint32_t i = 0; i < mobs.size (); i++)
+    {
+      for (uint32_t j = i + 1; j < mobs.size (); j++)
+        {
+          boundedModel->GetLoss (mobs[i], mobs[j]);
+          NS_TEST_ASSERT_MSG_LT_OR_EQ (boundedModel->GetNCachedPairs (), 2, "too many pairs cached");
+        }
+    }
+  NS_TEST_ASSERT_MSG_EQ (boundedModel->GetNCachedPairs (), 2, "least recently used pairs not kept");
+}
+
+
+/**
+ * Test suite of the CniUrbanmicrocellPropagationLossModel
+ */
+class CniUrbanmicrocellPropagationLossModelTestSuite : public TestSuite
+{
+public:
+  CniUrbanmicrocellPropagationLossModelTestSuite ();
+};
+
+CniUrbanmicrocellPropagationLossModelTestSuite::CniUrbanmicrocellPropagationLossModelTestSuite ()
+  : TestSuite ("cni-urbanmicrocell-propagation-loss-model", UNIT)
+{
+  AddTestCase (new CniUrbanmicrocellPairCacheTestCase, TestCase::QUICK);
+}
+
+static CniUrbanmicrocellPropagationLossModelTestSuite g_cniUrbanmicrocellPropagationLossModelTestSuite;
@@ -0,0 +1,271 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <ns3/log.h>
+#include <ns3/test.h>
+#include <ns3/sl-pool.h>
+#include <ns3/sl-v2x-preconfig-pool-factory.h>
+#include <cmath>
+#include <sstream>
+
+
+NS_LOG_COMPONENT_DEFINE ("TestSlPoolV2x");
+
+using namespace ns3;
+
+
+/**
+ * Check that the PSSCH resources indicated by a received SCI, looked up
+ * in the tables of the SidelinkCommResourcePoolV2x, match the resources
+ * computed for every RIV and PSCCH resource of the pool.
+ */
+class SlPoolV2xRivTableTestCase : public TestCase
+{
+public:
+  /**
+   * Constructor
+   * \param sizeSubchannel the number of RBs per subchannel
+   * \param numSubchannel the number of subchannels
+   * \param adjacency whether the PSCCH and PSSCH are adjacent
+   */
+  SlPoolV2xRivTableTestCase (uint16_t sizeSubchannel, uint16_t numSubchannel, bool adjacency);
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Build the name of the test case
+   * \param sizeSubchannel the number of RBs per subchannel
+   * \param numSubchannel the number of subchannels
+   * \param adjacency whether the PSCCH and PSSCH are adjacent
+   * \return the name of the test case
+   */
+  static std::string BuildNameString (uint16_t sizeSubchannel, uint16_t numSubchannel, bool adjacency);
+
+  uint16_t m_sizeSubchannel; ///< the number of RBs per subchannel
+  uint16_t m_numSubchannel; ///< the number of subchannels
+  bool m_adjacency; ///< whether the PSCCH and PSSCH are adjacent
+};
+
+SlPoolV2xRivTableTestCase::SlPoolV2xRivTableTestCase (uint16_t sizeSubchannel, uint16_t numSubchannel, bool adjacency)
+  : TestCase (BuildNameString (sizeSubchannel, numSubchannel, adjacency)),
+    m_sizeSubchannel (sizeSubchannel),
+    m_numSubchannel (numSubchannel),
+    m_adjacency (adjacency)
+{
+}
+
+std::string
+SlPoolV2xRivTableTestCase::BuildNameString (uint16_t sizeSubchannel, uint16_t numSubchannel, bool adjacency)
+{
+  std::ostringstream oss;
+  oss << "RIV table with " << numSubchannel << " subchannels of " << sizeSubchannel << " RBs, "
+      << (adjacency ? "adjacent" : "non-adjacent") << " PSCCH/PSSCH";
+  return oss.str ();
+}
+
+void
+SlPoolV2xRivTableTestCase::DoRun (void)
+{
+  SlV2xPreconfigPoolFactory factory;
+  factory.SetAdjacencyPscchPssch (m_adjacency);
+  factory.SetSizeSubchannel (m_sizeSubchannel);
+  factory.SetNumSubchannel (m_numSubchannel);
+  factory.SetStartRbSubchannel (0);
+  factory.SetStartRbPscchPool (0);
+  Ptr<SidelinkRxCommResourcePoolV2x> pool = CreateObject<SidelinkRxCommResourcePoolV2x> ();
+  pool->SetPool (factory.CreatePool ());
+
+  std::vector<bool> validRiv (256, false);
+  for (uint16_t subchLen = 1; subchLen <= m_numSubchannel; subchLen++)
+    {
+      for (uint16_t startSubch = 0; startSubch + subchLen <= m_numSubchannel; startSubch++)
+        {
+          // encoding of LteUeMac::CalcRiv
+          uint16_t riv;
+          if ((subchLen - 1) <= std::floor (m_numSubchannel / 2))
+            {
+              riv = m_numSubchannel * (subchLen - 1) + startSubch;
+            }
+          else
+            {
+              riv = m_numSubchannel * (m_numSubchannel - subchLen + 1) + (m_numSubchannel - 1 - startSubch);
+            }
+          validRiv[riv] = true;
+          const SidelinkCommResourcePoolV2x::SidelinkTransmissionInfo* info = pool->GetPsschRxResources (riv, startSubch);
+          NS_TEST_ASSERT_MSG_NE (info, 0, "no PSSCH resources for RIV " << riv);
+          NS_TEST_ASSERT_MSG_EQ (info->rbStart, startSubch * m_sizeSubchannel + (m_adjacency ? 2 : 0), "wrong start RB for RIV " << riv);
+          NS_TEST_ASSERT_MSG_EQ (info->rbLen, subchLen * m_sizeSubchannel - 2, "wrong number of RBs for RIV " << riv);
+
+          std::list<SidelinkCommResourcePoolV2x::SidelinkTransmissionInfo> txInfo = pool->GetPsschTransmissions (riv, startSubch);
+          NS_TEST_ASSERT_MSG_EQ (txInfo.size (), 1, "wrong number of PSSCH transmissions for RIV " << riv);
+          NS_TEST_ASSERT_MSG_EQ (txInfo.front ().rbStart, info->rbStart, "table and computed start RB differ for RIV " << riv);
+          NS_TEST_ASSERT_MSG_EQ (txInfo.front ().rbLen, info->rbLen, "table and computed number of RBs differ for RIV " << riv);
+        }
+    }
+
+  for (uint16_t riv = 0; riv < 256; riv++)
+    {
+      if (!validRiv[riv])
+        {
+          NS_TEST_ASSERT_MSG_EQ (pool->GetPsschRxResources (riv, 0), 0, "PSSCH resources for invalid RIV " << riv);
+        }
+    }
+  NS_TEST_ASSERT_MSG_EQ (pool->GetPsschRxResources (0, m_numSubchannel), 0, "PSSCH resources for an invalid PSCCH resource");
+}
+
+
+/**
+ * Check the absolute subframe arithmetic of the V2X pools and the placement
+ * in time of the transmissions of a grant across the wrap-around of the
+ * frame numbers.
+ */
+class SlPoolV2xSubframeTestCase : public TestCase
+{
+public:
+  /**
+   * Constructor
+   * \param adjacency whether the PSCCH and PSSCH are adjacent
+   */
+  SlPoolV2xSubframeTestCase (bool adjacency);
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Check the subframes of the transmissions of a grant
+   * \param txInfo the transmissions
+   * \param subframe the first subframe of the grant
+   * \param pRsvp the resource reservation interval
+   * \param sfGap the gap between the initial transmission and the retransmission
+   * \param reTxIdx whether the retransmission precedes the initial transmission
+   * \param reselCtr the number of reservations
+   */
+  void CheckTransmissions (const std::list<SidelinkCommResourcePoolV2x::SidelinkTransmissionInfo> &txInfo,
+                           SidelinkCommResourcePoolV2x::SubframeInfo subframe, uint16_t pRsvp,
+                           uint8_t sfGap, uint8_t reTxIdx, uint8_t reselCtr);
+
+  bool m_adjacency; ///< whether the PSCCH and PSSCH are adjacent
+};
+
+SlPoolV2xSubframeTestCase::SlPoolV2xSubframeTestCase (bool adjacency)
+  : TestCase (adjacency ? "Subframes of the transmissions, adjacent PSCCH/PSSCH" : "Subframes of the transmissions, non-adjacent PSCCH/PSSCH"),
+    m_adjacency (adjacency)
+{
+}
+
+void
+SlPoolV2xSubframeTestCase::CheckTransmissions (const std::list<SidelinkCommResourcePoolV2x::SidelinkTransmissionInfo> &txInfo,
+                                               SidelinkCommResourcePoolV2x::SubframeInfo subframe, uint16_t pRsvp,
+                                               uint8_t sfGap, uint8_t reTxIdx, uint8_t reselCtr)
+{
+  NS_TEST_ASSERT_MSG_EQ (txInfo.size (), (sfGap == 0 ? 1u : 2u) * reselCtr, "wrong number of transmissions");
+  std::list<SidelinkCommResourcePoolV2x::SidelinkTransmissionInfo>::const_iterator it = txInfo.begin ();
+  for (uint8_t ctr = 0; ctr < reselCtr; ctr++)
+    {
+      SidelinkCommResourcePoolV2x::SubframeInfo first = subframe.Offset (ctr * pRsvp);
+      if (sfGap != 0 && reTxIdx == 1)
+        {
+          NS_TEST_ASSERT_MSG_EQ ((it++)->subframe.GetIndex (), first.Offset (-sfGap).GetIndex (), "wrong retransmission subframe " << (int) ctr);
+        }
+      NS_TEST_ASSERT_MSG_EQ ((it++)->subframe.GetIndex (), first.GetIndex (), "wrong initial transmission subframe " << (int) ctr);
+      if (sfGap != 0 && reTxIdx == 0)
+        {
+          NS_TEST_ASSERT_MSG_EQ ((it++)->subframe.GetIndex (), first.Offset (sfGap).GetIndex (), "wrong retransmission subframe " << (int) ctr);
+        }
+    }
+}
+
+void
+SlPoolV2xSubframeTestCase::DoRun (void)
+{
+  typedef SidelinkCommResourcePoolV2x::SubframeInfo SubframeInfo;
+
+  for (uint32_t index = 0; index < SidelinkCommResourcePoolV2x::SUBFRAME_CYCLE; index++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (SubframeInfo::FromIndex (index).GetIndex (), index, "wrong subframe index");
+    }
+  SubframeInfo last = SubframeInfo::FromIndex (SidelinkCommResourcePoolV2x::SUBFRAME_CYCLE - 1);
+  NS_TEST_ASSERT_MSG_EQ (last.frameNo, 1024, "wrong frame of the last subframe");
+  NS_TEST_ASSERT_MSG_EQ (last.subframeNo, 10, "wrong subframe of the last subframe");
+  SubframeInfo first = last.Offset (1);
+  NS_TEST_ASSERT_MSG_EQ (first.frameNo, 1, "wrong frame after the wrap-around");
+  NS_TEST_ASSERT_MSG_EQ (first.subframeNo, 1, "wrong subframe after the wrap-around");
+  NS_TEST_ASSERT_MSG_EQ (first.Offset (-1).GetIndex (), last.GetIndex (), "wrong subframe before the wrap-around");
+  NS_TEST_ASSERT_MSG_EQ (SubframeInfo::GetDistance (last, first.Offset (14)), 15, "wrong distance across the wrap-around");
+  NS_TEST_ASSERT_MSG_EQ (SubframeInfo::OffsetIndex (10230, 15 * 1000), 4750, "wrong index after several wrap-arounds");
+  NS_TEST_ASSERT_MSG_EQ (SubframeInfo::OffsetIndex (3, -100), 10143, "wrong index before the wrap-around");
+  NS_TEST_ASSERT_MSG_EQ (SubframeInfo::GetIndexDistance (10143, 3), 100, "wrong index distance across the wrap-around");
+  NS_TEST_ASSERT_MSG_EQ (SubframeInfo::GetIndexDistance (3, 3), 0, "wrong index distance to the same subframe");
+
+  SlV2xPreconfigPoolFactory factory;
+  factory.SetAdjacencyPscchPssch (m_adjacency);
+  factory.SetSizeSubchannel (10);
+  factory.SetNumSubchannel (3);
+  factory.SetStartRbSubchannel (0);
+  factory.SetStartRbPscchPool (0);
+  Ptr<SidelinkTxCommResourcePoolV2x> pool = CreateObject<SidelinkTxCommResourcePoolV2x> ();
+  pool->SetPool (factory.CreatePool ());
+
+  uint16_t pRsvp[] = {20, 100};
+  uint8_t sfGap[] = {0, 1, 15};
+  // grants starting in the frames before the wrap-around
+  SubframeInfo start[] = {SubframeInfo::FromIndex (10230), SubframeInfo::FromIndex (10239), SubframeInfo::FromIndex (3)};
+  for (uint8_t p = 0; p < 2; p++)
+    {
+      for (uint8_t g = 0; g < 3; g++)
+        {
+          for (uint8_t reTxIdx = 0; reTxIdx <= 1; reTxIdx++)
+            {
+              for (uint8_t s = 0; s < 3; s++)
+                {
+                  CheckTransmissions (pool->GetPscchTransmissions (start[s], 0, pRsvp[p], sfGap[g], reTxIdx, 0, 5),
+                                      start[s], pRsvp[p], sfGap[g], reTxIdx, 5);
+                  CheckTransmissions (pool->GetPsschTransmissions (start[s], 0, pRsvp[p], sfGap[g], reTxIdx, 0, 5),
+                                      start[s], pRsvp[p], sfGap[g], reTxIdx, 5);
+                }
+            }
+        }
+    }
+
+  std::list<SidelinkCommResourcePoolV2x::SidelinkTransmissionInfo> csr = pool->GetCandidateResources (last, 1, 100, 1);
+  NS_TEST_ASSERT_MSG_EQ (csr.size (), 99 * 3, "wrong number of candidate resources");
+  NS_TEST_ASSERT_MSG_EQ (csr.front ().subframe.GetIndex (), last.Offset (1).GetIndex (), "wrong first candidate subframe");
+  NS_TEST_ASSERT_MSG_EQ (csr.back ().subframe.GetIndex (), last.Offset (99).GetIndex (), "wrong last candidate subframe");
+}
+
+
+/**
+ * Test suite of the sidelink V2X resource pools
+ */
+class SlPoolV2xTestSuite : public TestSuite
+{
+public:
+  SlPoolV2xTestSuite ();
+};
+
+SlPoolV2xTestSuite::SlPoolV2xTestSuite ()
+  : TestSuite ("sl-pool-v2x", UNIT)
+{
+  AddTestCase (new SlPoolV2xRivTableTestCase (10, 3, true), TestCase::QUICK);
+  AddTestCase (new SlPoolV2xRivTableTestCase (10, 5, false), TestCase::QUICK);
+  AddTestCase (new SlPoolV2xRivTableTestCase (5, 10, true), TestCase::QUICK);
+  AddTestCase (new SlPoolV2xRivTableTestCase (5, 20, false), TestCase::QUICK);
+  AddTestCase (new SlPoolV2xSubframeTestCase (true), TestCase::QUICK);
+  AddTestCase (new SlPoolV2xSubframeTestCase (false), TestCase::QUICK);
+}
+
+static SlPoolV2xTestSuite g_slPoolV2xTestSuite;
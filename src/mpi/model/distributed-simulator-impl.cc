@@ -116,6 +116,7 @@ DistributedSimulatorImpl::DistributedSimulatorImpl ()
   m_currentUid = 0;
   m_currentTs = 0;
   m_currentContext = Simulator::NO_CONTEXT;
+  m_eventCount = 0;
   m_unscheduledEvents = 0;
   m_events = 0;
 }
@@ -229,6 +230,16 @@ DistributedSimulatorImpl::CalculateLookAhead (void)
                 }
             }
         }
+
+      // the links declared by the other channels
+      const std::vector<MpiInterface::RemoteLink> &links = MpiInterface::GetRemoteLinks ();
+      for (std::vector<MpiInterface::RemoteLink>::const_iterator link = links.begin (); link != links.end (); ++link)
+        {
+          if (link->m_delay < m_lookAhead)
+            {
+              m_lookAhead = link->m_delay;
+            }
+        }
     }
 
   // m_lookAhead is now set
@@ -327,6 +338,7 @@ DistributedSimulatorImpl::ProcessOneEvent (void)
   m_currentTs = next.key.m_ts;
   m_currentContext = next.key.m_context;
   m_currentUid = next.key.m_uid;
+  m_eventCount++;
   next.impl->Invoke ();
   next.impl->Unref ();
 }
@@ -644,4 +656,10 @@ DistributedSimulatorImpl::GetContext (void) const
   return m_currentContext;
 }
 
+uint64_t
+DistributedSimulatorImpl::GetEventCount (void) const
+{
+  return m_eventCount;
+}
+
 } // namespace ns3
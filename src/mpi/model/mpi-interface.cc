@@ -33,12 +33,14 @@ namespace ns3 {
 NS_LOG_COMPONENT_DEFINE ("MpiInterface");
 
 ParallelCommunicationInterface* MpiInterface::g_parallelCommunicationInterface = 0;
+std::vector<MpiInterface::RemoteLink> MpiInterface::g_remoteLinks;
 
 void
 MpiInterface::Destroy ()
 {
   NS_ASSERT (g_parallelCommunicationInterface);
   g_parallelCommunicationInterface->Destroy ();
+  g_remoteLinks.clear ();
 }
 
 uint32_t
@@ -115,6 +117,23 @@ MpiInterface::SendPacket (Ptr<Packet> p, const Time& rxTime, uint32_t node, uint
   g_parallelCommunicationInterface->SendPacket (p, rxTime, node, dev);
 }
 
+void
+MpiInterface::AddRemoteLink (uint32_t systemId, Ptr<Channel> channel, const Time &delay)
+{
+  NS_LOG_FUNCTION (systemId << channel << delay);
+  NS_ASSERT_MSG (delay.IsStrictlyPositive (), "a remote link needs a positive delay");
+  RemoteLink link;
+  link.m_systemId = systemId;
+  link.m_channel = channel;
+  link.m_delay = delay;
+  g_remoteLinks.push_back (link);
+}
+
+const std::vector<MpiInterface::RemoteLink> &
+MpiInterface::GetRemoteLinks ()
+{
+  return g_remoteLinks;
+}
 
 void
 MpiInterface::Disable ()
@@ -24,6 +24,8 @@
 
 #include <ns3/nstime.h>
 #include <ns3/packet.h>
+#include <ns3/channel.h>
+#include <vector>
 
 namespace ns3 {
 /**
@@ -94,8 +96,40 @@ public:
    * Serialize and send a packet to the specified node and net device
    */
   static void SendPacket (Ptr<Packet> p, const Time &rxTime, uint32_t node, uint32_t dev);
+
+  /**
+   * A link to a remote system through a channel which is not a
+   * point-to-point channel.
+   */
+  struct RemoteLink
+  {
+    uint32_t m_systemId;  //!< the remote system
+    Ptr<Channel> m_channel; //!< the channel reaching the remote system
+    Time m_delay;         //!< the minimum delay of the packets sent on the channel
+  };
+  /**
+   * \param systemId the remote system
+   * \param channel the channel reaching the remote system
+   * \param delay the minimum delay between the sending of a packet
+   * through the channel and its reception by the remote system
+   *
+   * Declare a link to a remote system, so that the parallel simulators
+   * account for it in their lookahead like the remote point-to-point
+   * channels.  The links must be declared before Simulator::Run and on
+   * both sides.
+   */
+  static void AddRemoteLink (uint32_t systemId, Ptr<Channel> channel, const Time &delay);
+  /**
+   * \return the links declared by AddRemoteLink
+   */
+  static const std::vector<RemoteLink> & GetRemoteLinks ();
 private:
 
+  /**
+   * The links declared by AddRemoteLink.
+   */
+  static std::vector<RemoteLink> g_remoteLinks;
+
   /**
    * Static instance of the instantiated parallel controller.
    */
@@ -83,6 +83,7 @@ NullMessageSimulatorImpl::NullMessageSimulatorImpl ()
   m_currentUid = 0;
   m_currentTs = 0;
   m_currentContext = Simulator::NO_CONTEXT;
+  m_eventCount = 0;
   m_unscheduledEvents = 0;
   m_events = 0;
 
@@ -199,6 +200,18 @@ NullMessageSimulatorImpl::CalculateLookAhead (void)
               remoteChannelBundle->AddChannel (channel, delay.Get () );
             }
         }
+
+      // the links declared by the other channels
+      const std::vector<MpiInterface::RemoteLink> &links = MpiInterface::GetRemoteLinks ();
+      for (std::vector<MpiInterface::RemoteLink>::const_iterator link = links.begin (); link != links.end (); ++link)
+        {
+          Ptr<RemoteChannelBundle> remoteChannelBundle = RemoteChannelBundleManager::Find (link->m_systemId);
+          if (!remoteChannelBundle)
+            {
+              remoteChannelBundle = RemoteChannelBundleManager::Add (link->m_systemId);
+            }
+          remoteChannelBundle->AddChannel (link->m_channel, link->m_delay);
+        }
     }
 
   // Completed setup of remote channel bundles.  Setup send and receive buffers.
@@ -240,6 +253,7 @@ NullMessageSimulatorImpl::ProcessOneEvent (void)
   m_currentTs = next.key.m_ts;
   m_currentContext = next.key.m_context;
   m_currentUid = next.key.m_uid;
+  m_eventCount++;
   next.impl->Invoke ();
   next.impl->Unref ();
 }
@@ -575,6 +589,12 @@ NullMessageSimulatorImpl::GetContext (void) const
   return m_currentContext;
 }
 
+uint64_t
+NullMessageSimulatorImpl::GetEventCount (void) const
+{
+  return m_eventCount;
+}
+
 Time NullMessageSimulatorImpl::CalculateGuaranteeTime (uint32_t nodeSysId)
 {
   Ptr<RemoteChannelBundle> bundle = RemoteChannelBundleManager::Find (nodeSysId);
@@ -20,6 +20,7 @@
 #include "ns3/log.h"
 #include "ns3/fatal-impl.h"
 #include "ns3/abort.h"
+#include "ns3/async-file-stream.h"
 #include <fstream>
 
 namespace ns3 {
@@ -30,11 +31,9 @@ OutputStreamWrapper::OutputStreamWrapper (std::string filename, std::ios::openmo
   : m_destroyable (true)
 {
   NS_LOG_FUNCTION (this << filename << filemode);
-  std::ofstream* os = new std::ofstream ();
-  os->open (filename.c_str (), filemode);
-  m_ostream = os;
+  m_ostream = AsyncFileStream::Create (filename, filemode);
   FatalImpl::RegisterStream (m_ostream);
-  NS_ABORT_MSG_UNLESS (os->is_open (), "AsciiTraceHelper::CreateFileStream():  " <<
+  NS_ABORT_MSG_IF (m_ostream->fail (), "AsciiTraceHelper::CreateFileStream():  " <<
                        "Unable to Open " << filename << " for mode " << filemode);
 }
 
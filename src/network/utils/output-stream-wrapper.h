@@ -71,7 +71,8 @@ class OutputStreamWrapper : public SimpleRefCount<OutputStreamWrapper>
 {
 public:
   /**
-   * Constructor
+   * Constructor; the file is written by a background thread, see
+   * AsyncFileStream, if the global value AsyncFileStreamsEnabled is true.
    * \param filename file name
    * \param filemode std::ios::openmode flags
    */
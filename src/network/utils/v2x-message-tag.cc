@@ -0,0 +1,132 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "v2x-message-tag.h"
+#include "ns3/log.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("V2xMessageTag");
+
+NS_OBJECT_ENSURE_REGISTERED (V2xMessageTag);
+
+TypeId
+V2xMessageTag::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::V2xMessageTag")
+    .SetParent<Tag> ()
+    .SetGroupName ("Network")
+    .AddConstructor<V2xMessageTag> ()
+  ;
+  return tid;
+}
+TypeId
+V2xMessageTag::GetInstanceTypeId (void) const
+{
+  return GetTypeId ();
+}
+uint32_t
+V2xMessageTag::GetSerializedSize (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return 4 + 4 + 8 + 3 * 8;
+}
+void
+V2xMessageTag::Serialize (TagBuffer buf) const
+{
+  NS_LOG_FUNCTION (this << &buf);
+  buf.WriteU32 (m_stationId);
+  buf.WriteU32 (m_sequenceNumber);
+  buf.WriteU64 (m_generationTime.GetTimeStep ());
+  buf.WriteDouble (m_position.x);
+  buf.WriteDouble (m_position.y);
+  buf.WriteDouble (m_position.z);
+}
+void
+V2xMessageTag::Deserialize (TagBuffer buf)
+{
+  NS_LOG_FUNCTION (this << &buf);
+  m_stationId = buf.ReadU32 ();
+  m_sequenceNumber = buf.ReadU32 ();
+  m_generationTime = TimeStep (buf.ReadU64 ());
+  m_position.x = buf.ReadDouble ();
+  m_position.y = buf.ReadDouble ();
+  m_position.z = buf.ReadDouble ();
+}
+void
+V2xMessageTag::Print (std::ostream &os) const
+{
+  NS_LOG_FUNCTION (this << &os);
+  os << "StationId=" << m_stationId << " SequenceNumber=" << m_sequenceNumber
+     << " GenerationTime=" << m_generationTime << " Position=" << m_position;
+}
+V2xMessageTag::V2xMessageTag ()
+  : Tag (),
+    m_stationId (0),
+    m_sequenceNumber (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+V2xMessageTag::SetStationId (uint32_t stationId)
+{
+  NS_LOG_FUNCTION (this << stationId);
+  m_stationId = stationId;
+}
+uint32_t
+V2xMessageTag::GetStationId (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_stationId;
+}
+void
+V2xMessageTag::SetSequenceNumber (uint32_t sequenceNumber)
+{
+  NS_LOG_FUNCTION (this << sequenceNumber);
+  m_sequenceNumber = sequenceNumber;
+}
+uint32_t
+V2xMessageTag::GetSequenceNumber (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_sequenceNumber;
+}
+void
+V2xMessageTag::SetGenerationTime (Time time)
+{
+  NS_LOG_FUNCTION (this << time);
+  m_generationTime = time;
+}
+Time
+V2xMessageTag::GetGenerationTime (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_generationTime;
+}
+void
+V2xMessageTag::SetPosition (Vector position)
+{
+  NS_LOG_FUNCTION (this << position);
+  m_position = position;
+}
+Vector
+V2xMessageTag::GetPosition (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_position;
+}
+
+} // namespace ns3
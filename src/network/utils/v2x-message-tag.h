@@ -0,0 +1,98 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef V2X_MESSAGE_TAG_H
+#define V2X_MESSAGE_TAG_H
+
+#include "ns3/tag.h"
+#include "ns3/nstime.h"
+#include "ns3/vector.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup network
+ *
+ * Metadata of a V2X message (e.g. a CAM or a BSM): the transmitting
+ * station, the sequence number of the message, and the time and the
+ * position of the station at its generation.
+ *
+ * The tag is meant to be added to the payload of the message as a byte
+ * tag, which is kept through the fragmentation, concatenation and
+ * reassembly of the lower layers, so that the receivers and the trace
+ * sinks can read it without parsing the payload.
+ */
+class V2xMessageTag : public Tag
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  virtual TypeId GetInstanceTypeId (void) const;
+  virtual uint32_t GetSerializedSize (void) const;
+  virtual void Serialize (TagBuffer buf) const;
+  virtual void Deserialize (TagBuffer buf);
+  virtual void Print (std::ostream &os) const;
+  V2xMessageTag ();
+
+  /**
+   * Set the identifier of the transmitting station
+   * \param stationId the identifier, e.g. the node id
+   */
+  void SetStationId (uint32_t stationId);
+  /**
+   * \returns the identifier of the transmitting station
+   */
+  uint32_t GetStationId (void) const;
+  /**
+   * Set the sequence number of the message
+   * \param sequenceNumber the sequence number among the messages of the station
+   */
+  void SetSequenceNumber (uint32_t sequenceNumber);
+  /**
+   * \returns the sequence number of the message
+   */
+  uint32_t GetSequenceNumber (void) const;
+  /**
+   * Set the generation time of the message
+   * \param time the generation time
+   */
+  void SetGenerationTime (Time time);
+  /**
+   * \returns the generation time of the message
+   */
+  Time GetGenerationTime (void) const;
+  /**
+   * Set the position of the station at the generation of the message
+   * \param position the position
+   */
+  void SetPosition (Vector position);
+  /**
+   * \returns the position of the station at the generation of the message
+   */
+  Vector GetPosition (void) const;
+
+private:
+  uint32_t m_stationId; //!< identifier of the transmitting station
+  uint32_t m_sequenceNumber; //!< sequence number of the message
+  Time m_generationTime; //!< generation time of the message
+  Vector m_position; //!< position of the station at the generation
+};
+
+} // namespace ns3
+
+#endif /* V2X_MESSAGE_TAG_H */
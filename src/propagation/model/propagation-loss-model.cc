@@ -28,6 +28,7 @@
 #include "ns3/double.h"
 #include "ns3/string.h"
 #include "ns3/pointer.h"
+#include "ns3/wall-clock-profiler.h"
 #include <cmath>
 
 namespace ns3 {
@@ -74,6 +75,7 @@ PropagationLossModel::CalcRxPower (double txPowerDbm,
                                    Ptr<MobilityModel> a,
                                    Ptr<MobilityModel> b) const
 {
+  NS_PROFILE_SCOPE ("PropagationLossModel::CalcRxPower");
   double self = DoCalcRxPower (txPowerDbm, a, b);
   if (m_next != 0)
     {
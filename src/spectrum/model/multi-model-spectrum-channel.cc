@@ -34,6 +34,9 @@
 #include <ns3/propagation-delay-model.h>
 #include <ns3/antenna-model.h>
 #include <ns3/angles.h>
+#include <ns3/wall-clock-profiler.h>
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 #include <utility>
 #include "multi-model-spectrum-channel.h"
@@ -82,6 +85,8 @@ RxSpectrumModelInfo::RxSpectrumModelInfo (Ptr<const SpectrumModel> rxSpectrumMod
 
 
 MultiModelSpectrumChannel::MultiModelSpectrumChannel ()
+  : m_spatialIndexValid (false),
+    m_spatialIndexMaxSpeed (0)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -95,6 +100,17 @@ MultiModelSpectrumChannel::DoDispose ()
   m_spectrumPropagationLoss = 0;
   m_txSpectrumModelInfoMap.clear ();
   m_rxSpectrumModelInfoMap.clear ();
+  for (std::set<Ptr<MobilityModel> >::iterator it = m_trackedMobilities.begin ();
+       it != m_trackedMobilities.end ();
+       ++it)
+    {
+      (*it)->TraceDisconnectWithoutContext ("CourseChange", MakeCallback (&MultiModelSpectrumChannel::NotifyCourseChange, this));
+    }
+  m_trackedMobilities.clear ();
+  m_spatialIndex.clear ();
+  m_spatialIndexCells.clear ();
+  m_indexedMobilities.clear ();
+  m_unindexedRxPhys.clear ();
   SpectrumChannel::DoDispose ();
 }
 
@@ -119,6 +135,19 @@ MultiModelSpectrumChannel::GetTypeId (void)
                    DoubleValue (1.0e9),
                    MakeDoubleAccessor (&MultiModelSpectrumChannel::m_maxLossDb),
                    MakeDoubleChecker<double> ())
+    .AddAttribute ("MaxInterferenceDistance",
+                   "If positive, the maximum distance in meters between the "
+                   "transmitter and a receiver for which transmissions "
+                   "will be passed to the receiving PHY. The receivers in "
+                   "range are looked up in a grid index of their positions, "
+                   "so that the other ones are skipped before any copy "
+                   "of the signal or propagation loss evaluation. The index "
+                   "assumes that a mobility model notifies a course change "
+                   "whenever its velocity changes. A value of 0 disables "
+                   "this filter and considers all receivers.",
+                   DoubleValue (0.0),
+                   MakeDoubleAccessor (&MultiModelSpectrumChannel::m_maxInterferenceDistance),
+                   MakeDoubleChecker<double> (0.0))
     .AddTraceSource ("PathLoss",
                      "This trace is fired whenever a new path loss value "
                      "is calculated. The first and second parameters "
@@ -175,6 +204,7 @@ MultiModelSpectrumChannel::AddRx (Ptr<SpectrumPhy> phy)
     }
 
   ++m_numDevices;
+  m_spatialIndexValid = false;
 
   RxSpectrumModelInfoMap_t::iterator rxInfoIterator = m_rxSpectrumModelInfoMap.find (rxSpectrumModelUid);
 
@@ -264,9 +294,11 @@ void
 MultiModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
 {
   NS_LOG_FUNCTION (this << txParams);
+  NS_PROFILE_SCOPE ("MultiModelSpectrumChannel::StartTx");
 
   NS_ASSERT (txParams->txPhy);
   NS_ASSERT (txParams->psd);
+  NS_ASSERT_MSG (txParams->psdGain == 1.0, "the PSD of a transmitted signal must not be scaled");
   Ptr<SpectrumSignalParameters> txParamsTrace = txParams->Copy (); // copy it since traced value cannot be const (because of potential underlying DynamicCasts)
   m_txSigParamsTrace (txParamsTrace);
 
@@ -282,6 +314,14 @@ MultiModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
   NS_LOG_LOGIC ("converter map size: " << txInfoIteratorerator->second.m_spectrumConverterMap.size ());
   NS_LOG_LOGIC ("converter map first element: " << txInfoIteratorerator->second.m_spectrumConverterMap.begin ()->first);
 
+  // look up the receivers in range once for all the RX SpectrumModels
+  bool cullReceivers = (m_maxInterferenceDistance > 0) && txMobility;
+  std::vector<Ptr<SpectrumPhy> > rxCandidates;
+  if (cullReceivers)
+    {
+      GetRxCandidates (txMobility->GetPosition (), rxCandidates);
+    }
+
   for (RxSpectrumModelInfoMap_t::const_iterator rxInfoIterator = m_rxSpectrumModelInfoMap.begin ();
        rxInfoIterator != m_rxSpectrumModelInfoMap.end ();
        ++rxInfoIterator)
@@ -293,7 +333,8 @@ MultiModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
       if (txSpectrumModelUid == rxSpectrumModelUid)
         {
           NS_LOG_LOGIC ("no spectrum conversion needed");
-          convertedTxPowerSpectrum = txParams->psd;
+          // copy it once since it may be shared by the receivers
+          convertedTxPowerSpectrum = txParams->psd->Copy ();
         }
       else
         {
@@ -308,86 +349,251 @@ MultiModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
         }
 
 
+      if (cullReceivers)
+        {
+          for (std::vector<Ptr<SpectrumPhy> >::const_iterator rxPhyIterator = rxCandidates.begin ();
+               rxPhyIterator != rxCandidates.end ();
+               ++rxPhyIterator)
+            {
+              if (rxInfoIterator->second.m_rxPhySet.count (*rxPhyIterator) > 0)
+                {
+                  StartTxToRx (txParams, convertedTxPowerSpectrum, txMobility, *rxPhyIterator);
+                }
+            }
+          continue;
+        }
+
       for (std::set<Ptr<SpectrumPhy> >::const_iterator rxPhyIterator = rxInfoIterator->second.m_rxPhySet.begin ();
            rxPhyIterator != rxInfoIterator->second.m_rxPhySet.end ();
            ++rxPhyIterator)
         {
-          NS_ASSERT_MSG ((*rxPhyIterator)->GetRxSpectrumModel ()->GetUid () == rxSpectrumModelUid,
-                         "SpectrumModel change was not notified to MultiModelSpectrumChannel (i.e., AddRx should be called again after model is changed)");
+          StartTxToRx (txParams, convertedTxPowerSpectrum, txMobility, *rxPhyIterator);
+        }
+    }
 
-          if ((*rxPhyIterator) != txParams->txPhy)
-            {
-              NS_LOG_LOGIC (" copying signal parameters " << txParams);
-              Ptr<SpectrumSignalParameters> rxParams = txParams->Copy ();
-              rxParams->psd = Copy<SpectrumValue> (convertedTxPowerSpectrum);
-              Time delay = MicroSeconds (0);
+}
 
-              Ptr<MobilityModel> receiverMobility = (*rxPhyIterator)->GetMobility ();
+void
+MultiModelSpectrumChannel::StartTxToRx (Ptr<SpectrumSignalParameters> txParams, Ptr<SpectrumValue> convertedTxPowerSpectrum,
+                                        Ptr<MobilityModel> txMobility, Ptr<SpectrumPhy> rxPhy)
+{
+  NS_ASSERT_MSG (rxPhy->GetRxSpectrumModel ()->GetUid () == convertedTxPowerSpectrum->GetSpectrumModelUid (),
+                 "SpectrumModel change was not notified to MultiModelSpectrumChannel (i.e., AddRx should be called again after model is changed)");
 
-              if (txMobility && receiverMobility)
-                {
-                  double pathLossDb = 0;
-                  if (rxParams->txAntenna != 0)
-                    {
-                      Angles txAngles (receiverMobility->GetPosition (), txMobility->GetPosition ());
-                      double txAntennaGain = rxParams->txAntenna->GetGainDb (txAngles);
-                      NS_LOG_LOGIC ("txAntennaGain = " << txAntennaGain << " dB");
-                      pathLossDb -= txAntennaGain;
-                    }
-                  Ptr<AntennaModel> rxAntenna = (*rxPhyIterator)->GetRxAntenna ();
-                  if (rxAntenna != 0)
-                    {
-                      Angles rxAngles (txMobility->GetPosition (), receiverMobility->GetPosition ());
-                      double rxAntennaGain = rxAntenna->GetGainDb (rxAngles);
-                      NS_LOG_LOGIC ("rxAntennaGain = " << rxAntennaGain << " dB");
-                      pathLossDb -= rxAntennaGain;
-                    }
-                  if (m_propagationLoss)
-                    {
-                      double propagationGainDb = m_propagationLoss->CalcRxPower (0, txMobility, receiverMobility);
-                      NS_LOG_LOGIC ("propagationGainDb = " << propagationGainDb << " dB");
-                      pathLossDb -= propagationGainDb;
-                    }                    
-                  NS_LOG_LOGIC ("total pathLoss = " << pathLossDb << " dB");    
-                  m_pathLossTrace (txParams->txPhy, *rxPhyIterator, pathLossDb);
-                  if ( pathLossDb > m_maxLossDb)
-                    {
-                      // beyond range
-                      continue;
-                    }
-                  double pathGainLinear = std::pow (10.0, (-pathLossDb) / 10.0);
-                  *(rxParams->psd) *= pathGainLinear;              
-
-                  if (m_spectrumPropagationLoss)
-                    {
-                      rxParams->psd = m_spectrumPropagationLoss->CalcRxPowerSpectralDensity (rxParams->psd, txMobility, receiverMobility);
-                    }
-
-                  if (m_propagationDelay)
-                    {
-                      delay = m_propagationDelay->GetDelay (txMobility, receiverMobility);
-                    }
-                }
+  if (rxPhy == txParams->txPhy)
+    {
+      return;
+    }
 
-              Ptr<NetDevice> netDev = (*rxPhyIterator)->GetDevice ();
-              if (netDev)
-                {
-                  // the receiver has a NetDevice, so we expect that it is attached to a Node
-                  uint32_t dstNode =  netDev->GetNode ()->GetId ();
-                  Simulator::ScheduleWithContext (dstNode, delay, &MultiModelSpectrumChannel::StartRx, this,
-                                                  rxParams, *rxPhyIterator);
-                }
-              else
+  // a receiver supporting it shares the transmitted PSD, and the path
+  // gain is passed as a scalar instead of being applied to a copy
+  bool sharedPsd = rxPhy->IsPsdGainSupported () && !m_spectrumPropagationLoss;
+
+  NS_LOG_LOGIC (" copying signal parameters " << txParams);
+  Ptr<SpectrumSignalParameters> rxParams;
+  if (sharedPsd)
+    {
+      // do not copy the PSD along with the other parameters
+      Ptr<SpectrumValue> txPsd = txParams->psd;
+      txParams->psd = 0;
+      rxParams = txParams->Copy ();
+      txParams->psd = txPsd;
+      rxParams->psd = convertedTxPowerSpectrum;
+    }
+  else
+    {
+      rxParams = txParams->Copy ();
+      rxParams->psd = Copy<SpectrumValue> (convertedTxPowerSpectrum);
+    }
+  Time delay = MicroSeconds (0);
+
+  Ptr<MobilityModel> receiverMobility = rxPhy->GetMobility ();
+
+  if (txMobility && receiverMobility)
+    {
+      double pathLossDb = 0;
+      if (rxParams->txAntenna != 0)
+        {
+          Angles txAngles (receiverMobility->GetPosition (), txMobility->GetPosition ());
+          double txAntennaGain = rxParams->txAntenna->GetGainDb (txAngles);
+          NS_LOG_LOGIC ("txAntennaGain = " << txAntennaGain << " dB");
+          pathLossDb -= txAntennaGain;
+        }
+      Ptr<AntennaModel> rxAntenna = rxPhy->GetRxAntenna ();
+      if (rxAntenna != 0)
+        {
+          Angles rxAngles (txMobility->GetPosition (), receiverMobility->GetPosition ());
+          double rxAntennaGain = rxAntenna->GetGainDb (rxAngles);
+          NS_LOG_LOGIC ("rxAntennaGain = " << rxAntennaGain << " dB");
+          pathLossDb -= rxAntennaGain;
+        }
+      if (m_propagationLoss)
+        {
+          double propagationGainDb = m_propagationLoss->CalcRxPower (0, txMobility, receiverMobility);
+          NS_LOG_LOGIC ("propagationGainDb = " << propagationGainDb << " dB");
+          pathLossDb -= propagationGainDb;
+        }                    
+      NS_LOG_LOGIC ("total pathLoss = " << pathLossDb << " dB");    
+      m_pathLossTrace (txParams->txPhy, rxPhy, pathLossDb);
+      if ( pathLossDb > m_maxLossDb)
+        {
+          // beyond range
+          return;
+        }
+      double pathGainLinear = std::pow (10.0, (-pathLossDb) / 10.0);
+      if (sharedPsd)
+        {
+          rxParams->psdGain = pathGainLinear;
+        }
+      else
+        {
+          *(rxParams->psd) *= pathGainLinear;
+        }
+
+      if (m_spectrumPropagationLoss)
+        {
+          rxParams->psd = m_spectrumPropagationLoss->CalcRxPowerSpectralDensity (rxParams->psd, txMobility, receiverMobility);
+        }
+
+      if (m_propagationDelay)
+        {
+          delay = m_propagationDelay->GetDelay (txMobility, receiverMobility);
+        }
+    }
+
+  Ptr<NetDevice> netDev = rxPhy->GetDevice ();
+  if (netDev)
+    {
+      // the receiver has a NetDevice, so we expect that it is attached to a Node
+      uint32_t dstNode =  netDev->GetNode ()->GetId ();
+      Simulator::ScheduleWithContext (dstNode, delay, &MultiModelSpectrumChannel::StartRx, this,
+                                      rxParams, rxPhy);
+    }
+  else
+    {
+      // the receiver is not attached to a NetDevice, so we cannot assume that it is attached to a node
+      Simulator::Schedule (delay, &MultiModelSpectrumChannel::StartRx, this,
+                           rxParams, rxPhy);
+    }
+}
+
+void
+MultiModelSpectrumChannel::GetRxCandidates (const Vector& position, std::vector<Ptr<SpectrumPhy> >& candidates)
+{
+  NS_LOG_FUNCTION (this << position);
+
+  // receivers moved by at most the maximum speed since the index was built
+  double slack = m_spatialIndexMaxSpeed * (Simulator::Now () - m_spatialIndexTime).GetSeconds ();
+  if (!m_spatialIndexValid || slack > m_maxInterferenceDistance / 2)
+    {
+      BuildSpatialIndex ();
+      slack = 0;
+    }
+
+  candidates = m_unindexedRxPhys;
+  int64_t range = (int64_t) std::ceil ((m_maxInterferenceDistance + slack) / m_maxInterferenceDistance);
+  SpatialIndexCell_t cell = GetSpatialIndexCell (position);
+  for (int64_t x = cell.first - range; x <= cell.first + range; ++x)
+    {
+      for (int64_t y = cell.second - range; y <= cell.second + range; ++y)
+        {
+          std::map<SpatialIndexCell_t, std::vector<Ptr<SpectrumPhy> > >::const_iterator it = m_spatialIndex.find (SpatialIndexCell_t (x, y));
+          if (it == m_spatialIndex.end ())
+            {
+              continue;
+            }
+          for (std::vector<Ptr<SpectrumPhy> >::const_iterator phyIt = it->second.begin (); phyIt != it->second.end (); ++phyIt)
+            {
+              if (CalculateDistance ((*phyIt)->GetMobility ()->GetPosition (), position) <= m_maxInterferenceDistance)
                 {
-                  // the receiver is not attached to a NetDevice, so we cannot assume that it is attached to a node
-                  Simulator::Schedule (delay, &MultiModelSpectrumChannel::StartRx, this,
-                                       rxParams, *rxPhyIterator);
+                  candidates.push_back (*phyIt);
                 }
             }
         }
+    }
+  // keep the order of the receiver sets, so that the receptions are scheduled in the same order
+  std::sort (candidates.begin (), candidates.end ());
+  NS_LOG_LOGIC (candidates.size () << " receivers in range");
+}
 
+void
+MultiModelSpectrumChannel::BuildSpatialIndex ()
+{
+  NS_LOG_FUNCTION (this);
+
+  m_spatialIndex.clear ();
+  m_spatialIndexCells.clear ();
+  m_indexedMobilities.clear ();
+  m_unindexedRxPhys.clear ();
+  m_spatialIndexMaxSpeed = 0;
+  for (RxSpectrumModelInfoMap_t::const_iterator rxInfoIterator = m_rxSpectrumModelInfoMap.begin ();
+       rxInfoIterator != m_rxSpectrumModelInfoMap.end ();
+       ++rxInfoIterator)
+    {
+      for (std::set<Ptr<SpectrumPhy> >::const_iterator rxPhyIterator = rxInfoIterator->second.m_rxPhySet.begin ();
+           rxPhyIterator != rxInfoIterator->second.m_rxPhySet.end ();
+           ++rxPhyIterator)
+        {
+          Ptr<MobilityModel> mobility = (*rxPhyIterator)->GetMobility ();
+          if (mobility == 0)
+            {
+              m_unindexedRxPhys.push_back (*rxPhyIterator);
+              continue;
+            }
+          SpatialIndexCell_t cell = GetSpatialIndexCell (mobility->GetPosition ());
+          m_spatialIndex[cell].push_back (*rxPhyIterator);
+          m_spatialIndexCells[*rxPhyIterator] = cell;
+          m_indexedMobilities[mobility].push_back (*rxPhyIterator);
+          Vector velocity = mobility->GetVelocity ();
+          m_spatialIndexMaxSpeed = std::max (m_spatialIndexMaxSpeed, std::sqrt (velocity.x * velocity.x + velocity.y * velocity.y));
+          if (m_trackedMobilities.insert (mobility).second)
+            {
+              mobility->TraceConnectWithoutContext ("CourseChange", MakeCallback (&MultiModelSpectrumChannel::NotifyCourseChange, this));
+            }
+        }
+    }
+  m_spatialIndexTime = Simulator::Now ();
+  m_spatialIndexValid = true;
+}
+
+void
+MultiModelSpectrumChannel::NotifyCourseChange (Ptr<const MobilityModel> mobility)
+{
+  std::map<Ptr<const MobilityModel>, std::vector<Ptr<SpectrumPhy> > >::const_iterator mobIt = m_indexedMobilities.find (mobility);
+  if (!m_spatialIndexValid || mobIt == m_indexedMobilities.end ())
+    {
+      return;
     }
+  NS_LOG_FUNCTION (this << mobility);
+
+  // the receiver is indexed at its current position, and moves from now on
+  // at its new speed, which can only increase the maximum speed
+  Vector velocity = mobility->GetVelocity ();
+  m_spatialIndexMaxSpeed = std::max (m_spatialIndexMaxSpeed, std::sqrt (velocity.x * velocity.x + velocity.y * velocity.y));
+  SpatialIndexCell_t cell = GetSpatialIndexCell (mobility->GetPosition ());
+  for (std::vector<Ptr<SpectrumPhy> >::const_iterator phyIt = mobIt->second.begin (); phyIt != mobIt->second.end (); ++phyIt)
+    {
+      SpatialIndexCell_t& oldCell = m_spatialIndexCells[*phyIt];
+      if (oldCell == cell)
+        {
+          continue;
+        }
+      std::vector<Ptr<SpectrumPhy> >& oldPhys = m_spatialIndex[oldCell];
+      oldPhys.erase (std::find (oldPhys.begin (), oldPhys.end (), *phyIt));
+      if (oldPhys.empty ())
+        {
+          m_spatialIndex.erase (oldCell);
+        }
+      m_spatialIndex[cell].push_back (*phyIt);
+      oldCell = cell;
+    }
+}
 
+MultiModelSpectrumChannel::SpatialIndexCell_t
+MultiModelSpectrumChannel::GetSpatialIndexCell (const Vector& position) const
+{
+  return SpatialIndexCell_t ((int64_t) std::floor (position.x / m_maxInterferenceDistance),
+                             (int64_t) std::floor (position.y / m_maxInterferenceDistance));
 }
 
 void
@@ -27,8 +27,11 @@
 #include <ns3/spectrum-channel.h>
 #include <ns3/spectrum-propagation-loss-model.h>
 #include <ns3/propagation-delay-model.h>
+#include <ns3/mobility-model.h>
+#include <ns3/nstime.h>
 #include <map>
 #include <set>
+#include <vector>
 
 namespace ns3 {
 
@@ -164,6 +167,53 @@ private:
    */
   virtual void StartRx (Ptr<SpectrumSignalParameters> params, Ptr<SpectrumPhy> receiver);
 
+  /**
+   * Propagate the signal of a transmitter to a single receiver.
+   *
+   * @param txParams The signal parameters of the transmitter.
+   * @param convertedTxPowerSpectrum The transmitted PSD in the receiver's SpectrumModel.
+   * @param txMobility The mobility model of the transmitter.
+   * @param rxPhy The receiver SpectrumPhy.
+   */
+  void StartTxToRx (Ptr<SpectrumSignalParameters> txParams, Ptr<SpectrumValue> convertedTxPowerSpectrum,
+                    Ptr<MobilityModel> txMobility, Ptr<SpectrumPhy> rxPhy);
+
+  /**
+   * Get the receivers within m_maxInterferenceDistance of a position,
+   * together with the receivers without mobility model. The spatial index
+   * is rebuilt if needed.
+   *
+   * @param position The position of the transmitter.
+   * @param candidates The receivers, sorted like the sets of m_rxSpectrumModelInfoMap.
+   */
+  void GetRxCandidates (const Vector& position, std::vector<Ptr<SpectrumPhy> >& candidates);
+
+  /**
+   * Rebuild the spatial index of the receivers from their current positions.
+   */
+  void BuildSpatialIndex ();
+
+  /**
+   * Move the receivers of a mobility model to their current cell of the
+   * spatial index when it changes its course.
+   *
+   * @param mobility The mobility model of the receiver.
+   */
+  void NotifyCourseChange (Ptr<const MobilityModel> mobility);
+
+  /**
+   * Cell of the spatial index.
+   */
+  typedef std::pair<int64_t, int64_t> SpatialIndexCell_t;
+
+  /**
+   * Get the cell of the spatial index containing a position.
+   *
+   * @param position The position.
+   * @return The cell.
+   */
+  SpatialIndexCell_t GetSpatialIndexCell (const Vector& position) const;
+
   /**
    * Propagation delay model to be used with this channel.
    */
@@ -207,6 +257,26 @@ private:
    */
   double m_maxLossDb;
 
+  /**
+   * Maximum interference distance [m], 0 if disabled.
+   *
+   * Any receiver farther than this from the transmitter is skipped.
+   */
+  double m_maxInterferenceDistance;
+
+  /**
+   * Uniform grid of the receivers with a mobility model, with cells
+   * of m_maxInterferenceDistance side.
+   */
+  std::map<SpatialIndexCell_t, std::vector<Ptr<SpectrumPhy> > > m_spatialIndex;
+  std::map<Ptr<SpectrumPhy>, SpatialIndexCell_t> m_spatialIndexCells; //!< Cell of each indexed receiver.
+  std::map<Ptr<const MobilityModel>, std::vector<Ptr<SpectrumPhy> > > m_indexedMobilities; //!< Indexed receivers of each mobility model.
+  std::vector<Ptr<SpectrumPhy> > m_unindexedRxPhys; //!< Receivers without mobility model.
+  std::set<Ptr<MobilityModel> > m_trackedMobilities; //!< Mobility models whose course changes are tracked.
+  bool m_spatialIndexValid;        //!< False if the spatial index has to be rebuilt.
+  Time m_spatialIndexTime;         //!< Time at which the spatial index was built.
+  double m_spatialIndexMaxSpeed;   //!< Maximum speed [m/s] of the receivers when the index was built.
+
   /**
    * \deprecated The non-const \c Ptr<SpectrumPhy> argument
    * is deprecated and will be changed to \c Ptr<const SpectrumPhy>
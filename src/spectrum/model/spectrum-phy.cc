@@ -52,5 +52,11 @@ SpectrumPhy::~SpectrumPhy ()
   NS_LOG_FUNCTION (this);
 }
 
+bool
+SpectrumPhy::IsPsdGainSupported () const
+{
+  return false;
+}
+
 
 } // namespace
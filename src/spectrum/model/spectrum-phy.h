@@ -112,6 +112,16 @@ public:
    */
   virtual void StartRx (Ptr<SpectrumSignalParameters> params) = 0;
 
+  /**
+   * Tell if this SpectrumPhy accepts signals whose psd is shared with the
+   * other receivers, i.e., whose received Power Spectral Density is
+   * SpectrumSignalParameters::psd scaled by SpectrumSignalParameters::psdGain.
+   * Such a SpectrumPhy must not modify the psd.
+   *
+   * @return true if a shared psd is accepted, false by default
+   */
+  virtual bool IsPsdGainSupported () const;
+
 private:
   /**
    * \brief Copy constructor
@@ -31,6 +31,7 @@ namespace ns3 {
 NS_LOG_COMPONENT_DEFINE ("SpectrumSignalParameters");
 
 SpectrumSignalParameters::SpectrumSignalParameters ()
+  : psdGain (1.0)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -43,7 +44,11 @@ SpectrumSignalParameters::~SpectrumSignalParameters ()
 SpectrumSignalParameters::SpectrumSignalParameters (const SpectrumSignalParameters& p)
 {
   NS_LOG_FUNCTION (this << &p);
-  psd = p.psd->Copy ();
+  if (p.psd)
+    {
+      psd = p.psd->Copy ();
+    }
+  psdGain = p.psdGain;
   duration = p.duration;
   txPhy = p.txPhy;
   txAntenna = p.txAntenna;
@@ -93,6 +93,15 @@ struct SpectrumSignalParameters : public SimpleRefCount<SpectrumSignalParameters
    */
   Ptr <SpectrumValue> psd;
 
+  /**
+   * The linear gain to be applied to psd to get the received Power
+   * Spectral Density. It differs from 1 only if the channel passes
+   * the signal to a SpectrumPhy supporting it (see
+   * SpectrumPhy::IsPsdGainSupported), in which case psd is shared
+   * with the other receivers and must not be modified.
+   */
+  double psdGain;
+
   /**
    * The duration of the packet transmission. It is
    * assumed that the Power Spectral Density remains constant for the
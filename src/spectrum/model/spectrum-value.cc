@@ -103,20 +103,21 @@ SpectrumValue::ConstBandsEnd () const
 }
 
 
+// The element-wise operations are written as counted loops over the
+// underlying arrays, so that the compiler can vectorize them.
+
 void
 SpectrumValue::Add (const SpectrumValue& x)
 {
-  Values::iterator it1 = m_values.begin ();
-  Values::const_iterator it2 = x.m_values.begin ();
-
   NS_ASSERT (m_spectrumModel == x.m_spectrumModel);
+  NS_ASSERT (m_values.size () == x.m_values.size ());
 
-  while (it1 != m_values.end ())
+  double *v = m_values.data ();
+  const double *xv = x.m_values.data ();
+  const size_t n = m_values.size ();
+  for (size_t i = 0; i < n; i++)
     {
-      NS_ASSERT ( it2 != x.m_values.end ());
-      *it1 += *it2;
-      ++it1;
-      ++it2;
+      v[i] += xv[i];
     }
 }
 
@@ -124,12 +125,11 @@ SpectrumValue::Add (const SpectrumValue& x)
 void
 SpectrumValue::Add (double s)
 {
-  Values::iterator it1 = m_values.begin ();
-
-  while (it1 != m_values.end ())
+  double *v = m_values.data ();
+  const size_t n = m_values.size ();
+  for (size_t i = 0; i < n; i++)
     {
-      *it1 += s;
-      ++it1;
+      v[i] += s;
     }
 }
 
@@ -138,17 +138,15 @@ SpectrumValue::Add (double s)
 void
 SpectrumValue::Subtract (const SpectrumValue& x)
 {
-  Values::iterator it1 = m_values.begin ();
-  Values::const_iterator it2 = x.m_values.begin ();
-
   NS_ASSERT (m_spectrumModel == x.m_spectrumModel);
+  NS_ASSERT (m_values.size () == x.m_values.size ());
 
-  while (it1 != m_values.end ())
+  double *v = m_values.data ();
+  const double *xv = x.m_values.data ();
+  const size_t n = m_values.size ();
+  for (size_t i = 0; i < n; i++)
     {
-      NS_ASSERT ( it2 != x.m_values.end ());
-      *it1 -= *it2;
-      ++it1;
-      ++it2;
+      v[i] -= xv[i];
     }
 }
 
@@ -164,17 +162,15 @@ SpectrumValue::Subtract (double s)
 void
 SpectrumValue::Multiply (const SpectrumValue& x)
 {
-  Values::iterator it1 = m_values.begin ();
-  Values::const_iterator it2 = x.m_values.begin ();
-
   NS_ASSERT (m_spectrumModel == x.m_spectrumModel);
+  NS_ASSERT (m_values.size () == x.m_values.size ());
 
-  while (it1 != m_values.end ())
+  double *v = m_values.data ();
+  const double *xv = x.m_values.data ();
+  const size_t n = m_values.size ();
+  for (size_t i = 0; i < n; i++)
     {
-      NS_ASSERT ( it2 != x.m_values.end ());
-      *it1 *= *it2;
-      ++it1;
-      ++it2;
+      v[i] *= xv[i];
     }
 }
 
@@ -182,12 +178,11 @@ SpectrumValue::Multiply (const SpectrumValue& x)
 void
 SpectrumValue::Multiply (double s)
 {
-  Values::iterator it1 = m_values.begin ();
-
-  while (it1 != m_values.end ())
+  double *v = m_values.data ();
+  const size_t n = m_values.size ();
+  for (size_t i = 0; i < n; i++)
     {
-      *it1 *= s;
-      ++it1;
+      v[i] *= s;
     }
 }
 
@@ -197,17 +192,15 @@ SpectrumValue::Multiply (double s)
 void
 SpectrumValue::Divide (const SpectrumValue& x)
 {
-  Values::iterator it1 = m_values.begin ();
-  Values::const_iterator it2 = x.m_values.begin ();
-
   NS_ASSERT (m_spectrumModel == x.m_spectrumModel);
+  NS_ASSERT (m_values.size () == x.m_values.size ());
 
-  while (it1 != m_values.end ())
+  double *v = m_values.data ();
+  const double *xv = x.m_values.data ();
+  const size_t n = m_values.size ();
+  for (size_t i = 0; i < n; i++)
     {
-      NS_ASSERT ( it2 != x.m_values.end ());
-      *it1 /= *it2;
-      ++it1;
-      ++it2;
+      v[i] /= xv[i];
     }
 }
 
@@ -216,12 +209,59 @@ void
 SpectrumValue::Divide (double s)
 {
   NS_LOG_FUNCTION (this << s);
-  Values::iterator it1 = m_values.begin ();
+  double *v = m_values.data ();
+  const size_t n = m_values.size ();
+  for (size_t i = 0; i < n; i++)
+    {
+      v[i] /= s;
+    }
+}
 
-  while (it1 != m_values.end ())
+
+SpectrumValue&
+SpectrumValue::AddScaled (const SpectrumValue& rhs, double s)
+{
+  NS_ASSERT (m_spectrumModel == rhs.m_spectrumModel);
+  NS_ASSERT (m_values.size () == rhs.m_values.size ());
+
+  double *v = m_values.data ();
+  const double *xv = rhs.m_values.data ();
+  const size_t n = m_values.size ();
+  for (size_t i = 0; i < n; i++)
     {
-      *it1 /= s;
-      ++it1;
+      v[i] += xv[i] * s;
+    }
+  return *this;
+}
+
+
+void
+CalculateSinr (const SpectrumValue& signal, const SpectrumValue& allSignals, const SpectrumValue& noise,
+               SpectrumValue& interf, SpectrumValue& sinr)
+{
+  NS_ASSERT (signal.m_spectrumModel == allSignals.m_spectrumModel);
+  NS_ASSERT (signal.m_spectrumModel == noise.m_spectrumModel);
+  NS_ASSERT (signal.m_values.size () == allSignals.m_values.size ());
+  NS_ASSERT (signal.m_values.size () == noise.m_values.size ());
+  NS_ASSERT (&interf != &sinr);
+
+  const size_t n = signal.m_values.size ();
+  interf.m_spectrumModel = signal.m_spectrumModel;
+  interf.m_values.resize (n);
+  sinr.m_spectrumModel = signal.m_spectrumModel;
+  sinr.m_values.resize (n);
+
+  const double *sv = signal.m_values.data ();
+  const double *av = allSignals.m_values.data ();
+  const double *nv = noise.m_values.data ();
+  double *iv = interf.m_values.data ();
+  double *rv = sinr.m_values.data ();
+  for (size_t i = 0; i < n; i++)
+    {
+      double s = sv[i];
+      double in = av[i] - s + nv[i];
+      iv[i] = in;
+      rv[i] = s / in;
     }
 }
 
@@ -409,6 +409,33 @@ public:
    */
   SpectrumValue& operator= (double rhs);
 
+  /**
+   * Add the Right Hand Side of the operator multiplied by a scalar to
+   * *this, component by component, in a single pass and without
+   * temporaries
+   *
+   * @param rhs the Right Hand Side
+   * @param s the scalar
+   *
+   * @return a reference to *this
+   */
+  SpectrumValue& AddScaled (const SpectrumValue& rhs, double s);
+
+  /**
+   * Compute, component by component, the interference plus noise
+   * perceived by a signal and its SINR, i.e., interf = allSignals -
+   * signal + noise and sinr = signal / interf. This is done in a single
+   * pass and without temporaries.
+   *
+   * @param signal the signal
+   * @param allSignals the sum of all the signals, including signal
+   * @param noise the noise
+   * @param interf the interference plus noise (output)
+   * @param sinr the SINR (output)
+   */
+  friend void CalculateSinr (const SpectrumValue& signal, const SpectrumValue& allSignals, const SpectrumValue& noise,
+                             SpectrumValue& interf, SpectrumValue& sinr);
+
 
 
   /**
@@ -0,0 +1,161 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include <ns3/core-module.h>
+#include <ns3/test.h>
+#include <ns3/mobility-module.h>
+#include <ns3/spectrum-module.h>
+
+
+NS_LOG_COMPONENT_DEFINE ("MultiModelSpectrumChannelTest");
+
+using namespace ns3;
+
+
+/**
+ * Check that the MaxInterferenceDistance attribute of the
+ * MultiModelSpectrumChannel passes a signal to the same receivers as
+ * without it, except for the ones farther than the maximum distance,
+ * including receivers which move without notifying a course change.
+ */
+class MultiModelSpectrumChannelMaxDistanceTestCase : public TestCase
+{
+public:
+  MultiModelSpectrumChannelMaxDistanceTestCase ();
+  virtual ~MultiModelSpectrumChannelMaxDistanceTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Run the scenario and count the signals passed to the receivers
+   * \param maxDistance the MaxInterferenceDistance of the channel
+   */
+  void RunScenario (double maxDistance);
+
+  /**
+   * Trace the path loss of a signal passed to a receiver
+   * \param txPhy the transmitter
+   * \param rxPhy the receiver
+   * \param lossDb the path loss
+   */
+  void TracePathLoss (Ptr<SpectrumPhy> txPhy, Ptr<SpectrumPhy> rxPhy, double lossDb);
+
+  double m_maxDistance; ///< the maximum distance of the current run
+  uint32_t m_inRange; ///< signals passed to receivers within the maximum distance
+  uint32_t m_outOfRange; ///< signals passed to receivers farther than the maximum distance
+};
+
+MultiModelSpectrumChannelMaxDistanceTestCase::MultiModelSpectrumChannelMaxDistanceTestCase ()
+  : TestCase ("Check the MaxInterferenceDistance attribute")
+{
+}
+
+MultiModelSpectrumChannelMaxDistanceTestCase::~MultiModelSpectrumChannelMaxDistanceTestCase ()
+{
+}
+
+void
+MultiModelSpectrumChannelMaxDistanceTestCase::TracePathLoss (Ptr<SpectrumPhy> txPhy, Ptr<SpectrumPhy> rxPhy, double lossDb)
+{
+  if (CalculateDistance (txPhy->GetMobility ()->GetPosition (), rxPhy->GetMobility ()->GetPosition ()) <= m_maxDistance)
+    {
+      m_inRange++;
+    }
+  else
+    {
+      m_outOfRange++;
+    }
+}
+
+void
+MultiModelSpectrumChannelMaxDistanceTestCase::RunScenario (double maxDistance)
+{
+  m_inRange = 0;
+  m_outOfRange = 0;
+
+  SpectrumChannelHelper channelHelper = SpectrumChannelHelper::Default ();
+  channelHelper.SetChannel ("ns3::MultiModelSpectrumChannel",
+                            "MaxInterferenceDistance", DoubleValue (maxDistance));
+  Ptr<SpectrumChannel> channel = channelHelper.Create ();
+  channel->TraceConnectWithoutContext ("PathLoss", MakeCallback (&MultiModelSpectrumChannelMaxDistanceTestCase::TracePathLoss, this));
+
+  // transmitter at the origin, receivers on the x axis, the last two
+  // moving towards the transmitter and away from it
+  NodeContainer txNode;
+  txNode.Create (1);
+  NodeContainer rxNodes;
+  rxNodes.Create (5);
+  MobilityHelper mobility;
+  mobility.SetMobilityModel ("ns3::ConstantVelocityMobilityModel");
+  mobility.Install (txNode);
+  mobility.Install (rxNodes);
+  double positions[] = {50, 150, 450, 300, 20};
+  double speeds[] = {0, 0, 0, -100, 100};
+  for (uint32_t i = 0; i < rxNodes.GetN (); i++)
+    {
+      Ptr<ConstantVelocityMobilityModel> mob = rxNodes.Get (i)->GetObject<ConstantVelocityMobilityModel> ();
+      mob->SetPosition (Vector (positions[i], 0, 0));
+      mob->SetVelocity (Vector (speeds[i], 0, 0));
+    }
+
+  WaveformGeneratorHelper waveformGeneratorHelper;
+  waveformGeneratorHelper.SetTxPowerSpectralDensity (MicrowaveOvenSpectrumValueHelper::CreatePowerSpectralDensityMwo1 ());
+  waveformGeneratorHelper.SetChannel (channel);
+  waveformGeneratorHelper.SetPhyAttribute ("Period", TimeValue (MilliSeconds (10)));
+  waveformGeneratorHelper.SetPhyAttribute ("DutyCycle", DoubleValue (0.5));
+  NetDeviceContainer waveformGeneratorDevices = waveformGeneratorHelper.Install (txNode);
+  Ptr<WaveformGenerator> wave = waveformGeneratorDevices.Get (0)->GetObject<NonCommunicatingNetDevice> ()->GetPhy ()->GetObject<WaveformGenerator> ();
+
+  SpectrumAnalyzerHelper spectrumAnalyzerHelper;
+  spectrumAnalyzerHelper.SetChannel (channel);
+  spectrumAnalyzerHelper.SetRxSpectrumModel (SpectrumModelIsm2400MhzRes1Mhz);
+  spectrumAnalyzerHelper.Install (rxNodes);
+
+  Simulator::Schedule (Seconds (0.1), &WaveformGenerator::Start, wave);
+  Simulator::Stop (Seconds (5.0));
+  Simulator::Run ();
+  Simulator::Destroy ();
+}
+
+void
+MultiModelSpectrumChannelMaxDistanceTestCase::DoRun (void)
+{
+  m_maxDistance = 100;
+  RunScenario (0);
+  uint32_t expectedInRange = m_inRange;
+  NS_TEST_ASSERT_MSG_GT (m_outOfRange, 0, "all receivers are always in range");
+
+  RunScenario (m_maxDistance);
+  NS_TEST_ASSERT_MSG_EQ (m_inRange, expectedInRange, "signals not passed to receivers in range");
+  NS_TEST_ASSERT_MSG_EQ (m_outOfRange, 0, "signals passed to receivers out of range");
+}
+
+
+class MultiModelSpectrumChannelTestSuite : public TestSuite
+{
+public:
+  MultiModelSpectrumChannelTestSuite ();
+};
+
+MultiModelSpectrumChannelTestSuite::MultiModelSpectrumChannelTestSuite ()
+  : TestSuite ("multi-model-spectrum-channel", UNIT)
+{
+  NS_LOG_INFO ("creating MultiModelSpectrumChannelTestSuite");
+
+  AddTestCase (new MultiModelSpectrumChannelMaxDistanceTestCase, TestCase::QUICK);
+}
+
+static MultiModelSpectrumChannelTestSuite g_multiModelSpectrumChannelTestSuite;
@@ -223,6 +223,24 @@ SpectrumValueTestSuite::SpectrumValueTestSuite ()
   AddTestCase (new SpectrumValueTestCase (tv9b, v9, "tv9b =  doubleValue * v1"), TestCase::QUICK);
   AddTestCase (new SpectrumValueTestCase (tv10b, v10, "tv10b = doubleValue div v1"), TestCase::QUICK);
 
+  SpectrumValue tv3c (f), tv4c (f);
+  tv3c = v1;
+  tv3c.AddScaled (v2, 1.0);
+  tv4c = v1;
+  tv4c.AddScaled (v2, -1.0);
+  AddTestCase (new SpectrumValueTestCase (tv3c, v3, "tv3c = v1, AddScaled (v2, 1)"), TestCase::QUICK);
+  AddTestCase (new SpectrumValueTestCase (tv4c, v4, "tv4c = v1, AddScaled (v2, -1)"), TestCase::QUICK);
+
+  SpectrumValue tv9c (f);
+  tv9c = v9;
+  tv9c.AddScaled (v1, -doubleValue);
+  AddTestCase (new SpectrumValueTestCase (tv9c, SpectrumValue (f), "tv9c = v9, AddScaled (v1, -doubleValue)"), TestCase::QUICK);
+
+  SpectrumValue interf (f), sinr (f);
+  CalculateSinr (v1, v3, v2, interf, sinr);
+  AddTestCase (new SpectrumValueTestCase (interf, v3 - v1 + v2, "interf = v3 - v1 + v2"), TestCase::QUICK);
+  AddTestCase (new SpectrumValueTestCase (sinr, v1 / (v3 - v1 + v2), "sinr = v1 div (v3 - v1 + v2)"), TestCase::QUICK);
+
 
 
 
@@ -0,0 +1,320 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/cam-application.h"
+#include "ns3/log.h"
+#include "ns3/abort.h"
+#include "ns3/simulator.h"
+#include "ns3/uinteger.h"
+#include "ns3/double.h"
+#include "ns3/enum.h"
+#include "ns3/pointer.h"
+#include "ns3/string.h"
+#include "ns3/packet.h"
+#include "ns3/node.h"
+#include "ns3/mobility-model.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/inet6-socket-address.h"
+#include "ns3/udp-socket-factory.h"
+#include "ns3/v2x-message-tag.h"
+#include <cmath>
+
+NS_LOG_COMPONENT_DEFINE ("CamApplication");
+
+namespace ns3 {
+
+NS_OBJECT_ENSURE_REGISTERED (CamApplication);
+
+TypeId
+CamApplication::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::CamApplication")
+    .SetParent<Application> ()
+    .SetGroupName ("Wave")
+    .AddConstructor<CamApplication> ()
+    .AddAttribute ("Remote", "The address of the destination of the messages",
+                   AddressValue (),
+                   MakeAddressAccessor (&CamApplication::m_peer),
+                   MakeAddressChecker ())
+    .AddAttribute ("Protocol", "The type of protocol to use.",
+                   TypeIdValue (UdpSocketFactory::GetTypeId ()),
+                   MakeTypeIdAccessor (&CamApplication::m_tid),
+                   MakeTypeIdChecker ())
+    .AddAttribute ("LocalPort", "The port of the received messages (0 to not receive them)",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&CamApplication::m_localPort),
+                   MakeUintegerChecker<uint16_t> ())
+    .AddAttribute ("GenerationMode", "The generation mode of the messages",
+                   EnumValue (CamApplication::PERIODIC),
+                   MakeEnumAccessor (&CamApplication::m_mode),
+                   MakeEnumChecker (CamApplication::PERIODIC, "Periodic",
+                                    CamApplication::ETSI, "Etsi"))
+    .AddAttribute ("Interval", "The generation interval of the PERIODIC mode",
+                   TimeValue (MilliSeconds (100)),
+                   MakeTimeAccessor (&CamApplication::m_interval),
+                   MakeTimeChecker ())
+    .AddAttribute ("Jitter", "A RandomVariableStream for the jitter in seconds added to the interval of the PERIODIC mode",
+                   StringValue ("ns3::ConstantRandomVariable[Constant=0.0]"),
+                   MakePointerAccessor (&CamApplication::m_jitter),
+                   MakePointerChecker <RandomVariableStream>())
+    .AddAttribute ("StartOffset", "A RandomVariableStream for the offset in seconds of the first message",
+                   StringValue ("ns3::UniformRandomVariable[Min=0.0|Max=0.1]"),
+                   MakePointerAccessor (&CamApplication::m_startOffset),
+                   MakePointerChecker <RandomVariableStream>())
+    .AddAttribute ("PacketSize", "A RandomVariableStream for the size in bytes of the messages",
+                   StringValue ("ns3::ConstantRandomVariable[Constant=190]"),
+                   MakePointerAccessor (&CamApplication::m_packetSize),
+                   MakePointerChecker <RandomVariableStream>())
+    .AddAttribute ("CheckInterval", "The interval of the checks of the ETSI mode (T_CheckCamGen)",
+                   TimeValue (MilliSeconds (100)),
+                   MakeTimeAccessor (&CamApplication::m_checkInterval),
+                   MakeTimeChecker ())
+    .AddAttribute ("MinInterval", "The minimum generation interval of the ETSI mode (T_GenCamMin)",
+                   TimeValue (MilliSeconds (100)),
+                   MakeTimeAccessor (&CamApplication::m_minInterval),
+                   MakeTimeChecker ())
+    .AddAttribute ("MaxInterval", "The maximum generation interval of the ETSI mode (T_GenCamMax)",
+                   TimeValue (Seconds (1)),
+                   MakeTimeAccessor (&CamApplication::m_maxInterval),
+                   MakeTimeChecker ())
+    .AddAttribute ("HeadingThreshold", "The heading change in degrees triggering a message in the ETSI mode",
+                   DoubleValue (4.0),
+                   MakeDoubleAccessor (&CamApplication::m_headingThreshold),
+                   MakeDoubleChecker<double> (0.0))
+    .AddAttribute ("DistanceThreshold", "The position change in meters triggering a message in the ETSI mode",
+                   DoubleValue (4.0),
+                   MakeDoubleAccessor (&CamApplication::m_distanceThreshold),
+                   MakeDoubleChecker<double> (0.0))
+    .AddAttribute ("SpeedThreshold", "The speed change in m/s triggering a message in the ETSI mode",
+                   DoubleValue (0.5),
+                   MakeDoubleAccessor (&CamApplication::m_speedThreshold),
+                   MakeDoubleChecker<double> (0.0))
+    .AddAttribute ("NumTriggeredCams", "The number of messages generated at the interval of a triggered message in the ETSI mode (N_GenCam)",
+                   UintegerValue (3),
+                   MakeUintegerAccessor (&CamApplication::m_numTriggeredCams),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddTraceSource ("Tx", "A message is sent",
+                     MakeTraceSourceAccessor (&CamApplication::m_txTrace),
+                     "ns3::Packet::TracedCallback")
+    .AddTraceSource ("Rx", "A message is received",
+                     MakeTraceSourceAccessor (&CamApplication::m_rxTrace),
+                     "ns3::Packet::AddressTracedCallback")
+  ;
+  return tid;
+}
+
+CamApplication::CamApplication ()
+  : m_socket (0),
+    m_rxSocket (0),
+    m_sent (0),
+    m_nTimeTriggered (0),
+    m_lastSpeed (0.0),
+    m_lastHeading (0.0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+CamApplication::~CamApplication ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+int64_t
+CamApplication::AssignStreams (int64_t stream)
+{
+  NS_LOG_FUNCTION (this << stream);
+  m_jitter->SetStream (stream);
+  m_startOffset->SetStream (stream + 1);
+  m_packetSize->SetStream (stream + 2);
+  return 3;
+}
+
+uint32_t
+CamApplication::GetSent (void) const
+{
+  return m_sent;
+}
+
+void
+CamApplication::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_socket = 0;
+  m_rxSocket = 0;
+  // chain up
+  Application::DoDispose ();
+}
+
+void
+CamApplication::StartApplication (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_socket == 0)
+    {
+      m_socket = Socket::CreateSocket (GetNode (), m_tid);
+      int ret = Inet6SocketAddress::IsMatchingType (m_peer) ? m_socket->Bind6 () : m_socket->Bind ();
+      if (ret == -1)
+        {
+          NS_FATAL_ERROR ("Failed to bind socket");
+        }
+      m_socket->Connect (m_peer);
+      m_socket->SetAllowBroadcast (true);
+      m_socket->ShutdownRecv ();
+    }
+  if (m_localPort != 0 && m_rxSocket == 0)
+    {
+      m_rxSocket = Socket::CreateSocket (GetNode (), m_tid);
+      if (m_rxSocket->Bind (InetSocketAddress (Ipv4Address::GetAny (), m_localPort)) == -1)
+        {
+          NS_FATAL_ERROR ("Failed to bind socket");
+        }
+      m_rxSocket->SetRecvCallback (MakeCallback (&CamApplication::HandleRead, this));
+    }
+
+  Time offset = Seconds (std::max (0.0, m_startOffset->GetValue ()));
+  if (m_mode == PERIODIC)
+    {
+      m_event = Simulator::Schedule (offset, &CamApplication::GeneratePeriodic, this);
+    }
+  else
+    {
+      // the first check generates a message, at the maximum interval
+      Ptr<MobilityModel> mobility = GetNode ()->GetObject<MobilityModel> ();
+      m_lastPosition = mobility != 0 ? mobility->GetPosition () : Vector ();
+      m_lastSpeed = mobility != 0 ? mobility->GetVelocity ().GetLength () : 0.0;
+      m_lastHeading = GetHeading ();
+      m_lastTime = Simulator::Now () + offset - m_maxInterval;
+      m_genCam = m_maxInterval;
+      m_nTimeTriggered = m_numTriggeredCams;
+      m_event = Simulator::Schedule (offset, &CamApplication::CheckEtsi, this);
+    }
+}
+
+void
+CamApplication::StopApplication (void)
+{
+  NS_LOG_FUNCTION (this);
+  Simulator::Cancel (m_event);
+}
+
+double
+CamApplication::GetHeading (void) const
+{
+  Ptr<MobilityModel> mobility = GetNode ()->GetObject<MobilityModel> ();
+  if (mobility == 0)
+    {
+      return m_lastHeading;
+    }
+  Vector velocity = mobility->GetVelocity ();
+  if (velocity.x == 0 && velocity.y == 0)
+    {
+      return m_lastHeading;
+    }
+  return std::atan2 (velocity.y, velocity.x) * 180.0 / M_PI;
+}
+
+void
+CamApplication::GeneratePeriodic (void)
+{
+  NS_LOG_FUNCTION (this);
+  SendCam ();
+  Time next = m_interval + Seconds (m_jitter->GetValue ());
+  m_event = Simulator::Schedule (next.IsPositive () ? next : Time (0), &CamApplication::GeneratePeriodic, this);
+}
+
+void
+CamApplication::CheckEtsi (void)
+{
+  NS_LOG_FUNCTION (this);
+  Time elapsed = Simulator::Now () - m_lastTime;
+  bool dynamics = false;
+  if (elapsed >= m_minInterval)
+    {
+      Ptr<MobilityModel> mobility = GetNode ()->GetObject<MobilityModel> ();
+      if (mobility != 0)
+        {
+          double headingChange = std::fabs (GetHeading () - m_lastHeading);
+          headingChange = std::min (headingChange, 360.0 - headingChange);
+          dynamics = headingChange > m_headingThreshold
+            || CalculateDistance (mobility->GetPosition (), m_lastPosition) > m_distanceThreshold
+            || std::fabs (mobility->GetVelocity ().GetLength () - m_lastSpeed) > m_speedThreshold;
+        }
+    }
+  if (dynamics)
+    {
+      // condition 1: the dynamics changed, the next messages follow the
+      // same interval
+      NS_LOG_LOGIC ("message triggered by the dynamics after " << elapsed.GetSeconds () << "s");
+      m_genCam = elapsed;
+      m_nTimeTriggered = 0;
+      SendCam ();
+    }
+  else if (elapsed >= m_genCam)
+    {
+      // condition 2: the generation interval elapsed
+      NS_LOG_LOGIC ("message triggered by the interval " << m_genCam.GetSeconds () << "s");
+      if (++m_nTimeTriggered >= m_numTriggeredCams)
+        {
+          m_genCam = m_maxInterval;
+        }
+      SendCam ();
+    }
+  m_event = Simulator::Schedule (m_checkInterval, &CamApplication::CheckEtsi, this);
+}
+
+void
+CamApplication::SendCam (void)
+{
+  NS_LOG_FUNCTION (this);
+  uint32_t size = m_packetSize->GetInteger ();
+  NS_ABORT_MSG_IF (size == 0, "The messages must have at least one byte to carry their tag");
+  Ptr<Packet> packet = Create<Packet> (size);
+
+  Ptr<MobilityModel> mobility = GetNode ()->GetObject<MobilityModel> ();
+  V2xMessageTag tag;
+  tag.SetStationId (GetNode ()->GetId ());
+  tag.SetSequenceNumber (m_sent);
+  tag.SetGenerationTime (Simulator::Now ());
+  if (mobility != 0)
+    {
+      tag.SetPosition (mobility->GetPosition ());
+      m_lastPosition = mobility->GetPosition ();
+      m_lastSpeed = mobility->GetVelocity ().GetLength ();
+      m_lastHeading = GetHeading ();
+    }
+  packet->AddByteTag (tag);
+  m_lastTime = Simulator::Now ();
+
+  m_txTrace (packet);
+  m_socket->Send (packet);
+  m_sent++;
+  NS_LOG_INFO ("node " << GetNode ()->GetId () << " sent message " << tag.GetSequenceNumber ()
+                       << " of " << size << " bytes");
+}
+
+void
+CamApplication::HandleRead (Ptr<Socket> socket)
+{
+  NS_LOG_FUNCTION (this << socket);
+  Ptr<Packet> packet;
+  Address from;
+  while ((packet = socket->RecvFrom (from)))
+    {
+      m_rxTrace (packet, from);
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,144 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef CAM_APPLICATION_H
+#define CAM_APPLICATION_H
+
+#include "ns3/application.h"
+#include "ns3/address.h"
+#include "ns3/event-id.h"
+#include "ns3/nstime.h"
+#include "ns3/vector.h"
+#include "ns3/socket.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/traced-callback.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup wave
+ * \brief Generates Cooperative Awareness Messages (CAMs), or other
+ * periodic V2X messages such as BSMs, and broadcasts them through a
+ * socket, e.g. over the LTE sidelink.
+ *
+ * In the PERIODIC mode, a message is generated every Interval, plus a
+ * random Jitter. In the ETSI mode, the generation rules of ETSI EN 302
+ * 637-2 are checked every CheckInterval: a message is generated when
+ * the heading, the position or the speed of the node changed by more
+ * than a threshold since the previous one and MinInterval elapsed, or
+ * when the current generation interval elapsed. The generation interval
+ * is MaxInterval, or the interval of the last message triggered by the
+ * dynamics of the node for the next NumTriggeredCams messages.
+ *
+ * The first message is generated after a random StartOffset, and the
+ * size of each message is drawn from PacketSize. The messages have no
+ * payload bytes: their metadata (node id, sequence number, generation
+ * time and position) is carried by a V2xMessageTag byte tag.
+ */
+class CamApplication : public Application
+{
+public:
+  /// Generation mode of the messages
+  enum GenerationMode
+  {
+    PERIODIC,
+    ETSI
+  };
+
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  CamApplication ();
+  virtual ~CamApplication ();
+
+  /**
+   * Assign a fixed random variable stream number to the random variables
+   * used by this model.
+   *
+   * \param stream first stream index to use
+   * \return the number of stream indices assigned by this model
+   */
+  int64_t AssignStreams (int64_t stream);
+
+  /**
+   * \return the number of messages generated
+   */
+  uint32_t GetSent (void) const;
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  // inherited from Application base class.
+  virtual void StartApplication (void);
+  virtual void StopApplication (void);
+
+  /** Generate a message and schedule the next one in the PERIODIC mode. */
+  void GeneratePeriodic (void);
+  /** Check the ETSI generation rules and schedule the next check. */
+  void CheckEtsi (void);
+  /** Generate and send a message. */
+  void SendCam (void);
+  /**
+   * Receive the messages of a socket
+   * \param socket the socket
+   */
+  void HandleRead (Ptr<Socket> socket);
+  /**
+   * \return the heading of the node in degrees, or the previous one if
+   *         the node does not move
+   */
+  double GetHeading (void) const;
+
+  Address m_peer; //!< destination of the messages
+  TypeId m_tid; //!< type of the socket factory
+  uint16_t m_localPort; //!< port of the received messages, or 0
+  GenerationMode m_mode; //!< generation mode
+  Time m_interval; //!< interval of the PERIODIC mode
+  Ptr<RandomVariableStream> m_jitter; //!< jitter of the PERIODIC mode, in seconds
+  Ptr<RandomVariableStream> m_startOffset; //!< offset of the first message, in seconds
+  Ptr<RandomVariableStream> m_packetSize; //!< size of the messages, in bytes
+  Time m_checkInterval; //!< T_CheckCamGen
+  Time m_minInterval; //!< T_GenCamMin
+  Time m_maxInterval; //!< T_GenCamMax
+  double m_headingThreshold; //!< heading change triggering a message, in degrees
+  double m_distanceThreshold; //!< position change triggering a message, in meters
+  double m_speedThreshold; //!< speed change triggering a message, in m/s
+  uint32_t m_numTriggeredCams; //!< N_GenCam
+
+  Ptr<Socket> m_socket; //!< socket of the sent messages
+  Ptr<Socket> m_rxSocket; //!< socket of the received messages
+  EventId m_event; //!< next generation or check
+  uint32_t m_sent; //!< number of messages generated
+  Time m_genCam; //!< current generation interval of the ETSI mode (T_GenCam)
+  uint32_t m_nTimeTriggered; //!< messages generated at T_GenCam since the last triggered one
+  Time m_lastTime; //!< generation time of the last message
+  Vector m_lastPosition; //!< position at the last message
+  double m_lastSpeed; //!< speed at the last message
+  double m_lastHeading; //!< heading at the last message, in degrees
+
+  /// Traced callback: a message was sent
+  TracedCallback<Ptr<const Packet> > m_txTrace;
+  /// Traced callback: a message was received
+  TracedCallback<Ptr<const Packet>, const Address &> m_rxTrace;
+};
+
+} // namespace ns3
+
+#endif /* CAM_APPLICATION_H */
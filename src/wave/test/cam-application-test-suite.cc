@@ -0,0 +1,171 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+#include "ns3/enum.h"
+#include "ns3/uinteger.h"
+#include "ns3/node-container.h"
+#include "ns3/simple-net-device-helper.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/constant-velocity-mobility-model.h"
+#include "ns3/v2x-message-tag.h"
+#include "ns3/cam-helper.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup wave
+ * \ingroup tests
+ *
+ * Broadcast the messages of a CamApplication on a moving node to a
+ * static node, and check the generation times and the received tags.
+ */
+class CamApplicationTestCase : public TestCase
+{
+public:
+  /**
+   * Constructor
+   * \param name the name of the test case
+   * \param mode the generation mode
+   * \param speed the speed of the transmitter, in m/s
+   * \param interval the expected interval of the messages
+   */
+  CamApplicationTestCase (std::string name, CamApplication::GenerationMode mode, double speed, Time interval);
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Record a sent message
+   * \param packet the message
+   */
+  void Tx (Ptr<const Packet> packet);
+  /**
+   * Check a received message
+   * \param packet the message
+   * \param from the address of the transmitter
+   */
+  void Rx (Ptr<const Packet> packet, const Address &from);
+
+  CamApplication::GenerationMode m_mode; ///< generation mode
+  double m_speed; ///< speed of the transmitter
+  Time m_interval; ///< expected interval of the messages
+  std::vector<Time> m_txTimes; ///< generation times of the messages
+  uint32_t m_received; ///< number of messages received
+};
+
+CamApplicationTestCase::CamApplicationTestCase (std::string name, CamApplication::GenerationMode mode, double speed, Time interval)
+  : TestCase (name),
+    m_mode (mode),
+    m_speed (speed),
+    m_interval (interval),
+    m_received (0)
+{
+}
+
+void
+CamApplicationTestCase::Tx (Ptr<const Packet> packet)
+{
+  NS_TEST_ASSERT_MSG_EQ (packet->GetSize (), (uint32_t) 300, "wrong message size");
+  m_txTimes.push_back (Simulator::Now ());
+}
+
+void
+CamApplicationTestCase::Rx (Ptr<const Packet> packet, const Address &from)
+{
+  V2xMessageTag tag;
+  NS_TEST_ASSERT_MSG_EQ (packet->FindFirstMatchingByteTag (tag), true, "message without tag");
+  NS_TEST_ASSERT_MSG_EQ (tag.GetStationId (), (uint32_t) 0, "wrong station id");
+  NS_TEST_ASSERT_MSG_EQ (tag.GetSequenceNumber (), m_received, "wrong sequence number");
+  NS_TEST_ASSERT_MSG_EQ (tag.GetGenerationTime (), m_txTimes.back (), "wrong generation time");
+  NS_TEST_ASSERT_MSG_EQ_TOL (tag.GetPosition ().x, m_speed * tag.GetGenerationTime ().GetSeconds (), 1e-9, "wrong position");
+  m_received++;
+}
+
+void
+CamApplicationTestCase::DoRun (void)
+{
+  NodeContainer nodes;
+  nodes.Create (2);
+  for (uint32_t i = 0; i < nodes.GetN (); i++)
+    {
+      Ptr<ConstantVelocityMobilityModel> mobility = CreateObject<ConstantVelocityMobilityModel> ();
+      mobility->SetVelocity (Vector (i == 0 ? m_speed : 0.0, 0, 0));
+      nodes.Get (i)->AggregateObject (mobility);
+    }
+  SimpleNetDeviceHelper simple;
+  NetDeviceContainer devices = simple.Install (nodes);
+  InternetStackHelper internet;
+  internet.Install (nodes);
+  Ipv4AddressHelper ipv4;
+  ipv4.SetBase ("10.1.1.0", "255.255.255.0");
+  ipv4.Assign (devices);
+
+  CamHelper cam ("ns3::UdpSocketFactory", InetSocketAddress (Ipv4Address ("10.1.1.255"), 8000));
+  cam.SetAttribute ("GenerationMode", EnumValue (m_mode));
+  cam.SetAttribute ("StartOffset", StringValue ("ns3::ConstantRandomVariable[Constant=0.0]"));
+  cam.SetAttribute ("PacketSize", StringValue ("ns3::ConstantRandomVariable[Constant=300]"));
+  ApplicationContainer tx = cam.Install (nodes.Get (0));
+  tx.Get (0)->TraceConnectWithoutContext ("Tx", MakeCallback (&CamApplicationTestCase::Tx, this));
+  cam.SetAttribute ("LocalPort", UintegerValue (8000));
+  cam.SetAttribute ("StartOffset", StringValue ("ns3::ConstantRandomVariable[Constant=10.0]"));
+  ApplicationContainer rx = cam.Install (nodes.Get (1));
+  rx.Get (0)->TraceConnectWithoutContext ("Rx", MakeCallback (&CamApplicationTestCase::Rx, this));
+  tx.Stop (Seconds (2.05));
+  rx.Stop (Seconds (2.05));
+
+  Simulator::Stop (Seconds (2.1));
+  Simulator::Run ();
+
+  uint32_t expected = (uint32_t) (Seconds (2) / m_interval) + 1;
+  NS_TEST_ASSERT_MSG_EQ (m_txTimes.size (), (std::size_t) expected, "wrong number of messages");
+  for (uint32_t i = 0; i < m_txTimes.size (); i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (m_txTimes[i], m_interval * i, "wrong generation time of message " << i);
+    }
+  NS_TEST_ASSERT_MSG_EQ (m_received, expected, "wrong number of messages received");
+  NS_TEST_ASSERT_MSG_EQ (DynamicCast<CamApplication> (tx.Get (0))->GetSent (), expected, "wrong number of messages sent");
+  Simulator::Destroy ();
+}
+
+
+/**
+ * \ingroup wave
+ * \ingroup tests
+ *
+ * Test suite of the CAM application.
+ */
+class CamApplicationTestSuite : public TestSuite
+{
+public:
+  CamApplicationTestSuite ();
+};
+
+CamApplicationTestSuite::CamApplicationTestSuite ()
+  : TestSuite ("cam-application", UNIT)
+{
+  AddTestCase (new CamApplicationTestCase ("periodic", CamApplication::PERIODIC, 10.0, MilliSeconds (100)), TestCase::QUICK);
+  // the messages of a static node are generated at T_GenCamMax
+  AddTestCase (new CamApplicationTestCase ("etsi static", CamApplication::ETSI, 0.0, Seconds (1)), TestCase::QUICK);
+  // a node moves by more than 4 m in 100 ms at 50 m/s, and in 200 ms at 25 m/s
+  AddTestCase (new CamApplicationTestCase ("etsi 50 m/s", CamApplication::ETSI, 50.0, MilliSeconds (100)), TestCase::QUICK);
+  AddTestCase (new CamApplicationTestCase ("etsi 25 m/s", CamApplication::ETSI, 25.0, MilliSeconds (200)), TestCase::QUICK);
+}
+
+static CamApplicationTestSuite g_camApplicationTestSuite;
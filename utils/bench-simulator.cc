@@ -39,6 +39,28 @@ std::string g_me;
 // Output field width
 int g_fwidth = 6;
 
+// TTI of the subframe-synchronous workload, in ns, or 0
+uint64_t g_tti = 0;
+
+/**
+ * Get the delay of an event, aligned on the TTI boundaries in the
+ * subframe-synchronous workload
+ * \param ns the delay drawn from the distribution, in ns
+ * \return the delay of the event
+ */
+Time
+GetDelay (double ns)
+{
+  if (g_tti == 0)
+    {
+      return NanoSeconds (ns);
+    }
+  // the event is delayed to the first TTI boundary after the drawn time,
+  // as the events of LTE are on the subframe boundaries
+  uint64_t at = Simulator::Now ().GetNanoSeconds () + (uint64_t) ns;
+  return NanoSeconds ((at / g_tti + 1) * g_tti) - Simulator::Now ();
+}
+
 /// Bench class
 class Bench
 {
@@ -107,7 +129,7 @@ Bench::RunBench (void)
   time.Start ();
   for (uint32_t i = 0; i < m_population; ++i)
     {
-      Time at = NanoSeconds (m_rand->GetValue ());
+      Time at = GetDelay (m_rand->GetValue ());
       Simulator::Schedule (at, &Bench::Cb, this);
     }
   init = time.End ();
@@ -139,7 +161,7 @@ Bench::Cb (void)
     }
   DEB ("event at " << Simulator::Now ().GetSeconds () << "s");
 
-  Time after = NanoSeconds (m_rand->GetValue ());
+  Time after = GetDelay (m_rand->GetValue ());
   Simulator::Schedule (after, &Bench::Cb, this);
   ++m_count;
 }
@@ -207,6 +229,7 @@ int main (int argc, char *argv[])
   bool schedHeap = false;
   bool schedList = false;
   bool schedMap  = true;
+  bool schedBucket = false;
 
   uint32_t pop   =  100000;
   uint32_t total = 1000000;
@@ -221,17 +244,21 @@ int main (int argc, char *argv[])
              "  an ascii file, given by the --file=\"<filename>\" argument,\n"
              "  or standard input, by the argument --file=\"-\"\n"
              "In the case of either --file form, the input is expected\n"
-             "to be ascii, giving the relative event times in ns.");
+             "to be ascii, giving the relative event times in ns.\n"
+             "With --tti=<ns>, the events are delayed to the next multiple\n"
+             "of the TTI, as the subframe-synchronous events of LTE.");
   cmd.AddValue ("cal",   "use CalendarSheduler",          schedCal);
   cmd.AddValue ("heap",  "use HeapScheduler",             schedHeap);
   cmd.AddValue ("list",  "use ListSheduler",              schedList);
   cmd.AddValue ("map",   "use MapScheduler (default)",    schedMap);
+  cmd.AddValue ("bucket", "use BucketScheduler",          schedBucket);
   cmd.AddValue ("debug", "enable debugging output",       g_debug);
   cmd.AddValue ("pop",   "event population size (default 1E5)",         pop);
   cmd.AddValue ("total", "total number of events to run (default 1E6)", total);
   cmd.AddValue ("runs",  "number of runs (default 1)",    runs);
   cmd.AddValue ("file",  "file of relative event times",  filename);
   cmd.AddValue ("prec",  "printed output precision",      g_fwidth);
+  cmd.AddValue ("tti",   "TTI of the subframe-synchronous workload in ns (default 0: none)", g_tti);
   cmd.Parse (argc, argv);
   g_me = cmd.GetName () + ": ";
   g_fwidth += 6;  // 5 extra chars in '2.000002e+07 ': . e+0 _
@@ -249,6 +276,10 @@ int main (int argc, char *argv[])
     {
       factory.SetTypeId ("ns3::ListScheduler");
     }
+  if (schedBucket)
+    {
+      factory.SetTypeId ("ns3::BucketScheduler");
+    }
   Simulator::SetScheduler (factory);
 
   LOGME (std::setprecision (g_fwidth - 6));
@@ -258,6 +289,10 @@ int main (int argc, char *argv[])
   LOGME ("population: " << pop);
   LOGME ("total events: " << total);
   LOGME ("runs: " << runs);
+  if (g_tti != 0)
+    {
+      LOGME ("TTI: " << g_tti << " ns");
+    }
 
   Bench *bench = new Bench (pop, total);
   bench->SetRandomStream (GetRandomStream (filename));
@@ -300,6 +335,10 @@ int main (int argc, char *argv[])
     }
 
   LOG ("");
+  EventPool::Stats pool = EventPool::GetStats ();
+  LOG ("Event pool: " << pool.m_allocations << " allocations, " <<
+       pool.m_reuses << " reused, " << pool.m_unpooled << " unpooled, " <<
+       pool.m_cached << " cached");
   Simulator::Destroy ();
   delete bench;
   return 0;
@@ -0,0 +1,173 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program can be used to benchmark the SpectrumValue operations
+// used by the interference and SINR evaluations, comparing the
+// arithmetic operators with the fused in-place kernels, for 'n'
+// iterations on SpectrumValues of 'bands' values (e.g., one per RB)
+// Sample usage:  ./waf --run 'bench-spectrum-value --n=1000000 --bands=50'
+
+#include "ns3/command-line.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/spectrum-value.h"
+#include <iostream>
+#include <stdlib.h> // for exit ()
+#include <limits>
+#include <algorithm>
+
+using namespace ns3;
+
+static Ptr<SpectrumValue> g_signal;
+static Ptr<SpectrumValue> g_allSignals;
+static Ptr<SpectrumValue> g_noise;
+static Ptr<SpectrumValue> g_interf;
+static Ptr<SpectrumValue> g_sinr;
+static double g_gain = 1e-9;
+static double g_check; // accumulated so that the computations are not optimized away
+
+static void
+benchSinrOperators (uint32_t n)
+{
+  for (uint32_t i = 0; i < n; i++)
+    {
+      SpectrumValue interf = (*g_allSignals) - (*g_signal) + (*g_noise);
+      SpectrumValue sinr = (*g_signal) / interf;
+      g_check += sinr[i % sinr.GetSpectrumModel ()->GetNumBands ()];
+    }
+}
+
+static void
+benchSinrKernel (uint32_t n)
+{
+  for (uint32_t i = 0; i < n; i++)
+    {
+      CalculateSinr (*g_signal, *g_allSignals, *g_noise, *g_interf, *g_sinr);
+      g_check += (*g_sinr)[i % g_sinr->GetSpectrumModel ()->GetNumBands ()];
+    }
+}
+
+static void
+benchAddScaledOperators (uint32_t n)
+{
+  for (uint32_t i = 0; i < n; i++)
+    {
+      (*g_allSignals) += (*g_signal) * g_gain;
+      (*g_allSignals) -= (*g_signal) * g_gain;
+    }
+  g_check += (*g_allSignals)[0];
+}
+
+static void
+benchAddScaledKernel (uint32_t n)
+{
+  for (uint32_t i = 0; i < n; i++)
+    {
+      g_allSignals->AddScaled (*g_signal, g_gain);
+      g_allSignals->AddScaled (*g_signal, -g_gain);
+    }
+  g_check += (*g_allSignals)[0];
+}
+
+static uint64_t
+runBenchOneIteration (void (*bench) (uint32_t), uint32_t n)
+{
+  SystemWallClockMs time;
+  time.Start ();
+  (*bench) (n);
+  uint64_t deltaMs = time.End ();
+  return deltaMs;
+}
+
+
+static void
+runBench (void (*bench) (uint32_t), uint32_t n, uint32_t minIterations, char const *name)
+{
+  uint64_t minDelay = std::numeric_limits<uint64_t>::max();
+  for (uint32_t i = 0; i < minIterations; i++)
+    {
+      uint64_t delay = runBenchOneIteration(bench, n);
+      minDelay = std::min(minDelay, delay);
+    }
+  double ps = n;
+  ps *= 1000;
+  ps /= std::max (minDelay, (uint64_t) 1);
+  std::cout << ps << " evaluations/s"
+            << " (" << minDelay << " ms elapsed)\t"
+            << name
+            << std::endl;
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t n = 0;
+  uint32_t bands = 50;
+  uint32_t minIterations = 1;
+
+  CommandLine cmd;
+  cmd.Usage ("Benchmark SpectrumValue operations");
+  cmd.AddValue ("n", "number of iterations", n);
+  cmd.AddValue ("bands", "number of values of each SpectrumValue", bands);
+  cmd.AddValue ("min-iterations", "number of subiterations to minimize iteration time over", minIterations);
+  cmd.Parse (argc, argv);
+
+  if (n == 0 || bands == 0)
+    {
+      std::cerr << "Error-- number of iterations must be specified " <<
+        "by command-line argument --n=(number of iterations)" << std::endl;
+      exit (1);
+    }
+
+  std::vector<double> freqs;
+  for (uint32_t i = 0; i < bands; i++)
+    {
+      freqs.push_back (2.0e9 + i * 180.0e3);
+    }
+  Ptr<SpectrumModel> sm = Create<SpectrumModel> (freqs);
+  g_signal = Create<SpectrumValue> (sm);
+  g_allSignals = Create<SpectrumValue> (sm);
+  g_noise = Create<SpectrumValue> (sm);
+  g_interf = Create<SpectrumValue> (sm);
+  g_sinr = Create<SpectrumValue> (sm);
+  for (uint32_t i = 0; i < bands; i++)
+    {
+      (*g_signal)[i] = (i % 5 == 0) ? 0 : 1e-16 * (1 + i);
+      (*g_allSignals)[i] = 3 * (*g_signal)[i] + 1e-18 * i;
+    }
+  (*g_noise) = 1.6e-20;
+
+  // the kernels must give the same values as the operators
+  CalculateSinr (*g_signal, *g_allSignals, *g_noise, *g_interf, *g_sinr);
+  SpectrumValue sinr = (*g_signal) / ((*g_allSignals) - (*g_signal) + (*g_noise));
+  for (uint32_t i = 0; i < bands; i++)
+    {
+      if (sinr[i] != (*g_sinr)[i])
+        {
+          std::cerr << "Error-- CalculateSinr differs from the operators on band " << i << std::endl;
+          exit (1);
+        }
+    }
+
+  std::cout << "Running bench-spectrum-value with n=" << n << " bands=" << bands << std::endl;
+
+  runBench (&benchSinrOperators, n, minIterations, "SINR with operators");
+  runBench (&benchSinrKernel, n, minIterations, "SINR with CalculateSinr");
+  runBench (&benchAddScaledOperators, n, minIterations, "Add/subtract scaled signal with operators");
+  runBench (&benchAddScaledKernel, n, minIterations, "Add/subtract scaled signal with AddScaled");
+
+  std::cout << "(checksum " << g_check << ")" << std::endl;
+
+  return 0;
+}
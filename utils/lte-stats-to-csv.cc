@@ -0,0 +1,67 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program converts the binary output files of the LTE statistics
+// calculators (written when ns3::LteStatsCalculator::BinaryOutputEnabled
+// is true) to CSV, or with --tab to the text format of the calculators.
+// Sample usage:  ./waf --run 'lte-stats-to-csv --input=SlRxPhyStats.txt --output=SlRxPhyStats.csv'
+
+#include "ns3/command-line.h"
+#include "ns3/lte-stats-file.h"
+#include <iostream>
+#include <fstream>
+#include <stdlib.h> // for exit ()
+
+using namespace ns3;
+
+int
+main (int argc, char *argv[])
+{
+  std::string input;
+  std::string output;
+  bool tab = false;
+
+  CommandLine cmd;
+  cmd.AddValue ("input", "binary statistics file", input);
+  cmd.AddValue ("output", "output file (standard output if empty)", output);
+  cmd.AddValue ("tab", "write the text format of the calculators instead of CSV", tab);
+  cmd.Parse (argc, argv);
+
+  std::ifstream in (input.c_str (), std::ios_base::in | std::ios_base::binary);
+  if (!in.is_open ())
+    {
+      std::cerr << "Can't open file " << input << std::endl;
+      exit (1);
+    }
+  std::ofstream outFile;
+  if (!output.empty ())
+    {
+      outFile.open (output.c_str ());
+      if (!outFile.is_open ())
+        {
+          std::cerr << "Can't open file " << output << std::endl;
+          exit (1);
+        }
+    }
+  std::ostream& out = output.empty () ? std::cout : outFile;
+
+  if (!LteStatsFile::ConvertToText (in, out, tab ? '\t' : ',', tab))
+    {
+      std::cerr << "Invalid binary statistics file " << input << std::endl;
+      exit (1);
+    }
+  return 0;
+}